@@ -88,6 +88,12 @@ if( NOT APPLE )
   endif()
 endif()
 
+#-------------------------------------------------------------------------------
+# In-kernel file copy
+#-------------------------------------------------------------------------------
+check_function_exists( copy_file_range HAVE_COPY_FILE_RANGE )
+compiler_define_if_found( HAVE_COPY_FILE_RANGE HAVE_COPY_FILE_RANGE )
+
 #-------------------------------------------------------------------------------
 # Check for libcrypt
 #-------------------------------------------------------------------------------
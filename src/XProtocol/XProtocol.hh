@@ -268,7 +268,8 @@ enum XDirlistRequestOption {
    kXR_online = 1,
    kXR_dstat  = 2,
    kXR_dcksm  = 4,   // dcksm implies dstat irrespective of dstat setting
-   kXR_dstatx = 8    // Return extended information, if available
+   kXR_dstatx = 8,   // Return extended information, if available
+   kXR_drecurse = 16 // List the whole subtree; implies dstat
 };
 
 struct ClientDirlistRequest {
@@ -312,6 +312,7 @@ XrdConfig::XrdConfig()
    ProtInfo.totalCF  = &totalCF;
 
    XrdNetAddr::SetCache(3*60*60); // Cache address resolutions for 3 hours
+   XrdNetAddr::SetResolver(4);    // Resolve in 4 threads, coalesce lookups
 
    // This may reset the NPROC resource limit, which is done here as we
    // expect to be operating as a daemon. We set the argument limlower=true
@@ -1745,7 +1746,8 @@ int XrdConfig::xmaxfd(XrdSysError *eDest, XrdOucStream &Config)
                                          [kaparms parms] [cache <ct>] [[no]dnr]
                                          [routes <rtype> [use <ifn1>,<ifn2>]]
                                          [[no]rpipa] [[no]dyndns]
-                                         [udprefresh <sec>]
+                                         [udprefresh <sec>] [negcache <nct>]
+                                         [dnsthreads <n>] [dnswait <wt>]
 
              <rtype>: split | common | local
 
@@ -1754,7 +1756,13 @@ int XrdConfig::xmaxfd(XrdSysError *eDest, XrdOucStream &Config)
              kaparms   keepalive paramters as specified by parms.
              <blen>    is the socket's send/rcv buffer size.
              <ct>      Seconds to cache address to name resolutions.
+             <nct>     Seconds to cache failed address to name resolutions.
              [no]dnr   do [not] perform a reverse DNS lookup if not needed.
+             dnsthreads number of threads performing address to name
+                       resolutions, 0 performs them in-line.
+             dnswait   Seconds to wait for an address to name resolution.
+                       When 0, the numeric address is used while the name
+                       is being resolved and cached for later connections.
              routes    specifies the network configuration (see reference)
              [no]rpipa do [not] resolve private IP addresses.
              [no]dyndns This network does [not] use a dynamic DNS.
@@ -1769,6 +1777,7 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
     char *val;
     int  i, n, V_keep = -1, V_nodnr = 0, V_istls = 0, V_blen = -1, V_ct = -1;
     int   V_assumev4 = -1, v_rpip = -1, V_dyndns = -1, V_udpref = -1;
+    int   V_nct = -1, V_dnst = -1, V_dnsw = -1;
     long long llp;
     struct netopts {const char *opname; int hasarg; int opval;
                            int *oploc;  const char *etxt;}
@@ -1780,7 +1789,10 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
         {"kaparms",    4, 0, &V_keep,   "option"},
         {"buffsz",     1, 0, &V_blen,   "network buffsz"},
         {"cache",      2, 0, &V_ct,     "cache time"},
+        {"negcache",   2, 0, &V_nct,    "negcache time"},
         {"dnr",        0, 0, &V_nodnr,  "option"},
+        {"dnsthreads", 1, 0, &V_dnst,   "dnsthreads"},
+        {"dnswait",    2, 0, &V_dnsw,   "dnswait time"},
         {"nodnr",      0, 1, &V_nodnr,  "option"},
         {"dyndns",     0, 1, &V_dyndns, "option"},
         {"nodyndns",   0, 0, &V_dyndns, "option"},
@@ -1864,6 +1876,9 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
          XrdNetAddr::SetDynDNS(V_dyndns != 0);
         }
      if (V_ct >= 0) XrdNetAddr::SetCache(V_ct);
+     if (V_nct >= 0) XrdNetAddr::SetNegCache(V_nct);
+     if (V_dnst >= 0 || V_dnsw >= 0)
+        XrdNetAddr::SetResolver(V_dnst, (V_dnsw >= 0 ? V_dnsw*1000 : -1));
 
      if (v_rpip >= 0) XrdInet::netIF.SetRPIPA(v_rpip != 0);
      if (V_assumev4 >= 0) XrdInet::SetAssumeV4(true);
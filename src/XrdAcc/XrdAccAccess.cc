@@ -353,11 +353,37 @@ const char *XrdAccAccess::Resolve(const XrdSecEntity *Entity)
 #define XrdAccSWAP(x) oldtab.x = Atab.x;   Atab.x  =  newtab.x; \
                       newtab.x = oldtab.x; oldtab.x = 0;
 
+namespace
+{
+int CompileCaps(const char *key, XrdAccCapability *cap, void *arg)
+{
+   cap->Compile();
+   return 0;
+}
+}
+
 void XrdAccAccess::SwapTabs(struct XrdAccAccess_Tables &newtab)
 {
    struct XrdAccAccess_Tables oldtab;
    bool hRefX = false, hRefY = false;
 
+// Compile the capability lists into prefix indexes. This is done before the
+// tables are swapped in so that lookups never see a partially built index.
+// The anyuser list is always used with path substitution and is left as is.
+//
+   if (newtab.G_Hash) newtab.G_Hash->Apply(CompileCaps, 0);
+   if (newtab.H_Hash) newtab.H_Hash->Apply(CompileCaps, 0);
+   if (newtab.N_Hash) newtab.N_Hash->Apply(CompileCaps, 0);
+   if (newtab.O_Hash) newtab.O_Hash->Apply(CompileCaps, 0);
+   if (newtab.R_Hash) newtab.R_Hash->Apply(CompileCaps, 0);
+   if (newtab.U_Hash) newtab.U_Hash->Apply(CompileCaps, 0);
+   if (newtab.D_List) newtab.D_List->Compile();
+   if (newtab.Z_List) newtab.Z_List->Compile();
+   for (XrdAccAccess_ID *idP = newtab.SXList; idP; idP = idP->next)
+       if (idP->caps) idP->caps->Compile();
+   for (XrdAccAccess_ID *idP = newtab.SYList; idP; idP = idP->next)
+       if (idP->caps) idP->caps->Compile();
+
 // Determine if we need to resolve the host name early
 //
    XrdAccAccess_ID *xlP = newtab.SXList;
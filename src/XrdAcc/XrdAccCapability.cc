@@ -28,6 +28,10 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <climits>
+#include <string>
+#include <vector>
+
 #include "XrdAcc/XrdAccCapability.hh"
 
 /******************************************************************************/
@@ -36,6 +40,136 @@
   
 extern unsigned long XrdOucHashVal2(const char *KeyVal, int KeyLen);
 
+/******************************************************************************/
+/*                        X r d A c c C a p I n d e x                         */
+/******************************************************************************/
+
+// A compressed byte-wise prefix trie over the paths of a capability list. A
+// capability applies when its path is a prefix of the target path and the
+// first applicable capability in list order wins. Each node that ends a path
+// records the list position (rank) of the first capability with that path so
+// that a lookup is a single walk down the target path keeping the lowest rank
+// seen. Matching is on bytes, not path components, as that is what the list
+// walk does (e.g. "/data" applies to "/database").
+//
+class XrdAccCapIndex
+{
+public:
+
+int   Privs(XrdAccPrivCaps &pathpriv, const char *pathname, int pathlen) const;
+
+void  Insert(const char *pathval, int pathlen, int rank,
+             const XrdAccPrivCaps &privval);
+
+      XrdAccCapIndex() : nodes(1) {}
+     ~XrdAccCapIndex() {}
+
+private:
+
+struct Node
+      {std::string    label;   // Bytes on the edge leading to this node
+       int            rank;    // List position of capability ending here
+       XrdAccPrivCaps priv;
+       std::vector<std::pair<char,int> > kids; // Sorted by first label byte
+
+       Node() : rank(INT_MAX) {}
+      };
+
+int   Kid(int n, char c) const;
+
+std::vector<Node> nodes;       // nodes[0] is the root with an empty label
+};
+
+/******************************************************************************/
+  
+int XrdAccCapIndex::Kid(int n, char c) const
+{
+   const std::vector<std::pair<char,int> > &kids = nodes[n].kids;
+   int lo = 0, hi = (int)kids.size() - 1;
+
+   while(lo <= hi)
+        {int mid = (lo + hi) / 2;
+         if (kids[mid].first == c) return kids[mid].second;
+         if (kids[mid].first <  c) lo = mid + 1;
+            else hi = mid - 1;
+        }
+   return -1;
+}
+
+/******************************************************************************/
+
+void XrdAccCapIndex::Insert(const char *pathval, int pathlen, int rank,
+                            const XrdAccPrivCaps &privval)
+{
+   int n = 0, pos = 0, k;
+
+   while(pos < pathlen)
+        {if ((k = Kid(n, pathval[pos])) < 0)
+            {Node leaf;
+             leaf.label.assign(pathval+pos, pathlen-pos);
+             nodes.push_back(leaf);
+             k = nodes.size() - 1;
+             std::vector<std::pair<char,int> > &kids = nodes[n].kids;
+             auto it = kids.begin();
+             while(it != kids.end() && it->first < pathval[pos]) it++;
+             kids.insert(it, std::make_pair(pathval[pos], k));
+             n = k; pos = pathlen;
+             break;
+            }
+
+      // Find out how much of the edge label matches
+      //
+         const std::string &lbl = nodes[k].label;
+         int i = 0, llen = lbl.size();
+         while(i < llen && pos+i < pathlen && lbl[i] == pathval[pos+i]) i++;
+         if (i == llen) {n = k; pos += i; continue;}
+
+      // Split the edge; the new node takes over the leading matching bytes
+      //
+         Node mid;
+         mid.label = lbl.substr(0, i);
+         mid.kids.push_back(std::make_pair(lbl[i], k));
+         nodes[k].label.erase(0, i);
+         nodes.push_back(mid);
+         int m = nodes.size() - 1;
+         std::vector<std::pair<char,int> > &kids = nodes[n].kids;
+         for (auto &kid : kids) if (kid.second == k) {kid.second = m; break;}
+         n = m; pos += i;
+        }
+
+// Only the first capability with a particular path can ever apply
+//
+   if (rank < nodes[n].rank)
+      {nodes[n].rank = rank;
+       nodes[n].priv.pprivs = privval.pprivs;
+       nodes[n].priv.nprivs = privval.nprivs;
+      }
+}
+
+/******************************************************************************/
+
+int XrdAccCapIndex::Privs(XrdAccPrivCaps &pathpriv, const char *pathname,
+                          int pathlen) const
+{
+   const Node *best = 0;
+   int n = 0, pos = 0;
+
+   while(1)
+        {const Node &nd = nodes[n];
+         if (nd.rank != INT_MAX && (!best || nd.rank < best->rank)) best = &nd;
+         if (pos >= pathlen || (n = Kid(n, pathname[pos])) < 0) break;
+         const std::string &lbl = nodes[n].label;
+         if ((int)lbl.size() > pathlen - pos
+         ||  strncmp(pathname+pos, lbl.data(), lbl.size())) break;
+         pos += lbl.size();
+        }
+
+   if (!best) return 0;
+   pathpriv.pprivs = (XrdAccPrivs)(pathpriv.pprivs | best->priv.pprivs);
+   pathpriv.nprivs = (XrdAccPrivs)(pathpriv.nprivs | best->priv.nprivs);
+   return 1;
+}
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
@@ -46,7 +180,7 @@ XrdAccCapability::XrdAccCapability(char *pathval, XrdAccPrivCaps &privval)
 
 // Do common initialization
 //
-   next = 0; ctmp = 0;
+   next = 0; ctmp = 0; cidx = 0;
    priv.pprivs = privval.pprivs; priv.nprivs = privval.nprivs;
    plen = strlen(pathval); pins = 0; prem = 0;
    pkey = XrdOucHashVal2((const char *)pathval, plen);
@@ -71,10 +205,41 @@ XrdAccCapability::~XrdAccCapability()
      XrdAccCapability *cp, *np = next;
 
      if (path) {free(path); path = 0;}
+     if (cidx) {delete cidx; cidx = 0;}
 
      while(np) {cp = np; np = np->next; cp->next = 0; delete cp;}
      next = 0;
 }
+/******************************************************************************/
+/*                               C o m p i l e                                */
+/******************************************************************************/
+
+void XrdAccCapability::Compile()
+{
+   static const int minCaps = 8; // Shorter lists are faster to walk
+   XrdAccCapIndex *newidx = new XrdAccCapIndex;
+   int rank = 0;
+
+// Build the index, if worth having. Templates are expanded at their position.
+//
+   Flatten(*newidx, rank);
+   if (rank < minCaps) {delete newidx; newidx = 0;}
+
+   if (cidx) delete cidx;
+   cidx = newidx;
+}
+
+/******************************************************************************/
+
+void XrdAccCapability::Flatten(XrdAccCapIndex &index, int &rank)
+{
+   XrdAccCapability *cp = this;
+
+   do {if (cp->ctmp) cp->ctmp->Flatten(index, rank);
+          else index.Insert(cp->path, cp->plen, rank++, cp->priv);
+      } while ((cp = cp->next));
+}
+
 /******************************************************************************/
 /*                                 P r i v s                                  */
 /******************************************************************************/
@@ -87,6 +252,10 @@ int XrdAccCapability::Privs(      XrdAccPrivCaps &pathpriv,
 {XrdAccCapability *cp=this;
  const int psl = (pathsub ? strlen(pathsub) : 0);
 
+// Use the compiled index when there is no substitution to be made
+//
+ if (cidx && !pathsub) return cidx->Privs(pathpriv, pathname, pathlen);
+
  do {if (cp->ctmp)
        {if (cp->ctmp->Privs(pathpriv,pathname,pathlen,pathhash,pathsub))
            return 1;
@@ -153,6 +322,19 @@ XrdAccCapName::~XrdAccCapName()
    while(np) {cp = np; np = np->next; cp->next = 0; delete cp;}
 }
   
+/******************************************************************************/
+/*                               C o m p i l e                                */
+/******************************************************************************/
+
+void XrdAccCapName::Compile()
+{
+   XrdAccCapName *ncp = this;
+
+   do {if (ncp->C_List) ncp->C_List->Compile();
+       ncp = ncp->next;
+      } while(ncp);
+}
+
 /******************************************************************************/
 /*                                  F i n d                                   */
 /******************************************************************************/
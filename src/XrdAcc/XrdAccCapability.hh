@@ -39,12 +39,21 @@
 /******************************************************************************/
 /*                      X r d A c c C a p a b i l i t y                       */
 /******************************************************************************/
+
+class XrdAccCapIndex;
   
 class XrdAccCapability
 {
 public:
 void                Add(XrdAccCapability *newcap) {next = newcap;}
 
+// Compile() builds a prefix index over this capability list, with any
+// templates expanded in place, so that Privs() need not walk the list when no
+// substitution is requested. It must only be called on the head of a list
+// before the list is made visible to other threads.
+//
+void                Compile();
+
 XrdAccCapability   *Next() {return next;}
 
 // Privs() searches the associated capability for a prefix matching path. If one
@@ -79,14 +88,17 @@ int                 Subcomp(const char *pathname, const int pathlen,
                   XrdAccCapability(char *pathval, XrdAccPrivCaps &privval);
 
                   XrdAccCapability(XrdAccCapability *taddr)
-                        {next = 0; ctmp = taddr;
+                        {next = 0; ctmp = taddr; cidx = 0;
                          pkey = 0; path = 0; plen = 0; pins = 0; prem = 0;
                         }
 
                  ~XrdAccCapability();
 private:
+void              Flatten(XrdAccCapIndex &cidx, int &rank);
+
 XrdAccCapability *next;      // -> Next capability
 XrdAccCapability *ctmp;      // -> Capability template
+XrdAccCapIndex   *cidx;      // -> Compiled prefix index (list head only)
 
 /*----------- The below fields are valid when template is zero -----------*/
 
@@ -109,6 +121,8 @@ void              Add(XrdAccCapName *cnp) {next = cnp;}
 
 XrdAccCapability *Find(const char *name);
 
+void              Compile();
+
        XrdAccCapName(char *name, XrdAccCapability *cap)
                     {next = 0; CapName = strdup(name); CNlen = strlen(name);
                      C_List = cap;
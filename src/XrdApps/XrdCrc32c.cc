@@ -29,6 +29,8 @@
 /******************************************************************************/
 
 #include <iostream>
+#include <chrono>
+#include <vector>
 
 #include <fcntl.h>
 #include <cstdio>
@@ -40,6 +42,7 @@
 #include <sys/uio.h>
 
 #include "XrdOuc/XrdOucCRC.hh"
+#include "XrdOuc/XrdOucCRC32C.hh"
 #include "XrdSys/XrdSysE2T.hh"
 
 
@@ -64,6 +67,50 @@ void Fatal(const char *op, const char *target)
    exit(3);
 }
   
+/******************************************************************************/
+/*                                 B e n c h                                  */
+/******************************************************************************/
+
+// Measure the per-core page checksum rate for pgread sized buffers using the
+// page at a time loop and the multi-page kernel used by XrdOucCRC::Calc32C().
+//
+int Bench()
+{
+   static const size_t maxSZ = 8*1024*1024, pgSZ = XrdSys::PageSize;
+   static const size_t totBytes = (size_t)4*1024*1024*1024;
+   std::vector<uint32_t> csVec(maxSZ/pgSZ);
+   char *buffP;
+   int rc;
+
+   if ((rc = posix_memalign((void **)&buffP, pgSZ, maxSZ)))
+      {errno = rc; Fatal("allocate buffer for", "benchmark");}
+   for (size_t i = 0; i < maxSZ; i++) buffP[i] = (char)(i*2654435761U >> 24);
+
+   std::cout <<"bufsz  per-page GB/s  multi-page GB/s" <<std::endl;
+   for (size_t bSZ = 1024*1024; bSZ <= maxSZ; bSZ *= 2)
+       {size_t nPages = bSZ/pgSZ, nIter = totBytes/bSZ;
+        double gbs[2];
+        for (int k = 0; k < 2; k++)
+            {auto tBeg = std::chrono::steady_clock::now();
+             for (size_t n = 0; n < nIter; n++)
+                 {if (k) XrdOucCRC::Calc32C(buffP, bSZ, csVec.data());
+                     else for (size_t i = 0; i < nPages; i++)
+                              csVec[i] = crc32c(0, buffP+i*pgSZ, pgSZ);
+                 }
+             std::chrono::duration<double> tDiff =
+                      std::chrono::steady_clock::now() - tBeg;
+             gbs[k] = double(totBytes) / tDiff.count() / 1.0e9;
+            }
+        char oBuff[80];
+        snprintf(oBuff, sizeof(oBuff), "%2zuMB   %13.2f  %15.2f",
+                 bSZ/(1024*1024), gbs[0], gbs[1]);
+        std::cout <<oBuff <<std::endl;
+       }
+
+   free(buffP);
+   return 0;
+}
+
 /******************************************************************************/
 /*                                 U s a g e                                  */
 /******************************************************************************/
@@ -74,7 +121,8 @@ void Usage(int rc)
           "\n<path> the path to the file whose checksum if to be computed."
           "\n-      compute checksum from data presented at standard in;"
           "\n       example: xrdcp <url> - | xrdcrc32c -\n"
-          "\nopts: -d -h -n -s -x\n"
+          "\nopts: -b -d -h -n -s -x\n"
+          "\n-b benchmark page checksumming of 1MB to 8MB buffers (arguments ignored)."
           "\n-d read data directly into the buffer, do not use the file cache."
           "\n-h display usage information (arguments ignored)."
           "\n-n do not end output with a newline character."
@@ -103,9 +151,11 @@ int main(int argc, char *argv[])
 //
    opterr = 0;
    if (argc > 1 && '-' == *argv[1]) 
-      while ((c = getopt(argc,argv,"dhnsx")) && ((unsigned char)c != 0xff))
+      while ((c = getopt(argc,argv,"bdhnsx")) && ((unsigned char)c != 0xff))
      { switch(c)
        {
+       case 'b': return Bench();
+                 break;
        case 'd': opts |= O_DIRECT;
                  break;
        case 'h': Usage(0);
@@ -1,4 +1,5 @@
 #include "XrdCks/XrdCksCalccrc32C.hh"
+#include "XrdOuc/XrdOucCRC32C.hh"
 
 /*
     C++ implementation of CRC-32C checksums based upon
@@ -22,6 +23,32 @@ void XrdCksCalccrc32C::Update(const char *Buff, int BLen)
     C32CResult = (unsigned int)XrdOucCRC::Calc32C(Buff, BLen, C32CResult);
 }
 
+static inline uint32_t getCS(const char *Cksum)
+{
+    uint32_t cs;
+    memcpy(&cs, Cksum, sizeof(cs));
+#ifndef Xrd_Big_Endian
+    cs = ntohl(cs);
+#endif
+    return cs;
+}
+
+const char *XrdCksCalccrc32C::Combine(const char *Cksum, int DLen)
+{
+    C32CResult = crc32c_combine(C32CResult, getCS(Cksum), DLen);
+    return Final();
+}
+
+const char *XrdCksCalccrc32C::Combine(const char *Cksum1, const char *Cksum2,
+                                      int DLen)
+{
+    TheResult = crc32c_combine(getCS(Cksum1), getCS(Cksum2), DLen);
+#ifndef Xrd_Big_Endian
+    TheResult = htonl(TheResult);
+#endif
+    return (const char *)&TheResult;
+}
+
 const char *XrdCksCalccrc32C::Type(int &csSz)
 {
     csSz = sizeof(TheResult);
@@ -42,6 +42,10 @@
 class XrdCksCalccrc32C : public XrdCksCalc
 {
 public:
+    bool Combinable() {return true;}
+    const char *Combine(const char *Cksum, int DLen);
+    const char *Combine(const char *Cksum1, const char *Cksum2, int DLen);
+
     char *Final();
     
     void Init();
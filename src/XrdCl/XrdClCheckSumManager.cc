@@ -21,6 +21,7 @@
 #include "XrdCl/XrdClUtils.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClParallelCheckSum.hh"
 #include "XrdCks/XrdCksCalc.hh"
 #include "XrdCks/XrdCksLoader.hh"
 #include "XrdCks/XrdCksCalc.hh"
@@ -129,12 +130,66 @@ namespace XrdCl
       return false;
     }
 
+    const uint32_t  buffSize   = 2*1024*1024;
+    int64_t         bytesRead  = 0;
+
+    //--------------------------------------------------------------------------
+    // If the checksums of the blocks can be combined, the blocks are
+    // checksummed by the worker threads while we read ahead
+    //--------------------------------------------------------------------------
+    uint32_t threads = ParallelCheckSum::GetNbThreads();
+    std::unique_ptr<ParallelCheckSum> cks;
+    if( calc->Combinable() && threads )
+    {
+      cks.reset( new ParallelCheckSum( { algName } ) );
+      XRootDStatus st = cks->Initialize();
+      if( !st.IsOK() )
+      {
+        log->Debug( UtilityMsg, "Unable to compute %s in parallel, computing "
+                    "it inline: %s", algName.c_str(), st.ToString().c_str() );
+        cks.reset();
+      }
+    }
+
+    if( cks )
+    {
+      XrdSysSemaphore slots( 2 * threads );
+      bool            ok     = true;
+      uint64_t        offset = 0;
+
+      while( true )
+      {
+        slots.Wait();
+        char *buffer = new char[buffSize];
+        bytesRead = read( fd, buffer, buffSize );
+        if( bytesRead <= 0 )
+        {
+          if( bytesRead == -1 )
+          {
+            log->Error( UtilityMsg, "Unable read from %s: %s", filePath.c_str(),
+                        XrdSysE2T( errno ) );
+            ok = false;
+          }
+          delete [] buffer;
+          break;
+        }
+        cks->Update( offset, buffer, bytesRead,
+                     [buffer, &slots]{ delete [] buffer; slots.Post(); } );
+        offset += bytesRead;
+      }
+
+      //------------------------------------------------------------------------
+      // The workers are done with the buffers before the slots go away
+      //------------------------------------------------------------------------
+      cks->Wait();
+      close( fd );
+      return ok && cks->GetCheckSum( algName, result ).IsOK();
+    }
+
     //--------------------------------------------------------------------------
     // Calculate the checksum
     //--------------------------------------------------------------------------
-    const uint32_t  buffSize   = 2*1024*1024;
     char           *buffer     = new char[buffSize];
-    int64_t         bytesRead  = 0;
 
     while( (bytesRead = read( fd, buffer, buffSize )) )
     {
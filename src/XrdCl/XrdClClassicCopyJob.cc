@@ -24,6 +24,7 @@
 
 #include "XrdCl/XrdClClassicCopyJob.hh"
 #include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClCopyPacer.hh"
 #include "XrdCl/XrdClLog.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClFile.hh"
@@ -39,6 +40,7 @@
 #include "XrdCl/XrdClXRootDTransport.hh"
 #include "XrdClXCpCtx.hh"
 #include "XrdCl/XrdClCheckSumHelper.hh"
+#include "XrdCl/XrdClParallelCheckSum.hh"
 #include "XrdSys/XrdSysE2T.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
@@ -55,6 +57,10 @@
 #include <fcntl.h>
 #include <cerrno>
 #include <unistd.h>
+#include <sys/ioctl.h>
+#if defined(__linux__)
+#include <linux/fs.h>
+#endif
 
 #if __cplusplus < 201103L
 #include <ctime>
@@ -215,6 +221,23 @@ namespace
         return XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errNotImplemented );
       }
 
+      //------------------------------------------------------------------------
+      //! Get the parameters of the read pipeline (empty if not adaptive)
+      //------------------------------------------------------------------------
+      virtual std::string GetPipeline()
+      {
+        return std::string();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the file being read if the data may be copied without passing
+      //! through the chunks (null otherwise)
+      //------------------------------------------------------------------------
+      virtual XrdCl::File* GetFile()
+      {
+        return 0;
+      }
+
     protected:
 
       XrdCl::CheckSumHelper               *pCkSumHelper;
@@ -286,6 +309,38 @@ namespace
       //------------------------------------------------------------------------
       virtual int64_t GetSize() = 0;
 
+      //------------------------------------------------------------------------
+      //! Get the parameters of the write pipeline (empty if not adaptive)
+      //------------------------------------------------------------------------
+      virtual std::string GetPipeline()
+      {
+        return std::string();
+      }
+
+      //------------------------------------------------------------------------
+      //! Copy a range of the source without the data passing through us
+      //!
+      //! @param  srcFile the open source file
+      //! @param  srcUrl  url of the source
+      //! @param  offset  offset of the range, the same in both files
+      //! @param  length  length of the range
+      //! @param  copied  number of bytes copied, possibly less than requested
+      //! @param  method  how the data were copied
+      //! @return status of the operation, errNotSupported if it cannot be
+      //!         done for the given pair of files
+      //------------------------------------------------------------------------
+      virtual XrdCl::XRootDStatus CopyFrom( XrdCl::File       *srcFile,
+                                            const XrdCl::URL  &srcUrl,
+                                            uint64_t           offset,
+                                            uint64_t           length,
+                                            uint64_t          &copied,
+                                            std::string       &method )
+      {
+        (void)srcFile; (void)srcUrl; (void)offset; (void)length; (void)method;
+        copied = 0;
+        return XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errNotSupported );
+      }
+
       //------------------------------------------------------------------------
       //! Set POSC
       //------------------------------------------------------------------------
@@ -584,9 +639,9 @@ namespace
         Source( ckSumType, addcks ),
         pUrl( url ), pFile( new XrdCl::File() ), pSize( -1 ),
         pCurrentOffset( 0 ), pChunkSize( chunkSize ),
-        pParallel( parallelChunks ),
+        pParallel( parallelChunks ), pQueued( 0 ),
         pNbConn( 0 ), pUsePgRead( false ),
-        pDoServer( doserver )
+        pDoServer( doserver ), pReported( 0 )
       {
         int val = XrdCl::DefaultSubStreamsPerChannel;
         XrdCl::DefaultEnv::GetEnv()->GetInt( "SubStreamsPerChannel", val );
@@ -643,6 +698,9 @@ namespace
             st = cksHelper->Initialize();
             if( !st.IsOK() ) return st;
           }
+
+          st = SetUpCheckSum();
+          if( !st.IsOK() ) return st;
         }
 
         //----------------------------------------------------------------------
@@ -680,6 +738,7 @@ namespace
           delete ipstack;
         }
 
+        SetUpPacer();
         SetOnDataConnectHandler( pFile );
 
         return XRootDStatus();
@@ -698,6 +757,13 @@ namespace
       //------------------------------------------------------------------------
       virtual XrdCl::XRootDStatus StartAt( uint64_t offset )
       {
+        //----------------------------------------------------------------------
+        // A new data connection might have made us read ahead from where we
+        // were before
+        //----------------------------------------------------------------------
+        std::unique_lock<std::mutex> lck( pDataConnCB->mtx );
+        CleanUpChunks();
+        pCks.reset();
         pCurrentOffset = offset;
         pContinue      = true;
         return XrdCl::XRootDStatus();
@@ -737,6 +803,23 @@ namespace
           delete [] (char *)ch->chunk.GetBuffer();
           delete ch;
         }
+        pQueued = 0;
+      }
+
+      //------------------------------------------------------------------------
+      // Get the parameters of the read pipeline
+      //------------------------------------------------------------------------
+      virtual std::string GetPipeline()
+      {
+        return pPacer ? pPacer->ToString() : std::string();
+      }
+
+      //------------------------------------------------------------------------
+      // Get the file being read
+      //------------------------------------------------------------------------
+      virtual XrdCl::File* GetFile()
+      {
+        return pFile;
       }
 
       //------------------------------------------------------------------------
@@ -766,6 +849,9 @@ namespace
             // in case of --continue option we have to calculate the checksum from scratch
             return XrdCl::Utils::GetLocalCheckSum( checkSum, checkSumType, pUrl->GetPath() );
 
+          if( cksHelper && InParallel( cksHelper ) )
+            return pCks->GetCheckSum( checkSumType, checkSum );
+
           if( cksHelper )
             return cksHelper->GetCheckSum( checkSum, checkSumType );
 
@@ -816,21 +902,38 @@ namespace
         }
         if( pNbConn ) parallel *= pNbConn;
 
-        while( pChunks.size() < parallel && pCurrentOffset < pSize )
+        while( pCurrentOffset < pSize )
         {
+          //--------------------------------------------------------------------
+          // The adaptive pipeline is limited by the bytes in flight, yet keeps
+          // at least one chunk per connected stream
+          //--------------------------------------------------------------------
           uint64_t chunkSize = pChunkSize;
+          if( pPacer )
+          {
+            chunkSize = pPacer->GetChunkSize();
+            uint64_t inflight = std::max<uint64_t>( pPacer->GetInFlight(),
+                                                    chunkSize * pNbConn );
+            if( !pChunks.empty() && pQueued + chunkSize > inflight ) break;
+          }
+          else if( pChunks.size() >= parallel ) break;
+
           if( pCurrentOffset + chunkSize > (uint64_t)pSize )
             chunkSize = pSize - pCurrentOffset;
 
           char *buffer = new char[chunkSize];
-          ChunkHandler *ch = new ChunkHandler();
+          ChunkHandler *ch = new ChunkHandler( pPacer.get(), pCks.get(),
+                                               chunkSize );
           auto st = pUsePgRead
                      ? reader->PgRead( pCurrentOffset, chunkSize, buffer, ch )
                      : reader->Read( pCurrentOffset, chunkSize, buffer, ch );
           pChunks.push( ch );
+          pQueued        += chunkSize;
           pCurrentOffset += chunkSize;
           if( !st.IsOK() )
           {
+            if( pPacer )
+              pPacer->OnDelivered( ch->sample, 0, XrdCl::CopyPacer::Now() );
             ch->status = st;
             ch->sem->Post();
             break;
@@ -838,6 +941,68 @@ namespace
         }
       }
 
+      //------------------------------------------------------------------------
+      // Size the pipeline adaptively when reading from a remote server
+      //------------------------------------------------------------------------
+      void SetUpPacer()
+      {
+        if( pUrl->IsLocalFile() && !pUrl->IsMetalink() ) return;
+
+        int adaptive    = XrdCl::DefaultCpAdaptive;
+        int maxInFlight = XrdCl::DefaultCpMaxInFlight;
+        XrdCl::DefaultEnv::GetEnv()->GetInt( "CpAdaptive",    adaptive );
+        XrdCl::DefaultEnv::GetEnv()->GetInt( "CpMaxInFlight", maxInFlight );
+        if( adaptive != 1 || maxInFlight <= 0 ) return;
+
+        pPacer.reset( new XrdCl::CopyPacer( pChunkSize, pParallel, maxInFlight ) );
+      }
+
+      //------------------------------------------------------------------------
+      // Checksum the chunks of a local file on the worker threads as they
+      // come in, the types that cannot be combined are updated in order as
+      // the chunks are handed over to the destination
+      //------------------------------------------------------------------------
+      XrdCl::XRootDStatus SetUpCheckSum()
+      {
+        using namespace XrdCl;
+        std::vector<std::string> types;
+        if( pCkSumHelper && ParallelCheckSum::IsSupported( pCkSumHelper->GetType() ) )
+          types.push_back( pCkSumHelper->GetType() );
+        for( auto cksHelper : pAddCksHelpers )
+          if( ParallelCheckSum::IsSupported( cksHelper->GetType() ) )
+            types.push_back( cksHelper->GetType() );
+        if( types.empty() ) return XRootDStatus();
+
+        pCks.reset( new ParallelCheckSum( types ) );
+        return pCks->Initialize();
+      }
+
+      //------------------------------------------------------------------------
+      // Check whether the checksum is computed by the worker threads
+      //------------------------------------------------------------------------
+      bool InParallel( XrdCl::CheckSumHelper *cksHelper )
+      {
+        return pCks && pCks->Has( cksHelper->GetType() );
+      }
+
+      //------------------------------------------------------------------------
+      // Log the parameters of the pipeline whenever they change, though not
+      // more often than once per second
+      //------------------------------------------------------------------------
+      void ReportPipeline()
+      {
+        time_t now = time( 0 );
+        if( now == pReported ) return;
+        std::string pipeline = pPacer->ToString();
+        std::string params   = pipeline.substr( 0, pipeline.find( " (" ) );
+        if( params == pReportedParams ) return;
+        pReported       = now;
+        pReportedParams = params;
+        XrdCl::DefaultEnv::GetLog()->Info( XrdCl::UtilityMsg, "Read pipeline "
+                                           "for %s: %s", pUrl->GetObfuscatedURL().c_str(),
+                                           pipeline.c_str() );
+      }
+
       //------------------------------------------------------------------------
       // Set the on-connect handler for data streams
       //------------------------------------------------------------------------
@@ -885,6 +1050,8 @@ namespace
 
         std::unique_ptr<ChunkHandler> ch( pChunks.front() );
         pChunks.pop();
+        pQueued -= ch->size;
+        if( pPacer ) ReportPipeline();
         lck.unlock();
 
         ch->sem->Wait();
@@ -903,11 +1070,12 @@ namespace
         // if it is a local file update the checksum
         if( pUrl->IsLocalFile() && !pUrl->IsMetalink() && !pContinue )
         {
-          if( pCkSumHelper )
+          if( pCkSumHelper && !InParallel( pCkSumHelper ) )
             pCkSumHelper->Update( ci.GetBuffer(), ci.GetLength() );
 
           for( auto cksHelper : pAddCksHelpers )
-            cksHelper->Update( ci.GetBuffer(), ci.GetLength() );
+            if( !InParallel( cksHelper ) )
+              cksHelper->Update( ci.GetBuffer(), ci.GetLength() );
         }
 
         return XRootDStatus( stOK, suContinue );
@@ -919,7 +1087,12 @@ namespace
       class ChunkHandler: public XrdCl::ResponseHandler
       {
         public:
-          ChunkHandler(): sem( new XrdSysSemaphore(0) ) {}
+          ChunkHandler( XrdCl::CopyPacer *pacer, XrdCl::ParallelCheckSum *cks,
+                        uint32_t size ):
+            sem( new XrdSysSemaphore(0) ), pacer( pacer ), cks( cks ), size( size )
+          {
+            if( pacer ) sample = pacer->OnSend( XrdCl::CopyPacer::Now() );
+          }
           virtual ~ChunkHandler() { delete sem; }
           virtual void HandleResponse( XrdCl::XRootDStatus *statusval,
                                        XrdCl::AnyObject    *response )
@@ -931,6 +1104,19 @@ namespace
               chunk = ToChunk( response );
               delete response;
             }
+            if( pacer )
+              pacer->OnDelivered( sample, status.IsOK() ? chunk.GetLength() : 0,
+                                  XrdCl::CopyPacer::Now() );
+            //------------------------------------------------------------------
+            // The chunk is handed over once it has been checksummed
+            //------------------------------------------------------------------
+            if( cks && status.IsOK() )
+            {
+              XrdSysSemaphore *done = sem;
+              cks->Update( chunk.GetOffset(), chunk.GetBuffer(), chunk.GetLength(),
+                           [done]{ done->Post(); } );
+              return;
+            }
             sem->Post();
           }
 
@@ -951,9 +1137,13 @@ namespace
             }
           }
 
-        XrdSysSemaphore     *sem;
-        XrdCl::PageInfo      chunk;
-        XrdCl::XRootDStatus  status;
+        XrdSysSemaphore         *sem;
+        XrdCl::PageInfo          chunk;
+        XrdCl::XRootDStatus      status;
+        XrdCl::CopyPacer        *pacer;
+        XrdCl::CopyPacer::Sample sample;
+        XrdCl::ParallelCheckSum *cks;
+        uint32_t                 size;
       };
 
       const XrdCl::URL          *pUrl;
@@ -963,12 +1153,19 @@ namespace
       uint32_t                   pChunkSize;
       uint16_t                   pParallel;
       std::queue<ChunkHandler*>  pChunks;
+      uint64_t                   pQueued;
       std::string                pDataServer;
       uint16_t                   pNbConn;
       uint16_t                   pMaxNbConn;
       bool                       pUsePgRead;
       bool                       pDoServer;
 
+      std::unique_ptr<XrdCl::CopyPacer> pPacer;
+      time_t                            pReported;
+      std::string                       pReportedParams;
+
+      std::unique_ptr<XrdCl::ParallelCheckSum> pCks;
+
       std::shared_ptr<CancellableJob> pDataConnCB;
   };
 
@@ -1061,6 +1258,7 @@ namespace
           pUsePgRead = XrdCl::Utils::HasPgRW( pDataServer ) && ( val == 1 );
         }
 
+        SetUpPacer();
         SetOnDataConnectHandler( pZipArchive );
 
         return XrdCl::XRootDStatus();
@@ -1080,6 +1278,14 @@ namespace
         return GetChunkImpl( pZipArchive, ci );
       }
 
+      //------------------------------------------------------------------------
+      //! The data have to be extracted from the archive
+      //------------------------------------------------------------------------
+      virtual XrdCl::File* GetFile()
+      {
+        return 0;
+      }
+
       //------------------------------------------------------------------------
       // Get check sum
       //------------------------------------------------------------------------
@@ -1699,11 +1905,13 @@ namespace
       //------------------------------------------------------------------------
       //! Constructor
       //------------------------------------------------------------------------
-      XRootDDestination( const XrdCl::URL &url, uint8_t parallelChunks,
-                         const std::string &ckSumType, const XrdCl::ClassicCopyJob &cpjob ):
+      XRootDDestination( const XrdCl::URL &url, uint32_t chunkSize,
+                         uint8_t parallelChunks, const std::string &ckSumType,
+                         const XrdCl::ClassicCopyJob &cpjob ):
         Destination( ckSumType ),
         pUrl( url ), pFile( new XrdCl::File( XrdCl::File::DisableVirtRedirect ) ),
-        pParallel( parallelChunks ), pSize( -1 ), pUsePgWrt( false ), cpjob( cpjob )
+        pChunkSize( chunkSize ), pParallel( parallelChunks ), pQueued( 0 ),
+        pSize( -1 ), pNoReflink( false ), pUsePgWrt( false ), cpjob( cpjob )
       {
       }
 
@@ -1815,8 +2023,31 @@ namespace
         pSize = info->GetSize();
         delete info;
 
+        //----------------------------------------------------------------------
+        // Size the pipeline adaptively when writing to a remote server, the
+        // chunk size is up to the source
+        //----------------------------------------------------------------------
+        int adaptive    = DefaultCpAdaptive;
+        int maxInFlight = DefaultCpMaxInFlight;
+        DefaultEnv::GetEnv()->GetInt( "CpAdaptive",    adaptive );
+        DefaultEnv::GetEnv()->GetInt( "CpMaxInFlight", maxInFlight );
+        if( ( !pUrl.IsLocalFile() || pUrl.IsMetalink() ) &&
+            adaptive == 1 && maxInFlight > 0 )
+          pPacer.reset( new CopyPacer( pChunkSize, pParallel, maxInFlight ) );
+
         if( pUrl.IsLocalFile() && pCkSumHelper && !pContinue )
+        {
+          //--------------------------------------------------------------------
+          // Checksum the chunks on the worker threads as they get written
+          //--------------------------------------------------------------------
+          std::string type = pCkSumHelper->GetType();
+          if( ParallelCheckSum::IsSupported( type ) )
+          {
+            pCks.reset( new ParallelCheckSum( { type } ) );
+            return pCks->Initialize();
+          }
           return pCkSumHelper->Initialize();
+        }
 
         return XRootDStatus();
       }
@@ -1847,7 +2078,9 @@ namespace
         //----------------------------------------------------------------------
         // If there is still place for this chunk to be sent send it
         //----------------------------------------------------------------------
-        if( pChunks.size() < pParallel )
+        if( pPacer ? pChunks.empty() ||
+                     pQueued + ci.GetLength() <= pPacer->GetInFlight()
+                   : pChunks.size() < pParallel )
           return QueueChunk( std::move( ci ) );
 
         //----------------------------------------------------------------------
@@ -1856,6 +2089,7 @@ namespace
         //----------------------------------------------------------------------
         std::unique_ptr<ChunkHandler> ch( pChunks.front() );
         pChunks.pop();
+        pQueued -= ch->chunk.GetLength();
         ch->sem->Wait();
         delete [] (char*)ch->chunk.GetBuffer();
         if( !ch->status.IsOK() )
@@ -1898,6 +2132,63 @@ namespace
           delete [] (char *)ch->chunk.GetBuffer();
           delete ch;
         }
+        pQueued = 0;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the parameters of the write pipeline
+      //------------------------------------------------------------------------
+      virtual std::string GetPipeline()
+      {
+        if( !pPacer ) return std::string();
+        //----------------------------------------------------------------------
+        // We do not choose the chunk size, so just tell how many bytes we
+        // keep in flight
+        //----------------------------------------------------------------------
+        std::string pipeline = pPacer->ToString();
+        return XrdCl::Utils::BytesToString( pPacer->GetInFlight() ) + "B in flight" +
+               pipeline.substr( pipeline.find( " in flight" ) + 10 );
+      }
+
+      //------------------------------------------------------------------------
+      //! Copy a range of the source without the data passing through us:
+      //! local files are cloned or copied by the kernel, files at the same
+      //! server are cloned by the server
+      //------------------------------------------------------------------------
+      virtual XrdCl::XRootDStatus CopyFrom( XrdCl::File       *srcFile,
+                                            const XrdCl::URL  &srcUrl,
+                                            uint64_t           offset,
+                                            uint64_t           length,
+                                            uint64_t          &copied,
+                                            std::string       &method )
+      {
+        using namespace XrdCl;
+        copied = 0;
+        if( !pFile->IsOpen() || pUrl.IsMetalink() || srcUrl.IsMetalink() )
+          return XRootDStatus( stError, errNotSupported );
+
+        if( pUrl.IsLocalFile() && srcUrl.IsLocalFile() )
+          return LocalCopy( srcUrl.GetPath(), offset, length, copied, method );
+
+        if( pUrl.IsLocalFile() || srcUrl.IsLocalFile() || !srcFile )
+          return XRootDStatus( stError, errNotSupported );
+
+        //----------------------------------------------------------------------
+        // Only a server that has both files open can clone one into the other
+        //----------------------------------------------------------------------
+        std::string srcServer, dstServer;
+        srcFile->GetProperty( "DataServer", srcServer );
+        pFile->GetProperty( "DataServer", dstServer );
+        if( srcServer.empty() || srcServer != dstServer )
+          return XRootDStatus( stError, errNotSupported );
+
+        CloneLocations locs;
+        locs.Add( *srcFile, offset, offset, length );
+        XRootDStatus st = pFile->Clone( locs );
+        if( !st.IsOK() ) return st;
+        copied = length;
+        method = "clone";
+        return st;
       }
 
       //------------------------------------------------------------------------
@@ -1907,22 +2198,26 @@ namespace
       {
         // we are writing chunks in order so we can calc the checksum
         // in case of local files
-        if( pUrl.IsLocalFile() && pCkSumHelper && !pContinue )
+        if( pUrl.IsLocalFile() && pCkSumHelper && !pContinue && !pCks )
           pCkSumHelper->Update( ci.GetBuffer(), ci.GetLength() );
 
-        ChunkHandler *ch = new ChunkHandler( std::move( ci ) );
+        ChunkHandler *ch = new ChunkHandler( std::move( ci ), pPacer.get(),
+                                             pContinue ? 0 : pCks.get() );
         XrdCl::XRootDStatus st;
         st = pUsePgWrt
            ? pFile->PgWrite(ch->chunk.GetOffset(), ch->chunk.GetLength(), ch->chunk.GetBuffer(), ch->chunk.GetCksums(), ch)
            : pFile->Write( ch->chunk.GetOffset(), ch->chunk.GetLength(), ch->chunk.GetBuffer(), ch );
         if( !st.IsOK() )
         {
+          if( pPacer )
+            pPacer->OnDelivered( ch->sample, 0, XrdCl::CopyPacer::Now() );
           CleanUpChunks();
           delete [] (char*)ch->chunk.GetBuffer();
           delete ch;
           return st;
         }
         pChunks.push( ch );
+        pQueued += ch->chunk.GetLength();
         return XrdCl::XRootDStatus();
       }
 
@@ -1932,6 +2227,7 @@ namespace
       virtual XrdCl::XRootDStatus Flush()
       {
         XrdCl::XRootDStatus st;
+        pQueued = 0;
         while( !pChunks.empty() )
         {
           ChunkHandler *ch = pChunks.front();
@@ -1963,6 +2259,9 @@ namespace
             // in case of --continue option we have to calculate the checksum from scratch
             return XrdCl::Utils::GetLocalCheckSum( checkSum, checkSumType, pUrl.GetPath() );
 
+          if( pCks )
+            return pCks->GetCheckSum( checkSumType, checkSum );
+
           if( pCkSumHelper )
             return pCkSumHelper->GetCheckSum( checkSum, checkSumType );
 
@@ -2008,21 +2307,41 @@ namespace
       class ChunkHandler: public XrdCl::ResponseHandler
       {
         public:
-          ChunkHandler( XrdCl::PageInfo &&ci ):
+          ChunkHandler( XrdCl::PageInfo &&ci, XrdCl::CopyPacer *pacer,
+                        XrdCl::ParallelCheckSum *cks ):
             sem( new XrdSysSemaphore(0) ),
-            chunk(std::move( ci ) ) {}
+            chunk(std::move( ci ) ), pacer( pacer ), cks( cks )
+          {
+            if( pacer ) sample = pacer->OnSend( XrdCl::CopyPacer::Now() );
+          }
           virtual ~ChunkHandler() { delete sem; }
           virtual void HandleResponse( XrdCl::XRootDStatus *statusval,
                                        XrdCl::AnyObject    */*response*/ )
           {
             this->status = *statusval;
             delete statusval;
+            if( pacer )
+              pacer->OnDelivered( sample, status.IsOK() ? chunk.GetLength() : 0,
+                                  XrdCl::CopyPacer::Now() );
+            //------------------------------------------------------------------
+            // The buffer is released once it has been checksummed
+            //------------------------------------------------------------------
+            if( cks && status.IsOK() )
+            {
+              XrdSysSemaphore *done = sem;
+              cks->Update( chunk.GetOffset(), chunk.GetBuffer(), chunk.GetLength(),
+                           [done]{ done->Post(); } );
+              return;
+            }
             sem->Post();
           }
 
-          XrdSysSemaphore        *sem;
-          XrdCl::PageInfo         chunk;
-          XrdCl::XRootDStatus     status;
+          XrdSysSemaphore         *sem;
+          XrdCl::PageInfo          chunk;
+          XrdCl::XRootDStatus      status;
+          XrdCl::CopyPacer        *pacer;
+          XrdCl::CopyPacer::Sample sample;
+          XrdCl::ParallelCheckSum *cks;
       };
 
       inline XrdCl::XRootDStatus CheckIfRetriable( XrdCl::XRootDStatus &status )
@@ -2044,11 +2363,80 @@ namespace
         return status;
       }
 
+      //------------------------------------------------------------------------
+      // Copy a range between two local files, sharing the extents if the
+      // file system allows for it and letting the kernel copy them otherwise
+      //------------------------------------------------------------------------
+      XrdCl::XRootDStatus LocalCopy( const std::string &srcPath,
+                                     uint64_t           offset,
+                                     uint64_t           length,
+                                     uint64_t          &copied,
+                                     std::string       &method )
+      {
+        using namespace XrdCl;
+        int srcFd = open( srcPath.c_str(), O_RDONLY );
+        if( srcFd < 0 )
+          return XRootDStatus( stError, errLocalError, errno );
+        int dstFd = open( pUrl.GetPath().c_str(), O_WRONLY );
+        if( dstFd < 0 )
+        {
+          int err = errno;
+          close( srcFd );
+          return XRootDStatus( stError, errLocalError, err );
+        }
+
+        int err = ENOTSUP;
+#ifdef FICLONERANGE
+        if( !pNoReflink )
+        {
+          struct file_clone_range range;
+          range.src_fd      = srcFd;
+          range.src_offset  = offset;
+          range.src_length  = length;
+          range.dest_offset = offset;
+          if( ioctl( dstFd, FICLONERANGE, &range ) == 0 )
+          {
+            copied = length;
+            method = "reflink";
+            err    = 0;
+          }
+          else pNoReflink = true;
+        }
+#endif
+#ifdef HAVE_COPY_FILE_RANGE
+        if( !copied )
+        {
+          loff_t srcOff = offset, dstOff = offset;
+          err = 0;
+          while( copied < length )
+          {
+            ssize_t n = copy_file_range( srcFd, &srcOff, dstFd, &dstOff,
+                                         length - copied, 0 );
+            if( n < 0 && errno == EINTR ) continue;
+            if( n < 0 ) { err = errno; break; }
+            if( n == 0 ) break; // the source has shrunk
+            copied += n;
+          }
+          if( copied ) method = "copy_file_range";
+        }
+#endif
+        close( srcFd );
+        if( close( dstFd ) && !err ) err = errno;
+        if( err && !copied )
+          return XRootDStatus( stError, errLocalError, err );
+        return XRootDStatus();
+      }
+
       const XrdCl::URL             pUrl;
       XrdCl::File                 *pFile;
+      uint32_t                     pChunkSize;
       uint8_t                      pParallel;
       std::queue<ChunkHandler *>   pChunks;
+      uint64_t                     pQueued;
       int64_t                      pSize;
+      std::unique_ptr<XrdCl::CopyPacer> pPacer;
+      std::unique_ptr<XrdCl::ParallelCheckSum> pCks;
+      bool                         pNoReflink;
 
       std::string                  pWrtRecoveryRedir;
       std::string                  pLastURL;
@@ -2562,7 +2950,7 @@ namespace XrdCl
         newDestUrl.SetParams( params );
  //     makeDir = true; // Backward compatibility for xroot destinations!!!
       }
-      dest.reset( new XRootDDestination( newDestUrl, parallelChunks, checkSumType, *this ) );
+      dest.reset( new XRootDDestination( newDestUrl, chunkSize, parallelChunks, checkSumType, *this ) );
     }
 
     dest->SetForce( force );
@@ -2593,6 +2981,59 @@ namespace XrdCl
     uint16_t  threshold_interval = parallelChunks;
     bool      threshold_draining = false;
     timer_nsec_t threshold_timer;
+
+    //--------------------------------------------------------------------------
+    // Local files and files at the same server may be copied without the
+    // data passing through us. The range is copied in pieces so that the
+    // progress can be reported, and whatever is left if it fails is copied
+    // chunk by chunk as usual.
+    //--------------------------------------------------------------------------
+    int zeroCopy = DefaultCpZeroCopy;
+    DefaultEnv::GetEnv()->GetInt( "CpZeroCopy", zeroCopy );
+    if( zeroCopy == 1 && src->GetFile() && !continue_ && !xRate &&
+        !xRateThreshold && addcksums.empty() && size > 0 )
+    {
+      const uint64_t piece = 268435456; // 256MB
+      std::string    method;
+      while( total_processed < size )
+      {
+        uint64_t copied = 0;
+        st = dest->CopyFrom( src->GetFile(), GetSource(), total_processed,
+                             std::min( size - total_processed, piece ),
+                             copied, method );
+        total_processed += copied;
+        if( !st.IsOK() || !copied ) break;
+
+        if( cptimer && cptimer->elapsed() > cpTimeout ) // check the CP timeout
+          return SetResult( stError, errOperationExpired, 0, "CPTimeout exceeded." );
+
+        if( progress )
+        {
+          progress->JobProgress( pJobId, total_processed, size );
+          if( progress->ShouldCancel( pJobId ) )
+            return SetResult( stError, errOperationInterrupted, kXR_Cancelled, "The copy-job has been cancelled!" );
+        }
+      }
+
+      if( !st.IsOK() )
+        log->Debug( UtilityMsg, "Could not copy %s without reading it: %s",
+                    GetSource().GetObfuscatedURL().c_str(), st.ToString().c_str() );
+
+      if( total_processed )
+      {
+        log->Info( UtilityMsg, "Copied %llu bytes using %s",
+                   (unsigned long long) total_processed, method.c_str() );
+        pResults->Set( "zeroCopy", method );
+        //----------------------------------------------------------------------
+        // The rest, if anything, is read as if we were continuing, which also
+        // makes the local checksums to be computed from the files
+        //----------------------------------------------------------------------
+        st = src->StartAt( total_processed );
+        if( !st.IsOK() ) return SetResult( st );
+        dest->SetContinue( true );
+      }
+    }
+
     while( 1 )
     {
       st = src->GetChunk( pageInfo );
@@ -2709,6 +3150,22 @@ namespace XrdCl
     }
     pResults->Set( "size", total_processed );
 
+    //--------------------------------------------------------------------------
+    // Report how the pipelines were sized in the end
+    //--------------------------------------------------------------------------
+    std::string pipeline = src->GetPipeline();
+    if( !pipeline.empty() )
+    {
+      log->Info( UtilityMsg, "Read pipeline: %s", pipeline.c_str() );
+      pResults->Set( "readPipeline", pipeline );
+    }
+    pipeline = dest->GetPipeline();
+    if( !pipeline.empty() )
+    {
+      log->Info( UtilityMsg, "Write pipeline: %s", pipeline.c_str() );
+      pResults->Set( "writePipeline", pipeline );
+    }
+
     //--------------------------------------------------------------------------
     // Finalize the destination
     //--------------------------------------------------------------------------
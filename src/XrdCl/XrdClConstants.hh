@@ -90,12 +90,17 @@ namespace XrdCl
   const int DefaultNoTlsOK                 = 0;
   const int DefaultTlsNoData               = 0;
   const int DefaultTlsMetalink             = 0;
+  const int DefaultTlsSessionReuse         = 0;
   const int DefaultZipMtlnCksum            = 0;
   const int DefaultIPNoShuffle             = 0;
   const int DefaultWantTlsOnNoPgrw         = 0;
   const int DefaultRetryWrtAtLBLimit       = 3;
   const int DefaultCpRetry                 = 0;
   const int DefaultCpUsePgWrtRd            = 1;
+  const int DefaultCpAdaptive              = 0;
+  const int DefaultCpMaxInFlight           = 268435456;
+  const int DefaultCpZeroCopy              = 1;
+  const int DefaultCpCksThreads            = 4;
 
   const char * const DefaultPollerPreference   = "built-in";
   const char * const DefaultNetworkStack       = "IPAuto";
@@ -158,10 +163,15 @@ namespace XrdCl
       { to_lower( "NoTlsOK" ),                 DefaultNoTlsOK },
       { to_lower( "TlsNoData" ),               DefaultTlsNoData },
       { to_lower( "TlsMetalink" ),             DefaultTlsMetalink },
+      { to_lower( "TlsSessionReuse" ),         DefaultTlsSessionReuse },
       { to_lower( "ZipMtlnCksum" ),            DefaultZipMtlnCksum },
       { to_lower( "IPNoShuffle" ),             DefaultIPNoShuffle },
       { to_lower( "WantTlsOnNoPgrw" ),         DefaultWantTlsOnNoPgrw },
-      { to_lower( "RetryWrtAtLBLimit" ),       DefaultRetryWrtAtLBLimit }
+      { to_lower( "RetryWrtAtLBLimit" ),       DefaultRetryWrtAtLBLimit },
+      { to_lower( "CpAdaptive" ),              DefaultCpAdaptive },
+      { to_lower( "CpMaxInFlight" ),           DefaultCpMaxInFlight },
+      { to_lower( "CpZeroCopy" ),              DefaultCpZeroCopy },
+      { to_lower( "CpCksThreads" ),            DefaultCpCksThreads }
     };
 
   static std::unordered_map<std::string, std::string> theDefaultStrs
@@ -52,7 +52,7 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
     //--------------------------------------------------------------------------
     ProgressDisplay(): pPrevious(0), pPrintProgressBar(true),
       pPrintSourceCheckSum(false), pPrintTargetCheckSum(false),
-      pPrintAdditionalCheckSum(false)
+      pPrintAdditionalCheckSum(false), pPrintPipeline(false)
     {}
 
     //--------------------------------------------------------------------------
@@ -139,6 +139,15 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
           PrintCheckSum( d.source, cks, size );
       }
 
+      if( pPrintPipeline )
+      {
+        std::string pipeline;
+        if( results->Get( "readPipeline", pipeline ) )
+          std::cerr << "Read pipeline: " << pipeline << std::endl;
+        if( results->Get( "writePipeline", pipeline ) )
+          std::cerr << "Write pipeline: " << pipeline << std::endl;
+      }
+
       pOngoingJobs.erase(it);
     }
 
@@ -282,6 +291,7 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
     void PrintSourceCheckSum( bool print ) { pPrintSourceCheckSum = print; }
     void PrintTargetCheckSum( bool print ) { pPrintTargetCheckSum = print; }
     void PrintAdditionalCheckSum( bool print ) { pPrintAdditionalCheckSum = print; }
+    void PrintPipeline( bool print )       { pPrintPipeline       = print; }
 
   private:
     struct JobData
@@ -300,6 +310,7 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
     bool                        pPrintSourceCheckSum;
     bool                        pPrintTargetCheckSum;
     bool                        pPrintAdditionalCheckSum;
+    bool                        pPrintPipeline;
     std::map<uint32_t, JobData> pOngoingJobs;
     XrdSysRecMutex              pMutex;
 };
@@ -497,6 +508,8 @@ int main( int argc, char **argv )
   ProgressDisplay progress;
   if( config.Want(XrdCpConfig::DoNoPbar) || !isatty( fileno( stdout ) ) )
     progress.PrintProgressBar( false );
+  if( config.Want( XrdCpConfig::DoVerbose ) )
+    progress.PrintPipeline( true );
 
   bool         posc          = false;
   bool         force         = false;
@@ -0,0 +1,225 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClCopyPacer.hh"
+#include "XrdCl/XrdClUtils.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  CopyPacer::CopyPacer( uint32_t maxChunkSize, uint32_t initChunks,
+                        uint64_t maxInFlight ):
+    pMaxChunkSize( std::max<uint32_t>( maxChunkSize, 1 ) ),
+    pMinChunkSize( std::min( MinChunkSize, pMaxChunkSize ) ),
+    pMaxInFlight( std::max<uint64_t>( maxInFlight, pMinChunkSize ) ),
+    pDelivered( 0 ), pDeliveredTime( 0 ), pFirstDelivery( 0 ),
+    pPending( 0 ), pFilled( false ), pMinRtt( 0 ), pMinRttStamp( 0 ),
+    pProbeStart( 0 ), pProbeUntil( 0 ), pProbed( false ),
+    pChunkSize( pMinChunkSize )
+  {
+    //--------------------------------------------------------------------------
+    // Until we know better as much is in flight as with a fixed pipeline, but
+    // in small chunks so that the first answer tells the round trip time
+    //--------------------------------------------------------------------------
+    pInitInFlight = uint64_t( std::max<uint32_t>( initChunks, 1 ) ) * pMaxChunkSize;
+    pInitInFlight = std::min( pInitInFlight, pMaxInFlight );
+    pInFlight     = pInitInFlight;
+  }
+
+  //----------------------------------------------------------------------------
+  // Note that a request has been issued
+  //----------------------------------------------------------------------------
+  CopyPacer::Sample CopyPacer::OnSend( uint64_t now )
+  {
+    std::unique_lock<std::mutex> lck( pMutex );
+    Sample s;
+    s.sent      = now;
+    s.delivered = pDelivered;
+    //--------------------------------------------------------------------------
+    // If nothing is in flight the link has been idle and the delivery rate
+    // has to be measured from now on
+    //--------------------------------------------------------------------------
+    s.deliveredTime = pPending ? pDeliveredTime : now;
+    ++pPending;
+    return s;
+  }
+
+  //----------------------------------------------------------------------------
+  // Note that a request has been answered
+  //----------------------------------------------------------------------------
+  void CopyPacer::OnDelivered( const Sample &sample, uint32_t bytes,
+                               uint64_t now )
+  {
+    std::unique_lock<std::mutex> lck( pMutex );
+    if( pPending ) --pPending;
+    if( !bytes ) return; // failed requests tell us nothing
+
+    pDelivered     += bytes;
+    pDeliveredTime  = now;
+    if( !pFirstDelivery ) pFirstDelivery = now;
+    //--------------------------------------------------------------------------
+    // Once a request issued after the first answer came back we have seen a
+    // full round trip and may also shrink the pipeline
+    //--------------------------------------------------------------------------
+    else if( sample.sent >= pFirstDelivery ) pFilled = true;
+
+    //--------------------------------------------------------------------------
+    // The delivery rate is measured over at least the latency of the request
+    // so that a burst of answers does not overestimate it
+    //--------------------------------------------------------------------------
+    uint64_t rtt      = std::max<uint64_t>( now - sample.sent, 1 );
+    uint64_t interval = std::max<uint64_t>( now - sample.deliveredTime, rtt );
+    double   bw       = double( pDelivered - sample.delivered ) * 1e6 / interval;
+
+    while( !pBwSamples.empty() && pBwSamples.back().second <= bw )
+      pBwSamples.pop_back();
+    pBwSamples.emplace_back( now, bw );
+    while( pBwSamples.front().first + BwWindow < now )
+      pBwSamples.pop_front();
+
+    //--------------------------------------------------------------------------
+    // If the minimum has not been seen for a while the pipeline is drained
+    // in order to take a fresh measurement. Whatever is issued while probing
+    // goes out on its own.
+    //--------------------------------------------------------------------------
+    bool expired = pMinRtt && now > pMinRttStamp + RttWindow;
+    if( !pMinRtt || rtt <= pMinRtt || expired )
+    {
+      pMinRtt      = rtt;
+      pMinRttStamp = now;
+    }
+    if( pProbeUntil )
+    {
+      if( sample.sent >= pProbeStart ) pProbed = true;
+      if( pProbed && now >= pProbeUntil ) pProbeUntil = 0;
+    }
+    else if( expired )
+    {
+      pProbeStart = now;
+      pProbeUntil = now + ProbeTime;
+      pProbed     = false;
+    }
+
+    Update();
+  }
+
+  //----------------------------------------------------------------------------
+  // Recompute the chunk size and the bytes in flight
+  //----------------------------------------------------------------------------
+  void CopyPacer::Update()
+  {
+    if( pProbeUntil )
+    {
+      pChunkSize = pMinChunkSize;
+      pInFlight  = pMinChunkSize;
+      return;
+    }
+
+    double   bdp    = pBwSamples.front().second * pMinRtt / 1e6;
+    uint64_t target = uint64_t( 2 * bdp );
+
+    uint64_t chunk = pMinChunkSize;
+    while( chunk < pMaxChunkSize && chunk * ChunksPerBdp < target )
+      chunk *= 2;
+    chunk = std::min<uint64_t>( chunk, pMaxChunkSize );
+
+    uint64_t inflight = std::max( target, 2 * chunk );
+    if( !pFilled ) inflight = std::max( inflight, pInitInFlight );
+    inflight = std::min( inflight, pMaxInFlight );
+
+    pChunkSize = std::min( chunk, inflight );
+    pInFlight  = inflight;
+  }
+
+  //----------------------------------------------------------------------------
+  // Size of the next chunk to be requested
+  //----------------------------------------------------------------------------
+  uint32_t CopyPacer::GetChunkSize() const
+  {
+    std::unique_lock<std::mutex> lck( pMutex );
+    return pChunkSize;
+  }
+
+  //----------------------------------------------------------------------------
+  // Number of bytes that should be in flight
+  //----------------------------------------------------------------------------
+  uint64_t CopyPacer::GetInFlight() const
+  {
+    std::unique_lock<std::mutex> lck( pMutex );
+    return pInFlight;
+  }
+
+  //----------------------------------------------------------------------------
+  // Estimated bottleneck bandwidth
+  //----------------------------------------------------------------------------
+  double CopyPacer::GetBandwidth() const
+  {
+    std::unique_lock<std::mutex> lck( pMutex );
+    return pBwSamples.empty() ? 0 : pBwSamples.front().second;
+  }
+
+  //----------------------------------------------------------------------------
+  // Estimated round trip time
+  //----------------------------------------------------------------------------
+  double CopyPacer::GetMinRtt() const
+  {
+    std::unique_lock<std::mutex> lck( pMutex );
+    return pMinRtt / 1e6;
+  }
+
+  //----------------------------------------------------------------------------
+  // Human readable summary of the current parameters
+  //----------------------------------------------------------------------------
+  std::string CopyPacer::ToString() const
+  {
+    uint32_t chunk    = GetChunkSize();
+    uint64_t inflight = GetInFlight();
+    std::ostringstream o;
+    o << "chunk " << Utils::BytesToString( chunk ) << "B x ";
+    o << ( inflight + chunk - 1 ) / chunk << " in flight";
+    double bw = GetBandwidth();
+    if( bw > 0 )
+    {
+      o << " (" << Utils::BytesToString( uint64_t( bw ) ) << "B/s, rtt ";
+      o << std::fixed << std::setprecision( 1 ) << GetMinRtt() * 1e3 << "ms)";
+    }
+    return o.str();
+  }
+
+  //----------------------------------------------------------------------------
+  // Current time in microseconds of the monotonic clock
+  //----------------------------------------------------------------------------
+  uint64_t CopyPacer::Now()
+  {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(
+             steady_clock::now().time_since_epoch() ).count();
+  }
+}
@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_COPY_PACER_HH__
+#define __XRD_CL_COPY_PACER_HH__
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Sizes the request pipeline of a classic copy job from what it observes
+  //! on the wire, along the lines of BBR: it keeps a windowed maximum of the
+  //! delivery rate and a windowed minimum of the request latency and aims at
+  //! having twice their product (the bandwidth-delay product) in flight. The
+  //! chunk size follows so that this is covered by a handful of requests,
+  //! which keeps chunks small on a LAN and large on long fat links.
+  //!
+  //! A full pipeline queues up at the bottleneck, so that the latency seen
+  //! later on is mostly of our own making. Hence, the transfer starts with
+  //! small chunks and, if no lower latency has been seen for a while, the
+  //! pipeline is drained to a single small chunk until a fresh measurement
+  //! has been taken.
+  //!
+  //! All the times are in microseconds of a monotonic clock, so that the
+  //! controller can be driven by a simulated link as well.
+  //----------------------------------------------------------------------------
+  class CopyPacer
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! State of the pipeline at the time a request was issued
+      //------------------------------------------------------------------------
+      struct Sample
+      {
+        Sample(): sent( 0 ), delivered( 0 ), deliveredTime( 0 ) {}
+        uint64_t sent;           //!< when the request was issued
+        uint64_t delivered;      //!< bytes delivered until then
+        uint64_t deliveredTime;  //!< when those were delivered
+      };
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param maxChunkSize : the largest chunk to be requested
+      //! @param initChunks   : number of chunks in flight until the first
+      //!                       measurement is available
+      //! @param maxInFlight  : upper bound of the bytes in flight
+      //------------------------------------------------------------------------
+      CopyPacer( uint32_t maxChunkSize, uint32_t initChunks,
+                 uint64_t maxInFlight );
+
+      //------------------------------------------------------------------------
+      //! Note that a request has been issued
+      //------------------------------------------------------------------------
+      Sample OnSend( uint64_t now );
+
+      //------------------------------------------------------------------------
+      //! Note that a request issued at the time of the sample was answered
+      //! with given number of bytes
+      //------------------------------------------------------------------------
+      void OnDelivered( const Sample &sample, uint32_t bytes, uint64_t now );
+
+      //------------------------------------------------------------------------
+      //! Size of the next chunk to be requested
+      //------------------------------------------------------------------------
+      uint32_t GetChunkSize() const;
+
+      //------------------------------------------------------------------------
+      //! Number of bytes that should be in flight
+      //------------------------------------------------------------------------
+      uint64_t GetInFlight() const;
+
+      //------------------------------------------------------------------------
+      //! Estimated bottleneck bandwidth in bytes per second (0 if unknown)
+      //------------------------------------------------------------------------
+      double GetBandwidth() const;
+
+      //------------------------------------------------------------------------
+      //! Estimated round trip time in seconds (0 if unknown)
+      //------------------------------------------------------------------------
+      double GetMinRtt() const;
+
+      //------------------------------------------------------------------------
+      //! Human readable summary of the current parameters
+      //------------------------------------------------------------------------
+      std::string ToString() const;
+
+      //------------------------------------------------------------------------
+      //! Current time in microseconds of the monotonic clock
+      //------------------------------------------------------------------------
+      static uint64_t Now();
+
+      //------------------------------------------------------------------------
+      //! Smallest chunk the pacer is going to choose
+      //------------------------------------------------------------------------
+      static constexpr uint32_t MinChunkSize = 524288;
+
+    private:
+      void Update();
+
+      static constexpr uint64_t BwWindow  = 2000000;   //!< 2s
+      static constexpr uint64_t RttWindow = 10000000;  //!< 10s
+      static constexpr uint64_t ProbeTime = 200000;    //!< 0.2s
+      static constexpr uint32_t ChunksPerBdp = 4;
+
+      mutable std::mutex                          pMutex;
+      const uint32_t                              pMaxChunkSize;
+      const uint32_t                              pMinChunkSize;
+      const uint64_t                              pMaxInFlight;
+      uint64_t                                    pDelivered;
+      uint64_t                                    pDeliveredTime;
+      uint64_t                                    pFirstDelivery;
+      uint32_t                                    pPending;
+      bool                                        pFilled;
+      std::deque<std::pair<uint64_t, double>>     pBwSamples;   // decreasing
+      uint64_t                                    pMinRtt;
+      uint64_t                                    pMinRttStamp;
+      uint64_t                                    pProbeStart;
+      uint64_t                                    pProbeUntil;
+      bool                                        pProbed;
+      uint32_t                                    pChunkSize;
+      uint64_t                                    pInFlight;
+      uint64_t                                    pInitInFlight;
+  };
+}
+
+#endif // __XRD_CL_COPY_PACER_HH__
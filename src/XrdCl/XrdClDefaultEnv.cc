@@ -299,6 +299,7 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "NoTlsOK",                 DefaultNoTlsOK                 );
     REGISTER_VAR_INT( varsInt, "TlsNoData",               DefaultTlsNoData               );
     REGISTER_VAR_INT( varsInt, "TlsMetalink",             DefaultTlsMetalink             );
+    REGISTER_VAR_INT( varsInt, "TlsSessionReuse",         DefaultTlsSessionReuse         );
     REGISTER_VAR_INT( varsInt, "ZipMtlnCksum",            DefaultZipMtlnCksum            );
     REGISTER_VAR_INT( varsInt, "IPNoShuffle",             DefaultIPNoShuffle             );
     REGISTER_VAR_INT( varsInt, "WantTlsOnNoPgrw",         DefaultWantTlsOnNoPgrw         );
@@ -306,6 +307,10 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "XRateThreshold",          DefaultXRateThreshold          );
     REGISTER_VAR_INT( varsInt, "CpRetry",                 DefaultCpRetry                 );
     REGISTER_VAR_INT( varsInt, "CpUsePgWrtRd",            DefaultCpUsePgWrtRd            );
+    REGISTER_VAR_INT( varsInt, "CpAdaptive",              DefaultCpAdaptive              );
+    REGISTER_VAR_INT( varsInt, "CpMaxInFlight",           DefaultCpMaxInFlight           );
+    REGISTER_VAR_INT( varsInt, "CpZeroCopy",              DefaultCpZeroCopy              );
+    REGISTER_VAR_INT( varsInt, "CpCksThreads",            DefaultCpCksThreads            );
 
     REGISTER_VAR_STR( varsStr, "ClientMonitor",           DefaultClientMonitor           );
     REGISTER_VAR_STR( varsStr, "ClientMonitorParam",      DefaultClientMonitorParam      );
@@ -508,7 +508,8 @@ namespace
                              finalst( 0 ), pending( 1 ),
                              dirList( new XrdCl::DirectoryList() ), expires( expires ),
                              handler( handler ), flags( flags ),
-                             fs( new XrdCl::FileSystem( url ) )
+                             fs( new XrdCl::FileSystem( url ) ),
+                             checked( false ), serverSide( false )
       {
         dirList->SetParentName( path );
       }
@@ -544,6 +545,8 @@ namespace
       XrdCl::DirListFlags::Flags  flags;
       XrdCl::FileSystem          *fs;
       XrdSysMutex                 mtx;
+      bool                        checked;    // first response has been seen
+      bool                        serverSide; // server lists the whole tree
   };
 
   //----------------------------------------------------------------------------
@@ -596,10 +599,24 @@ namespace
 
           std::string parent = pCtx->dirList->GetParentName();
 
+          //--------------------------------------------------------------------
+          // A server that walks the tree itself starts the listing with a "./"
+          // entry, the names that follow are relative to the top directory.
+          // Otherwise, we have to list each subdirectory ourselves.
+          //--------------------------------------------------------------------
+          if( !pCtx->checked )
+          {
+            pCtx->checked    = true;
+            pCtx->serverSide = dirList->GetSize() &&
+                               dirList->At( 0 )->GetName() == "./";
+          }
+
           DirectoryList::Iterator itr;
           for( itr = dirList->Begin(); itr != dirList->End(); ++itr )
           {
             DirectoryList::ListEntry *entry = *itr;
+            if( pCtx->serverSide && entry->GetName() == "./" )
+              continue;
             StatInfo *info = entry->GetStatInfo();
             if( !info )
             {
@@ -612,14 +629,18 @@ namespace
             std::string path = dirList->GetParentName() + entry->GetName();
 
             // add new entry to the result
-            path = path.substr( parent.size() );
+            if( pCtx->serverSide )
+              path = entry->GetName();
+            else
+              path = path.substr( parent.size() );
             entry->SetStatInfo( 0 ); // StatInfo is no longer owned by dirList
             DirectoryList::ListEntry *e =
                 new DirectoryList::ListEntry( entry->GetHostAddress(), path, info );
             pCtx->dirList->Add( e );
 
-            // if it's a directory do a recursive call
-            if( info->TestFlags( StatInfo::IsDir ) )
+            // if it's a directory do a recursive call unless the server
+            // already takes care of it
+            if( !pCtx->serverSide && info->TestFlags( StatInfo::IsDir ) )
             {
               // bump the pending counter
               ++pCtx->pending;
@@ -1701,6 +1722,13 @@ namespace XrdCl
     if( ( flags & DirListFlags::Cksm ) )
       req->options[0] = kXR_dstat | kXR_dcksm;
 
+    //--------------------------------------------------------------------------
+    // Ask the server to walk the tree, servers that cannot do so ignore the
+    // option and the recursive handler falls back to listing each directory
+    //--------------------------------------------------------------------------
+    if( flags & DirListFlags::Recursive )
+      req->options[0] |= kXR_drecurse;
+
     if( flags & DirListFlags::Recursive )
       handler = new RecursiveDirListHandler( *pImpl->fsdata->pUrl, url.GetPath(), flags, handler, timeout );
 
@@ -1891,6 +1919,46 @@ namespace XrdCl
     return XRootDStatus();
   }
 
+  //----------------------------------------------------------------------------
+  // List entries of a directory in batches - sync
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::DirListStream( const std::string   &path,
+                                          DirListFlags::Flags  flags,
+                                          DirListCallback      callback,
+                                          time_t               timeout )
+  {
+    if( flags & ( DirListFlags::Locate | DirListFlags::Merge |
+                  DirListFlags::Zip ) )
+      return XRootDStatus( stError, errNotSupported );
+
+    //--------------------------------------------------------------------------
+    // Each batch is handed over as it arrives and released when the callback
+    // returns, the final response carries the overall status
+    //--------------------------------------------------------------------------
+    XrdSysSemaphore sem( 0 );
+    XRootDStatus    result;
+    auto handler = ResponseHandler::Wrap(
+        [&sem, &result, &callback]( XRootDStatus &st, AnyObject &rsp )
+        {
+          DirectoryList *batch = 0;
+          rsp.Get( batch );
+          if( batch ) callback( *batch );
+          if( st.IsOK() && st.code == suContinue ) return;
+          result = st;
+          sem.Post();
+        } );
+
+    XRootDStatus st = DirList( path, flags | DirListFlags::Chunked, handler,
+                               timeout );
+    if( !st.IsOK() )
+    {
+      delete handler;
+      return st;
+    }
+    sem.Wait();
+    return result;
+  }
+
   //----------------------------------------------------------------------------
   // Send cache info to the server - async
   //----------------------------------------------------------------------------
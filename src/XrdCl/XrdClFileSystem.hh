@@ -32,6 +32,7 @@
 #include "XrdCl/XrdClXRootDResponses.hh"
 #include "XrdSys/XrdSysPthread.hh"
 #include "XProtocol/XProtocol.hh"
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -164,7 +165,8 @@ namespace XrdCl
       Stat      = 1,  //!< Stat each entry
       Locate    = 2,  //!< Locate all servers hosting the directory and send
                       //!< the dirlist request to all of them
-      Recursive = 4,  //!< Do a recursive listing
+      Recursive = 4,  //!< Do a recursive listing, done by the server when
+                      //!< it supports it
       Merge     = 8,  //!< Merge duplicates
       Chunked   = 16, //!< Serve chunked results for better performance
       Zip       = 32, //!< List content of ZIP files
@@ -646,6 +648,35 @@ namespace XrdCl
                             time_t                timeout = 0 )
                             XRD_WARN_UNUSED_RESULT;
 
+      //------------------------------------------------------------------------
+      //! Callback receiving a batch of directory entries
+      //------------------------------------------------------------------------
+      typedef std::function<void( DirectoryList &batch )> DirListCallback;
+
+      //------------------------------------------------------------------------
+      //! List entries of a directory handing them to the caller in batches as
+      //! they arrive instead of collecting the whole listing first - sync.
+      //! This is the way to list large trees with Recursive as memory use
+      //! does not depend on the size of the listing.
+      //!
+      //! @param path     directory path
+      //! @param flags    DirListFlags, Chunked is implied and Locate, Merge
+      //!                 and Zip are not supported
+      //! @param callback called for each batch of entries, it is called from
+      //!                 a client thread and one batch at a time. Entry names
+      //!                 are relative to path. The batch is deleted when the
+      //!                 callback returns.
+      //! @param timeout  timeout value, if 0 the environment default will
+      //!                 be used
+      //! @return         status of the operation, suPartial when part of a
+      //!                 recursive listing could not be obtained
+      //------------------------------------------------------------------------
+      XRootDStatus DirListStream( const std::string   &path,
+                                  DirListFlags::Flags  flags,
+                                  DirListCallback      callback,
+                                  time_t               timeout = 0 )
+                                  XRD_WARN_UNUSED_RESULT;
+
       //------------------------------------------------------------------------
       //! Send cache into the server - async
       //!
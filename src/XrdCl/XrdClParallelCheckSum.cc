@@ -0,0 +1,331 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClParallelCheckSum.hh"
+#include "XrdCl/XrdClCheckSumManager.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClJobManager.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClUtils.hh"
+#include "XrdCks/XrdCksCalc.hh"
+#include "XrdCks/XrdCksData.hh"
+
+#include <algorithm>
+#include <memory>
+
+#include <unistd.h>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // The workers are shared by all the checksums of the process. They are
+  // started on first use, and again in the child after a fork.
+  //----------------------------------------------------------------------------
+  std::mutex         poolMutex;
+  XrdCl::JobManager *pool    = 0;
+  pid_t              poolPid = 0;
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // A block to be checksummed
+  //----------------------------------------------------------------------------
+  struct ParallelCheckSum::Block
+  {
+    uint64_t               offset;
+    const char            *buffer;
+    uint32_t               size;
+    std::function<void()>  done;
+  };
+
+  //----------------------------------------------------------------------------
+  // Job checksumming a block on one of the workers
+  //----------------------------------------------------------------------------
+  class ParallelCheckSum::BlockJob: public Job
+  {
+    public:
+      BlockJob( ParallelCheckSum *self, Block *block ):
+        self( self ), block( block )
+      {
+      }
+
+      virtual void Run( void* )
+      {
+        self->Process( block );
+        delete this;
+      }
+
+    private:
+      ParallelCheckSum *self;
+      Block            *block;
+  };
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  ParallelCheckSum::ParallelCheckSum( const std::vector<std::string> &types ):
+    pOutstanding( 0 ), pCombinedUpTo( 0 )
+  {
+    for( auto &type : types )
+      if( std::find( pTypes.begin(), pTypes.end(), type ) == pTypes.end() )
+        pTypes.push_back( type );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  ParallelCheckSum::~ParallelCheckSum()
+  {
+    Wait();
+    for( auto calc : pCalcs )
+      delete calc;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the calculators for all the types
+  //----------------------------------------------------------------------------
+  XRootDStatus ParallelCheckSum::Initialize()
+  {
+    Log             *log    = DefaultEnv::GetLog();
+    CheckSumManager *cksMan = DefaultEnv::GetCheckSumManager();
+
+    if( !cksMan )
+    {
+      log->Error( UtilityMsg, "Unable to get the checksum manager" );
+      return XRootDStatus( stError, errInternal );
+    }
+
+    for( auto &type : pTypes )
+    {
+      XrdCksCalc *calc = cksMan->GetCalculator( type );
+      if( !calc )
+      {
+        log->Error( UtilityMsg, "Unable to get a calculator for %s",
+                    type.c_str() );
+        return XRootDStatus( stError, errCheckSumError );
+      }
+      pCalcs.push_back( calc );
+      if( !calc->Combinable() )
+        return XRootDStatus( stError, errNotSupported, 0,
+                             "Checksums cannot be combined" );
+    }
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Check whether the checksums of given type can be computed in parallel
+  //----------------------------------------------------------------------------
+  bool ParallelCheckSum::IsSupported( const std::string &type )
+  {
+    CheckSumManager *cksMan = DefaultEnv::GetCheckSumManager();
+    if( !cksMan ) return false;
+    std::unique_ptr<XrdCksCalc> calc( cksMan->GetCalculator( type ) );
+    return calc && calc->Combinable();
+  }
+
+  //----------------------------------------------------------------------------
+  // Check whether given type is being computed
+  //----------------------------------------------------------------------------
+  bool ParallelCheckSum::Has( const std::string &type ) const
+  {
+    return std::find( pTypes.begin(), pTypes.end(), type ) != pTypes.end();
+  }
+
+  //----------------------------------------------------------------------------
+  // Checksum a block of data
+  //----------------------------------------------------------------------------
+  void ParallelCheckSum::Update( uint64_t offset, const void *buffer,
+                                 uint32_t size, std::function<void()> done )
+  {
+    if( !size || pCalcs.size() != pTypes.size() )
+    {
+      if( done ) done();
+      return;
+    }
+
+    Block *block = new Block{ offset, (const char*)buffer, size,
+                              std::move( done ) };
+    {
+      std::unique_lock<std::mutex> lck( pMutex );
+      ++pOutstanding;
+    }
+
+    JobManager *workers = GetPool();
+    if( workers )
+      workers->QueueJob( new BlockJob( this, block ) );
+    else
+      Process( block );
+  }
+
+  //----------------------------------------------------------------------------
+  // Checksum a block and combine it with its neighbours
+  //----------------------------------------------------------------------------
+  void ParallelCheckSum::Process( Block *block )
+  {
+    //--------------------------------------------------------------------------
+    // A slice at a time goes through all the calculators so that the data
+    // are read from memory only once
+    //--------------------------------------------------------------------------
+    std::vector<std::unique_ptr<XrdCksCalc>> partials;
+    for( auto calc : pCalcs )
+      partials.emplace_back( calc->New() );
+
+    for( uint32_t pos = 0; pos < block->size; pos += SliceSize )
+    {
+      uint32_t len = std::min( SliceSize, block->size - pos );
+      for( auto &partial : partials )
+        partial->Update( block->buffer + pos, len );
+    }
+
+    Partial part;
+    part.size = block->size;
+    for( auto &partial : partials )
+    {
+      int size = 0;
+      partial->Type( size );
+      part.checkSums.emplace_back( partial->Final(), size );
+    }
+
+    //--------------------------------------------------------------------------
+    // The data are not needed anymore
+    //--------------------------------------------------------------------------
+    uint64_t offset = block->offset;
+    if( block->done ) block->done();
+    delete block;
+
+    std::unique_lock<std::mutex> lck( pMutex );
+    pPartials.emplace( offset, std::move( part ) );
+    auto itr = pPartials.begin();
+    while( itr != pPartials.end() && itr->first == pCombinedUpTo )
+    {
+      for( size_t i = 0; i < pCalcs.size(); ++i )
+        pCalcs[i]->Combine( itr->second.checkSums[i].data(), itr->second.size );
+      pCombinedUpTo += itr->second.size;
+      itr = pPartials.erase( itr );
+    }
+
+    if( !--pOutstanding ) pCond.notify_all();
+  }
+
+  //----------------------------------------------------------------------------
+  // Wait until all the blocks handed over have been checksummed
+  //----------------------------------------------------------------------------
+  void ParallelCheckSum::Wait()
+  {
+    std::unique_lock<std::mutex> lck( pMutex );
+    pCond.wait( lck, [this]{ return pOutstanding == 0; } );
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the checksum of given type in the "type:value" notation
+  //----------------------------------------------------------------------------
+  XRootDStatus ParallelCheckSum::GetCheckSum( const std::string &type,
+                                              std::string       &checkSum )
+  {
+    XrdCksData ckSum;
+    XRootDStatus st = GetCheckSum( type, ckSum );
+    if( !st.IsOK() ) return st;
+
+    char cksBuffer[265];
+    ckSum.Get( cksBuffer, 256 );
+    checkSum  = type + ":";
+    checkSum += Utils::NormalizeChecksum( type, cksBuffer );
+
+    Log *log = DefaultEnv::GetLog();
+    log->Dump( UtilityMsg, "Checksum computed in parallel: %s",
+               checkSum.c_str() );
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the checksum of given type
+  //----------------------------------------------------------------------------
+  XRootDStatus ParallelCheckSum::GetCheckSum( const std::string &type,
+                                              XrdCksData        &result )
+  {
+    Wait();
+
+    auto itr = std::find( pTypes.begin(), pTypes.end(), type );
+    if( itr == pTypes.end() || pCalcs.size() != pTypes.size() )
+      return XRootDStatus( stError, errCheckSumError );
+
+    std::unique_lock<std::mutex> lck( pMutex );
+    if( !pPartials.empty() )
+    {
+      Log *log = DefaultEnv::GetLog();
+      log->Error( UtilityMsg, "Data missing at offset %llu for the %s checksum",
+                  (unsigned long long) pCombinedUpTo, type.c_str() );
+      return XRootDStatus( stError, errCheckSumError );
+    }
+
+    XrdCksCalc *calc = pCalcs[itr - pTypes.begin()];
+    int size = 0;
+    calc->Type( size );
+    result.Set( type.c_str() );
+    result.Set( (void*)calc->Final(), size );
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Number of worker threads
+  //----------------------------------------------------------------------------
+  uint32_t ParallelCheckSum::GetNbThreads()
+  {
+    int threads = DefaultCpCksThreads;
+    DefaultEnv::GetEnv()->GetInt( "CpCksThreads", threads );
+    return threads > 0 ? threads : 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the workers, null if the checksums are to be computed inline
+  //----------------------------------------------------------------------------
+  JobManager* ParallelCheckSum::GetPool()
+  {
+    uint32_t threads = GetNbThreads();
+    if( !threads ) return 0;
+
+    std::unique_lock<std::mutex> lck( poolMutex );
+    if( pool && poolPid == getpid() ) return pool;
+
+    //--------------------------------------------------------------------------
+    // The threads of the parent did not make it through a fork, the old pool
+    // is leaked on purpose as its queue may be in any state
+    //--------------------------------------------------------------------------
+    pool = 0;
+
+    JobManager *workers = new JobManager( threads );
+    if( !workers->Initialize() || !workers->Start() )
+    {
+      Log *log = DefaultEnv::GetLog();
+      log->Warning( UtilityMsg, "Unable to start the checksum workers, "
+                    "computing checksums inline" );
+      delete workers;
+      return 0;
+    }
+    pool    = workers;
+    poolPid = getpid();
+    return pool;
+  }
+}
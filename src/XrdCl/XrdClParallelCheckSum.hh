@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_PARALLEL_CHECK_SUM_HH__
+#define __XRD_CL_PARALLEL_CHECK_SUM_HH__
+
+#include "XrdCl/XrdClXRootDResponses.hh"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class XrdCksCalc;
+class XrdCksData;
+
+namespace XrdCl
+{
+  class JobManager;
+
+  //----------------------------------------------------------------------------
+  //! Computes checksums of one or more types over blocks of data on a pool of
+  //! worker threads, so that the checksums do not hold up the thread that
+  //! moves the data.
+  //!
+  //! The blocks may be handed over in any order: each of them is checksummed
+  //! on its own and the partial checksums are combined as soon as they are
+  //! adjacent to what has been combined so far. Hence, only the algorithms
+  //! that allow for combining checksums (adler32, crc32c) are supported. All
+  //! the types are computed in a single pass over every block.
+  //----------------------------------------------------------------------------
+  class ParallelCheckSum
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param types : the checksum types to be computed
+      //------------------------------------------------------------------------
+      ParallelCheckSum( const std::vector<std::string> &types );
+
+      //------------------------------------------------------------------------
+      //! Destructor, waits for the blocks that are being checksummed
+      //------------------------------------------------------------------------
+      ~ParallelCheckSum();
+
+      //------------------------------------------------------------------------
+      //! Get the calculators for all the types, fails with errNotSupported
+      //! if any of them cannot be combined
+      //------------------------------------------------------------------------
+      XRootDStatus Initialize();
+
+      //------------------------------------------------------------------------
+      //! Check whether the checksums of given type can be computed in parallel
+      //------------------------------------------------------------------------
+      static bool IsSupported( const std::string &type );
+
+      //------------------------------------------------------------------------
+      //! Check whether given type is being computed
+      //------------------------------------------------------------------------
+      bool Has( const std::string &type ) const;
+
+      //------------------------------------------------------------------------
+      //! Checksum a block of data
+      //!
+      //! @param offset : offset of the block, the blocks have to cover the
+      //!                 data from offset 0 without overlapping
+      //! @param buffer : the data, which have to remain valid until done is
+      //!                 called
+      //! @param size   : size of the block
+      //! @param done   : called, possibly from another thread, once the
+      //!                 buffer is not needed anymore
+      //------------------------------------------------------------------------
+      void Update( uint64_t offset, const void *buffer, uint32_t size,
+                   std::function<void()> done = nullptr );
+
+      //------------------------------------------------------------------------
+      //! Wait until all the blocks handed over have been checksummed
+      //------------------------------------------------------------------------
+      void Wait();
+
+      //------------------------------------------------------------------------
+      //! Get the checksum of given type over everything handed over so far
+      //! in the usual "type:value" notation, fails if the blocks do not
+      //! make up a contiguous range starting at 0
+      //------------------------------------------------------------------------
+      XRootDStatus GetCheckSum( const std::string &type,
+                                std::string       &checkSum );
+
+      //------------------------------------------------------------------------
+      //! Get the checksum of given type over everything handed over so far
+      //------------------------------------------------------------------------
+      XRootDStatus GetCheckSum( const std::string &type, XrdCksData &result );
+
+      //------------------------------------------------------------------------
+      //! Number of worker threads (0 if the checksums are computed inline)
+      //------------------------------------------------------------------------
+      static uint32_t GetNbThreads();
+
+    private:
+      ParallelCheckSum( const ParallelCheckSum& ) = delete;
+      ParallelCheckSum& operator=( const ParallelCheckSum& ) = delete;
+
+      struct Block;
+      class  BlockJob;
+
+      void Process( Block *block );
+
+      static JobManager* GetPool();
+
+      static constexpr uint32_t SliceSize = 131072;  //!< stays in the cache
+
+      //------------------------------------------------------------------------
+      // Partial checksums of a block that is not adjacent to the others yet
+      //------------------------------------------------------------------------
+      struct Partial
+      {
+        uint32_t                 size;
+        std::vector<std::string> checkSums;
+      };
+
+      std::vector<std::string>     pTypes;
+      std::vector<XrdCksCalc*>     pCalcs;        // over [0, pCombinedUpTo)
+      std::mutex                   pMutex;
+      std::condition_variable      pCond;
+      uint64_t                     pOutstanding;
+      uint64_t                     pCombinedUpTo;
+      std::map<uint64_t, Partial>  pPartials;
+  };
+}
+
+#endif // __XRD_CL_PARALLEL_CHECK_SUM_HH__
@@ -23,6 +23,7 @@
 #include "XrdCl/XrdClLog.hh"
 #include "XrdCl/XrdClConstants.hh"
 
+#include "XrdNet/XrdNetAddrInfo.hh"
 #include "XrdTls/XrdTls.hh"
 #include "XrdTls/XrdTlsContext.hh"
 #include "XrdOuc/XrdOucUtils.hh"
@@ -135,13 +136,24 @@ namespace XrdCl
       return false;
     }
 
+    //--------------------------------------------------------------------------
+    // If asked for, keep the sessions we get so that reconnecting to the
+    // same server can skip the full handshake. This is off by default as the
+    // server certificate chain is not verified again when a session is
+    // resumed.
+    //--------------------------------------------------------------------------
+    int reuse = DefaultTlsSessionReuse;
+    env->GetInt("TlsSessionReuse", reuse);
+    if (reuse)
+      tlsContext->SessionCache(XrdTlsContext::scClnt);
+
     return true;
   }
 
   //------------------------------------------------------------------------
   // Constructor
   //------------------------------------------------------------------------
-  Tls::Tls( Socket *socket, AsyncSocketHandler *socketHandler ) : pSocket( socket ), pTlsHSRevert( None ), pSocketHandler( socketHandler )
+  Tls::Tls( Socket *socket, AsyncSocketHandler *socketHandler ) : pSocket( socket ), pTlsHSRevert( None ), pSocketHandler( socketHandler ), pSessOffered( false )
   {
     //----------------------------------------------------------------------
     // Set the message callback for TLS layer
@@ -165,6 +177,27 @@ namespace XrdCl
     const char *verhost = 0;
     if( thehost != "localhost" && thehost != "127.0.0.1" && thehost != "[::1]" )
       verhost = thehost.c_str();
+
+    //--------------------------------------------------------------------------
+    // Offer a saved session for this server, this has to be done before the
+    // first connect attempt (we get called again while the hand-shake is
+    // in progress)
+    //--------------------------------------------------------------------------
+    if( !pSessOffered )
+    {
+      pSessOffered = true;
+      if( netInfo )
+      {
+        std::string sesskey = thehost + ":" + std::to_string( netInfo->Port() );
+        if( pTls->ResumeSession( sesskey.c_str() ) )
+        {
+          XrdCl::Log *log = XrdCl::DefaultEnv::GetLog();
+          log->Debug( XrdCl::TlsMsg, "Resuming TLS session with %s",
+                      sesskey.c_str() );
+        }
+      }
+    }
+
     XrdTls::RC error = pTls->Connect( verhost, &errmsg );
     XRootDStatus status = ToStatus( error );
     if( !status.IsOK() )
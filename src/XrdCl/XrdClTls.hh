@@ -136,6 +136,11 @@ namespace XrdCl
       //! Socket handler (for enabling/disabling write notification)
       //------------------------------------------------------------------------
       AsyncSocketHandler           *pSocketHandler;
+
+      //------------------------------------------------------------------------
+      //! True once a saved TLS session has been looked up for this connection
+      //------------------------------------------------------------------------
+      bool                          pSessOffered;
   };
 }
 
@@ -65,21 +65,27 @@ bool XCpCtx::GetNextUrl( std::string & url )
 
 XCpSrc* XCpCtx::WeakestLink( XCpSrc *exclude )
 {
-  uint64_t transferRate = -1; // set transferRate to max uint64 value
+  double finishTime = -1;
   XCpSrc *ret = 0;
 
   std::list<XCpSrc*>::iterator itr;
   XrdSysMutexHelper lck( pMtx );
 
+  //----------------------------------------------------------------------------
+  // The weakest link is the source that, at its current transfer rate, will
+  // be the last one to deliver the data it holds
+  //----------------------------------------------------------------------------
   for( itr = pSources.begin() ; itr != pSources.end() ; ++itr )
   {
     XCpSrc *src = *itr;
     if( src == exclude ) continue;
-    uint64_t tmp = src->TransferRate();
-    if( src->HasData() && tmp < transferRate )
+    uint64_t outstanding = src->Outstanding();
+    if( !outstanding ) continue;
+    double tmp = double( outstanding ) / double( src->TransferRate() + 1 );
+    if( tmp > finishTime )
     {
       ret = src;
-      transferRate = tmp;
+      finishTime = tmp;
     }
   }
 
@@ -92,13 +98,50 @@ void XCpCtx::PutChunk( PageInfo* chunk )
   pSink.Put( chunk );
 }
 
-std::pair<uint64_t, uint64_t> XCpCtx::GetBlock()
+std::pair<uint64_t, uint64_t> XCpCtx::GetBlock( XCpSrc *src )
 {
   XrdSysMutexHelper lck( pMtx );
 
   uint64_t blkSize = pBlockSize, offset = pOffset;
-  if( pOffset + blkSize > uint64_t( pFileSize ) )
-    blkSize = pFileSize - pOffset;
+  uint64_t remaining = uint64_t( pFileSize ) > pOffset ? pFileSize - pOffset : 0;
+
+  //----------------------------------------------------------------------------
+  // Once we know how fast the sources are, weight the block size by the share
+  // of the aggregate transfer rate this source delivers: a source as fast as
+  // the average gets the default block size, a faster one more, a slower one
+  // less. Near the end of the file the remaining data is split in proportion
+  // to the transfer rates so that all the sources finish at about the same
+  // time rather than everyone waiting for the slowest one.
+  //----------------------------------------------------------------------------
+  uint64_t myRate = src ? src->TransferRate() : 0, totalRate = 0;
+  size_t   nbRated = 0;
+  if( myRate )
+  {
+    std::list<XCpSrc*>::iterator itr;
+    for( itr = pSources.begin() ; itr != pSources.end() ; ++itr )
+    {
+      if( !(*itr)->IsRunning() ) continue;
+      uint64_t rate = (*itr)->TransferRate();
+      if( !rate ) continue;
+      totalRate += rate;
+      ++nbRated;
+    }
+  }
+
+  if( myRate && totalRate )
+  {
+    double share = double( myRate ) / double( totalRate );
+    blkSize = static_cast<uint64_t>( share * nbRated * pBlockSize );
+    uint64_t tail = static_cast<uint64_t>( share * remaining );
+    if( blkSize > tail ) blkSize = tail;
+    // always hand out whole chunks
+    blkSize = ( blkSize + pChunkSize - 1 ) / pChunkSize * pChunkSize;
+    if( !blkSize ) blkSize = pChunkSize;
+  }
+
+  if( blkSize > remaining ) blkSize = remaining;
+  // don't leave behind less than a chunk
+  if( remaining - blkSize < pChunkSize ) blkSize = remaining;
   pOffset += blkSize;
 
   return std::make_pair( offset, blkSize );
@@ -195,7 +238,7 @@ bool XCpCtx::AllDone()
   XrdSysCondVarHelper lck( pDoneCV );
 
   if( !pDone )
-    pDoneCV.Wait( 60 );
+    pDoneCV.Wait( 1 );
 
   return pDone;
 }
@@ -119,7 +119,9 @@ class XCpCtx
     bool GetNextUrl( std::string & url );
 
     /**
-     * Get the 'weakest' sources
+     * Get the 'weakest' source, i.e. the source that at its
+     * current transfer rate will be the last one to deliver
+     * the data it holds
      *
      * @param exclude : the source that is excluded from the
      *                  search
@@ -135,11 +137,18 @@ class XCpCtx
     void PutChunk( PageInfo* chunk );
 
     /**
-     * Get next block that has to be transferred
+     * Get next block that has to be transferred. The block size
+     * is weighted by the share of the aggregate transfer rate
+     * delivered by the source, and towards the end of the file
+     * the remaining data is split in proportion to the transfer
+     * rates.
      *
-     * @return : pair of offset and block size
+     * @param src : the source asking for the block, if null (or
+     *              its transfer rate is not known yet) a block
+     *              of the default size is returned
+     * @return    : pair of offset and block size
      */
-    std::pair<uint64_t, uint64_t> GetBlock();
+    std::pair<uint64_t, uint64_t> GetBlock( XCpSrc *src = 0 );
 
     /**
      * Set the file size (GetSize will block until
@@ -210,7 +219,9 @@ class XCpCtx
     /**
      * Returns true if all chunks have been transferred,
      * otherwise blocks until NotifyIdleSrc is called,
-     * or a 1 minute timeout occurs.
+     * or a 1 second timeout occurs (so idle sources may
+     * promptly take over work from a source that slowed
+     * down).
      *
      * @return : true is all chunks have been transferred,
      *           false otherwise.
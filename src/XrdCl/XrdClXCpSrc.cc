@@ -116,6 +116,12 @@ XCpSrc::XCpSrc( uint32_t chunkSize, uint8_t parallel, int64_t fileSize, XCpCtx *
 
 XCpSrc::~XCpSrc()
 {
+  if( !pUrl.empty() )
+  {
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( UtilityMsg, "Received %llu bytes from %s",
+                (unsigned long long) pDataTransfered, pUrl.c_str() );
+  }
   pCtx->RemoveSrc( this );
   // we release ctx, it is always Delete() by its creator
   // not by us.
@@ -371,9 +377,19 @@ XRootDStatus XCpSrc::ReadChunks()
     }
   }
 
+  //----------------------------------------------------------------------------
+  // Keep about two seconds worth of data in flight, starting small until we
+  // know our transfer rate. A slow source thus issues smaller reads and does
+  // not hold on to data that faster sources could fetch sooner.
+  //----------------------------------------------------------------------------
+  uint64_t readSize = 2 * TransferRate() / pParallel;
+  if( readSize > pChunkSize ) readSize = pChunkSize;
+  if( readSize < MinReadSize ) readSize = MinReadSize;
+  readSize &= ~uint64_t( 4095 );
+
   while( pOngoing.size() < pParallel && pCurrentOffset < pBlkEnd )
   {
-    uint64_t chunkSize = pChunkSize;
+    uint64_t chunkSize = readSize;
     if( pCurrentOffset + chunkSize > pBlkEnd )
       chunkSize = pBlkEnd - pCurrentOffset;
     pOngoing[pCurrentOffset] = chunkSize;
@@ -567,7 +583,7 @@ void XCpSrc::Steal( XCpSrc *src )
 
 XRootDStatus XCpSrc::GetWork()
 {
-  std::pair<uint64_t, uint64_t> p = pCtx->GetBlock();
+  std::pair<uint64_t, uint64_t> p = pCtx->GetBlock( this );
 
   if( p.second > 0 )
   {
@@ -593,6 +609,18 @@ XRootDStatus XCpSrc::GetWork()
   return XRootDStatus( stError, errInvalidOp );
 }
 
+uint64_t XCpSrc::Outstanding()
+{
+  XrdSysMutexHelper lck( pMtx );
+  uint64_t outstanding = pCurrentOffset < pBlkEnd ? pBlkEnd - pCurrentOffset : 0;
+  std::map<uint64_t, uint64_t>::iterator itr;
+  for( itr = pRecovered.begin() ; itr != pRecovered.end() ; ++itr )
+    outstanding += itr->second;
+  for( itr = pOngoing.begin() ; itr != pOngoing.end() ; ++itr )
+    outstanding += itr->second;
+  return outstanding;
+}
+
 uint64_t XCpSrc::TransferRate()
 {
   time_t duration = pTransferTime + time( 0 ) - pStartTime;
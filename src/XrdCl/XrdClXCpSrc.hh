@@ -114,7 +114,11 @@ class XCpSrc
       return pCurrentOffset < pBlkEnd || !pRecovered.empty() || !pOngoing.empty();
     }
 
-
+    /**
+     * @return : the number of bytes allocated to this source
+     *           that have not been received yet
+     */
+    uint64_t Outstanding();
 
     /**
      * Get the transfer rate for current source
@@ -140,6 +144,11 @@ class XCpSrc
 
   private:
 
+    /**
+     * The smallest read issued for a slow source
+     */
+    static const uint64_t MinReadSize = 64 * 1024;
+
     /**
      * Destructor (private).
      *
@@ -140,6 +140,10 @@ public:
    // Any possible notification
    virtual void Notify() { }
 
+   // Keep 'dh' DH and 'rsa' RSA key pairs pre-generated for handshakes;
+   // returns false if the implementation does not support it
+   virtual bool SetKeyPool(int, int) { return false; }
+
    // Hook to a Key Derivation Function (PBKDF2 when possible)
    virtual XrdCryptoKDFunLen_t KDFunLen(); // Length of buffer
    virtual XrdCryptoKDFun_t KDFun();
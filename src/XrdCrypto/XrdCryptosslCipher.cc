@@ -37,6 +37,7 @@
 #include "XrdSut/XrdSutRndm.hh"
 #include "XrdCrypto/XrdCryptosslTrace.hh"
 #include "XrdCrypto/XrdCryptosslCipher.hh"
+#include "XrdCrypto/XrdCryptosslKeyPool.hh"
 
 //#include <openssl/dsa.h>
 #include <openssl/bio.h>
@@ -482,11 +483,13 @@ XrdCryptosslCipher::XrdCryptosslCipher(bool padded, int bits, char *pub,
 
       DEBUG("configure DH parameters");
       //
-      // Set params for DH object
-      EVP_PKEY_CTX *pkctx = EVP_PKEY_CTX_new(dhparms, 0);
-      EVP_PKEY_keygen_init(pkctx);
-      EVP_PKEY_keygen(pkctx, &fDH);
-      EVP_PKEY_CTX_free(pkctx);
+      // Take a pre-generated key, if any; otherwise set params for DH object
+      if (!(fDH = XrdCryptosslKeyPool::GetDH(dhparms))) {
+         EVP_PKEY_CTX *pkctx = EVP_PKEY_CTX_new(dhparms, 0);
+         EVP_PKEY_keygen_init(pkctx);
+         EVP_PKEY_keygen(pkctx, &fDH);
+         EVP_PKEY_CTX_free(pkctx);
+      }
       if (fDH) {
          // Init context
          ctx = EVP_CIPHER_CTX_new();
@@ -525,11 +528,14 @@ XrdCryptosslCipher::XrdCryptosslCipher(bool padded, int bits, char *pub,
             if (dhParam) {
                if (XrdCheckDH(dhParam) == 1) {
                   //
-                  // generate DH key
-                  EVP_PKEY_CTX *pkctx = EVP_PKEY_CTX_new(dhParam, 0);
-                  EVP_PKEY_keygen_init(pkctx);
-                  EVP_PKEY_keygen(pkctx, &fDH);
-                  EVP_PKEY_CTX_free(pkctx);
+                  // generate DH key, unless a pre-generated one is available
+                  EVP_PKEY_CTX *pkctx = 0;
+                  if (!(fDH = XrdCryptosslKeyPool::GetDH(dhParam))) {
+                     pkctx = EVP_PKEY_CTX_new(dhParam, 0);
+                     EVP_PKEY_keygen_init(pkctx);
+                     EVP_PKEY_keygen(pkctx, &fDH);
+                     EVP_PKEY_CTX_free(pkctx);
+                  }
                   if (fDH) {
                      // Now we can compute the cipher
                      ltmp = EVP_PKEY_size(fDH);
@@ -35,6 +35,7 @@
 #include "XrdCrypto/XrdCryptosslFactory.hh"
 #include "XrdCrypto/XrdCryptosslAux.hh"
 #include "XrdCrypto/XrdCryptosslCipher.hh"
+#include "XrdCrypto/XrdCryptosslKeyPool.hh"
 #include "XrdCrypto/XrdCryptosslMsgDigest.hh"
 #include "XrdCrypto/XrdCryptosslRSA.hh"
 #include "XrdCrypto/XrdCryptosslX509.hh"
@@ -112,6 +113,15 @@ void XrdCryptosslFactory::SetTrace(kXR_int32 trace)
    }
 }
 
+//______________________________________________________________________________
+bool XrdCryptosslFactory::SetKeyPool(int dh, int rsa)
+{
+   // Keep 'dh' DH and 'rsa' RSA key pairs pre-generated for handshakes
+
+   XrdCryptosslKeyPool::Configure(dh, rsa);
+   return true;
+}
+
 //______________________________________________________________________________
 XrdCryptoKDFunLen_t XrdCryptosslFactory::KDFunLen()
 {
@@ -54,6 +54,9 @@ public:
    // Set trace flags
    void SetTrace(kXR_int32 trace);
 
+   // Pre-generated key pairs for handshakes
+   bool SetKeyPool(int dh, int rsa);
+
    // Hook to Key Derivation Function (PBKDF2)
    XrdCryptoKDFunLen_t KDFunLen(); // Default Length of buffer
    XrdCryptoKDFun_t KDFun();
@@ -0,0 +1,292 @@
+/******************************************************************************/
+/*                                                                            */
+/*                X r d C r y p t o s s l K e y P o o l . c c                 */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+/* ************************************************************************** */
+/*                                                                            */
+/* Pool of pre-generated key pairs for handshakes                             */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "XrdCrypto/XrdCryptosslKeyPool.hh"
+#include "XrdCrypto/XrdCryptosslTrace.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <ctime>
+#include <deque>
+#include <map>
+
+#include <openssl/bn.h>
+#include <openssl/rsa.h>
+
+namespace
+{
+   // Number of distinct RSA key sizes we keep keys for
+   const int kMaxRSASizes = 4;
+
+   // Seconds between reports of requests that found the pool empty
+   const int kReportIntvl = 60;
+
+   // Never destroyed: at exit the generator thread may still be waiting on
+   // it and destroying it would block until that wait times out.
+   XrdSysCondVar  &poolCond = *new XrdSysCondVar(0);
+   bool            running = false;
+   int             dhDepth = 0;
+   int             rsaDepth = 0;
+   EVP_PKEY       *dhParams = 0;
+   std::deque<EVP_PKEY *> dhKeys;
+   std::map<int, std::deque<EVP_PKEY *> > rsaKeys;
+   XrdCryptosslKeyPool::Stats poolStats = {0, 0, 0, 0, 0, 0, 0};
+   long long       lastMissed = 0;
+
+   void *KeyPoolThread(void *)
+   {
+      XrdCryptosslKeyPool::Generate();
+      return (void *)0;
+   }
+
+   //
+   // Start the generator thread; called with poolCond locked
+   void Start()
+   {
+      EPNAME("KeyPool::Start");
+      pthread_t tid;
+      if (running || (dhDepth <= 0 && rsaDepth <= 0)) return;
+      if (XrdSysThread::Run(&tid, KeyPoolThread, 0, 0, "Crypto key pool")) {
+         PRINT("cannot start key pool thread; keys will be generated in-line");
+         dhDepth = rsaDepth = 0;
+         return;
+      }
+      running = true;
+   }
+
+   EVP_PKEY *NewDH(EVP_PKEY *params)
+   {
+      EVP_PKEY *key = 0;
+      EVP_PKEY_CTX *pkctx = EVP_PKEY_CTX_new(params, 0);
+      if (pkctx) {
+         EVP_PKEY_keygen_init(pkctx);
+         EVP_PKEY_keygen(pkctx, &key);
+         EVP_PKEY_CTX_free(pkctx);
+      }
+      return key;
+   }
+
+   EVP_PKEY *NewRSA(int bits)
+   {
+      EVP_PKEY *key = 0;
+      BIGNUM *e = BN_new();
+      if (!e) return 0;
+      BN_set_word(e, 0x10001);
+      EVP_PKEY_CTX *pkctx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, 0);
+      if (pkctx) {
+         EVP_PKEY_keygen_init(pkctx);
+         EVP_PKEY_CTX_set_rsa_keygen_bits(pkctx, bits);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+         EVP_PKEY_CTX_set1_rsa_keygen_pubexp(pkctx, e);
+         BN_free(e);
+#else
+         EVP_PKEY_CTX_set_rsa_keygen_pubexp(pkctx, e);
+#endif
+         EVP_PKEY_keygen(pkctx, &key);
+         EVP_PKEY_CTX_free(pkctx);
+      } else {
+         BN_free(e);
+      }
+      // Only keep keys passing the consistency check, as in XrdCryptosslRSA
+      if (key) {
+         EVP_PKEY_CTX *ckctx = EVP_PKEY_CTX_new(key, 0);
+         if (EVP_PKEY_check(ckctx) != 1) {
+            EVP_PKEY_free(key);
+            key = 0;
+         }
+         EVP_PKEY_CTX_free(ckctx);
+      }
+      return key;
+   }
+}
+
+//_____________________________________________________________________________
+void XrdCryptosslKeyPool::Configure(int dhKeys, int rsaKeys)
+{
+   // Set the number of keys of each kind to keep ready. The thread is started
+   // on the first request so that this can be called before daemonizing.
+
+   poolCond.Lock();
+   dhDepth  = (dhKeys  > 0) ? dhKeys  : 0;
+   rsaDepth = (rsaKeys > 0) ? rsaKeys : 0;
+   poolCond.Signal();
+   poolCond.UnLock();
+}
+
+//_____________________________________________________________________________
+EVP_PKEY *XrdCryptosslKeyPool::GetDH(EVP_PKEY *params)
+{
+   // Take a pre-generated DH key pair for 'params', if any
+
+   EVP_PKEY *key = 0;
+   if (!params) return 0;
+
+   poolCond.Lock();
+   if (dhDepth <= 0) {
+      poolCond.UnLock();
+      return 0;
+   }
+   Start();
+
+   // The first parameters we see are the ones we generate keys for
+   if (!dhParams) {
+      EVP_PKEY_up_ref(params);
+      dhParams = params;
+   }
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+   bool same = (params == dhParams) || EVP_PKEY_parameters_eq(params, dhParams) == 1;
+#else
+   bool same = (params == dhParams) || EVP_PKEY_cmp_parameters(params, dhParams) == 1;
+#endif
+   if (same) {
+      if (!dhKeys.empty()) {
+         key = dhKeys.front();
+         dhKeys.pop_front();
+         poolStats.dhTaken++;
+      } else {
+         poolStats.dhMissed++;
+      }
+      poolCond.Signal();
+   }
+   poolCond.UnLock();
+   return key;
+}
+
+//_____________________________________________________________________________
+EVP_PKEY *XrdCryptosslKeyPool::GetRSA(int bits)
+{
+   // Take a pre-generated RSA key pair of 'bits' bits, if any
+
+   EVP_PKEY *key = 0;
+
+   poolCond.Lock();
+   if (rsaDepth <= 0) {
+      poolCond.UnLock();
+      return 0;
+   }
+   Start();
+
+   std::map<int, std::deque<EVP_PKEY *> >::iterator it = rsaKeys.find(bits);
+   if (it == rsaKeys.end()) {
+      // Start keeping keys of this size, if we still can
+      if ((int)rsaKeys.size() < kMaxRSASizes) rsaKeys[bits];
+      poolStats.rsaMissed++;
+   } else if (!it->second.empty()) {
+      key = it->second.front();
+      it->second.pop_front();
+      poolStats.rsaTaken++;
+   } else {
+      poolStats.rsaMissed++;
+   }
+   poolCond.Signal();
+   poolCond.UnLock();
+   return key;
+}
+
+//_____________________________________________________________________________
+void XrdCryptosslKeyPool::GetStats(Stats &st, bool reset)
+{
+   // Current statistics
+
+   poolCond.Lock();
+   st = poolStats;
+   st.dhAvail = (int)dhKeys.size();
+   st.rsaAvail = 0;
+   std::map<int, std::deque<EVP_PKEY *> >::iterator it;
+   for (it = rsaKeys.begin(); it != rsaKeys.end(); ++it)
+      st.rsaAvail += (int)it->second.size();
+   if (reset) {
+      poolStats.dhTaken = poolStats.dhMissed = 0;
+      poolStats.rsaTaken = poolStats.rsaMissed = 0;
+      poolStats.generated = 0;
+      lastMissed = 0;
+   }
+   poolCond.UnLock();
+}
+
+//_____________________________________________________________________________
+void XrdCryptosslKeyPool::Generate()
+{
+   // Keep the pools filled. DH keys come first as every handshake needs one.
+   // Requests that found the pool empty are reported periodically so that
+   // the pool size can be adjusted.
+   EPNAME("KeyPool::Generate");
+
+   time_t lastReport = time(0);
+
+   poolCond.Lock();
+   while (true) {
+      EVP_PKEY *params = 0;
+      int bits = 0;
+
+      if (dhParams && (int)dhKeys.size() < dhDepth) {
+         params = dhParams;
+      } else if (rsaDepth > 0) {
+         std::map<int, std::deque<EVP_PKEY *> >::iterator it;
+         for (it = rsaKeys.begin(); it != rsaKeys.end(); ++it)
+            if ((int)it->second.size() < rsaDepth) {
+               bits = it->first;
+               break;
+            }
+      }
+
+      time_t now = time(0);
+      long long missed = poolStats.dhMissed + poolStats.rsaMissed;
+      if (missed != lastMissed && now - lastReport >= kReportIntvl) {
+         PRINT("pool depleted "<<(missed - lastMissed)<<" times (dh taken "
+               <<poolStats.dhTaken<<" missed "<<poolStats.dhMissed
+               <<", rsa taken "<<poolStats.rsaTaken<<" missed "
+               <<poolStats.rsaMissed<<"); consider a larger pool");
+         lastMissed = missed;
+         lastReport = now;
+      }
+
+      if (!params && !bits) {
+         poolCond.Wait(kReportIntvl);
+         continue;
+      }
+
+      // Generate without holding the lock
+      poolCond.UnLock();
+      EVP_PKEY *key = (params ? NewDH(params) : NewRSA(bits));
+      poolCond.Lock();
+
+      if (!key) {
+         PRINT("key generation failed; retrying later");
+         poolCond.Wait(1);
+         continue;
+      }
+      poolStats.generated++;
+      if (params) dhKeys.push_back(key);
+         else     rsaKeys[bits].push_back(key);
+   }
+}
@@ -0,0 +1,78 @@
+#ifndef __CRYPTO_SSLKEYPOOL_H__
+#define __CRYPTO_SSLKEYPOOL_H__
+/******************************************************************************/
+/*                                                                            */
+/*                X r d C r y p t o s s l K e y P o o l . h h                 */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+/* ************************************************************************** */
+/*                                                                            */
+/* Pool of pre-generated key pairs for handshakes                             */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include <openssl/evp.h>
+
+// ---------------------------------------------------------------------------//
+//
+// A background thread keeps a bounded supply of fresh DH and RSA key pairs
+// so that handshakes do not have to generate them. Each key is handed out
+// once and then belongs to the caller. DH keys are generated for the
+// parameters of the first request and only handed out for equal parameters.
+// RSA keys (exponent 65537) are generated for the sizes that were requested.
+// When the pool is empty, or not configured, Get*() return 0 and the caller
+// generates the key itself as before.
+//
+// ---------------------------------------------------------------------------//
+class XrdCryptosslKeyPool
+{
+public:
+   struct Stats {
+      long long dhTaken;     // DH keys handed out
+      long long dhMissed;    // DH requests that found the pool empty
+      long long rsaTaken;    // RSA keys handed out
+      long long rsaMissed;   // RSA requests that found the pool empty
+      long long generated;   // Keys generated in the background
+      int       dhAvail;     // DH keys currently available
+      int       rsaAvail;    // RSA keys currently available (all sizes)
+   };
+
+   // Set the number of keys to keep ready; 0 disables that kind of key
+   static void      Configure(int dhKeys, int rsaKeys);
+
+   // Take a DH key pair for the parameters in 'params'
+   static EVP_PKEY *GetDH(EVP_PKEY *params);
+
+   // Take an RSA key pair of 'bits' bits
+   static EVP_PKEY *GetRSA(int bits);
+
+   // Current statistics; counters are reset if 'reset' is true
+   static void      GetStats(Stats &st, bool reset = false);
+
+   // Generator loop (used internally by the pool thread)
+   static void      Generate();
+};
+
+#endif
@@ -34,6 +34,7 @@
 
 #include "XrdSut/XrdSutRndm.hh"
 #include "XrdCrypto/XrdCryptosslAux.hh"
+#include "XrdCrypto/XrdCryptosslKeyPool.hh"
 #include "XrdCrypto/XrdCryptosslTrace.hh"
 #include "XrdCrypto/XrdCryptosslRSA.hh"
 
@@ -75,6 +76,13 @@ XrdCryptosslRSA::XrdCryptosslRSA(int bits, int exp)
 
    DEBUG("bits: "<<bits<<", exp: "<<exp);
 
+   // Pre-generated keys have the default exponent and were already checked
+   if (exp == XrdCryptoDefRSAExp && (fEVP = XrdCryptosslKeyPool::GetRSA(bits))) {
+      status = kComplete;
+      DEBUG("basic length: "<<EVP_PKEY_size(fEVP)<<" bytes (pre-generated)");
+      return;
+   }
+
    // Try Key Generation
    BIGNUM *e = BN_new();
    if (!e) {
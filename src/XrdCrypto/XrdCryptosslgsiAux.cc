@@ -47,6 +47,7 @@
 #include "XrdSut/XrdSutRndm.hh"
 #include "XrdCrypto/XrdCryptogsiX509Chain.hh"
 #include "XrdCrypto/XrdCryptosslAux.hh"
+#include "XrdCrypto/XrdCryptosslKeyPool.hh"
 #include "XrdCrypto/XrdCryptosslRSA.hh"
 #include "XrdCrypto/XrdCryptosslTrace.hh"
 #include "XrdCrypto/XrdCryptosslX509.hh"
@@ -697,28 +698,30 @@ int XrdCryptosslX509CreateProxyReq(XrdCryptoX509 *xcpi,
 
    bits = (bits < XrdCryptoMinRSABits) ? XrdCryptoDefRSABits : bits;
    //
-   // Create the new PKI for the proxy (exponent 65537)
-   BIGNUM *e = BN_new();
-   if (!e) {
-      PRINT("proxy key could not be generated - return");
-      return -kErrPX_GenerateKey;
-   }
-   BN_set_word(e, 0x10001);
-   EVP_PKEY_CTX *pkctx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, 0);
-   EVP_PKEY_keygen_init(pkctx);
-   EVP_PKEY_CTX_set_rsa_keygen_bits(pkctx, bits);
+   // Create the new PKI for the proxy (exponent 65537), unless a
+   // pre-generated one is available
+   ekro.reset(XrdCryptosslKeyPool::GetRSA(bits));
+   if (!ekro) {
+      BIGNUM *e = BN_new();
+      if (!e) {
+         PRINT("proxy key could not be generated - return");
+         return -kErrPX_GenerateKey;
+      }
+      BN_set_word(e, 0x10001);
+      EVP_PKEY_CTX *pkctx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, 0);
+      EVP_PKEY_keygen_init(pkctx);
+      EVP_PKEY_CTX_set_rsa_keygen_bits(pkctx, bits);
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
-   EVP_PKEY_CTX_set1_rsa_keygen_pubexp(pkctx, e);
-   BN_free(e);
+      EVP_PKEY_CTX_set1_rsa_keygen_pubexp(pkctx, e);
+      BN_free(e);
 #else
-   EVP_PKEY_CTX_set_rsa_keygen_pubexp(pkctx, e);
+      EVP_PKEY_CTX_set_rsa_keygen_pubexp(pkctx, e);
 #endif
-   {
-     EVP_PKEY *tmppk = nullptr;
-     EVP_PKEY_keygen(pkctx, &tmppk);
-     ekro.reset(tmppk);
+      EVP_PKEY *tmppk = nullptr;
+      EVP_PKEY_keygen(pkctx, &tmppk);
+      ekro.reset(tmppk);
+      EVP_PKEY_CTX_free(pkctx);
    }
-   EVP_PKEY_CTX_free(pkctx);
    //
    // Set the key into the request
    if (!ekro) {
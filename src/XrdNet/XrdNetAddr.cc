@@ -37,6 +37,7 @@
 
 #include "XrdNet/XrdNetAddr.hh"
 #include "XrdNet/XrdNetCache.hh"
+#include "XrdNet/XrdNetResolver.hh"
 #include "XrdNet/XrdNetIdentity.hh"
 #include "XrdNet/XrdNetUtils.hh"
 #include "XrdSys/XrdSysE2T.hh"
@@ -512,6 +513,37 @@ void XrdNetAddr::SetCache(int keeptime)
 //
    theCache.SetKT(keeptime);
    dnsCache = (keeptime > 0 ? &theCache : 0);
+   if (dnsResolver) dnsResolver->SetCache(dnsCache);
+}
+
+/******************************************************************************/
+/*                           S e t N e g C a c h e                            */
+/******************************************************************************/
+
+void XrdNetAddr::SetNegCache(int keeptime) {XrdNetCache::SetNKT(keeptime);}
+
+/******************************************************************************/
+/*                           S e t R e s o l v e r                            */
+/******************************************************************************/
+
+void XrdNetAddr::SetResolver(int tnum, int maxwait)
+{
+   static XrdNetResolver *theResolver = 0;
+
+// Turn the resolver off if so wanted. Its threads simply remain idle.
+//
+   if (!tnum) {dnsResolver = 0; return;}
+
+// Create the resolver or adjust its settings
+//
+   if (!theResolver)
+      {if (tnum < 0) return;
+       theResolver = new XrdNetResolver(dnsCache, tnum, maxwait);
+       dnsResolver = theResolver;
+       return;
+      }
+   if (tnum > 0) {theResolver->SetThreads(tnum); dnsResolver = theResolver;}
+   if (maxwait >= 0) theResolver->SetWait(maxwait);
 }
 
 /******************************************************************************/
@@ -196,6 +196,33 @@ const char *Set(struct addrinfo *rP, int port, bool mapit=false);
 
 static void SetCache(int keeptime);
 
+//------------------------------------------------------------------------------
+//! Set the cache time for addresses that could not be resolved to a name.
+//! This method should only be called during initialization time. Such entries
+//! are never kept longer than resolved ones. The default is 600 seconds.
+//!
+//! @param  keeptime seconds to keep a failed resolution, 0 to not keep it.
+//------------------------------------------------------------------------------
+
+static void SetNegCache(int keeptime);
+
+//------------------------------------------------------------------------------
+//! Configure the resolver used for address to name resolutions. The resolver
+//! performs lookups in its own threads and coalesces concurrent lookups of
+//! the same address. This method should only be called during initialization
+//! time. The default is to not use a resolver and resolve in-line.
+//!
+//! @param  tnum     the number of resolver threads. Zero stops using the
+//!                  resolver while a negative value leaves it as is.
+//! @param  maxwait  the maximum number of milliseconds to wait for a lookup.
+//!                  Zero does not wait; the numeric address is used while the
+//!                  lookup proceeds and later requests find the name in the
+//!                  cache. A negative value leaves the setting as is, which
+//!                  initially is to wait until the lookup completes.
+//------------------------------------------------------------------------------
+
+static void SetResolver(int tnum, int maxwait=-1);
+
 //------------------------------------------------------------------------------
 //! Set the dialect being spoken on this network link.
 //!
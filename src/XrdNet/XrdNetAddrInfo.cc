@@ -37,6 +37,7 @@
 
 #include "XrdNet/XrdNetAddrInfo.hh"
 #include "XrdNet/XrdNetCache.hh"
+#include "XrdNet/XrdNetResolver.hh"
 
 /******************************************************************************/
 /*                 P l a t f o r m   D e p e n d e n c i e s                  */
@@ -69,11 +70,40 @@
 
 XrdNetCache           *XrdNetAddrInfo::dnsCache = 0;
 
+XrdNetResolver        *XrdNetAddrInfo::dnsResolver = 0;
+
 namespace
 {
    static const char lbVal[13] ={0,0,0,0,0,0,0,0,0,0,0,0,0x7f};
 };
 
+/******************************************************************************/
+/* Protected:                  C a n o n N a m e                              */
+/******************************************************************************/
+
+// The name is at hBuff+1 so that a numeric IPV6 address can be bracketed in
+// place. We always want numeric ipv6 addresses surrounded by brackets.
+// Additionally, some implementations of getnameinfo() return the scopeid when
+// a numeric address is returned. We check and remove it.
+//
+char *XrdNetAddrInfo::CanonName(char *hBuff)
+{
+   unsigned char *sp;
+   int n;
+
+   if (!index(hBuff+1, ':'))
+      {sp = (unsigned char *)(hBuff+1);
+       while(*sp) {if (isupper((int)*sp)) *sp = (char)tolower((int)*sp); sp++;}
+       return hBuff+1;
+      }
+
+   char *perCent = index(hBuff+1, '%');
+   if (perCent) *perCent = 0;
+   n = strlen(hBuff+1);
+   hBuff[0] = '['; hBuff[n+1] = ']'; hBuff[n+2] = 0;
+   return hBuff;
+}
+
 /******************************************************************************/
 /*                                F o r m a t                                 */
 /******************************************************************************/
@@ -425,33 +455,34 @@ int XrdNetAddrInfo::Resolve()
            }
    else return EAI_FAMILY;
 
-// Do lookup of canonical name. If an error is returned we simply assume that
-// the name is not resolvable and return the address as the host name.
+// Do lookup of canonical name. When a resolver is present it performs the
+// lookup so that concurrent lookups of the same address are done only once
+// and it caches the outcome itself. If an error is returned we simply assume
+// that the name is not resolvable and return the address as the host name.
+// We remember that for a while (the resolver does so on its own).
 //
-   if ((rc = getnameinfo(&IP.Addr, n, hBuff+1, sizeof(hBuff)-2, 0, 0, 0)))
+   if (dnsResolver) rc = dnsResolver->Lookup(*this, hBuff, sizeof(hBuff));
+      else rc = getnameinfo(&IP.Addr, n, hBuff+1, sizeof(hBuff)-2, 0, 0,
+                            NI_NAMEREQD);
+   if (rc)
       {int ec = errno;
        if (Format(hBuff, sizeof(hBuff), fmtAddr, noPort))
-          {hostName = strdup(hBuff); return 0;}
+          {hostName = strdup(hBuff);
+           if (dnsCache && !dnsResolver && rc != EAI_FAMILY)
+              dnsCache->Add(this, hostName, true);
+           return 0;
+          }
        errno = ec;
        return rc;
       }
 
-// Handle the case when the mapping returned an actual name or an address
-// We always want numeric ipv6 addresses surrounded by brackets. Additionally,
-// some implementations of getnameinfo() return the scopeid when a numeric
-// address is returned. We check and remove it.
-//
-        if (!index(hBuff+1, ':')) hostName = strdup(LowCase(hBuff+1));
-   else {char *perCent = index(hBuff+1, '%');
-         if (perCent) *perCent = 0;
-         n = strlen(hBuff+1);
-         hBuff[0] = '['; hBuff[n+1] = ']'; hBuff[n+2] = 0;
-         hostName = strdup(hBuff);
-        }
-
+// The resolver returns the name in its final form, otherwise we fix it up.
 // Add the entry to the cache and return success
 //
-   if (dnsCache) dnsCache->Add(this, hostName);
+   if (dnsResolver) hostName = strdup(hBuff);
+      else {hostName = strdup(CanonName(hBuff));
+            if (dnsCache) dnsCache->Add(this, hostName);
+           }
    return 0;
 }
   
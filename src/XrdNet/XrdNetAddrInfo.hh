@@ -49,6 +49,7 @@
 
 struct addrinfo;
 class  XrdNetCache;
+class  XrdNetResolver;
 
 class XrdNetAddrInfo
 {
@@ -359,11 +360,15 @@ XrdNetAddrInfo &operator=(XrdNetAddrInfo const &rhs)
                          }
 
 protected:
+friend class XrdNetResolver;
+
+static char               *CanonName(char *hBuff);
        char               *LowCase(char *str);
        int                 QFill(char *bAddr, int bLen);
        int                 Resolve();
 
 static XrdNetCache        *dnsCache;
+static XrdNetResolver     *dnsResolver;
 
 XrdNetSockAddr             IP;
 union {struct sockaddr    *sockAddr;
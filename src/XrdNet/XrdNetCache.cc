@@ -41,6 +41,7 @@
 /******************************************************************************/
   
 int XrdNetCache::keepTime = 0;
+int XrdNetCache::negTime  = 600;
 
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
@@ -48,59 +49,68 @@ int XrdNetCache::keepTime = 0;
   
 XrdNetCache::XrdNetCache(int psize, int csize)
 {
-     prevtablesize = psize;
-     nashtablesize = csize;
-     Threshold     = (csize * LoadMax) / 100;
-     nashnum       = 0;
-     nashtable     = (anItem **)malloc( (size_t)(csize*sizeof(anItem *)) );
-     memset((void *)nashtable, 0, (size_t)(csize*sizeof(anItem *)));
+   for (int i = 0; i < ShardNum; i++)
+       {aShard &Shard = Shards[i];
+        Shard.prevtablesize = psize;
+        Shard.nashtablesize = csize;
+        Shard.Threshold     = (csize * LoadMax) / 100;
+        Shard.nashnum       = 0;
+        Shard.nashtable     = (anItem **)malloc( (size_t)(csize*sizeof(anItem *)) );
+        memset((void *)Shard.nashtable, 0, (size_t)(csize*sizeof(anItem *)));
+       }
 }
 
 /******************************************************************************/
 /* public                            A d d                                    */
 /******************************************************************************/
   
-void XrdNetCache::Add(XrdNetAddrInfo *hAddr, const char *hName)
+void XrdNetCache::Add(XrdNetAddrInfo *hAddr, const char *hName, bool isNeg)
 {
    anItem Item, *hip;
-   int    kent;
+   int    kent, kt = keepTime;
+
+// Negative entries are kept for the shorter of the two times
+//
+   if (isNeg && negTime < kt) kt = negTime;
+   if (kt <= 0) return;
 
 // Get the key and make sure this is a valid address (should be)
 //
    if (!GenKey(Item, hAddr)) return;
+   aShard &Shard = ShardOf(Item);
 
 // We may be in a race condition, check we have this item
 //
-   myMutex.Lock();
-   if ((hip = Locate(Item)))
+   Shard.myMutex.Lock();
+   if ((hip = Locate(Shard, Item)))
       {if (hip->hName) free(hip->hName);
        hip->hName = strdup(hName);
-       hip->expTime = time(0) + keepTime;
-       myMutex.UnLock();
+       hip->expTime = time(0) + kt;
+       Shard.myMutex.UnLock();
        return;
       }
 
 // Check if we should expand the table
 //
-   if (++nashnum > Threshold) Expand();
+   if (++Shard.nashnum > Shard.Threshold) Expand(Shard);
 
 // Allocate a new entry
 //
-   hip = new anItem(Item, hName, keepTime);
+   hip = new anItem(Item, hName, kt);
 
 // Add the entry to the table
 //
-   kent = hip->aHash % nashtablesize;
-   hip->Next = nashtable[kent];
-   nashtable[kent] = hip;
-   myMutex.UnLock();
+   kent = hip->aHash % Shard.nashtablesize;
+   hip->Next = Shard.nashtable[kent];
+   Shard.nashtable[kent] = hip;
+   Shard.myMutex.UnLock();
 }
   
 /******************************************************************************/
 /* private                        E x p a n d                                 */
 /******************************************************************************/
   
-void XrdNetCache::Expand()
+void XrdNetCache::Expand(XrdNetCache::aShard &Shard)
 {
    int newsize, newent, i;
    size_t memlen;
@@ -108,7 +118,7 @@ void XrdNetCache::Expand()
 
 // Compute new size for table using a fibonacci series
 //
-   newsize = prevtablesize + nashtablesize;
+   newsize = Shard.prevtablesize + Shard.nashtablesize;
 
 // Allocate the new table
 //
@@ -118,8 +128,8 @@ void XrdNetCache::Expand()
 
 // Redistribute all of the current items
 //
-   for (i = 0; i < nashtablesize; i++)
-       {nip = nashtable[i];
+   for (i = 0; i < Shard.nashtablesize; i++)
+       {nip = Shard.nashtable[i];
         while(nip)
              {nextnip = nip->Next;
               newent  = nip->aHash % newsize;
@@ -131,14 +141,14 @@ void XrdNetCache::Expand()
 
 // Free the old table and plug in the new table
 //
-   free((void *)nashtable);
-   nashtable     = newtab;
-   prevtablesize = nashtablesize;
-   nashtablesize = newsize;
+   free((void *)Shard.nashtable);
+   Shard.nashtable     = newtab;
+   Shard.prevtablesize = Shard.nashtablesize;
+   Shard.nashtablesize = newsize;
 
 // Compute new expansion threshold
 //
-   Threshold = static_cast<int>((static_cast<long long>(newsize)*LoadMax)/100);
+   Shard.Threshold = static_cast<int>((static_cast<long long>(newsize)*LoadMax)/100);
 }
 
 /******************************************************************************/
@@ -153,31 +163,33 @@ char *XrdNetCache::Find(XrdNetAddrInfo *hAddr)
 // Get the hash for this address
 //
    if (!GenKey(Item, hAddr)) return 0;
+   aShard &Shard = ShardOf(Item);
 
 // Compute position of the hash table entry
 //
-   myMutex.Lock();
-   kent = Item.aHash%nashtablesize;
+   Shard.myMutex.Lock();
+   kent = Item.aHash%Shard.nashtablesize;
 
 // Find the entry
 //
-   nip = nashtable[kent];
+   nip = Shard.nashtable[kent];
    while(nip && *nip != Item) {pip = nip; nip = nip->Next;}
-   if (!nip) {myMutex.UnLock(); return 0;}
+   if (!nip) {Shard.myMutex.UnLock(); return 0;}
 
 // Make sure entry has not expired
 //
    if (nip->expTime > time(0))
       {char *hName = strdup(nip->hName);
-       myMutex.UnLock();
+       Shard.myMutex.UnLock();
        return hName;
       }
 
 // Remove the entry and return not found
 //
-   if (pip) pip->Next       = nip->Next;
-      else  nashtable[kent] = nip->Next;
-   myMutex.UnLock();
+   if (pip) pip->Next             = nip->Next;
+      else  Shard.nashtable[kent] = nip->Next;
+   Shard.nashnum--;
+   Shard.myMutex.UnLock();
    delete nip;
    return 0;
 }
@@ -221,15 +233,16 @@ int XrdNetCache::GenKey(XrdNetCache::anItem &Item, XrdNetAddrInfo *hAddr)
 /* Private:                       L o c a t e                                 */
 /******************************************************************************/
   
-XrdNetCache::anItem *XrdNetCache::Locate(XrdNetCache::anItem &Item)
+XrdNetCache::anItem *XrdNetCache::Locate(XrdNetCache::aShard &Shard,
+                                         XrdNetCache::anItem  &Item)
 {
   anItem *nip;
   unsigned int kent;
 
 // Find the entry
 //
-   kent = Item.aHash%nashtablesize;
-   nip = nashtable[kent];
+   kent = Item.aHash%Shard.nashtablesize;
+   nip = Shard.nashtable[kent];
    while(nip && *nip != Item) nip = nip->Next;
    return nip;
 }
@@ -48,9 +48,12 @@ public:
 //!
 //! @param  hAddr  points to the address of the name.
 //! @param  hName  points to the name to be associated with the address.
+//! @param  isNeg  when true, the address could not be resolved and hName is
+//!                the address in textual form. Such entries are kept for the
+//!                negative keep time which is normally much shorter.
 //------------------------------------------------------------------------------
 
-void   Add(XrdNetAddrInfo *hAddr, const char *hName);
+void   Add(XrdNetAddrInfo *hAddr, const char *hName, bool isNeg=false);
 
 //------------------------------------------------------------------------------
 //! Locate an address-hostname association in the cache.
@@ -71,15 +74,27 @@ char  *Find(XrdNetAddrInfo *hAddr);
 static
 void   SetKT(int ktval) {keepTime = ktval;}
 
+//------------------------------------------------------------------------------
+//! Set the keep time for negative entries during initialization. Negative
+//! entries are never kept longer than positive ones. The default is 600.
+//!
+//! @param  ktval  the number of seconds to keep a negative entry in the cache.
+//!                A value of zero disables negative caching.
+//------------------------------------------------------------------------------
+static
+void   SetNKT(int ktval) {negTime = ktval;}
+
 //------------------------------------------------------------------------------
 //! Constructor. When allocateing a new hash, two adjacent Fibonocci numbers.
-//! The series is simply n[j] = n[j-1] + n[j-2].
+//! The series is simply n[j] = n[j-1] + n[j-2]. The cache is split into
+//! shards, each with its own lock and table, so that lookups of different
+//! addresses do not serialize on one another.
 //!
 //! @param  psize  the correct Fibonocci antecedent to csize.
-//! @param  csize  the initial size of the table.
+//! @param  csize  the initial size of the table of each shard.
 //------------------------------------------------------------------------------
 
-       XrdNetCache(int psize = 987, int csize = 1597);
+       XrdNetCache(int psize = 89, int csize = 144);
 
 //------------------------------------------------------------------------------
 //! Destructor. The XrdNetCache object is not designed to be deleted. Doing
@@ -117,17 +132,30 @@ inline int       operator!=(const anItem &oth)
                 ~anItem() {if (hName) free(hName);}
       };
 
-void             Expand();
+static const int ShardNum = 16;
+
+struct aShard
+      {XrdSysMutex  myMutex;
+       anItem     **nashtable;
+       int          prevtablesize;
+       int          nashtablesize;
+       int          nashnum;
+       int          Threshold;
+      };
+
+void             Expand(aShard &Shard);
 int              GenKey(anItem &Item, XrdNetAddrInfo *hAddr);
-anItem          *Locate(anItem &Item);
+anItem          *Locate(aShard &Shard, anItem &Item);
+
+// Shards are selected by the high order bits of a multiplicative hash so that
+// the selection is independent of the bucket chosen within the shard.
+//
+inline aShard   &ShardOf(anItem &Item)
+                        {return Shards[(Item.aHash * 2654435761U) >> 28];}
 
 static int       keepTime;
+static int       negTime;
 
-XrdSysMutex      myMutex;
-anItem         **nashtable;
-int              prevtablesize;
-int              nashtablesize;
-int              nashnum;
-int              Threshold;
+aShard           Shards[ShardNum];
 };
 #endif
@@ -231,6 +231,59 @@ int XrdNetMsg::Send(const struct iovec iov[], int iovcnt,
    return (retc < 0 ? retErr(errno, specDest) : 0);
 }
   
+/******************************************************************************/
+/*                              S e n d M a n y                               */
+/******************************************************************************/
+
+int XrdNetMsg::SendMany(const struct iovec msgs[], int msgcnt)
+{
+   int retc, numSent = 0;
+
+// This is only supported for the address connected at construction
+//
+   if (!destOK)
+      {eDest->Emsg("NetMsg", "Destination not specified."); return -1;}
+
+#ifdef __linux__
+// Send as many messages as we can per system call. Each message has a single
+// element I/O vector and we need no address as the socket is connected.
+//
+   static const int maxMsgs = 64;
+   struct mmsghdr mVec[maxMsgs];
+
+   while(numSent < msgcnt)
+        {int n = (msgcnt - numSent > maxMsgs ? maxMsgs : msgcnt - numSent);
+         memset(mVec, 0, sizeof(struct mmsghdr)*n);
+         for (int i = 0; i < n; i++)
+             {mVec[i].msg_hdr.msg_iov    = const_cast<struct iovec*>
+                                           (&msgs[numSent+i]);
+              mVec[i].msg_hdr.msg_iovlen = 1;
+             }
+         do {retc = sendmmsg(FD, mVec, n, 0);}
+            while(retc < 0 && errno == EINTR);
+         if (retc <= 0) break;
+         numSent += retc;
+        }
+#else
+   while(numSent < msgcnt)
+        {do {retc = send(FD, (Sokdata_t)msgs[numSent].iov_base,
+                         msgs[numSent].iov_len, 0);
+            } while(retc < 0 && errno == EINTR);
+         if (retc < 0) break;
+         numSent++;
+        }
+#endif
+
+// Report the failure, if any. An error on the very first message is an error
+// for the whole batch.
+//
+   if (numSent < msgcnt)
+      {if (retErr((retc < 0 ? errno : EAGAIN), dfltDest) < 0 && !numSent)
+          return -1;
+      }
+   return numSent;
+}
+  
 /******************************************************************************/
 /*                       P r i v a t e   M e t h o d s                        */
 /******************************************************************************/
@@ -111,6 +111,20 @@ int           Send(const struct  iovec iov[], // Remaining parms as above
                          int     iovcnt,      // Number of elements in iovec
                    const char   *dest=0,      // Hostname to send UDP datagram
                          int     tmo=-1);     // Timeout in ms (-1 = none)
+
+//------------------------------------------------------------------------------
+//! Send several UDP messages to the endpoint specified in the constructor
+//! using as few system calls as possible (i.e. sendmmsg() where available).
+//!
+//! @param  msgs     The messages to send, each element is one datagram.
+//! @param  msgcnt   The number of messages.
+//! @return <0       No message sent due to error.
+//! @return >=0      The number of messages sent, starting with the first one.
+//!                  Fewer than msgcnt means the next one failed (reported).
+//------------------------------------------------------------------------------
+
+int           SendMany(const struct iovec msgs[], int msgcnt);
+
 //------------------------------------------------------------------------------
 //! Constructor
 //!
@@ -0,0 +1,299 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d N e t M s g Q u e u e . c c                      */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <sched.h>
+#include <sys/uio.h>
+
+#include "XrdNet/XrdNetMsg.hh"
+#include "XrdNet/XrdNetMsgQueue.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysTimer.hh"
+
+/******************************************************************************/
+/*                         L o c a l   D e f i n e s                          */
+/******************************************************************************/
+
+namespace
+{
+// Maximum number of queued messages handled by one pass of the sender
+//
+static const int maxBatch = 256;
+
+void *SenderThread(void *carg)
+      {XrdNetMsgQueue *qP = (XrdNetMsgQueue *)carg;
+       qP->Sender();
+       return (void *)0;
+      }
+}
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdNetMsgQueue::XrdNetMsgQueue(XrdSysError *erp, int qdepth, int seqoff)
+                              : eDest(erp), numDest(0), seqOff(seqoff),
+                                qTail(0), qHead(0), isIdle(false),
+                                isRunning(false), noThread(false),
+                                wakeSem(0), drainCond(0), sentUpTo(0),
+                                numWaits(0), numSent(0), numCalls(0),
+                                numErrs(0)
+{
+   uint64_t rSize = 16;
+
+// Size the ring as a power of two so positions map to slots with a mask
+//
+   while(rSize < (uint64_t)qdepth && rSize < 1048576) rSize <<= 1;
+   ringMask = rSize - 1;
+
+// Each slot is initially ready to be claimed for its own ring position
+//
+   Ring = new mSlot[rSize];
+   for (uint64_t i = 0; i < rSize; i++)
+       {Ring[i].seqNum.store(i, std::memory_order_relaxed);
+        Ring[i].mBuff = 0;
+        Ring[i].mBsz  = 0;
+        Ring[i].mLen  = 0;
+        Ring[i].mMask = 0;
+        Ring[i].setSeq= false;
+       }
+
+   memset(msgDest, 0, sizeof(msgDest));
+   memset(destSeq, 0, sizeof(destSeq));
+}
+
+/******************************************************************************/
+/*                               A d d D e s t                                */
+/******************************************************************************/
+
+int XrdNetMsgQueue::AddDest(XrdNetMsg *dest)
+{
+   XrdSysMutexHelper mHelp(startMutex);
+
+// Destinations must be added before messages are queued for them
+//
+   if (numDest >= maxDest) return -1;
+   msgDest[numDest] = dest;
+   return numDest++;
+}
+
+/******************************************************************************/
+/*                                 D r a i n                                  */
+/******************************************************************************/
+
+void XrdNetMsgQueue::Drain()
+{
+   uint64_t lastPos = qTail.load();
+
+// Wait for the sender to get past everything queued so far. When there is no
+// sender thread messages are sent by the producers and nothing is pending.
+//
+   if (!isRunning.load()) return;
+   drainCond.Lock();
+   while(sentUpTo < lastPos) drainCond.Wait();
+   drainCond.UnLock();
+}
+
+/******************************************************************************/
+/* Private:                        F l u s h                                  */
+/******************************************************************************/
+
+// Only one thread may be in Flush() at any one time
+//
+int XrdNetMsgQueue::Flush()
+{
+   struct iovec mVec[maxBatch];
+   mSlot *sP;
+   long long nSent = 0, nErrs = 0;
+   int n, k, rc, nCalls = 0;
+
+// Collect the run of consecutive published messages starting at the head
+//
+   for (n = 0; n < maxBatch; n++)
+       {sP = &Ring[(qHead+n) & ringMask];
+        if (sP->seqNum.load(std::memory_order_acquire) != qHead+n+1) break;
+       }
+   if (!n) return 0;
+
+// Send the batch to each destination in turn. The sequence number is set
+// per destination so it is inserted just before the batch goes out.
+//
+   for (int d = 0; d < numDest; d++)
+       {for (int i = k = 0; i < n; i++)
+            {sP = &Ring[(qHead+i) & ringMask];
+             if (!(sP->mMask & (1 << d))) continue;
+             if (sP->setSeq) sP->mBuff[seqOff] = destSeq[d]++;
+             mVec[k].iov_base = sP->mBuff;
+             mVec[k].iov_len  = sP->mLen;
+             k++;
+            }
+        if (!k) continue;
+        rc = msgDest[d]->SendMany(mVec, k);
+        nCalls++;
+        if (rc < 0) rc = 0;
+        nSent += rc; nErrs += k - rc;
+       }
+
+// Return the slots to the producers, each for the next turn around the ring
+//
+   for (int i = 0; i < n; i++)
+       {sP = &Ring[(qHead+i) & ringMask];
+        sP->seqNum.store(qHead+i+ringMask+1, std::memory_order_release);
+       }
+   qHead += n;
+
+// Update the statistics and tell anyone waiting in Drain() how far we got
+//
+   drainCond.Lock();
+   sentUpTo  = qHead;
+   numSent  += nSent;
+   numErrs  += nErrs;
+   numCalls += nCalls;
+   drainCond.Broadcast();
+   drainCond.UnLock();
+   return n;
+}
+
+/******************************************************************************/
+/*                              G e t S t a t s                               */
+/******************************************************************************/
+
+void XrdNetMsgQueue::GetStats(XrdNetMsgQueue::Stats &stats)
+{
+   stats.msgsQueued = static_cast<long long>(qTail.load());
+   stats.fullWaits  = numWaits.load();
+
+   drainCond.Lock();
+   stats.msgsSent   = numSent;
+   stats.sendCalls  = numCalls;
+   stats.sendErrs   = numErrs;
+   drainCond.UnLock();
+}
+
+/******************************************************************************/
+/*                                  S e n d                                   */
+/******************************************************************************/
+
+bool XrdNetMsgQueue::Send(int dmask, const char *buff, int blen, bool setseq)
+{
+   uint64_t pos;
+   mSlot *sP;
+
+// Ignore messages that would not go anywhere
+//
+   dmask &= (1 << numDest) - 1;
+   if (!dmask || blen <= 0) return false;
+
+// Make sure the sender is running, this is normally a single atomic load
+//
+   if (!isRunning.load(std::memory_order_relaxed)) StartSender();
+
+// Claim the next ring position. Should the slot still hold a message from the
+// previous turn around the ring, wait for the sender to send it.
+//
+   pos = qTail.fetch_add(1);
+   sP  = &Ring[pos & ringMask];
+   if (sP->seqNum.load(std::memory_order_acquire) != pos)
+      {numWaits++;
+       for (int i = 0; sP->seqNum.load(std::memory_order_acquire) != pos; i++)
+           {if (i < 64) sched_yield();
+               else XrdSysTimer::Wait(1);
+           }
+      }
+
+// The slot is ours, copy in the message. The slot buffer only ever grows.
+// Should we not get the memory we must still publish the slot so that the
+// sender does not stall; an empty mask makes it skip the message.
+//
+   if (sP->mBsz < blen)
+      {char *nBuff = (char *)realloc(sP->mBuff, blen);
+       if (nBuff) {sP->mBuff = nBuff; sP->mBsz = blen;}
+          else dmask = 0;
+      }
+   if (dmask) memcpy(sP->mBuff, buff, blen);
+   sP->mLen   = blen;
+   sP->mMask  = dmask;
+   sP->setSeq = setseq && seqOff >= 0 && seqOff < blen;
+   sP->seqNum.store(pos+1);
+
+// Wake up the sender if it went idle. Without a sender thread we send what
+// has been queued ourselves, one producer at a time.
+//
+   if (isRunning.load(std::memory_order_relaxed))
+      {if (isIdle.load() && isIdle.exchange(false)) wakeSem.Post();}
+      else {XrdSysMutexHelper mHelp(startMutex);
+            while(Flush()) {}
+           }
+   return dmask != 0;
+}
+
+/******************************************************************************/
+/*                                S e n d e r                                 */
+/******************************************************************************/
+
+void XrdNetMsgQueue::Sender()
+{
+
+// Send whatever has been queued. When nothing is, declare ourselves idle and
+// check once more to close the race with a producer that did not see us idle.
+//
+   while(true)
+        {if (Flush()) continue;
+         isIdle.store(true);
+         if (Ring[qHead & ringMask].seqNum.load() == qHead+1)
+            {isIdle.store(false); continue;}
+         wakeSem.Wait();
+        }
+}
+
+/******************************************************************************/
+/* Private:                  S t a r t S e n d e r                            */
+/******************************************************************************/
+
+bool XrdNetMsgQueue::StartSender()
+{
+   XrdSysMutexHelper mHelp(startMutex);
+   pthread_t tid;
+   int rc;
+
+// Start the sender thread unless someone beat us to it or it could not be
+// started before. In the latter case producers send the messages.
+//
+   if (isRunning.load()) return true;
+   if (noThread) return false;
+   if ((rc = XrdSysThread::Run(&tid, SenderThread, (void *)this, 0,
+                               "UDP sender")))
+      {if (eDest) eDest->Emsg("NetMsgQueue", rc,
+                              "start UDP sender thread; sending in-line.");
+       noThread = true;
+       return false;
+      }
+   isRunning.store(true);
+   return true;
+}
@@ -0,0 +1,173 @@
+#ifndef __XRDNETMSGQUEUE_HH__
+#define __XRDNETMSGQUEUE_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d N e t M s g Q u e u e . h h                      */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <atomic>
+#include <cstdint>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdNetMsg;
+class XrdSysError;
+
+//------------------------------------------------------------------------------
+//! The XrdNetMsgQueue class decouples the production of UDP messages from
+//! their transmission. Any number of threads queue messages without taking a
+//! lock; a single sender thread collects whatever has been queued and hands
+//! it to the kernel in batches via XrdNetMsg::SendMany(). Messages are sent in
+//! the order they were queued.
+//!
+//! The queue is a bounded ring of slots. A producer claims the next slot with
+//! an atomic increment, copies its message into the slot's private buffer and
+//! publishes it. Slot buffers are kept across uses so that, once warmed up,
+//! queueing a message does no memory allocation. When the ring is full the
+//! producer waits for the sender to free a slot; messages are never dropped.
+//!
+//! Up to maxDest destinations may be registered. Each message carries a mask
+//! of the destinations it is for. Optionally, a one byte sequence number that
+//! is maintained per destination is placed in each message just before it is
+//! sent, which is how monitoring streams number their packets.
+//------------------------------------------------------------------------------
+
+class XrdNetMsgQueue
+{
+public:
+
+static const int maxDest = 4;
+
+struct Stats
+      {long long msgsQueued;   //!< Messages queued
+       long long msgsSent;     //!< Datagrams sent (one per destination)
+       long long sendCalls;    //!< Calls to XrdNetMsg::SendMany()
+       long long sendErrs;     //!< Datagrams that could not be sent
+       long long fullWaits;    //!< Times a producer found the ring full
+      };
+
+//------------------------------------------------------------------------------
+//! Register a destination.
+//!
+//! @param  dest   pointer to a message object with a default destination.
+//!
+//! @return The destination number, the mask bit is 1<<number. A negative
+//!         value is returned when too many destinations were added.
+//------------------------------------------------------------------------------
+
+int    AddDest(XrdNetMsg *dest);
+
+//------------------------------------------------------------------------------
+//! Wait until all messages queued so far have been sent.
+//------------------------------------------------------------------------------
+
+void   Drain();
+
+//------------------------------------------------------------------------------
+//! Obtain usage statistics.
+//------------------------------------------------------------------------------
+
+void   GetStats(Stats &stats);
+
+//------------------------------------------------------------------------------
+//! Queue a message.
+//!
+//! @param  dmask  mask of destinations the message is to be sent to.
+//! @param  buff   the message, it is copied.
+//! @param  blen   the message length.
+//! @param  setseq when true and the object was created with a sequence number
+//!                offset, the per-destination sequence number is inserted.
+//!
+//! @return true if the message was queued, false if it was not (i.e. empty
+//!         destination mask, bad length, or no memory).
+//------------------------------------------------------------------------------
+
+bool   Send(int dmask, const char *buff, int blen, bool setseq=true);
+
+//------------------------------------------------------------------------------
+//! Send queued messages (used internally by the sender thread).
+//------------------------------------------------------------------------------
+
+void   Sender();
+
+//------------------------------------------------------------------------------
+//! Constructor. The sender thread is started when the first message is
+//! queued so the object may be created before the process daemonizes.
+//!
+//! @param  erp    the error message object for routing error messages.
+//! @param  qdepth number of queue slots, rounded up to a power of two.
+//! @param  seqoff offset in each message of the sequence number byte. A
+//!                negative value means messages are not numbered.
+//------------------------------------------------------------------------------
+
+       XrdNetMsgQueue(XrdSysError *erp, int qdepth=1024, int seqoff=-1);
+
+//------------------------------------------------------------------------------
+//! Destructor. The XrdNetMsgQueue object is not designed to be deleted as
+//! its thread keeps running.
+//------------------------------------------------------------------------------
+
+      ~XrdNetMsgQueue() {} // Never gets deleted
+
+private:
+
+struct alignas(64) mSlot
+      {std::atomic<uint64_t> seqNum;  // Ring position this slot is ready for
+       char                 *mBuff;
+       int                   mBsz;
+       int                   mLen;
+       int                   mMask;
+       bool                  setSeq;
+      };
+
+int            Flush();
+bool           StartSender();
+
+XrdSysError          *eDest;
+XrdNetMsg            *msgDest[maxDest];
+int                   numDest;
+int                   seqOff;
+unsigned char         destSeq[maxDest];
+
+mSlot                *Ring;
+uint64_t              ringMask;
+alignas(64) std::atomic<uint64_t> qTail;     // Next slot to be claimed
+alignas(64) uint64_t              qHead;     // Next slot to be sent
+std::atomic<bool>     isIdle;
+std::atomic<bool>     isRunning;
+bool                  noThread;              // Protected by startMutex
+
+XrdSysMutex           startMutex;
+XrdSysSemaphore       wakeSem;
+XrdSysCondVar         drainCond;
+uint64_t              sentUpTo;              // Protected by drainCond
+
+std::atomic<long long> numWaits;
+long long             numSent;               // Protected by drainCond
+long long             numCalls;              // Protected by drainCond
+long long             numErrs;               // Protected by drainCond
+};
+#endif
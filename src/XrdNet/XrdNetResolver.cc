@@ -0,0 +1,270 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d N e t R e s o l v e r . c c                      */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include "XrdNet/XrdNetCache.hh"
+#include "XrdNet/XrdNetResolver.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                     T h r e a d   I n t e r f a c e s                      */
+/******************************************************************************/
+
+namespace
+{
+void *ResolverThread(void *carg)
+      {XrdNetResolver *rP = (XrdNetResolver *)carg;
+       rP->Worker();
+       return (void *)0;
+      }
+
+long long NowMS()
+         {struct timespec ts;
+          clock_gettime(CLOCK_MONOTONIC, &ts);
+          return (long long)ts.tv_sec*1000 + ts.tv_nsec/1000000;
+         }
+}
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdNetResolver::XrdNetResolver(XrdNetCache *cP, int tnum, int msec,
+                               LookupFunc lFunc)
+                              : qCond(0), qSem(0), qFirst(0), qLast(0),
+                                dnsCache(cP), lookUp(lFunc ? lFunc : DoLookup),
+                                maxWait(msec), numThreads(0),
+                                wantThreads(tnum > 0 ? tnum : 1)
+{}
+
+/******************************************************************************/
+/* Private:                     D o L o o k u p                               */
+/******************************************************************************/
+
+int XrdNetResolver::DoLookup(const struct sockaddr *sAddr, SOCKLEN_t sLen,
+                             char *hBuff, int hBLen)
+{
+// We require a name so that an unregistered address is reported as such and
+// can be cached as a negative entry.
+//
+   return getnameinfo(sAddr, sLen, hBuff, hBLen, 0, 0, NI_NAMEREQD);
+}
+
+/******************************************************************************/
+/* Private:                         D o n e                                   */
+/******************************************************************************/
+
+void XrdNetResolver::Done(XrdNetResolver::aQuery *qP, int rc, const char *hName)
+{
+
+// Record the result, wake up anyone waiting for it, and release the query if
+// everyone has given up waiting. The query is no longer in flight so that a
+// later request after a cache expiry does a fresh lookup.
+//
+   qCond.Lock();
+   qP->rc = rc;
+   if (!rc) strlcpy(qP->hName, hName, sizeof(qP->hName));
+   qP->done = true;
+   inFlight.erase(qP->Key);
+   if (!(--qP->refs)) delete qP;
+      else qCond.Broadcast();
+   qCond.UnLock();
+}
+
+/******************************************************************************/
+/* Private:                       G e n K e y                                 */
+/******************************************************************************/
+
+bool XrdNetResolver::GenKey(XrdNetAddrInfo &hAddr, std::string &key)
+{
+   const sockaddr *sP = hAddr.SockAddr();
+
+   if (sP->sa_family == AF_INET)
+      {const sockaddr_in *s4 = (const sockaddr_in *)sP;
+       key.assign((const char *)&(s4->sin_addr), sizeof(s4->sin_addr));
+       return true;
+      }
+
+   if (sP->sa_family == AF_INET6)
+      {const sockaddr_in6 *s6 = (const sockaddr_in6 *)sP;
+       key.assign((const char *)&(s6->sin6_addr), sizeof(s6->sin6_addr));
+       return true;
+      }
+
+   return false;
+}
+
+/******************************************************************************/
+/*                                L o o k u p                                 */
+/******************************************************************************/
+
+int XrdNetResolver::Lookup(XrdNetAddrInfo &hAddr, char *hBuff, int hBLen)
+{
+   std::map<std::string, aQuery *>::iterator it;
+   std::string key;
+   aQuery *qP;
+   int rc;
+
+// Generate the key for this address
+//
+   if (!GenKey(hAddr, key)) return EAI_FAMILY;
+
+// Make sure the resolver threads are running
+//
+   qCond.Lock();
+   if (numThreads < wantThreads) StartThreads();
+
+// Should we have no threads at all, we do the lookup in-line
+//
+   if (!numThreads)
+      {char *hName;
+       qCond.UnLock();
+       if ((rc = lookUp(hAddr.SockAddr(), hAddr.SockSize(), hBuff+1, hBLen-2)))
+          return rc;
+       hName = XrdNetAddrInfo::CanonName(hBuff);
+       if (hName != hBuff) memmove(hBuff, hName, strlen(hName)+1);
+       return 0;
+      }
+
+// If a lookup for this address is already in progress we simply join it.
+// Otherwise, queue a new lookup for the resolver threads.
+//
+   if ((it = inFlight.find(key)) != inFlight.end())
+      {qP = it->second;
+       qP->refs++;
+      } else {
+       qP = new aQuery(hAddr, key);
+       qP->refs++;
+       inFlight[key] = qP;
+       if (qLast) qLast->Next = qP;
+          else    qFirst      = qP;
+       qLast = qP;
+       qSem.Post();
+      }
+
+// Wait for the result but no longer than we are allowed to wait
+//
+   if (maxWait < 0) {while(!qP->done) qCond.Wait();}
+      else if (maxWait > 0)
+              {long long endT = NowMS() + maxWait, waitT;
+               while(!qP->done && (waitT = endT - NowMS()) > 0)
+                    qCond.WaitMS(static_cast<int>(waitT));
+              }
+
+// Return the result and release our interest in the query
+//
+   if (!qP->done) rc = EAI_AGAIN;
+      else if (!(rc = qP->rc)) strlcpy(hBuff, qP->hName, hBLen);
+   if (!(--qP->refs)) delete qP;
+   qCond.UnLock();
+   return rc;
+}
+
+/******************************************************************************/
+/*                              S e t C a c h e                               */
+/******************************************************************************/
+
+void XrdNetResolver::SetCache(XrdNetCache *cP)
+{
+   qCond.Lock();
+   dnsCache = cP;
+   qCond.UnLock();
+}
+
+/******************************************************************************/
+/*                            S e t T h r e a d s                             */
+/******************************************************************************/
+
+void XrdNetResolver::SetThreads(int tnum)
+{
+   qCond.Lock();
+   if (tnum > wantThreads) wantThreads = tnum;
+   qCond.UnLock();
+}
+
+/******************************************************************************/
+/* Private:                 S t a r t T h r e a d s                           */
+/******************************************************************************/
+
+// Called with qCond locked
+//
+void XrdNetResolver::StartThreads()
+{
+   pthread_t tid;
+
+   while(numThreads < wantThreads)
+        {if (XrdSysThread::Run(&tid, ResolverThread, (void *)this, 0,
+                               "DNS resolver"))
+            {wantThreads = numThreads; break;}
+         numThreads++;
+        }
+}
+
+/******************************************************************************/
+/*                                W o r k e r                                 */
+/******************************************************************************/
+
+void XrdNetResolver::Worker()
+{
+   char hBuff[NI_MAXHOST], *hName;
+   XrdNetCache *cP;
+   aQuery *qP;
+   int rc;
+
+   while(true)
+        {qSem.Wait();
+         qCond.Lock();
+         if (!(qP = qFirst)) {qCond.UnLock(); continue;}
+         if (!(qFirst = qP->Next)) qLast = 0;
+         cP = dnsCache;
+         qCond.UnLock();
+
+      // Do the lookup and convert the name to the form we use
+      //
+         rc = lookUp(qP->Addr.SockAddr(), qP->Addr.SockSize(),
+                     hBuff+1, sizeof(hBuff)-2);
+         hName = (rc ? 0 : XrdNetAddrInfo::CanonName(hBuff));
+
+      // Cache the outcome. An unresolvable address is cached as its numeric
+      // form so that the next connection from it does not wait again.
+      //
+         if (cP)
+            {if (hName) cP->Add(&qP->Addr, hName);
+                else if (rc != EAI_FAMILY && rc != EAI_MEMORY
+                     &&  qP->Addr.Format(hBuff, sizeof(hBuff),
+                                         XrdNetAddrInfo::fmtAddr,
+                                         XrdNetAddrInfo::noPort))
+                        cP->Add(&qP->Addr, hBuff, true);
+            }
+
+         Done(qP, rc, hName);
+        }
+}
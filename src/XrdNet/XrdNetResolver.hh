@@ -0,0 +1,162 @@
+#ifndef __XRDNETRESOLVER_HH__
+#define __XRDNETRESOLVER_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d N e t R e s o l v e r . h h                      */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <map>
+#include <string>
+#include <netdb.h>
+#include <sys/socket.h>
+
+#include "XrdNet/XrdNetAddr.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdNetCache;
+
+//------------------------------------------------------------------------------
+//! The XrdNetResolver class performs address to name resolutions using a small
+//! pool of threads. Concurrent requests for the same address are coalesced
+//! into a single lookup whose result is handed to every requester. Results,
+//! including failures, are added to the name cache by the resolving thread so
+//! that a lookup that outlives its requesters still benefits later ones.
+//------------------------------------------------------------------------------
+
+class XrdNetResolver
+{
+public:
+
+//------------------------------------------------------------------------------
+//! Function used to perform the actual lookup. It has the same semantics as
+//! getnameinfo() called with a name buffer and no service buffer.
+//------------------------------------------------------------------------------
+
+typedef int (*LookupFunc)(const struct sockaddr *sAddr, SOCKLEN_t sLen,
+                          char *hBuff, int hBLen);
+
+//------------------------------------------------------------------------------
+//! Resolve an address to a host name.
+//!
+//! @param  hAddr  the address to be resolved, it must be an INET address.
+//! @param  hBuff  buffer to receive the name in the form XrdNetAddrInfo uses.
+//! @param  hBLen  size of the buffer, should be at least NI_MAXHOST.
+//!
+//! @return Success: 0 and the name is placed in hBuff.
+//!         Failure: the getnameinfo() error code. EAI_AGAIN is also returned
+//!                  when the lookup did not complete within the maximum wait
+//!                  time; it continues in the background.
+//------------------------------------------------------------------------------
+
+int    Lookup(XrdNetAddrInfo &hAddr, char *hBuff, int hBLen);
+
+//------------------------------------------------------------------------------
+//! Set the cache that receives lookup results.
+//!
+//! @param  cP     pointer to the cache, nil if results are not to be cached.
+//------------------------------------------------------------------------------
+
+void   SetCache(XrdNetCache *cP);
+
+//------------------------------------------------------------------------------
+//! Set the maximum time a requester waits for a lookup.
+//!
+//! @param  msec   milliseconds to wait. A negative value waits until the
+//!                lookup completes. Zero never waits; the requester proceeds
+//!                with the numeric address while the lookup runs.
+//------------------------------------------------------------------------------
+
+void   SetWait(int msec) {maxWait = msec;}
+
+//------------------------------------------------------------------------------
+//! Set the number of resolver threads. Threads are started when a lookup
+//! needs them so that the object may be configured before the process
+//! daemonizes. The number of threads is never reduced.
+//!
+//! @param  tnum   the total number of threads that should be running.
+//------------------------------------------------------------------------------
+
+void   SetThreads(int tnum);
+
+//------------------------------------------------------------------------------
+//! Process lookup requests (used internally by resolver threads).
+//------------------------------------------------------------------------------
+
+void   Worker();
+
+//------------------------------------------------------------------------------
+//! Constructor.
+//!
+//! @param  cP     pointer to the cache to receive results.
+//! @param  tnum   the number of resolver threads to use.
+//! @param  msec   the maximum wait time as described under SetWait().
+//! @param  lFunc  lookup function, the default uses getnameinfo().
+//------------------------------------------------------------------------------
+
+       XrdNetResolver(XrdNetCache *cP, int tnum=4, int msec=-1,
+                      LookupFunc lFunc=0);
+
+//------------------------------------------------------------------------------
+//! Destructor. The XrdNetResolver object is not designed to be deleted as
+//! its threads keep running.
+//------------------------------------------------------------------------------
+
+      ~XrdNetResolver() {} // Never gets deleted
+
+private:
+
+struct aQuery
+      {aQuery        *Next;
+       XrdNetAddr     Addr;
+       std::string    Key;
+       char           hName[NI_MAXHOST];
+       int            rc;
+       int            refs;
+       bool           done;
+
+                      aQuery(XrdNetAddrInfo &hAddr, const std::string &key)
+                            : Next(0), Addr(hAddr.SockAddr()), Key(key), rc(0),
+                              refs(1), done(false) {*hName = 0;}
+      };
+
+static int     DoLookup(const struct sockaddr *sAddr, SOCKLEN_t sLen,
+                        char *hBuff, int hBLen);
+void           Done(aQuery *qP, int rc, const char *hName);
+static bool    GenKey(XrdNetAddrInfo &hAddr, std::string &key);
+void           StartThreads();
+
+XrdSysCondVar  qCond;   // Protects everything below and signals completions
+XrdSysSemaphore qSem;
+std::map<std::string, aQuery *> inFlight;
+aQuery        *qFirst;
+aQuery        *qLast;
+XrdNetCache   *dnsCache;
+LookupFunc     lookUp;
+int            maxWait;
+int            numThreads;
+int            wantThreads;
+};
+#endif
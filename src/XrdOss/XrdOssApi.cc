@@ -44,6 +44,7 @@
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/param.h>
 #ifdef __solaris__
 #include <sys/vnode.h>
@@ -864,7 +865,9 @@ int XrdOssFile::Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &Env)
        if (!retc && !(buf.st_mode & S_IFREG))
           {close(fd); fd = (buf.st_mode & S_IFDIR ? -EISDIR : -ENOTBLK);}
        if ((Oflag & O_ACCMODE) != O_RDONLY)
-          {FSize = buf.st_size; cacheP = XrdOssCache::Find(local_path);}
+          {FSize = buf.st_size; cacheP = XrdOssCache::Find(local_path);
+           if (cacheP && fd >= 0) cacheP->fsdata->wrOpen++;
+          }
           else {if (buf.st_mode & XRDSFS_POSCPEND && fd >= 0)
                    {close(fd); fd=-ETXTBSY;}
                 FSize = -1; cacheP = 0;
@@ -919,6 +922,7 @@ int XrdOssFile::Close(long long *retsz)
         if (cacheP && FSize != buf.st_size)
            XrdOssCache::Adjust(cacheP, buf.st_size - FSize);
         if (retsz) *retsz = buf.st_size;
+        if (cacheP) {cacheP->fsdata->wrOpen--; cacheP = 0;}
        }
     if (close(fd)) return -errno;
     if (mmFile) {XrdOssMio::Recycle(mmFile); mmFile = 0;}
@@ -1127,13 +1131,76 @@ ssize_t XrdOssFile::Write(const void *buff, off_t offset, size_t blen)
      if (XrdOssSS->MaxSize && (long long)(offset+blen) > XrdOssSS->MaxSize)
         return (ssize_t)-XRDOSS_E8007;
 
-     do { retval = pwrite(fd, buff, blen, offset); }
-          while(retval < 0 && errno == EINTR);
+     if (cacheP)
+        {long long tBeg = cacheP->fsdata->WriteBeg();
+         do { retval = pwrite(fd, buff, blen, offset); }
+              while(retval < 0 && errno == EINTR);
+         cacheP->fsdata->WriteEnd(tBeg);
+        } else {
+         do { retval = pwrite(fd, buff, blen, offset); }
+              while(retval < 0 && errno == EINTR);
+        }
 
      if (retval < 0) retval = (retval == EBADF && cxobj ? -XRDOSS_E8022 : -errno);
      return retval;
 }
 
+/******************************************************************************/
+/*                                W r i t e V                                 */
+/******************************************************************************/
+
+/*
+  Function: Write the elements of 'writeV' to the associated file. Elements
+            that continue where the previous one ended are written with a
+            single pwritev() call.
+
+  Input:    writeV    - Vector of offset, length and buffer to write.
+            n         - Number of elements in writeV.
+
+  Output:   Returns the number of bytes written upon success and -errno o/w.
+*/
+
+ssize_t XrdOssFile::WriteV(XrdOucIOVec *writeV, int n)
+{
+#if defined(__linux__) || defined(__FreeBSD__)
+     static const int maxIOV = 64;
+     struct iovec iov[maxIOV];
+     ssize_t retval, totBytes = 0;
+     long long offset, runBytes, tBeg;
+     int i = 0, k;
+
+     if (fd < 0) return (ssize_t)-XRDOSS_E8004;
+
+// Collect a run of adjacent elements and write it out in one go
+//
+     while(i < n)
+          {offset = writeV[i].offset; runBytes = 0; k = 0;
+           do {iov[k].iov_base = writeV[i+k].data;
+               iov[k].iov_len  = writeV[i+k].size;
+               runBytes += writeV[i+k].size;
+               k++;
+              } while(i+k < n && k < maxIOV
+                   && writeV[i+k].offset == offset + runBytes);
+
+           if (XrdOssSS->MaxSize && offset + runBytes > XrdOssSS->MaxSize)
+              return (ssize_t)-XRDOSS_E8007;
+
+           tBeg = (cacheP ? cacheP->fsdata->WriteBeg() : 0);
+           do { retval = pwritev(fd, iov, k, offset); }
+                while(retval < 0 && errno == EINTR);
+           if (cacheP) cacheP->fsdata->WriteEnd(tBeg);
+
+           if (retval < 0) return (errno == EBADF && cxobj ? -XRDOSS_E8022 : -errno);
+           if (retval != runBytes) return -ESPIPE;
+           totBytes += retval;
+           i += k;
+          }
+     return totBytes;
+#else
+     return XrdOssDF::WriteV(writeV, n);
+#endif
+}
+
 /******************************************************************************/
 /*                                F c h m o d                                 */
 /******************************************************************************/
@@ -117,6 +117,7 @@ ssize_t ReadV(XrdOucIOVec *readV, int);
 ssize_t ReadRaw(    void *, off_t, size_t);
 ssize_t Write(const void *, off_t, size_t);
 int     Write(XrdSfsAio *aiop);
+ssize_t WriteV(XrdOucIOVec *writeV, int);
  
         // Constructor and destructor
         XrdOssFile(const char *tid, int fdnum=-1)
@@ -297,6 +298,7 @@ protected:
 long long minalloc;          //    Minimum allocation
 int       ovhalloc;          //    Allocation overage
 int       fuzalloc;          //    Allocation fuzz
+int       ldalloc;           //    Allocation load weight
 int       cscanint;          //    Seconds between cache scans
 int       xfrspeed;          //    Average transfer speed (bytes/second)
 int       xfrovhd;           //    Minimum seconds to get a file
@@ -77,6 +77,7 @@ XrdOssCache_FS     *XrdOssCache::fsfirst = 0;
 XrdOssCache_FS     *XrdOssCache::fslast  = 0;
 XrdOssCache_FSData *XrdOssCache::fsdata  = 0;
 double              XrdOssCache::fuzAlloc= 0.0;
+double              XrdOssCache::ldAlloc = 0.0;
 long long           XrdOssCache::minAlloc= 0;
 int                 XrdOssCache::fsCount = 0;
 int                 XrdOssCache::ovhAlloc= 0;
@@ -121,6 +122,9 @@ XrdOssCache_FSData::XrdOssCache_FSData(const char *fsp,
      updt = time(0);
      next = 0;
      stat = 0;
+     wrOpen = 0;
+     wrBusy = 0;
+     wrLatc = 0;
 
 // This is created only for new partitions!
 //
@@ -137,6 +141,53 @@ XrdOssCache_FSData::XrdOssCache_FSData(const char *fsp,
         }
 }
   
+/******************************************************************************/
+
+double XrdOssCache_FSData::Load()
+{
+   static const int minLatc = 100; // Latency assumed until writes are seen
+   int latc = wrLatc.load(std::memory_order_relaxed);
+   int ahead= wrBusy.load(std::memory_order_relaxed)
+            + wrOpen.load(std::memory_order_relaxed);
+
+// A new file will have to share the partition with the writers already there.
+// So, the load is the expected time to get a write done.
+//
+   if (latc < minLatc) latc = minLatc;
+   return static_cast<double>(ahead + 1) * static_cast<double>(latc);
+}
+
+/******************************************************************************/
+
+long long XrdOssCache_FSData::WriteBeg()
+{
+   struct timespec ts;
+
+   wrBusy.fetch_add(1, std::memory_order_relaxed);
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<long long>(ts.tv_sec)*1000000LL + ts.tv_nsec/1000;
+}
+
+/******************************************************************************/
+
+void XrdOssCache_FSData::WriteEnd(long long tBeg)
+{
+   struct timespec ts;
+   long long usec;
+   int avg;
+
+// Fold the latency of this write into the moving average (1/8 weight). Should
+// two writes finish together one of them may be lost, which is harmless.
+//
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   usec = static_cast<long long>(ts.tv_sec)*1000000LL + ts.tv_nsec/1000 - tBeg;
+   if (usec > 0x7fffffff) usec = 0x7fffffff;
+   avg = wrLatc.load(std::memory_order_relaxed);
+   wrLatc.store(avg + (static_cast<int>(usec) - avg)/8,
+                std::memory_order_relaxed);
+   wrBusy.fetch_sub(1, std::memory_order_relaxed);
+}
+  
 /******************************************************************************/
 /*            X r d O s s C a c h e _ F S   C o n s t r u c t o r             */
 /******************************************************************************/
@@ -493,8 +544,7 @@ int XrdOssCache::Alloc(XrdOssCache::allocInfo &aInfo)
 {
    EPNAME("Alloc");
    static const mode_t theMode = S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH;
-   XrdSysMutexHelper myMutex(&Mutex);
-   double diffree;
+   double diffree, curval, maxval, minLoad = 0.0;
    XrdOssPath::fnInfo Info;
    XrdOssCache_FS *fsp, *fspend, *fsp_sel;
    XrdOssCache_Group *cgp = 0;
@@ -507,39 +557,73 @@ int XrdOssCache::Alloc(XrdOssCache::allocInfo &aInfo)
    ||  (size=aInfo.cgSize*ovhAlloc/100+aInfo.cgSize) < minAlloc)
       aInfo.cgSize = size = minAlloc;
 
+// A partition is eligible if it is in the right space group, matches any
+// requested path, and has enough free space.
+//
+   auto Eligible = [&](XrdOssCache_FS *fsp) -> bool
+        {return !strcmp(aInfo.cgName, fsp->group)
+             && !(aInfo.cgPath && (aInfo.cgPlen > fsp->plen
+                               ||  strncmp(aInfo.cgPath,fsp->path,aInfo.cgPlen)))
+             && size <= fsp->fsdata->frsz;
+        };
+
 // Find the corresponding cache group
 //
+   Mutex.Lock();
    cgp = XrdOssCache_Group::fsgroups;
    while(cgp && strcmp(aInfo.cgName, cgp->group)) cgp = cgp->next;
-   if (!cgp) return -ENOENT;
+   if (!cgp) {Mutex.UnLock(); return -ENOENT;}
+
+// When load is to be considered we need the largest free space and the least
+// load of the eligible partitions to put both on the same scale. The load is
+// maintained by the I/O path and is read without any locks.
+//
+   maxfree = 1;
+   if (ldAlloc > 0.0)
+      {fsp = cgp->curr->next; fspend = fsp;
+       do {if (!Eligible(fsp)) continue;
+           if (fsp->fsdata->frsz > maxfree) maxfree = fsp->fsdata->frsz;
+           curval = fsp->fsdata->Load();
+           if (!minLoad || curval < minLoad) minLoad = curval;
+          } while((fsp = fsp->next) != fspend);
+      }
 
 // Find a cache that will fit this allocation request. We start with the next
 // entry past the last one we selected and go full round looking for a
-// compatable entry (enough space and in the right space group).
+// compatable entry (enough space and in the right space group). The value of
+// an entry is its free space or, when load is considered, a blend of its
+// relative free space and relative idleness weighted by ldAlloc.
 //
-   fsp_sel = 0; maxfree = 0;
+   fsp_sel = 0; maxval = 0.0;
    fsp = cgp->curr->next; fspend = fsp; // End when we hit the start again
    do {
-       if (strcmp(aInfo.cgName, fsp->group)
-       || (aInfo.cgPath && (aInfo.cgPlen > fsp->plen
-                        ||  strncmp(aInfo.cgPath,fsp->path,aInfo.cgPlen)))) continue;
+       if (!Eligible(fsp)) continue;
        curfree = fsp->fsdata->frsz;
-       if (size > curfree) continue;
+       if (ldAlloc <= 0.0) curval = static_cast<double>(curfree);
+          else curval = (1.0 - ldAlloc) * static_cast<double>(curfree)
+                                        / static_cast<double>(maxfree)
+                      +        ldAlloc  * minLoad / fsp->fsdata->Load();
 
              if (fuzAlloc > 0.999) {fsp_sel = fsp; break;}
        else  if (!fuzAlloc || !fsp_sel)
-                {if (curfree > maxfree) {fsp_sel = fsp; maxfree = curfree;}}
-       else {diffree = (!(curfree + maxfree) ? 0.0
-                     : static_cast<double>(XRDABS(maxfree - curfree)) /
-                       static_cast<double>(       maxfree + curfree));
-             if (diffree > fuzAlloc) {fsp_sel = fsp; maxfree = curfree;}
+                {if (curval > maxval) {fsp_sel = fsp; maxval = curval;}}
+       else {diffree = (!(curval + maxval) ? 0.0
+                     : XRDABS(maxval - curval) / (maxval + curval));
+             if (diffree > fuzAlloc) {fsp_sel = fsp; maxval = curval;}
             }
       } while((fsp = fsp->next) != fspend);
 
-// Check if we can realy fit this file. If so, update current scan pointer
+// Check if we can realy fit this file. If so, update current scan pointer and
+// temporarily adjust down the free space. The file is created without the lock.
 //
-   if (!fsp_sel) return -ENOSPC;
+   if (!fsp_sel) {Mutex.UnLock(); return -ENOSPC;}
    cgp->curr = fsp_sel;
+   DEBUG("free=" <<fsp_sel->fsdata->frsz <<'-' <<size <<" load="
+                 <<(ldAlloc > 0.0 ? fsp_sel->fsdata->Load() : 0.0)
+                 <<" path=" <<fsp_sel->fsdata->path);
+   fsp_sel->fsdata->frsz -= size;
+   fsp_sel->fsdata->stat |= XrdOssFSData_REFRESH;
+   Mutex.UnLock();
 
 // Construct the target filename
 //
@@ -551,27 +635,34 @@ int XrdOssCache::Alloc(XrdOssCache::allocInfo &aInfo)
 
 // Verify that target name was constructed
 //
-   if (!(*aInfo.cgPFbf)) return -ENAMETOOLONG;
+   if (!(*aInfo.cgPFbf)) datfd = -ENAMETOOLONG;
 
-// Simply open the file in the local filesystem, creating it if need be.
+// Simply open the file in the local filesystem, creating it if need be. As
+// others may be creating the same directory, it existing is not an error.
 //
-   if (aInfo.aMode)
+   else if (aInfo.aMode)
       {madeDir = 0;
        do {do {datfd = open(aInfo.cgPFbf,O_CREAT|O_TRUNC|O_WRONLY,aInfo.aMode);}
                while(datfd < 0 && errno == EINTR);
            if (datfd >= 0 || errno != ENOENT || madeDir) break;
            *Info.Slash='\0'; rc=mkdir(aInfo.cgPFbf,theMode); *Info.Slash='/';
+           if (rc && errno == EEXIST) rc = 0;
            madeDir = 1;
           } while(!rc);
-       if (datfd < 0) return (errno ? -errno : -EFAULT);
+       if (datfd < 0) datfd = (errno ? -errno : -EFAULT);
       }
 
-// All done (temporarily adjust down the free space)x
+// Return the space should we have failed
+//
+   if (datfd < 0)
+      {Mutex.Lock();
+       fsp_sel->fsdata->frsz += size;
+       Mutex.UnLock();
+       return datfd;
+      }
+
+// All done
 //
-   DEBUG("free=" <<fsp_sel->fsdata->frsz <<'-' <<size <<" path=" 
-                 <<fsp_sel->fsdata->path);
-   fsp_sel->fsdata->frsz -= size;
-   fsp_sel->fsdata->stat |= XrdOssFSData_REFRESH;
    aInfo.cgFSp  = fsp_sel;
    return datfd;
 }
@@ -665,13 +756,14 @@ int XrdOssCache::Init(const char *UPath, const char *Qfile, int isSOL, int us)
 
 /******************************************************************************/
 
-int XrdOssCache::Init(long long aMin, int ovhd, int aFuzz)
+int XrdOssCache::Init(long long aMin, int ovhd, int aFuzz, int aLoad)
 {
 // Set values
 //
    minAlloc = aMin;
    ovhAlloc = ovhd;
    fuzAlloc = static_cast<double>(aFuzz)/100.0;
+   ldAlloc  = static_cast<double>(aLoad)/100.0;
    return 0;
 }
 
@@ -30,6 +30,7 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <atomic>
 #include <ctime>
 #include <sys/stat.h>
 #include "XrdOuc/XrdOucDLlist.hh"
@@ -119,6 +120,17 @@ int                 stat;
 unsigned short      bdevID;
 unsigned short      partID;
 
+// The following track the write load on the partition. They are updated and
+// read without holding XrdOssCache::Mutex.
+//
+std::atomic<int>    wrOpen;  // Number of files open for writing
+std::atomic<int>    wrBusy;  // Number of writes in progress
+std::atomic<int>    wrLatc;  // Average write latency in microseconds
+
+       double       Load();
+       long long    WriteBeg();
+       void         WriteEnd(long long tBeg);
+
        XrdOssCache_FSData(const char *, STATFS_t &, dev_t);
       ~XrdOssCache_FSData() {if (path) free((void *)path);}
 };
@@ -246,7 +258,7 @@ static XrdOssCache_FS *Find(const char *Path, int lklen=0);
 static int             Init(const char *UDir, const char *Qfile,
                             int isSOL, int usync=0);
 
-static int             Init(long long aMin, int ovhd, int aFuzz);
+static int             Init(long long aMin, int ovhd, int aFuzz, int aLoad=0);
 
 static void            List(const char *lname, XrdSysError &Eroute);
 
@@ -276,6 +288,7 @@ static bool MapDM(const char *ldm, char *buff, int blen);
 
 static long long           minAlloc;
 static double              fuzAlloc;
+static double              ldAlloc;
 static int                 ovhAlloc;
 static int                 Quotas;
 static int                 Usage;
@@ -222,6 +222,7 @@ XrdOssSys::XrdOssSys()
    minalloc      = 0;
    ovhalloc      = 0;
    fuzalloc      = 0;
+   ldalloc       = 0;
    xfrspeed      = 9*1024*1024;
    xfrovhd       = 30;
    xfrhold       =  3*60*60;
@@ -372,7 +373,7 @@ int XrdOssSys::Configure(const char *configfn, XrdSysError &Eroute,
    if (m1 || m2) Eroute.Say("++++++ Configuring ", m1, m2, "mode . . .");
   }
    NoGo |= XrdOssCache::Init(UDir, QFile, Solitary, USync)
-          |XrdOssCache::Init(minalloc, ovhalloc, fuzalloc);
+          |XrdOssCache::Init(minalloc, ovhalloc, fuzalloc, ldalloc);
 
 // Configure the MSS interface including staging
 //
@@ -472,7 +473,7 @@ void XrdOssSys::Config_Display(XrdSysError &Eroute)
         else cloc = ConfigFN;
 
      snprintf(buff, sizeof(buff), "Config effective %s oss configuration:\n"
-                                  "       oss.alloc        %lld %d %d\n"
+                                  "       oss.alloc        %lld %d %d load %d\n"
                                   "       oss.spacescan    %d\n"
                                   "       oss.fdlimit      %d %d\n"
                                   "       oss.maxsize      %lld\n"
@@ -485,7 +486,7 @@ void XrdOssSys::Config_Display(XrdSysError &Eroute)
                                   "       oss.trace        %x\n"
                                   "       oss.xfr          %d deny %d keep %d",
              cloc,
-             minalloc, ovhalloc, fuzalloc,
+             minalloc, ovhalloc, fuzalloc, ldalloc,
              cscanint,
              FDFence, FDLimit, MaxSize,
              XrdOssConfig_Val(N2N_Lib,    namelib),
@@ -1181,6 +1182,7 @@ int XrdOssSys::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute)
 /* Function: aalloc
 
    Purpose:  To parse the directive: alloc <min> [<headroom> [<fuzz>]]
+                                               [load <weight>]
 
              <min>       minimum amount of free space needed in a partition.
                          (asterisk uses default).
@@ -1190,6 +1192,10 @@ int XrdOssSys::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute)
                          quantities that may be ignored when selecting a space
                            0 - reduces to finding the largest free space
                          100 - reduces to simple round-robin allocation
+             <weight>    the percentage of the selection based on the write
+                         load of each partition (files open for writing,
+                         writes in progress, and write latency) as opposed
+                         to the free space. The default is 0 (load ignored).
 
    Output: 0 upon success or !0 upon failure.
 */
@@ -1200,25 +1206,42 @@ int XrdOssSys::xalloc(XrdOucStream &Config, XrdSysError &Eroute)
     long long mina = 0;
     int       fuzz = 0;
     int       hdrm = 0;
+    int       ldwt = 0;
 
     if (!(val = Config.GetWord()))
        {Eroute.Emsg("Config", "alloc minfree not specified"); return 1;}
     if (strcmp(val, "*") &&
         XrdOuca2x::a2sz(Eroute, "alloc minfree", val, &mina, 0)) return 1;
 
-    if ((val = Config.GetWord()))
+    if ((val = Config.GetWord()) && strcmp(val, "load"))
        {if (strcmp(val, "*") &&
             XrdOuca2x::a2i(Eroute,"alloc headroom",val,&hdrm,0,100)) return 1;
 
-        if ((val = Config.GetWord()))
+        if ((val = Config.GetWord()) && strcmp(val, "load"))
            {if (strcmp(val, "*") &&
             XrdOuca2x::a2i(Eroute, "alloc fuzz", val, &fuzz, 0, 100)) return 1;
+            val = Config.GetWord();
            }
        }
 
+// Anything else after the fuzz has always been ignored, so keep doing that
+//
+    if (val && strcmp(val, "load"))
+       {Eroute.Say("Config warning: ignoring extraneous alloc option '",
+                   val, "'.");
+        val = 0;
+       }
+
+    if (val)
+       {if (!(val = Config.GetWord()))
+           {Eroute.Emsg("Config", "alloc load weight not specified"); return 1;}
+        if (XrdOuca2x::a2i(Eroute, "alloc load", val, &ldwt, 0, 100)) return 1;
+       }
+
     minalloc = mina;
     ovhalloc = hdrm;
     fuzalloc = fuzz;
+    ldalloc  = ldwt;
     return 0;
 }
 
@@ -37,6 +37,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 
+#include <cstdlib>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -86,6 +87,21 @@ int XrdOssCsiConfig::Init(XrdSysError &Eroute, const char *config_fn, const char
       {
          disableLooseWrite_ = true;
       }
+      else if (item == "tagcache" && !value.empty())
+      {
+         char *eP;
+         const unsigned long nb = strtoul(value.c_str(), &eP, 10);
+         if (*eP || value[0] == '-')
+         {
+            Eroute.Emsg("Config", "invalid tagcache value", value.c_str());
+            NoGo = 1;
+         }
+         else tagCacheBlocks_ = nb;
+      }
+      else if (item == "tagwriteback")
+      {
+         tagWriteBack_ = true;
+      }
    }
 
    if (NoGo) return NoGo;
@@ -99,6 +115,8 @@ int XrdOssCsiConfig::Init(XrdSysError &Eroute, const char *config_fn, const char
    Eroute.Say("       allow files without CRCs: ", allowMissingTags_ ? "yes" : "no");
    Eroute.Say("       pgWrite can extend      : ", disablePgExtend_ ? "no" : "yes");
    Eroute.Say("       loose writes            : ", disableLooseWrite_ ? "no" : "yes");
+   Eroute.Say("       tag cache blocks        : ", std::to_string((unsigned long long)tagCacheBlocks_).c_str());
+   Eroute.Say("       tag write-back          : ", (tagCacheBlocks_ && tagWriteBack_) ? "yes" : "no");
    Eroute.Say("       trace level             : ", std::to_string((long long int)OssCsiTrace.What).c_str());
    Eroute.Say("       prefix                  : ", tagParam_.prefix_.empty() ? "[empty]" : tagParam_.prefix_.c_str());
 
@@ -188,7 +188,7 @@ class XrdOssCsiConfig
 {
 public:
 
-  XrdOssCsiConfig() : fillFileHole_(true), xrdtSpaceName_("public"), allowMissingTags_(true), disablePgExtend_(false), disableLooseWrite_(false) { }
+  XrdOssCsiConfig() : fillFileHole_(true), xrdtSpaceName_("public"), allowMissingTags_(true), disablePgExtend_(false), disableLooseWrite_(false), tagCacheBlocks_(0), tagWriteBack_(false) { }
   ~XrdOssCsiConfig() { }
 
   int Init(XrdSysError &, const char *, const char *, XrdOucEnv *);
@@ -203,6 +203,10 @@ public:
 
   bool disableLooseWrite() const { return disableLooseWrite_; }
 
+  size_t tagCacheBlocks() const { return tagCacheBlocks_; }
+
+  bool tagWriteBack() const { return tagWriteBack_; }
+
   TagPath tagParam_;
 
 private:
@@ -217,6 +221,8 @@ private:
   bool allowMissingTags_;
   bool disablePgExtend_;
   bool disableLooseWrite_;
+  size_t tagCacheBlocks_;
+  bool tagWriteBack_;
 };
 
 #endif
@@ -36,6 +36,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+
 extern XrdOucTrace  OssCsiTrace;
 
 int XrdOssCsiTagstoreFile::Open(const char *path, const off_t dsize, const int Oflag, XrdOucEnv &Env)
@@ -48,6 +50,9 @@ int XrdOssCsiTagstoreFile::Open(const char *path, const off_t dsize, const int O
       return ret;
    }
    isOpen = true;
+   cache_.clear();
+   lru_.clear();
+   hdirty_ = false;
 
    struct guard_s
    {
@@ -134,11 +139,18 @@ int XrdOssCsiTagstoreFile::ResetSizes(const off_t size)
 {
    EPNAME("ResetSizes");
    if (!isOpen) return -EBADF;
+
+   // sizes are checked against the tag file itself so first write out and
+   // drop anything cached
+   const int fret = FlushTags(true);
+   if (fret<0) return fret;
+
    actualsize_ = size;
    struct stat sb;
    const int ssret = fd_->Fstat(&sb);
    if (ssret<0) return ssret;
    const off_t expected_tagfile_size = 20LL + 4*((trackinglen_+XrdSys::PageSize-1)/XrdSys::PageSize);
+   off_t tagfile_size = sb.st_size;
    // truncate can be relatively slow
    if (expected_tagfile_size < sb.st_size)
    {
@@ -146,6 +158,7 @@ int XrdOssCsiTagstoreFile::ResetSizes(const off_t size)
          ", from current size " << sb.st_size << " for " << fn_);
       const int tret = fd_->Ftruncate(expected_tagfile_size);
       if (tret<0) return tret;
+      tagfile_size = expected_tagfile_size;
    }
    else if (expected_tagfile_size > sb.st_size)
    {
@@ -157,32 +170,65 @@ int XrdOssCsiTagstoreFile::ResetSizes(const off_t size)
       if (stret<0) return stret;
       const int tret = fd_->Ftruncate(20LL + 4*nb);
       if (tret<0) return tret;
+      tagfile_size = 20LL + 4*nb;
    }
+   tagsOnDisk_ = tagsLogical_ = (tagfile_size > 20) ? (tagfile_size - 20)/4 : 0;
    return 0;
 }
 
 int XrdOssCsiTagstoreFile::Fsync()
 {
    if (!isOpen) return -EBADF;
+   const int fret = FlushTags(false);
+   const int ferr = FlushError();
+   if (fret<0) return fret;
+   if (ferr<0) return ferr;
    return fd_->Fsync();
 }
 
 void XrdOssCsiTagstoreFile::Flush()
 {
+   EPNAME("TagstoreFile::Flush");
    if (!isOpen) return;
+
+   // Flush can not return an error, so remember it for the next Fsync or Close
+   const int fret = FlushTags(false);
+   if (fret<0)
+   {
+      TRACE(Warn, "Unable to write tags for " << fn_ << " error " << fret);
+      std::lock_guard<std::mutex> guard(cmtx_);
+      flushErr_ = fret;
+   }
    fd_->Flush();
 }
 
 int XrdOssCsiTagstoreFile::Close()
 {
    if (!isOpen) return -EBADF;
+   const int fret = FlushTags(true);
+   const int ferr = FlushError();
    isOpen = false;
-   return fd_->Close();
+   const int cret = fd_->Close();
+   if (fret<0) return fret;
+   return (ferr<0) ? ferr : cret;
 }
 
 ssize_t XrdOssCsiTagstoreFile::WriteTags(const uint32_t *const buf, const off_t off, const size_t n)
 {
    if (!isOpen) return -EBADF;
+   if (cacheMax_) return WriteTagsCached(buf, off, n);
+   return WriteTagsFile(buf, off, n);
+}
+
+ssize_t XrdOssCsiTagstoreFile::ReadTags(uint32_t *const buf, const off_t off, const size_t n)
+{
+   if (!isOpen) return -EBADF;
+   if (cacheMax_) return ReadTagsCached(buf, off, n);
+   return ReadTagsFile(buf, off, n);
+}
+
+ssize_t XrdOssCsiTagstoreFile::WriteTagsFile(const uint32_t *const buf, const off_t off, const size_t n)
+{
    if (machineIsBige_ != fileIsBige_) return WriteTags_swap(buf, off, n);
 
    const ssize_t nwritten = XrdOssCsiTagstoreFile::fullwrite(*fd_, buf, 20LL+4*off, 4*n);
@@ -190,9 +236,8 @@ ssize_t XrdOssCsiTagstoreFile::WriteTags(const uint32_t *const buf, const off_t
    return nwritten/4;
 }
 
-ssize_t XrdOssCsiTagstoreFile::ReadTags(uint32_t *const buf, const off_t off, const size_t n)
+ssize_t XrdOssCsiTagstoreFile::ReadTagsFile(uint32_t *const buf, const off_t off, const size_t n)
 {
-   if (!isOpen) return -EBADF;
    if (machineIsBige_ != fileIsBige_) return ReadTags_swap(buf, off, n);
 
    const ssize_t nread = XrdOssCsiTagstoreFile::fullread(*fd_, buf, 20LL+4*off, 4*n);
@@ -207,13 +252,24 @@ int XrdOssCsiTagstoreFile::Truncate(const off_t size, bool datatoo)
       return -EBADF;
    }
 
+   // discard cached tags past the new length and write out the remainder
+   const off_t ntags = (size+XrdSys::PageSize-1)/XrdSys::PageSize;
+   TrimCache(ntags);
+   const int fret = FlushTags(false);
+   if (fret<0) return fret;
+
    // set tag file to correct length for value of size
-   const off_t expected_tagfile_size = 20LL + 4*((size+XrdSys::PageSize-1)/XrdSys::PageSize);
+   const off_t expected_tagfile_size = 20LL + 4*ntags;
    const int tret = fd_->Ftruncate(expected_tagfile_size);
 
    // if failed to set the tagfile length return error before updating header
    if (tret != XrdOssOK) return tret;
 
+   {
+      std::lock_guard<std::mutex> guard(cmtx_);
+      tagsOnDisk_ = tagsLogical_ = ntags;
+   }
+
    // truncating down to zero, so reset to content verified
    if (datatoo && size==0) hflags_ |= XrdOssCsiTagstore::csVer;
 
@@ -265,3 +321,200 @@ ssize_t XrdOssCsiTagstoreFile::ReadTags_swap(uint32_t *const buf, const off_t of
    }
    return n;
 }
+
+/******************************************************************************/
+/*                             T a g   C a c h e                              */
+/******************************************************************************/
+
+ssize_t XrdOssCsiTagstoreFile::WriteTagsCached(const uint32_t *const buf, const off_t off, const size_t n)
+{
+   std::lock_guard<std::mutex> guard(cmtx_);
+
+   // write-through: update the file and then any blocks which are cached
+   if (!writeBack_)
+   {
+      const ssize_t wret = WriteTagsFile(buf, off, n);
+      if (wret<0) return wret;
+      tagsOnDisk_ = std::max(tagsOnDisk_, (off_t)(off+n));
+   }
+
+   size_t done = 0;
+   while(done<n)
+   {
+      const off_t idx = (off+done)/tbsize_;
+      const size_t bo = (off+done)%tbsize_;
+      const size_t cnt = std::min(n-done, tbsize_-bo);
+      TagBlock *blk = nullptr;
+      if (writeBack_)
+      {
+         // a block which is to be entirely overwritten need not be read first
+         const int gret = GetBlock(idx, !(bo==0 && cnt==tbsize_), blk);
+         if (gret<0) return gret;
+         if (blk->dlo >= blk->dhi)
+         {
+            blk->dlo = bo;
+            blk->dhi = bo+cnt;
+         }
+         else
+         {
+            blk->dlo = std::min(blk->dlo, bo);
+            blk->dhi = std::max(blk->dhi, bo+cnt);
+         }
+      }
+      else
+      {
+         auto it = cache_.find(idx);
+         if (it != cache_.end()) blk = &it->second;
+      }
+      if (blk) memcpy(&blk->tags[bo], &buf[done], 4*cnt);
+      done += cnt;
+   }
+
+   tagsLogical_ = std::max(tagsLogical_, (off_t)(off+n));
+   return n;
+}
+
+ssize_t XrdOssCsiTagstoreFile::ReadTagsCached(uint32_t *const buf, const off_t off, const size_t n)
+{
+   std::lock_guard<std::mutex> guard(cmtx_);
+
+   // as for a short read of the tag file
+   if (off+(off_t)n > tagsLogical_) return -EDOM;
+
+   size_t done = 0;
+   while(done<n)
+   {
+      const off_t idx = (off+done)/tbsize_;
+      const size_t bo = (off+done)%tbsize_;
+      const size_t cnt = std::min(n-done, tbsize_-bo);
+      TagBlock *blk;
+      const int gret = GetBlock(idx, true, blk);
+      if (gret<0) return gret;
+      memcpy(&buf[done], &blk->tags[bo], 4*cnt);
+      done += cnt;
+   }
+   return n;
+}
+
+// Find or insert the block with index idx, evicting (and if needed writing)
+// the least recently used block if the cache is full. Called with cmtx_ held.
+int XrdOssCsiTagstoreFile::GetBlock(const off_t idx, const bool load, TagBlock *&blk)
+{
+   auto it = cache_.find(idx);
+   if (it != cache_.end())
+   {
+      lru_.splice(lru_.begin(), lru_, it->second.lru);
+      blk = &it->second;
+      return 0;
+   }
+
+   while(!lru_.empty() && cache_.size() >= cacheMax_)
+   {
+      auto vit = cache_.find(lru_.back());
+      if (vit->second.dlo < vit->second.dhi)
+      {
+         const int wret = WriteBlock(vit->first, vit->second);
+         if (wret<0) return wret;
+      }
+      cache_.erase(vit);
+      lru_.pop_back();
+   }
+
+   TagBlock nb;
+   nb.tags.assign(tbsize_, 0);
+   nb.dlo = nb.dhi = 0;
+   const off_t start = idx*tbsize_;
+   if (load && tagsOnDisk_ > start)
+   {
+      const size_t nread = std::min((off_t)tbsize_, tagsOnDisk_-start);
+      const ssize_t rret = ReadTagsFile(nb.tags.data(), start, nread);
+      if (rret<0) return rret;
+   }
+
+   lru_.push_front(idx);
+   nb.lru = lru_.begin();
+   blk = &cache_.insert(std::make_pair(idx, std::move(nb))).first->second;
+   return 0;
+}
+
+// Write the dirty range of a block. Called with cmtx_ held.
+int XrdOssCsiTagstoreFile::WriteBlock(const off_t idx, TagBlock &blk)
+{
+   const off_t start = idx*tbsize_ + blk.dlo;
+   const ssize_t wret = WriteTagsFile(&blk.tags[blk.dlo], start, blk.dhi-blk.dlo);
+   if (wret<0) return wret;
+   tagsOnDisk_ = std::max(tagsOnDisk_, (off_t)(start+blk.dhi-blk.dlo));
+   blk.dlo = blk.dhi = 0;
+   return 0;
+}
+
+// Write any dirty tags, in file order, followed by the header if it is dirty.
+// Optionally drop all the cached blocks.
+int XrdOssCsiTagstoreFile::FlushTags(const bool drop)
+{
+   std::lock_guard<std::mutex> guard(cmtx_);
+
+   if (writeBack_)
+   {
+      std::vector<off_t> dirty;
+      for(auto &it : cache_)
+      {
+         if (it.second.dlo < it.second.dhi) dirty.push_back(it.first);
+      }
+      std::sort(dirty.begin(), dirty.end());
+      for(const off_t idx : dirty)
+      {
+         const int wret = WriteBlock(idx, cache_[idx]);
+         if (wret<0) return wret;
+      }
+      if (hdirty_)
+      {
+         const ssize_t wret = fullwrite(*fd_, header_, 0, 20);
+         if (wret<0) return wret;
+         hdirty_ = false;
+      }
+   }
+
+   if (drop)
+   {
+      cache_.clear();
+      lru_.clear();
+   }
+   return 0;
+}
+
+// Return and clear the error of an earlier Flush, if any.
+int XrdOssCsiTagstoreFile::FlushError()
+{
+   std::lock_guard<std::mutex> guard(cmtx_);
+   const int ferr = flushErr_;
+   flushErr_ = 0;
+   return ferr;
+}
+
+// Forget cached tags at or past index ntags. Called without cmtx_ held.
+void XrdOssCsiTagstoreFile::TrimCache(const off_t ntags)
+{
+   std::lock_guard<std::mutex> guard(cmtx_);
+
+   for(auto it = cache_.begin(); it != cache_.end(); )
+   {
+      const off_t start = it->first*tbsize_;
+      TagBlock &blk = it->second;
+      if (start >= ntags)
+      {
+         lru_.erase(blk.lru);
+         it = cache_.erase(it);
+         continue;
+      }
+      if (start+(off_t)tbsize_ > ntags)
+      {
+         const size_t keep = ntags-start;
+         std::fill(blk.tags.begin()+keep, blk.tags.end(), 0);
+         blk.dhi = std::min(blk.dhi, keep);
+         if (blk.dlo >= blk.dhi) blk.dlo = blk.dhi = 0;
+      }
+      ++it;
+   }
+   tagsLogical_ = std::min(tagsLogical_, ntags);
+}
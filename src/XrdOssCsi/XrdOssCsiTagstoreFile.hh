@@ -36,13 +36,16 @@
 #include "XrdOuc/XrdOucCRC.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 
+#include <list>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 class XrdOssCsiTagstoreFile : public XrdOssCsiTagstore
 {
 public:
-   XrdOssCsiTagstoreFile(const std::string &fn, std::unique_ptr<XrdOssDF> fd, const char *tid) : fn_(fn), fd_(std::move(fd)), trackinglen_(0), isOpen(false), tident_(tid), tident(tident_.c_str()) { }
+   XrdOssCsiTagstoreFile(const std::string &fn, std::unique_ptr<XrdOssDF> fd, const char *tid, size_t cacheblocks=0, bool writeback=false) : fn_(fn), fd_(std::move(fd)), trackinglen_(0), isOpen(false), tident_(tid), tident(tident_.c_str()), cacheMax_(cacheblocks), writeBack_(cacheblocks && writeback), hdirty_(false), flushErr_(0), tagsOnDisk_(0), tagsLogical_(0) { }
    virtual ~XrdOssCsiTagstoreFile() { if (isOpen) { (void)Close(); } }
 
    virtual int Open(const char *, off_t, int, XrdOucEnv &) /* override */;
@@ -79,7 +82,7 @@ public:
       }
       if (size != trackinglen_)
       {
-         const int wtt = WriteTrackedTagSize(size);
+         const int wtt = WriteTrackedTagSize(size, true);
          if (wtt<0) return wtt;
       }
       return 0;
@@ -146,20 +149,78 @@ private:
    uint8_t header_[20];
    uint32_t hflags_;
 
+   // Tag cache: tags are cached in blocks of tbsize_ values (one 4k page of
+   // the tag file, covering 4MB of data) with at most cacheMax_ blocks held
+   // per file, evicted in LRU order. The tagstore is shared between all handles
+   // of a file so the cache is too. Without writeBack_ updates are written
+   // through; with it modified ranges and the header are kept dirty and are
+   // written on eviction, Flush, Fsync, Truncate and Close (a failure during
+   // Flush is reported by the next Fsync or Close). Dirty tags are
+   // always written before the header so that the tracked length on disk never
+   // covers tags which have not yet been written.
+   struct TagBlock
+   {
+      std::vector<uint32_t> tags;          // in machine byte order
+      size_t dlo, dhi;                     // dirty range, empty if dlo>=dhi
+      std::list<off_t>::iterator lru;
+   };
+
+   const size_t cacheMax_;
+   const bool writeBack_;
+   std::mutex cmtx_;
+   std::unordered_map<off_t, TagBlock> cache_;
+   std::list<off_t> lru_;
+   bool hdirty_;
+   int flushErr_;                          // unreported error from Flush
+   off_t tagsOnDisk_;                      // number of tags in the file
+   off_t tagsLogical_;                     // number including unwritten ones
+
+   static const size_t tbsize_ = 1024;
+
+   ssize_t WriteTagsFile(const uint32_t *, off_t, size_t);
+   ssize_t ReadTagsFile(uint32_t *, off_t, size_t);
    ssize_t WriteTags_swap(const uint32_t *, off_t, size_t);
    ssize_t ReadTags_swap(uint32_t *, off_t, size_t);
 
-   int WriteTrackedTagSize(const off_t size)
+   ssize_t WriteTagsCached(const uint32_t *, off_t, size_t);
+   ssize_t ReadTagsCached(uint32_t *, off_t, size_t);
+   int GetBlock(off_t, bool, TagBlock *&);
+   int WriteBlock(off_t, TagBlock &);
+   int FlushTags(bool);
+   int FlushError();
+   void TrimCache(off_t);
+
+   int WriteTrackedTagSize(const off_t size, const bool defer=false)
    {
       if (!isOpen) return -EBADF;
       trackinglen_ = size;
-      return MarshallAndWriteHeader();
+      return MarshallAndWriteHeader(defer);
    }
 
-   int MarshallAndWriteHeader()
+   // with write-back the header is only marked dirty; unless deferred it is
+   // then written together with any dirty tags.
+   int MarshallAndWriteHeader(const bool defer=false)
    {
       if (!isOpen) return -EBADF;
 
+      if (writeBack_)
+      {
+         {
+            std::lock_guard<std::mutex> guard(cmtx_);
+            MarshallHeader();
+            hdirty_ = true;
+         }
+         return defer ? 0 : FlushTags(false);
+      }
+
+      MarshallHeader();
+      ssize_t wret = fullwrite(*fd_, header_, 0, 20);
+      if (wret<0) return wret;
+      return 0;
+   }
+
+   void MarshallHeader()
+   {
       uint32_t y = cmagic_;
       if (fileIsBige_ != machineIsBige_) y = bswap_32(y);
       memcpy(header_, &y, 4);
@@ -175,10 +236,6 @@ private:
       uint32_t cv = XrdOucCRC::Calc32C(header_, 16, 0U);
       if (machineIsBige_ != fileIsBige_) cv = bswap_32(cv);
       memcpy(&header_[16], &cv, 4);
-
-      ssize_t wret = fullwrite(*fd_, header_, 0, 20);
-      if (wret<0) return wret;
-      return 0;
    }
 
    static const uint32_t cmagic_ = 0x30544452U;
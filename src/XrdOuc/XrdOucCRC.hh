@@ -152,6 +152,7 @@ static bool Ver32C(const void*     data,  size_t    count,
 
 private:
 
+static const int pgBatch = 64; // Pages verified per multi-page checksum call
 static unsigned int crctable[256];
 };
 #endif
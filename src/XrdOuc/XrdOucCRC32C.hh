@@ -16,4 +16,16 @@ uint32_t crc32c(uint32_t crc, void const *buf, size_t len);
 // crc32c_sw() is the same, but does not use the hardware instruction, even if
 // available.
 uint32_t crc32c_sw(uint32_t crc, void const *buf, size_t len);
+
+// crc32c_pages() computes the CRC-32C of each of npages consecutive pages of
+// pgsz bytes starting at buf, placing the result for page i in crcs[i].  Each
+// page checksum starts with crc == 0.  Several pages are computed concurrently
+// using the crc32 hardware instruction if available.
+void crc32c_pages(void const *buf, size_t pgsz, size_t npages, uint32_t *crcs);
+
+// crc32c_combine() returns the CRC-32C of two consecutive sequences of bytes
+// given the CRC-32C of each of them and the length of the second one. This
+// allows for pieces of a buffer to be checksummed in any order.
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2);
+
 #endif
@@ -322,6 +322,8 @@ bool XrdOucPsx::Parse(char *var, XrdOucStream &Config, XrdSysError &eDest)
              preread   [minpages [minrdsz]] [perf nn [recalc]]
              r/w       enables caching for files opened read/write.
              sfiles    {on | off | .<sfx>}
+             shared    <name> use the node-local cache shared by all processes
+                       using the same name (applies to clients).
              size      size of cache in bytes  (can be suffixed with k, m, g).
 
    Output: true upon success or false upon failure.
@@ -331,7 +333,8 @@ bool XrdOucPsx::ParseCache(XrdSysError *Eroute, XrdOucStream &Config)
 {
    long long llVal, cSize=-1, m2Cache=-1, pSize=-1, minPg = -1;
    const char *ivN = 0;
-   char  *val, *sfSfx = 0, sfVal = '0', lgVal = '0', dbVal = '0', rwVal = '0';
+   char  *val, *sfSfx = 0, *shName = 0;
+   char   sfVal = '0', lgVal = '0', dbVal = '0', rwVal = '0';
    char eBuff[2048], pBuff[1024], *eP;
    struct sztab {const char *Key; long long *Val;} szopts[] =
                {{"max2cache", &m2Cache},
@@ -379,6 +382,14 @@ do{for (i = 0; i < numopts; i++) if (!strcmp(szopts[i].Key, val)) break;
                 else if (*val == '.' && strlen(val) < 16) sfSfx = strdup(val);
                 else ivN = "sfiles";
                }
+       else if (!strcmp("shared", val))
+               {if (shName) {free(shName); shName = 0;}
+                if (!(val = Config.GetWord()) || strlen(val) > 64
+                ||  strspn(val, "abcdefghijklmnopqrstuvwxyz"
+                                "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789._-")
+                    != strlen(val)) ivN = "shared";
+                   else shName = strdup(val);
+               }
        else {Eroute->Emsg("Config","invalid cache keyword -", val);
              return false;
             }
@@ -409,6 +420,8 @@ do{for (i = 0; i < numopts; i++) if (!strcmp(szopts[i].Key, val)) break;
       }
    if (rwVal != '0') strcat(eP, "&optwr=1");
    if (*pBuff)       strcat(eP, pBuff);
+   if (shName)
+      {strcat(eP, "&shmname="); strcat(eP, shName); free(shName);}
 
    mCache = strdup(eBuff);
    return true;
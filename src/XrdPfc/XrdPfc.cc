@@ -20,6 +20,9 @@
 #include <sstream>
 #include <algorithm>
 #include <sys/statvfs.h>
+#ifdef __linux__
+#include <sys/sysmacros.h>
+#endif
 
 #include "XrdCl/XrdClURL.hh"
 #include "XrdCl/XrdClFileSystem.hh"
@@ -43,6 +46,8 @@
 #include "XrdPfcTrace.hh"
 #include "XrdPfcFSctl.hh"
 #include "XrdPfcInfo.hh"
+#include "XrdPfcInfoStore.hh"
+#include "XrdPfcRamTier.hh"
 #include "XrdPfcIOFile.hh"
 #include "XrdPfcIOFileBlock.hh"
 #include "XrdPfcResourceMonitor.hh"
@@ -61,9 +66,9 @@ void *ResourceMonitorThread(void*)
    return 0;
 }
 
-void *ProcessWriteTaskThread(void*)
+void *ProcessWriteTaskThread(void* wq)
 {
-   Cache::GetInstance().ProcessWriteTasks();
+   Cache::GetInstance().ProcessWriteTasks(static_cast<Cache::WriteQ*>(wq));
    return 0;
 }
 
@@ -106,10 +111,7 @@ XrdOucCache *XrdOucGetCache(XrdSysLogger *logger,
 
       XrdSysThread::Run(&tid, ResourceMonitorThread, 0, 0, "XrdPfc ResourceMonitor");
 
-      for (int wti = 0; wti < instance.RefConfiguration().m_wqueue_threads; ++wti)
-      {
-         XrdSysThread::Run(&tid, ProcessWriteTaskThread, 0, 0, "XrdPfc WriteTasks ");
-      }
+      // Write queue threads are started per device in get_write_queue().
 
       if (instance.is_prefetch_enabled())
       {
@@ -171,10 +173,15 @@ Cache::Cache(XrdSysLogger *logger, XrdOucEnv *env) :
    m_prefetch_condVar(0),
    m_prefetch_enabled(false),
    m_RAM_used(0),
+   m_RAM_prefetch_limit(0),
+   m_RAM_prefetch_waiting(false),
+   m_RAM_condVar(0),
    m_RAM_write_queue(0),
    m_RAM_std_size(0),
    m_isClient(false),
-   m_active_cond(0)
+   m_writes_between_purges(0),
+   m_active_cond(0),
+   m_prefetch_vtime(0)
 {
    // Default log level is Warning.
    m_trace->What = 2;
@@ -226,7 +233,27 @@ XrdOucCacheIO *Cache::Attach(XrdOucCacheIO *io, int Options)
    return io;
 }
 
-void Cache::AddWriteTask(Block* b, bool fromRead)
+Cache::WriteQ* Cache::get_write_queue(dev_t dev)
+{
+   XrdSysMutexHelper lock(&m_writeQ_mutex);
+
+   std::unique_ptr<WriteQ> &wqp = m_writeQs[dev];
+   if ( ! wqp)
+   {
+      wqp.reset(new WriteQ(dev));
+      WriteQ *wq = wqp.get();
+
+      pthread_t tid;
+      for (int wti = 0; wti < m_configuration.m_wqueue_threads; ++wti)
+      {
+         XrdSysThread::Run(&tid, ProcessWriteTaskThread, wq, 0, "XrdPfc WriteTasks ");
+      }
+      TRACE(Info, "Started write queue for device " << major(dev) << ":" << minor(dev));
+   }
+   return wqp.get();
+}
+
+void Cache::AddWriteTask(Block* b)
 {
    TRACE(Dump, "AddWriteTask() offset=" <<  b->m_offset << ". file " << b->get_file()->GetLocalPath());
 
@@ -235,14 +262,21 @@ void Cache::AddWriteTask(Block* b, bool fromRead)
       m_RAM_write_queue += b->get_size();
    }
 
-   m_writeQ.condVar.Lock();
-   if (fromRead)
-      m_writeQ.queue.push_back(b);
+   WriteQ *wq = get_write_queue(b->get_file()->GetDataDevice());
+
+   b->m_wq_time = std::chrono::steady_clock::now();
+
+   // Blocks that readers still hold on to go first; the readers' RAM is
+   // then released as soon as they are done with it.
+   wq->condVar.Lock();
+   if (b->m_refcnt > 1)
+      wq->prio_queue.push_back(b);
    else
-      m_writeQ.queue.push_front(b);
-   m_writeQ.size++;
-   m_writeQ.condVar.Signal();
-   m_writeQ.condVar.UnLock();
+      wq->queue.push_back(b);
+   if (++wq->size > wq->max_size)
+      wq->max_size = wq->size;
+   wq->condVar.Signal();
+   wq->condVar.UnLock();
 }
 
 void Cache::RemoveWriteQEntriesFor(File *file)
@@ -250,25 +284,41 @@ void Cache::RemoveWriteQEntriesFor(File *file)
    std::list<Block*> removed_blocks;
    long long         sum_size = 0;
 
-   m_writeQ.condVar.Lock();
-   std::list<Block*>::iterator i = m_writeQ.queue.begin();
-   while (i != m_writeQ.queue.end())
+   WriteQ *wq = nullptr;
    {
-      if ((*i)->m_file == file)
-      {
-         TRACE(Dump, "Remove entries for " <<  (void*)(*i) << " path " <<  file->lPath());
-         std::list<Block*>::iterator j = i++;
-         removed_blocks.push_back(*j);
-         sum_size += (*j)->get_size();
-         m_writeQ.queue.erase(j);
-         --m_writeQ.size;
-      }
-      else
+      XrdSysMutexHelper lock(&m_writeQ_mutex);
+      auto it = m_writeQs.find(file->GetDataDevice());
+      if (it != m_writeQs.end())
+         wq = it->second.get();
+   }
+   if ( ! wq)
+   {
+      file->BlocksRemovedFromWriteQ(removed_blocks);
+      return;
+   }
+
+   wq->condVar.Lock();
+   for (std::list<Block*> *q : { &wq->prio_queue, &wq->queue })
+   {
+      std::list<Block*>::iterator i = q->begin();
+      while (i != q->end())
       {
-         ++i;
+         if ((*i)->m_file == file)
+         {
+            TRACE(Dump, "Remove entries for " <<  (void*)(*i) << " path " <<  file->lPath());
+            std::list<Block*>::iterator j = i++;
+            removed_blocks.push_back(*j);
+            sum_size += (*j)->get_size();
+            q->erase(j);
+            --wq->size;
+         }
+         else
+         {
+            ++i;
+         }
       }
    }
-   m_writeQ.condVar.UnLock();
+   wq->condVar.UnLock();
 
    {
       XrdSysMutexHelper lock(&m_RAM_mutex);
@@ -278,62 +328,158 @@ void Cache::RemoveWriteQEntriesFor(File *file)
    file->BlocksRemovedFromWriteQ(removed_blocks);
 }
 
-void Cache::ProcessWriteTasks()
+void Cache::ProcessWriteTasks(WriteQ *wq)
 {
-   std::vector<Block*> blks_to_write(m_configuration.m_wqueue_blocks);
+   using namespace std::chrono;
+
+   std::vector<Block*> blks_to_write;
+   blks_to_write.reserve(m_configuration.m_wqueue_blocks);
 
    while (true)
    {
-      m_writeQ.condVar.Lock();
-      while (m_writeQ.size == 0)
+      wq->condVar.Lock();
+      while (wq->size == 0)
       {
-         m_writeQ.condVar.Wait();
+         wq->condVar.Wait();
       }
 
-      // MT -- optimize to pop several blocks if they are available (or swap the list).
-      // This makes sense especially for smallish block sizes.
-
-      int       n_pushed = std::min(m_writeQ.size, m_configuration.m_wqueue_blocks);
+      int       n_pushed = std::min(wq->size, m_configuration.m_wqueue_blocks);
       long long sum_size = 0;
 
+      steady_clock::time_point now = steady_clock::now();
+
+      blks_to_write.clear();
       for (int bi = 0; bi < n_pushed; ++bi)
       {
-         Block* block = m_writeQ.queue.front();
-         m_writeQ.queue.pop_front();
-         m_writeQ.writes_between_purges += block->get_size();
+         std::list<Block*> &q = wq->prio_queue.empty() ? wq->queue : wq->prio_queue;
+         Block* block = q.front();
+         q.pop_front();
          sum_size += block->get_size();
 
-         blks_to_write[bi] = block;
+         long long wait = duration_cast<microseconds>(now - block->m_wq_time).count();
+         wq->wait_sum += wait;
+         wq->wait_max  = std::max(wq->wait_max, wait);
+
+         blks_to_write.push_back(block);
 
          TRACE(Dump, "ProcessWriteTasks for block " <<  (void*)(block) << " path " << block->m_file->lPath());
       }
-      m_writeQ.size -= n_pushed;
+      wq->size     -= n_pushed;
+      wq->n_blocks += n_pushed;
 
-      m_writeQ.condVar.UnLock();
+      wq->condVar.UnLock();
 
+      {
+         XrdSysMutexHelper lock(&m_writeQ_mutex);
+         m_writes_between_purges += sum_size;
+      }
       {
          XrdSysMutexHelper lock(&m_RAM_mutex);
          m_RAM_write_queue -= sum_size;
       }
 
-      for (int bi = 0; bi < n_pushed; ++bi)
+      // Order blocks by file and offset so that adjacent blocks of a file
+      // can be written with a single call.
+      std::sort(blks_to_write.begin(), blks_to_write.end(),
+                [](const Block *a, const Block *b)
+                { return a->m_file != b->m_file ? a->m_file < b->m_file : a->m_offset < b->m_offset; });
+
+      int n_writes = 0;
+      for (int bi = 0; bi < n_pushed; ++n_writes)
       {
-         Block* block = blks_to_write[bi];
+         // Once written, blocks and possibly their file are gone. Only look
+         // at the blocks that follow.
+         File *file = blks_to_write[bi]->m_file;
+         int   n    = 1;
+         while (bi + n < n_pushed && blks_to_write[bi + n]->m_file == file &&
+                blks_to_write[bi + n]->m_offset == blks_to_write[bi + n - 1]->m_offset + blks_to_write[bi + n - 1]->get_size())
+         {
+            ++n;
+         }
 
-         block->m_file->WriteBlockToDisk(block);
+         file->WriteBlocksToDisk(&blks_to_write[bi], n);
+         bi += n;
       }
+
+      XrdSysCondVarHelper lock(&wq->condVar);
+      wq->n_writes += n_writes;
    }
 }
 
 long long Cache::WritesSinceLastCall()
 {
    // Called from ResourceMonitor for an alternative estimation of disk writes.
-   XrdSysCondVarHelper lock(&m_writeQ.condVar);
-   long long ret = m_writeQ.writes_between_purges;
-   m_writeQ.writes_between_purges = 0;
+   XrdSysMutexHelper lock(&m_writeQ_mutex);
+   long long ret = m_writes_between_purges;
+   m_writes_between_purges = 0;
    return ret;
 }
 
+void Cache::ReportWriteQueues()
+{
+   std::vector<WriteQ*> queues;
+   {
+      XrdSysMutexHelper lock(&m_writeQ_mutex);
+      for (auto &dq : m_writeQs) queues.push_back(dq.second.get());
+   }
+
+   for (WriteQ *wq : queues)
+   {
+      int       size, max_size;
+      long long n_blocks, n_writes, wait_avg, wait_max;
+      {
+         XrdSysCondVarHelper lock(&wq->condVar);
+         size     = wq->size;
+         max_size = wq->max_size;
+         n_blocks = wq->n_blocks;
+         n_writes = wq->n_writes;
+         wait_avg = n_blocks ? wq->wait_sum / n_blocks : 0;
+         wait_max = wq->wait_max;
+
+         wq->max_size = size;
+         wq->n_blocks = wq->n_writes = wq->wait_sum = wq->wait_max = 0;
+      }
+
+      char buf[512];
+      int  len = snprintf(buf, sizeof(buf), "{\"event\":\"write_queue\",\"dev\":\"%u:%u\","
+                          "\"depth\":%d,\"max_depth\":%d,\"n_blks\":%lld,\"n_writes\":%lld,"
+                          "\"wait_avg_us\":%lld,\"wait_max_us\":%lld}",
+                          (unsigned) major(wq->dev), (unsigned) minor(wq->dev),
+                          size, max_size, n_blocks, n_writes, wait_avg, wait_max);
+
+      TRACE(Debug, "ReportWriteQueues() " << buf);
+
+      if (m_gstream && ! m_gstream->Insert(buf, len + 1))
+      {
+         TRACE(Error, "Failed g-stream insertion of write_queue record, len=" << len);
+      }
+   }
+}
+
+void Cache::ReportRamTier()
+{
+   if ( ! m_ram_tier)
+      return;
+
+   RamTier::Stats rs;
+   m_ram_tier->GetStats(rs, true);
+
+   char buf[512];
+   int  len = snprintf(buf, sizeof(buf), "{\"event\":\"ram_tier\",\"capacity\":%lld,\"used\":%lld,"
+                       "\"n_blks\":%d,\"n_fids\":%d,\"hits\":%lld,\"misses\":%lld,\"b_hit\":%lld,"
+                       "\"inserts\":%lld,\"rejects\":%lld,\"evictions\":%lld}",
+                       m_ram_tier->GetCapacity(), rs.m_BytesUsed, rs.m_NBlocks, rs.m_NFileIds,
+                       rs.m_Hits, rs.m_Misses, rs.m_BytesHit,
+                       rs.m_Inserts, rs.m_Rejects, rs.m_Evictions);
+
+   TRACE(Debug, "ReportRamTier() " << buf);
+
+   if (m_gstream && ! m_gstream->Insert(buf, len + 1))
+   {
+      TRACE(Error, "Failed g-stream insertion of ram_tier record, len=" << len);
+   }
+}
+
 //==============================================================================
 
 char* Cache::RequestRAM(long long size)
@@ -379,19 +525,36 @@ char* Cache::RequestRAM(long long size)
 void Cache::ReleaseRAM(char* buf, long long size)
 {
    bool std_size = (size == m_configuration.m_bufferSize);
+   bool kept     = false;
+   bool wake_up  = false;
    {
       XrdSysMutexHelper lock(&m_RAM_mutex);
 
       m_RAM_used -= size;
 
+      if (m_RAM_prefetch_waiting && m_RAM_used < m_RAM_prefetch_limit)
+      {
+         m_RAM_prefetch_waiting = false;
+         wake_up = true;
+      }
+
       if (std_size && m_RAM_std_size < m_configuration.m_RamKeepStdBlocks)
       {
          m_RAM_std_blocks.push_back(buf);
          ++m_RAM_std_size;
-         return;
+         kept = true;
       }
    }
-   free(buf);
+
+   if (wake_up)
+   {
+      m_RAM_condVar.Lock();
+      m_RAM_condVar.Signal();
+      m_RAM_condVar.UnLock();
+   }
+
+   if ( ! kept)
+      free(buf);
 }
 
 File* Cache::GetFile(const std::string& path, IO* io, long long off, long long filesize)
@@ -660,13 +823,15 @@ void Cache::dec_ref_cnt(File* f, bool high_debug)
                               "\"lfn\":\"%s\",\"size\":%lld,\"blk_size\":%d,\"n_blks\":%d,\"n_blks_done\":%d,"
                               "\"access_cnt\":%lu,\"attach_t\":%lld,\"detach_t\":%lld,\"remotes\":%s,"
                               "\"b_hit\":%lld,\"b_miss\":%lld,\"b_bypass\":%lld,"
-                              "\"b_todisk\":%lld,\"b_prefetch\":%lld,\"n_cks_errs\":%d}",
+                              "\"b_todisk\":%lld,\"b_prefetch\":%lld,\"n_cks_errs\":%d,"
+                              "\"n_pf_blks\":%d,\"n_pf_hits\":%d,\"pf_score\":%.3f}",
                               f->GetLocalPath().c_str(), f->GetFileSize(), f->GetBlockSize(),
                               f->GetNBlocks(), f->GetNDownloadedBlocks(),
                               (unsigned long) f->GetAccessCnt(), (long long) as->AttachTime, (long long) as->DetachTime,
                               f->GetRemoteLocations().c_str(),
                               as->BytesHit, as->BytesMissed, as->BytesBypassed,
-                              st.m_BytesWritten, f->GetPrefetchedBytes(), st.m_NCksumErrors
+                              st.m_BytesWritten, f->GetPrefetchedBytes(), st.m_NCksumErrors,
+                              f->GetPrefetchReadCnt(), f->GetPrefetchHitCnt(), f->GetPrefetchScore()
          );
          bool suc = false;
          if (len < 4096)
@@ -711,7 +876,9 @@ void Cache::RegisterPrefetchFile(File* file)
    }
 
    m_prefetch_condVar.Lock();
-   m_prefetchList.push_back(file);
+   // New files start at the current virtual time so they neither wait for
+   // nor jump ahead of the files that are already being prefetched.
+   m_prefetchList.push_back( { file, m_prefetch_vtime } );
    m_prefetch_condVar.Signal();
    m_prefetch_condVar.UnLock();
 }
@@ -729,7 +896,7 @@ void Cache::DeRegisterPrefetchFile(File* file)
    m_prefetch_condVar.Lock();
    for (PrefetchList::iterator it = m_prefetchList.begin(); it != m_prefetchList.end(); ++it)
    {
-      if (*it == file)
+      if (it->m_file == file)
       {
          m_prefetchList.erase(it);
          break;
@@ -739,6 +906,18 @@ void Cache::DeRegisterPrefetchFile(File* file)
 }
 
 
+namespace
+{
+// Files whose prefetched blocks get used and that are being read fast get
+// more prefetch turns. Files that are not read at all still get a share so
+// that they eventually complete.
+double PrefetchWeight(File *f)
+{
+   double rate_blks = f->GetReadRate() / std::max(f->GetBlockSize(), 1);
+   return (0.1 + f->GetPrefetchScore()) * (1.0 + std::min(rate_blks, 100.0));
+}
+}
+
 File* Cache::GetNextFileToPrefetch()
 {
    m_prefetch_condVar.Lock();
@@ -747,11 +926,20 @@ File* Cache::GetNextFileToPrefetch()
       m_prefetch_condVar.Wait();
    }
 
-   //  std::sort(m_prefetchList.begin(), m_prefetchList.end(), myobject);
+   // Stride scheduling: the file with the smallest pass goes next and its
+   // pass is advanced by the inverse of its weight. Each file thus gets
+   // turns in proportion to its weight.
+
+   PrefetchList::iterator next = m_prefetchList.begin();
+   for (PrefetchList::iterator it = next + 1; it != m_prefetchList.end(); ++it)
+   {
+      if (it->m_pass < next->m_pass)
+         next = it;
+   }
 
-   size_t l = m_prefetchList.size();
-   int idx = rand() % l;
-   File* f = m_prefetchList[idx];
+   File* f = next->m_file;
+   m_prefetch_vtime = next->m_pass;
+   next->m_pass    += 1.0 / PrefetchWeight(f);
 
    m_prefetch_condVar.UnLock();
    return f;
@@ -760,23 +948,31 @@ File* Cache::GetNextFileToPrefetch()
 
 void Cache::Prefetch()
 {
-   const long long limit_RAM = m_configuration.m_RamAbsAvailable * 7 / 10;
+   {
+      XrdSysMutexHelper lock(&m_RAM_mutex);
+      m_RAM_prefetch_limit = m_configuration.m_RamAbsAvailable * 7 / 10;
+   }
 
    while (true)
    {
-      m_RAM_mutex.Lock();
-      bool doPrefetch = (m_RAM_used < limit_RAM);
-      m_RAM_mutex.UnLock();
-
-      if (doPrefetch)
-      {
-         File* f = GetNextFileToPrefetch();
-         f->Prefetch();
-      }
-      else
+      // Above the limit wait for ReleaseRAM() to bring the usage back down.
+      // It signals under m_RAM_condVar so the wake-up can not be missed.
+      m_RAM_condVar.Lock();
+      while (true)
       {
-         XrdSysTimer::Wait(5);
+         m_RAM_mutex.Lock();
+         bool doPrefetch = (m_RAM_used < m_RAM_prefetch_limit);
+         m_RAM_prefetch_waiting = ! doPrefetch;
+         m_RAM_mutex.UnLock();
+
+         if (doPrefetch) break;
+
+         m_RAM_condVar.Wait();
       }
+      m_RAM_condVar.UnLock();
+
+      File* f = GetNextFileToPrefetch();
+      f->Prefetch();
    }
 }
 
@@ -828,8 +1024,8 @@ int Cache::LocalFilePath(const char *curl, char *buff, int blen,
    }
 
    struct stat sbuff, sbuff2;
-   if (m_oss->Stat(f_name.c_str(), &sbuff)  == XrdOssOK &&
-       m_oss->Stat(i_name.c_str(), &sbuff2) == XrdOssOK)
+   if (m_oss->Stat(f_name.c_str(), &sbuff) == XrdOssOK &&
+       StatInfoFile(i_name, sbuff2)        == XrdOssOK)
    {
       if (S_ISDIR(sbuff.st_mode))
       {
@@ -857,10 +1053,9 @@ int Cache::LocalFilePath(const char *curl, char *buff, int blen,
 
          if (is_active) m_active_cond.UnLock();
 
-         XrdOssDF* infoFile = m_oss->newFile(m_configuration.m_username.c_str());
-         XrdOucEnv myEnv;
-         int res = infoFile->Open(i_name.c_str(), O_RDWR, 0600, myEnv);
-         if (res >= 0)
+         int res;
+         XrdOssDF* infoFile = OpenInfoFile(i_name, O_RDWR, res);
+         if (infoFile)
          {
             Info info(m_trace, 0);
             if (info.Read(infoFile, i_name.c_str()))
@@ -877,8 +1072,8 @@ int Cache::LocalFilePath(const char *curl, char *buff, int blen,
                }
             }
             infoFile->Close();
+            delete infoFile;
          }
-         delete infoFile;
 
          if ( ! is_active) m_active_cond.UnLock();
 
@@ -963,11 +1158,10 @@ long long Cache::DetermineFullFileSize(const std::string &cinfo_fname)
       }
    }
 
-   XrdOssDF *infoFile = m_oss->newFile(m_configuration.m_username.c_str());
-   XrdOucEnv env;
    long long ret;
-   int res = infoFile->Open(cinfo_fname.c_str(), O_RDONLY, 0600, env);
-   if (res < 0) {
+   int res;
+   XrdOssDF *infoFile = OpenInfoFile(cinfo_fname, O_RDONLY, res);
+   if ( ! infoFile) {
       ret = res;
    } else {
       Info info(m_trace, 0);
@@ -977,8 +1171,8 @@ long long Cache::DetermineFullFileSize(const std::string &cinfo_fname)
          ret = info.GetFileSize();
       }
       infoFile->Close();
+      delete infoFile;
    }
-   delete infoFile;
    return ret;
 }
 
@@ -1023,6 +1217,56 @@ int Cache::GetCacheControlXAttr(int fd, std::string& ival) const
    return 0;
 }
 
+//______________________________________________________________________________
+// Open cinfo file, from the InfoStore if it is used. With O_CREAT the file is
+// created in the meta space if it does not exist.
+// Returns nullptr and sets res to -errno on failure.
+//------------------------------------------------------------------------------
+XrdOssDF* Cache::OpenInfoFile(const std::string &cinfo_fname, int oflags, int &res, mode_t mode) const
+{
+   const char *myUser = m_configuration.m_username.c_str();
+   XrdOucEnv   myEnv;
+
+   XrdOssDF *infoFile;
+   if (m_info_store)
+   {
+      infoFile = m_info_store->newFile();
+   }
+   else
+   {
+      if (oflags & O_CREAT)
+      {
+         myEnv.Put("oss.asize", "64k"); // Advisory, block-map and access list lengths vary.
+         myEnv.Put("oss.cgroup", m_configuration.m_meta_space.c_str());
+         if ((res = m_oss->Create(myUser, cinfo_fname.c_str(), mode, myEnv, XRDOSS_mkpath)) != XrdOssOK)
+            return nullptr;
+         oflags &= ~O_CREAT;
+      }
+      infoFile = m_oss->newFile(myUser);
+   }
+
+   if ((res = infoFile->Open(cinfo_fname.c_str(), oflags, mode, myEnv)) != XrdOssOK)
+   {
+      delete infoFile;
+      return nullptr;
+   }
+   return infoFile;
+}
+
+int Cache::StatInfoFile(const std::string &cinfo_fname, struct stat &st) const
+{
+   if (m_info_store)
+      return m_info_store->Stat(cinfo_fname, st);
+   return m_oss->Stat(cinfo_fname.c_str(), &st);
+}
+
+int Cache::UnlinkInfoFile(const std::string &cinfo_fname) const
+{
+   if (m_info_store)
+      return m_info_store->Remove(cinfo_fname);
+   return m_oss->Unlink(cinfo_fname.c_str());
+}
+
 //______________________________________________________________________________
 // Calculate if the file is to be considered cached for the purposes of
 // only-if-cached and setting of atime of the Stat() calls.
@@ -1163,7 +1407,7 @@ int Cache::Prepare(const char *curl, int oflags, mode_t mode)
    }
 
    struct stat sbuff;
-   if (m_oss->Stat(i_name.c_str(), &sbuff) == XrdOssOK)
+   if (StatInfoFile(i_name, sbuff) == XrdOssOK)
    {
 
       if (m_configuration.m_httpcc && !is_http_cache_valid(f_name, i_name, url))
@@ -1308,9 +1552,12 @@ int Cache::UnlinkFile(const std::string& f_name, bool fail_if_open)
 
    std::string i_name = f_name + Info::s_infoExtension;
 
+   if (m_ram_tier)
+      m_ram_tier->Invalidate(f_name);
+
    // Unlink file & cinfo
    int f_ret = m_oss->Unlink(f_name.c_str());
-   int i_ret = m_oss->Unlink(i_name.c_str());
+   int i_ret = UnlinkInfoFile(i_name);
 
    if (st_blocks_to_purge)
       m_res_mon->register_file_purge(f_name, st_blocks_to_purge);
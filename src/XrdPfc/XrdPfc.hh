@@ -20,6 +20,7 @@
 #include <string>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 
 #include "Xrd/XrdScheduler.hh"
@@ -42,6 +43,8 @@ class XrdXrootdGStream;
 namespace XrdPfc
 {
 class File;
+class InfoStore;
+class RamTier;
 class IO;
 class PurgePin;
 class ResourceMonitor;
@@ -90,6 +93,8 @@ struct Configuration
    std::string m_username;              //!< username passed to oss plugin
    std::string m_data_space;            //!< oss space for data files
    std::string m_meta_space;            //!< oss space for metadata files (cinfo)
+   bool        m_infoStoreLog = false;  //!< keep cinfo records in a single InfoStore log instead of files
+   int         m_infoStoreFlushDelay = 100; //!< InfoStore batch commit delay in ms
 
    long long m_diskTotalSpace;          //!< total disk space on configured partition or oss space
    long long m_diskUsageLWM;            //!< cache purge - disk usage low water mark
@@ -100,15 +105,20 @@ struct Configuration
    int       m_purgeInterval;           //!< sleep interval between cache purges
    int       m_purgeColdFilesAge;       //!< purge files older than this age
    int       m_purgeAgeBasedPeriod;     //!< peform cold file / uvkeep purge every this many purge cycles
+   int       m_purgeThreads;            //!< number of threads scanning the name-space for purge candidates
+   bool      m_purgeEarly;              //!< unlink clearly old files while the purge scan is still running, off by default
    int       m_accHistorySize;          //!< max number of entries in access history part of cinfo file
 
    std::set<std::string> m_dirStatsDirs;     //!< directories for which stat reporting was requested
    std::set<std::string> m_dirStatsDirGlobs; //!< directory globs for which stat reporting was requested
    int       m_dirStatsInterval;        //!< time between resource monitor statistics dump in seconds
    int       m_dirStatsStoreDepth;      //!< maximum depth for statistics write out
+   int       m_dirSnapshotInterval;     //!< time between DirState snapshots in seconds, 0 (default) disables them
+   int       m_dirSnapshotMaxAge;       //!< scan instead of loading a snapshot whose last full scan is older than this, 0 for no limit
 
    long long m_bufferSize;              //!< cache block size, default 128 kB
    long long m_RamAbsAvailable;         //!< available from configuration
+   long long m_RamTierSize = 0;         //!< size of RAM tier for hot blocks, 0 disables it
    int       m_RamKeepStdBlocks;        //!< number of standard-sized blocks kept after release
    int       m_wqueue_blocks;           //!< maximum number of blocks written per write-queue loop
    int       m_wqueue_threads;          //!< number of threads writing blocks to disk
@@ -209,6 +219,17 @@ public:
    int GetCacheControlXAttr(const std::string &cinfo_fname, std::string& res) const;
    int GetCacheControlXAttr(int fd, std::string& res) const;
 
+   //---------------------------------------------------------------------
+   //! Access to cinfo files, either as files in the meta space or as
+   //! records in the InfoStore. Return values follow XrdOss conventions.
+   //---------------------------------------------------------------------
+   XrdOssDF* OpenInfoFile(const std::string &cinfo_fname, int oflags, int &res, mode_t mode = 0600) const;
+   int       StatInfoFile(const std::string &cinfo_fname, struct stat &st) const;
+   int       UnlinkInfoFile(const std::string &cinfo_fname) const;
+   InfoStore* GetInfoStore() const { return m_info_store; }
+
+   RamTier*  GetRamTier() const { return m_ram_tier; }
+
 
    //--------------------------------------------------------------------
    //! \brief Makes decision if the original XrdOucCacheIO should be cached.
@@ -259,10 +280,33 @@ public:
    //---------------------------------------------------------------------
    int  UnlinkFile(const std::string& f_name, bool fail_if_open);
 
+   //---------------------------------------------------------------------
+   //! Write queue of blocks going to one device of the data space.
+   //! Each queue has its own pfc.writequeue threads so that a slow disk
+   //! only holds back writes to itself.
+   //---------------------------------------------------------------------
+   struct WriteQ
+   {
+      WriteQ(dev_t d) : dev(d), condVar(0) {}
+
+      dev_t             dev;               //!< device of the data files in this queue
+      XrdSysCondVar     condVar;           //!< write list condVar
+      std::list<Block*> prio_queue;        //!< blocks with readers attached, written first
+      std::list<Block*> queue;             //!< all other blocks
+      int               size     = 0;      //!< current size of both lists
+
+      // Statistics since the last ReportWriteQueues(), protected by condVar.
+      int               max_size = 0;      //!< largest size seen
+      long long         n_blocks = 0;      //!< number of blocks written
+      long long         n_writes = 0;      //!< number of write calls, contiguous blocks are merged
+      long long         wait_sum = 0;      //!< total time blocks spent in the queue, us
+      long long         wait_max = 0;      //!< longest time a block spent in the queue, us
+   };
+
    //---------------------------------------------------------------------
    //! Add downloaded block in write queue.
    //---------------------------------------------------------------------
-   void AddWriteTask(Block* b, bool from_read);
+   void AddWriteTask(Block* b);
 
    //---------------------------------------------------------------------
    //!  \brief Remove blocks from write queue which belong to given prefetch.
@@ -273,10 +317,22 @@ public:
    //---------------------------------------------------------------------
    //! Separate task which writes blocks from ram to disk.
    //---------------------------------------------------------------------
-   void ProcessWriteTasks();
+   void ProcessWriteTasks(WriteQ *wq);
 
    long long WritesSinceLastCall();
 
+   //---------------------------------------------------------------------
+   //! Log depth and latency of each write queue and send them to the
+   //! g-stream, if configured. Resets the statistics.
+   //---------------------------------------------------------------------
+   void ReportWriteQueues();
+
+   //---------------------------------------------------------------------
+   //! Log RAM tier hit / miss / eviction counts and send them to the
+   //! g-stream, if configured. Resets the counts.
+   //---------------------------------------------------------------------
+   void ReportRamTier();
+
    char* RequestRAM(long long size);
    void  ReleaseRAM(char* buf, long long size);
 
@@ -340,6 +396,10 @@ private:
 
    ResourceMonitor  *m_res_mon;
 
+   InfoStore        *m_info_store = nullptr; //!< consolidated cinfo records, if configured
+
+   RamTier          *m_ram_tier = nullptr;   //!< hot blocks kept in RAM, if configured
+
    std::vector<Decision*> m_decisionpoints; //!< decision plugins
    PurgePin*              m_purge_pin;      //!< purge plugin
 
@@ -350,6 +410,9 @@ private:
 
    XrdSysMutex m_RAM_mutex;                 //!< lock for allcoation of RAM blocks
    long long   m_RAM_used;
+   long long   m_RAM_prefetch_limit;        //!< prefetching pauses above this RAM usage
+   bool        m_RAM_prefetch_waiting;      //!< prefetch thread waits on m_RAM_condVar
+   XrdSysCondVar m_RAM_condVar;             //!< signaled when RAM usage drops below the prefetch limit
    long long   m_RAM_write_queue;
    std::list<char*> m_RAM_std_blocks;       //!< A list of blocks of standard size, to be reused.
    int              m_RAM_std_size;
@@ -358,17 +421,11 @@ private:
    bool        m_dataXattr = false;         //!< True if xattrs are available on the data space
    bool        m_metaXattr = false;         //!< True if xattrs are available on the meta space
 
-   struct WriteQ
-   {
-      WriteQ() : condVar(0), writes_between_purges(0), size(0) {}
-
-      XrdSysCondVar     condVar;      //!< write list condVar
-      std::list<Block*> queue;        //!< container
-      long long         writes_between_purges; //!< upper bound on amount of bytes written between two purge passes
-      int               size;         //!< current size of write queue
-   };
+   XrdSysMutex              m_writeQ_mutex;          //!< lock for m_writeQs and m_writes_between_purges
+   std::map<dev_t, std::unique_ptr<WriteQ>> m_writeQs; //!< write queues by device, created on first use
+   long long                m_writes_between_purges; //!< upper bound on amount of bytes written between two purge passes
 
-   WriteQ m_writeQ;
+   WriteQ* get_write_queue(dev_t dev);
 
    // active map, purge delay set
    typedef std::map<std::string, File*>               ActiveMap_t;
@@ -387,8 +444,14 @@ private:
    bool is_http_cache_valid(const std::string& fname, const std::string& iname, XrdCl::URL& url);
 
    // prefetching
-   typedef std::vector<File*>  PrefetchList;
+   struct PrefetchEntry
+   {
+      File  *m_file;
+      double m_pass;   //!< virtual time of the next turn, advances by 1 / weight
+   };
+   typedef std::vector<PrefetchEntry>  PrefetchList;
    PrefetchList m_prefetchList;
+   double       m_prefetch_vtime;           //!< pass of the last file selected for prefetching
 };
 
 }
@@ -0,0 +1,118 @@
+#ifndef __XRDPFC_ACCESSPATTERN_HH__
+#define __XRDPFC_ACCESSPATTERN_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+namespace XrdPfc
+{
+//----------------------------------------------------------------------------
+//! Tracks block ranges read through a single IO and classifies the access
+//! as forward, backward or strided. Once a pattern has been seen for
+//! s_min_run consecutive reads, Next() predicts the blocks that will be
+//! read next so that prefetching can fetch them ahead of the client.
+//!
+//! Not thread-safe, the owner has to serialize access.
+//----------------------------------------------------------------------------
+class AccessPattern
+{
+public:
+   enum Kind_e { kUnknown, kForward, kBackward, kStrided };
+
+   static const int s_min_run = 2;
+
+   //---------------------------------------------------------------------
+   //! Record a read covering blocks idx_first to idx_last, inclusive.
+   //---------------------------------------------------------------------
+   void Record(int idx_first, int idx_last)
+   {
+      if (m_first < 0)
+      {
+         m_first = idx_first;
+         m_last  = idx_last;
+         return;
+      }
+
+      // Another read within the same block range tells us nothing new.
+      if (idx_first == m_first && idx_last == m_last)
+         return;
+
+      Kind_e kind;
+      int    stride = 0;
+
+      if (idx_first == m_last || idx_first == m_last + 1)
+         kind = kForward;
+      else if (idx_last == m_first || idx_last == m_first - 1)
+         kind = kBackward;
+      else
+      {
+         kind   = kStrided;
+         stride = idx_first - m_first;
+      }
+
+      if (kind == m_candidate && stride == m_stride)
+         ++m_run;
+      else
+      {
+         m_candidate = kind;
+         m_stride    = stride;
+         m_run       = 1;
+      }
+
+      m_first = idx_first;
+      m_last  = idx_last;
+   }
+
+   //---------------------------------------------------------------------
+   //! Detected access pattern, kUnknown until it has been confirmed.
+   //---------------------------------------------------------------------
+   Kind_e GetKind() const { return m_run >= s_min_run ? m_candidate : kUnknown; }
+
+   int GetStride() const { return m_stride; }
+
+   //---------------------------------------------------------------------
+   //! Predicted index of the k-th block (counting from 0) to be read after
+   //! the last recorded one. Returns -1 when there is no prediction.
+   //! Indices can be beyond the end of the file, the caller has to check.
+   //---------------------------------------------------------------------
+   int Next(int k) const
+   {
+      int idx;
+      switch (GetKind())
+      {
+         case kForward:  idx = m_last  + 1 + k; break;
+         case kBackward: idx = m_first - 1 - k; break;
+         case kStrided:
+         {
+            const int span = m_last - m_first + 1;
+            idx = m_first + m_stride * (k / span + 1) + k % span;
+            break;
+         }
+         default: return -1;
+      }
+      return idx >= 0 ? idx : -1;
+   }
+
+private:
+   int    m_first     = -1;         //!< first block of the last read
+   int    m_last      = -1;         //!< last block of the last read
+   int    m_stride    =  0;         //!< distance between strided reads, in blocks
+   int    m_run       =  0;         //!< consecutive reads matching m_candidate
+   Kind_e m_candidate = kUnknown;
+};
+}
+
+#endif
@@ -171,7 +171,7 @@ void Cache::ExecuteCommandUrl(const std::string& command_url)
       // Check if cinfo exists ... bail out if it does.
       {
          struct stat infoStat;
-         if (GetOss()->Stat(cinfo_path.c_str(), &infoStat) == XrdOssOK)
+         if (StatInfoFile(cinfo_path, infoStat) == XrdOssOK)
          {
             TRACE(Error, err_prefix << "cinfo file already exists for '" << file_path << "'. Refusing to overwrite.");
             return;
@@ -206,20 +206,10 @@ void Cache::ExecuteCommandUrl(const std::string& command_url)
 
          // Create the info file.
 
-         myEnv.Put("oss.asize", "64k"); // TODO: Calculate? Get it from configuration? Do not know length of access lists ...
-         myEnv.Put("oss.cgroup", conf.m_meta_space.c_str());
-         if ((cret = GetOss()->Create(myUser, cinfo_path.c_str(), 0600, myEnv, XRDOSS_mkpath)) != XrdOssOK)
-         {
-            TRACE(Error, err_prefix << "Create failed for info file " << cinfo_path << ERRNO_AND_ERRSTR(-cret));
-            myFile->Close(); delete myFile;
-            return;
-         }
-
-         XrdOssDF *myInfoFile = GetOss()->newFile(myUser);
-         if ((cret = myInfoFile->Open(cinfo_path.c_str(), O_RDWR, 0600, myEnv)) != XrdOssOK)
+         XrdOssDF *myInfoFile = OpenInfoFile(cinfo_path, O_RDWR | O_CREAT, cret);
+         if ( ! myInfoFile)
          {
             TRACE(Error, err_prefix << "Open failed for info file " << cinfo_path << ERRNO_AND_ERRSTR(-cret));
-            delete myInfoFile;
             myFile->Close(); delete myFile;
             return;
          }
@@ -246,13 +236,24 @@ void Cache::ExecuteCommandUrl(const std::string& command_url)
 
          myInfo.Write(myInfoFile, cinfo_path.c_str());
 
-         // Fake last modified time to the last access_time
+         // Fake last modified time to the last access_time, leaving the access
+         // time alone. InfoStore records have no file descriptor and only keep
+         // the modification time.
          {
             time_t last_detach;
             myInfo.GetLatestDetachTime(last_detach);
-            struct timespec acc_mod_time[2] = { {last_detach, UTIME_OMIT}, {last_detach, 0} };
+            if (myInfoFile->getFD() >= 0)
+            {
+               struct timespec acc_mod_time[2] = { {last_detach, UTIME_OMIT}, {last_detach, 0} };
+
+               futimens(myInfoFile->getFD(), acc_mod_time);
+            }
+            else
+            {
+               struct timeval acc_mod_time[2] = { {last_detach, 0}, {last_detach, 0} };
 
-            futimens(myInfoFile->getFD(), acc_mod_time);
+               myInfoFile->Fctl(XrdOssDF::Fctl_utimes, sizeof(acc_mod_time), (const char*) acc_mod_time);
+            }
          }
 
          myInfoFile->Close(); delete myInfoFile;
@@ -264,9 +265,9 @@ void Cache::ExecuteCommandUrl(const std::string& command_url)
                                 << "st_blocks=" << dstat.st_blocks);
 
          {
-            XrdSysCondVarHelper lock(&m_writeQ.condVar);
+            XrdSysMutexHelper lock(&m_writeQ_mutex);
 
-            m_writeQ.writes_between_purges += file_size;
+            m_writes_between_purges += file_size;
          }
          {
             int token = m_res_mon->register_file_open(file_path, time_now, false);
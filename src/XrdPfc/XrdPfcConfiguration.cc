@@ -1,6 +1,8 @@
 #include "XrdPfc.hh"
 #include "XrdPfcTrace.hh"
 #include "XrdPfcInfo.hh"
+#include "XrdPfcInfoStore.hh"
+#include "XrdPfcRamTier.hh"
 
 #include "XrdPfcResourceMonitor.hh"
 #include "XrdPfcPurgePin.hh"
@@ -45,9 +47,13 @@ Configuration::Configuration() :
    m_purgeInterval(300),
    m_purgeColdFilesAge(-1),
    m_purgeAgeBasedPeriod(10),
+   m_purgeThreads(4),
+   m_purgeEarly(false),
    m_accHistorySize(20),
    m_dirStatsInterval(900),
    m_dirStatsStoreDepth(1),
+   m_dirSnapshotInterval(0),
+   m_dirSnapshotMaxAge(7 * 24 * 3600),
    m_bufferSize(128*1024),
    m_RamAbsAvailable(0),
    m_RamKeepStdBlocks(0),
@@ -691,7 +697,7 @@ bool Cache::Config(const char *config_filename, const char *parameters, XrdOucEn
                       "       pfc.ram %.fg\n"
                       "       pfc.writequeue %d %d\n"
                       "       # Total available disk: %lld\n"
-                      "       pfc.diskusage %lld %lld files %lld %lld %lld purgeinterval %d purgecoldfiles %d\n"
+                      "       pfc.diskusage %lld %lld files %lld %lld %lld purgeinterval %d purgecoldfiles %d purgethreads %d purgeearly %s\n"
                       "       pfc.spaces %s %s\n"
                       "       pfc.trace %d\n"
                       "       pfc.flush %lld\n"
@@ -709,6 +715,7 @@ bool Cache::Config(const char *config_filename, const char *parameters, XrdOucEn
                       m_configuration.m_diskUsageLWM, m_configuration.m_diskUsageHWM,
                       m_configuration.m_fileUsageBaseline, m_configuration.m_fileUsageNominal, m_configuration.m_fileUsageMax,
                       m_configuration.m_purgeInterval, m_configuration.m_purgeColdFilesAge,
+                      m_configuration.m_purgeThreads, m_configuration.m_purgeEarly ? "on" : "off",
                       m_configuration.m_data_space.c_str(),
                       m_configuration.m_meta_space.c_str(),
                       m_trace->What,
@@ -731,6 +738,28 @@ bool Cache::Config(const char *config_filename, const char *parameters, XrdOucEn
             loff += snprintf(buff + loff, sizeof(buff) - loff, "               %s/*\n", i->c_str());
       }
 
+      if (m_configuration.m_dirSnapshotInterval > 0)
+      {
+         loff += snprintf(buff + loff, sizeof(buff) - loff, "       pfc.dirsnapshot interval %d maxage %d\n",
+                          m_configuration.m_dirSnapshotInterval, m_configuration.m_dirSnapshotMaxAge);
+      }
+      else
+      {
+         loff += snprintf(buff + loff, sizeof(buff) - loff, "       pfc.dirsnapshot off\n");
+      }
+
+      if (m_configuration.m_RamTierSize > 0)
+      {
+         loff += snprintf(buff + loff, sizeof(buff) - loff, "       pfc.ramtier %lldm\n",
+                          m_configuration.m_RamTierSize >> 20);
+      }
+
+      if (m_configuration.m_infoStoreLog)
+      {
+         loff += snprintf(buff + loff, sizeof(buff) - loff, "       pfc.infostore log flushdelay %d\n",
+                          m_configuration.m_infoStoreFlushDelay);
+      }
+
       if (m_configuration.m_hdfsmode)
       {
          loff += snprintf(buff + loff, sizeof(buff) - loff, "       pfc.hdfsmode hdfsbsize %lld\n", m_configuration.m_hdfsbsize);
@@ -771,6 +800,27 @@ bool Cache::Config(const char *config_filename, const char *parameters, XrdOucEn
 
    m_log.Say("       pfc g-stream has", m_gstream ? "" : " NOT", " been configured via xrootd.monitor directive\n");
 
+   // Open the InfoStore before anything looks for cinfo files.
+   if (aOK && CFG.m_infoStoreLog)
+   {
+      m_info_store = new InfoStore(*m_oss, m_trace, CFG.m_username, CFG.m_meta_space,
+                                   "/pfc-stats/InfoStore.log", CFG.m_infoStoreFlushDelay);
+      std::string err;
+      if ( ! m_info_store->Open(err))
+      {
+         m_log.Emsg("Config", "Error: can not open InfoStore,", err.c_str());
+         delete m_info_store; m_info_store = nullptr;
+         aOK = false;
+      }
+      // Records have no files to hold extended attributes.
+      m_metaXattr = false;
+   }
+
+   if (aOK && CFG.m_RamTierSize > 0)
+   {
+      m_ram_tier = new RamTier(CFG.m_RamTierSize, CFG.m_bufferSize);
+   }
+
    // Create the ResourceMonitor and get it ready for starting the main thread function.
    if (aOK)
    {
@@ -874,6 +924,26 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
                return false;
             }
          }
+         else if (strcmp(p, "purgethreads") == 0)
+         {
+            if (XrdOuca2x::a2i(m_log, "Error getting purgethreads", cwg.GetWord(), &m_configuration.m_purgeThreads, 1, 64))
+            {
+               return false;
+            }
+         }
+         else if (strcmp(p, "purgeearly") == 0)
+         {
+            const char *v = cwg.GetWord();
+            if (v && strcmp(v, "on") == 0)
+               m_configuration.m_purgeEarly = true;
+            else if (v && strcmp(v, "off") == 0)
+               m_configuration.m_purgeEarly = false;
+            else
+            {
+               m_log.Emsg("Config", "Error: purgeearly requires 'on' or 'off'.");
+               return false;
+            }
+         }
          else
          {
             m_log.Emsg("Config", "Error: diskusage stanza contains unknown directive", p);
@@ -989,6 +1059,71 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
          }
       }
    }
+   else if ( part == "dirsnapshot" )
+   {
+      const char *p = 0;
+      while ((p = cwg.GetWord()) && cwg.HasLast())
+      {
+         if (strcmp(p, "off") == 0)
+         {
+            m_configuration.m_dirSnapshotInterval = 0;
+         }
+         else if (strcmp(p, "interval") == 0)
+         {
+            if (XrdOuca2x::a2tm(m_log, "Error getting dirsnapshot interval", cwg.GetWord(),
+                                &m_configuration.m_dirSnapshotInterval, 60, 24 * 3600))
+            {
+               return false;
+            }
+         }
+         else if (strcmp(p, "maxage") == 0)
+         {
+            if (XrdOuca2x::a2tm(m_log, "Error getting dirsnapshot maxage", cwg.GetWord(),
+                                &m_configuration.m_dirSnapshotMaxAge, 0))
+            {
+               return false;
+            }
+         }
+         else
+         {
+            m_log.Emsg("Config", "Error: dirsnapshot stanza contains unknown directive '", p, "'");
+            return false;
+         }
+      }
+   }
+   else if ( part == "infostore" )
+   {
+      const char *p = cwg.GetWord();
+      if (strcmp(p, "cinfo") == 0)
+      {
+         m_configuration.m_infoStoreLog = false;
+      }
+      else if (strcmp(p, "log") == 0)
+      {
+         m_configuration.m_infoStoreLog = true;
+         while ((p = cwg.GetWord()) && cwg.HasLast())
+         {
+            if (strcmp(p, "flushdelay") == 0)
+            {
+               if (XrdOuca2x::a2i(m_log, "Error getting infostore flushdelay", cwg.GetWord(),
+                                  &m_configuration.m_infoStoreFlushDelay, 0, 10000))
+               {
+                  return false;
+               }
+            }
+            else
+            {
+               m_log.Emsg("Config", "Error: infostore stanza contains unknown directive '", p, "'");
+               return false;
+            }
+         }
+      }
+      else
+      {
+         m_log.Emsg("Config", "Error: infostore requires 'cinfo' or 'log', got '", p, "'");
+         return false;
+      }
+   }
    else if ( part == "blocksize" )
    {
       if ( ! blocksize_str2value("Config", cwg.GetWord(), CFG.m_bufferSize,
@@ -1077,6 +1212,13 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
          return false;
       }
    }
+   else if ( part == "ramtier" )
+   {
+      if ( XrdOuca2x::a2sz(m_log, "get RAM tier size", cwg.GetWord(), &m_configuration.m_RamTierSize, 0, 1024ll * 1024 * 1024 * 1024))
+      {
+         return false;
+      }
+   }
    else if ( part == "writequeue")
    {
       if (XrdOuca2x::a2i(m_log, "Error getting pfc.writequeue num-blocks", cwg.GetWord(), &m_configuration.m_wqueue_blocks, 1, 1024))
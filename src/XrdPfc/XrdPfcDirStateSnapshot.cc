@@ -123,19 +123,10 @@ void DataFsSnapshot::write_json_file(const std::string &file_path, XrdOss& oss,
 
    std::string cinfo_path(file_path + Info::s_infoExtension);
 
-   if ((cret = oss.Create(myUser, cinfo_path.c_str(), mode, myEnv, XRDOSS_mkpath)) != XrdOssOK)
-   {
-      TRACE(Error, "Create failed for info file " << cinfo_path << ERRNO_AND_ERRSTR(-cret));
-      myFile->Close(); delete myFile;
-      return;
-   }
-
-   XrdOssDF *myInfoFile = oss.newFile(myUser);
-   if ((cret = myInfoFile->Open(cinfo_path.c_str(), O_RDWR, mode, myEnv)) != XrdOssOK)
+   XrdOssDF *myInfoFile = Cache::TheOne().OpenInfoFile(cinfo_path, O_RDWR | O_CREAT, cret, mode);
+   if ( ! myInfoFile)
    {
       TRACE(Error, "Open failed for info file " << cinfo_path << ERRNO_AND_ERRSTR(-cret));
-      delete myInfoFile;
-      myFile->Close(); delete myFile;
       return;
    }
 
@@ -0,0 +1,526 @@
+#include "XrdPfcDirStateStore.hh"
+#include "XrdPfcDirState.hh"
+#include "XrdPfc.hh"
+#include "XrdPfcTrace.hh"
+
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucCRC.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace XrdPfc;
+
+//==============================================================================
+// File layout, all numbers in host byte order.
+//
+// Snapshot:  magic[8] generation:u64 time:i64 scan_time:i64 n_dirs:u32 crc32c:u32
+//            n_dirs x { parent_idx:u32 name:str usage }, parents come first
+// Journal:   magic[8] generation:u64
+//            records { length:u32 crc32c:u32 entries[length] }
+//            entry 'U': path:str usage, entry 'R': path:str
+//
+// str is length:u16 followed by the characters,
+// usage is st_blocks:i64 n_files:i32 last_open:i64 last_close:i64.
+//
+// scan_time is the time of the full name-space scan the snapshot descends
+// from. It is carried over to snapshots of a loaded tree so that the maximum
+// age bounds how long changes lost in a crash can go uncorrected.
+//==============================================================================
+
+namespace
+{
+   XrdSysTrace* GetTrace() { return Cache::GetInstance().GetTrace(); }
+   const char *m_traceID = "DirStateStore";
+
+   const char s_snap_magic[8] = { 'X', 'r', 'd', 'P', 'f', 'c', 'S', '2' };
+   const char s_jrnl_magic[8] = { 'X', 'r', 'd', 'P', 'f', 'c', 'J', '1' };
+
+   const uint32_t s_no_parent = 0xffffffff;
+
+   template<typename T>
+   void put(std::string &b, T v) { b.append((const char*) &v, sizeof(T)); }
+
+   void put_str(std::string &b, const std::string &s)
+   {
+      put<uint16_t>(b, s.length());
+      b.append(s);
+   }
+
+   void put_usage(std::string &b, const DirUsage &u)
+   {
+      put<int64_t>(b, u.m_StBlocks);
+      put<int32_t>(b, u.m_NFiles);
+      put<int64_t>(b, u.m_LastOpenTime);
+      put<int64_t>(b, u.m_LastCloseTime);
+   }
+
+   struct Reader
+   {
+      const char *m_pos, *m_end;
+      bool        m_ok = true;
+
+      Reader(const char *p, size_t len) : m_pos(p), m_end(p + len) {}
+
+      bool at_end() const { return m_pos == m_end; }
+
+      template<typename T>
+      T get()
+      {
+         T v{};
+         if (m_end - m_pos < (long) sizeof(T)) { m_ok = false; return v; }
+         memcpy(&v, m_pos, sizeof(T));
+         m_pos += sizeof(T);
+         return v;
+      }
+
+      std::string get_str()
+      {
+         uint16_t len = get<uint16_t>();
+         if ( ! m_ok || m_end - m_pos < len) { m_ok = false; return std::string(); }
+         std::string s(m_pos, len);
+         m_pos += len;
+         return s;
+      }
+
+      DirUsage get_usage()
+      {
+         DirUsage u;
+         u.m_StBlocks      = get<int64_t>();
+         u.m_NFiles        = get<int32_t>();
+         u.m_LastOpenTime  = get<int64_t>();
+         u.m_LastCloseTime = get<int64_t>();
+         return u;
+      }
+   };
+
+   void clear_tree(DirState &root)
+   {
+      root.m_subdirs.clear();
+      root.m_here_usage             = DirUsage();
+      root.m_recursive_subdir_usage = DirUsage();
+      root.m_scanned                = false;
+   }
+
+   void add_to_usage(DirState &ds, const DirUsage &d)
+   {
+      ds.m_here_usage.m_StBlocks += d.m_StBlocks;
+      ds.m_here_usage.m_NFiles   += d.m_NFiles;
+      ds.m_here_usage.update_last_times(d);
+   }
+
+   bool has_negative_usage(const DirState &ds)
+   {
+      if (ds.m_here_usage.m_StBlocks < 0 || ds.m_here_usage.m_NFiles < 0)
+         return true;
+      for (auto & [name, sub] : ds.m_subdirs)
+         if (has_negative_usage(sub))
+            return true;
+      return false;
+   }
+
+   void serialize_tree(const DirState &ds, uint32_t parent, std::string &buf, uint32_t &n_dirs)
+   {
+      uint32_t idx = n_dirs++;
+      put<uint32_t>(buf, parent);
+      put_str(buf, ds.m_dir_name);
+      put_usage(buf, ds.m_here_usage);
+      for (auto & [name, sub] : ds.m_subdirs)
+         serialize_tree(sub, idx, buf, n_dirs);
+   }
+}
+
+//------------------------------------------------------------------------------
+
+DirStateStore::DirStateStore(XrdOss &oss, const std::string &dir) :
+   m_oss(oss),
+   m_dir(dir),
+   m_snap_path(dir + "/DirState.snap"),
+   m_jrnl_path(dir + "/DirState.jrnl")
+{}
+
+DirStateStore::~DirStateStore()
+{
+   if (m_jrnl_file)
+   {
+      m_jrnl_file->Close();
+      delete m_jrnl_file;
+   }
+}
+
+//------------------------------------------------------------------------------
+
+XrdOssDF* DirStateStore::open_file(const std::string &path, int oflags)
+{
+   const Configuration &conf   = Cache::Conf();
+   const char          *myUser = conf.m_username.c_str();
+   XrdOucEnv            myEnv;
+   int                  cret;
+
+   myEnv.Put("oss.cgroup", conf.m_meta_space.c_str());
+
+   if ((oflags & O_CREAT) &&
+       (cret = m_oss.Create(myUser, path.c_str(), 0644, myEnv, XRDOSS_mkpath)) != XrdOssOK)
+   {
+      TRACE(Error, "Create failed for " << path << ERRNO_AND_ERRSTR(-cret));
+      return nullptr;
+   }
+
+   XrdOssDF *file = m_oss.newFile(myUser);
+   if ((cret = file->Open(path.c_str(), oflags & ~O_CREAT, 0644, myEnv)) != XrdOssOK)
+   {
+      if ((oflags & O_CREAT) || cret != -ENOENT)
+         TRACE(Error, "Open failed for " << path << ERRNO_AND_ERRSTR(-cret));
+      delete file;
+      return nullptr;
+   }
+   return file;
+}
+
+bool DirStateStore::read_file(const std::string &path, std::string &buf)
+{
+   XrdOssDF *file = open_file(path, O_RDONLY);
+   if ( ! file)
+      return false;
+
+   struct stat st;
+   bool ok = file->Fstat(&st) == XrdOssOK;
+   if (ok)
+   {
+      buf.resize(st.st_size);
+      ok = file->Read(buf.data(), 0, st.st_size) == st.st_size;
+   }
+   file->Close();
+   delete file;
+   return ok;
+}
+
+//------------------------------------------------------------------------------
+
+bool DirStateStore::Load(DataFsState &fs_state, time_t max_age, std::string &err)
+{
+   DirState *root = fs_state.get_root();
+   std::string buf;
+
+   if ( ! read_file(m_snap_path, buf))
+   {
+      err = "no snapshot at " + m_snap_path;
+      return false;
+   }
+
+   Reader r(buf.data(), buf.size());
+   char magic[8];
+   for (char &c : magic) c = r.get<char>();
+   unsigned long long generation = r.get<uint64_t>();
+   time_t             snap_time  = r.get<int64_t>();
+   time_t             scan_time  = r.get<int64_t>();
+   uint32_t           n_dirs     = r.get<uint32_t>();
+   uint32_t           crc        = r.get<uint32_t>();
+
+   if ( ! r.m_ok || memcmp(magic, s_snap_magic, sizeof(magic)) != 0 || n_dirs == 0)
+   {
+      err = "bad snapshot header";
+      return false;
+   }
+   if (XrdOucCRC::Calc32C(r.m_pos, r.m_end - r.m_pos) != crc)
+   {
+      err = "snapshot checksum mismatch";
+      return false;
+   }
+   if (max_age > 0 && time(0) - scan_time > max_age)
+   {
+      err = "last full scan is older than the configured maximum age";
+      return false;
+   }
+
+   std::vector<DirState*> dirs;
+   dirs.reserve(n_dirs);
+   for (uint32_t i = 0; i < n_dirs; ++i)
+   {
+      uint32_t    parent = r.get<uint32_t>();
+      std::string name   = r.get_str();
+      DirUsage    usage  = r.get_usage();
+
+      if ( ! r.m_ok || (i == 0) != (parent == s_no_parent) || (i > 0 && parent >= i))
+      {
+         err = "corrupt snapshot entry";
+         clear_tree(*root);
+         return false;
+      }
+
+      DirState *ds = (i == 0) ? root : dirs[parent]->create_child(name);
+      add_to_usage(*ds, usage);
+      ds->m_scanned = true;
+      dirs.push_back(ds);
+   }
+   if ( ! r.at_end())
+   {
+      err = "trailing data in snapshot";
+      clear_tree(*root);
+      return false;
+   }
+   m_generation = generation;
+
+   int n_records = replay_journal(fs_state);
+   if (n_records < 0 || has_negative_usage(*root))
+   {
+      err = "journal does not match the snapshot";
+      clear_tree(*root);
+      return false;
+   }
+
+   root->upward_propagate_initial_scan_usages();
+   m_scan_time = scan_time;
+
+   TRACE(Info, "Loaded snapshot with " << n_dirs << " directories, age " << time(0) - snap_time
+               << "s, last full scan " << time(0) - scan_time << "s ago, replayed "
+               << n_records << " journal records");
+   return true;
+}
+
+int DirStateStore::replay_journal(DataFsState &fs_state)
+{
+   // Returns number of records replayed or -1 for an inconsistent journal.
+   // A missing journal, one from another generation, or a torn tail are fine.
+
+   DirState *root = fs_state.get_root();
+   std::string buf;
+
+   if ( ! read_file(m_jrnl_path, buf))
+      return 0;
+
+   Reader r(buf.data(), buf.size());
+   char magic[8];
+   for (char &c : magic) c = r.get<char>();
+   unsigned long long generation = r.get<uint64_t>();
+
+   if ( ! r.m_ok || memcmp(magic, s_jrnl_magic, sizeof(magic)) != 0 || generation != m_generation)
+   {
+      TRACE(Info, "Journal " << m_jrnl_path << " is not for the current snapshot, ignoring it");
+      return 0;
+   }
+
+   int n_records = 0;
+   while ( ! r.at_end())
+   {
+      uint32_t len = r.get<uint32_t>();
+      uint32_t crc = r.get<uint32_t>();
+      if ( ! r.m_ok || r.m_end - r.m_pos < len || XrdOucCRC::Calc32C(r.m_pos, len) != crc)
+      {
+         TRACE(Warning, "Ignoring incomplete record at the end of journal " << m_jrnl_path);
+         break;
+      }
+
+      Reader e(r.m_pos, len);
+      while (e.m_ok && ! e.at_end())
+      {
+         char        type = e.get<char>();
+         std::string path = e.get_str();
+         if (type == 'U')
+         {
+            DirUsage d = e.get_usage();
+            if ( ! e.m_ok) break;
+            DirState *ds = root->find_path(path, -1, false, true);
+            add_to_usage(*ds, d);
+            ds->m_scanned = true;
+         }
+         else if (type == 'R')
+         {
+            DirState *ds = root->find_path(path, -1, false, false);
+            if (ds && ds->m_parent && ds->m_subdirs.empty())
+               ds->m_parent->m_subdirs.erase(ds->m_dir_name);
+         }
+         else
+         {
+            return -1;
+         }
+      }
+      if ( ! e.m_ok)
+         return -1;
+
+      r.m_pos += len;
+      ++n_records;
+   }
+   return n_records;
+}
+
+//------------------------------------------------------------------------------
+
+bool DirStateStore::WriteSnapshot(DataFsState &fs_state)
+{
+   using namespace std::chrono;
+
+   // A new generation on each snapshot; time based so that it also differs
+   // from a snapshot that failed to load.
+   unsigned long long generation =
+      duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+   if (generation <= m_generation)
+      generation = m_generation + 1;
+
+   // Without a loaded snapshot the tree comes from a full scan.
+   time_t now = time(0);
+   if (m_scan_time == 0)
+      m_scan_time = now;
+
+   std::string payload;
+   uint32_t    n_dirs = 0;
+   serialize_tree(*fs_state.get_root(), s_no_parent, payload, n_dirs);
+
+   std::string buf;
+   buf.reserve(40 + payload.size());
+   buf.append(s_snap_magic, sizeof(s_snap_magic));
+   put<uint64_t>(buf, generation);
+   put<int64_t> (buf, now);
+   put<int64_t> (buf, m_scan_time);
+   put<uint32_t>(buf, n_dirs);
+   put<uint32_t>(buf, XrdOucCRC::Calc32C(payload.data(), payload.size()));
+   buf.append(payload);
+
+   // Write to a temporary file and rename it, the old snapshot stays valid
+   // until the new one is complete.
+   std::string tmp_path = m_snap_path + ".tmp";
+   XrdOssDF *file = open_file(tmp_path, O_RDWR | O_CREAT);
+   if ( ! file)
+      return false;
+
+   bool ok = file->Ftruncate(0) == XrdOssOK &&
+             file->Write(buf.data(), 0, buf.size()) == (ssize_t) buf.size() &&
+             file->Fsync() == XrdOssOK;
+   file->Close();
+   delete file;
+
+   int ret;
+   if ( ! ok || (ret = m_oss.Rename(tmp_path.c_str(), m_snap_path.c_str())) != XrdOssOK)
+   {
+      TRACE(Error, "Failed writing snapshot " << m_snap_path);
+      return false;
+   }
+
+   m_generation = generation;
+   m_pending.clear();
+   m_n_pending = 0;
+
+   TRACE(Debug, "Wrote snapshot with " << n_dirs << " directories, " << buf.size() << " bytes");
+
+   if ( ! start_journal())
+      return false;
+
+   // Make the rename and the new journal durable before any journal record
+   // of this generation is; otherwise a crash could leave the records next
+   // to the previous snapshot, which would then be loaded without them.
+   if ( ! sync_dir())
+   {
+      invalidate();
+      return false;
+   }
+   return true;
+}
+
+bool DirStateStore::start_journal()
+{
+   if ( ! m_jrnl_file && ! (m_jrnl_file = open_file(m_jrnl_path, O_RDWR | O_CREAT)))
+   {
+      invalidate();
+      return false;
+   }
+
+   std::string buf(s_jrnl_magic, sizeof(s_jrnl_magic));
+   put<uint64_t>(buf, m_generation);
+
+   if (m_jrnl_file->Ftruncate(0) != XrdOssOK ||
+       m_jrnl_file->Write(buf.data(), 0, buf.size()) != (ssize_t) buf.size())
+   {
+      TRACE(Error, "Failed starting journal " << m_jrnl_path);
+      m_jrnl_file->Close();
+      delete m_jrnl_file;
+      m_jrnl_file = nullptr;
+      invalidate();
+      return false;
+   }
+   m_jrnl_offset = buf.size();
+   return true;
+}
+
+bool DirStateStore::sync_dir()
+{
+   char pfn[4096];
+   int  ret = m_oss.Lfn2Pfn(m_dir.c_str(), pfn, sizeof(pfn));
+   int  fd  = -1;
+
+   if (ret == XrdOssOK && (fd = open(pfn, O_RDONLY | O_DIRECTORY)) < 0)
+      ret = -errno;
+   if (fd >= 0)
+   {
+      if (fsync(fd) != 0)
+         ret = -errno;
+      close(fd);
+   }
+   if (ret != XrdOssOK)
+      TRACE(Error, "Failed syncing directory " << m_dir << ERRNO_AND_ERRSTR(-ret));
+   return ret == XrdOssOK;
+}
+
+void DirStateStore::invalidate()
+{
+   // Changes can no longer be journaled, make sure the snapshot is not used.
+   int ret = m_oss.Unlink(m_snap_path.c_str());
+   if (ret != XrdOssOK && ret != -ENOENT)
+      TRACE(Error, "Failed removing snapshot " << m_snap_path << ERRNO_AND_ERRSTR(-ret));
+}
+
+//------------------------------------------------------------------------------
+
+void DirStateStore::AddUsageDelta(DirState *ds, const DirUsage &delta)
+{
+   std::string path;
+   ds->generate_dir_path(path);
+
+   put<char>(m_pending, 'U');
+   put_str(m_pending, path);
+   put_usage(m_pending, delta);
+   ++m_n_pending;
+}
+
+void DirStateStore::AddDirRemoval(const std::string &dir_path)
+{
+   put<char>(m_pending, 'R');
+   put_str(m_pending, dir_path);
+   ++m_n_pending;
+}
+
+void DirStateStore::FlushJournal()
+{
+   if (m_n_pending == 0)
+      return;
+
+   if (m_jrnl_file)
+   {
+      std::string buf;
+      put<uint32_t>(buf, m_pending.size());
+      put<uint32_t>(buf, XrdOucCRC::Calc32C(m_pending.data(), m_pending.size()));
+      buf.append(m_pending);
+
+      if (m_jrnl_file->Write(buf.data(), m_jrnl_offset, buf.size()) == (ssize_t) buf.size() &&
+          m_jrnl_file->Fsync() == XrdOssOK)
+      {
+         m_jrnl_offset += buf.size();
+      }
+      else
+      {
+         // Later records would be replayed without this one. Stop journaling
+         // until the next snapshot, a restart will then do the full scan.
+         TRACE(Error, "Failed writing to journal " << m_jrnl_path << ", disabling it until next snapshot");
+         m_jrnl_file->Close();
+         delete m_jrnl_file;
+         m_jrnl_file = nullptr;
+         invalidate();
+      }
+   }
+
+   m_pending.clear();
+   m_n_pending = 0;
+}
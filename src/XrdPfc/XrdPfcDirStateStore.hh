@@ -0,0 +1,94 @@
+#ifndef __XRDPFC_DIRSTATESTORE_HH__
+#define __XRDPFC_DIRSTATESTORE_HH__
+
+#include "XrdPfcDirStateBase.hh"
+
+#include <string>
+#include <vector>
+
+class XrdOss;
+class XrdOssDF;
+
+namespace XrdPfc
+{
+struct DirState;
+struct DataFsState;
+
+//==============================================================================
+// DirStateStore
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Persistent copy of the DirState tree so that a restart does not require
+//! the full name-space scan.
+//!
+//! A snapshot holds the directory tree with the "here" usage of each
+//! directory. Changes processed after the snapshot are appended to a journal
+//! as usage deltas and directory removals, one record per heart-beat. Both
+//! files carry a generation number so a journal is only replayed on top of
+//! the snapshot it was started for. Records are checksummed, a torn last
+//! journal record is ignored.
+//!
+//! Changes not yet journaled are lost when the server stops. Snapshots
+//! therefore remember when the last full scan was done and one whose scan
+//! is older than the maximum age is not loaded.
+//------------------------------------------------------------------------------
+
+class DirStateStore
+{
+public:
+   DirStateStore(XrdOss &oss, const std::string &dir);
+   ~DirStateStore();
+
+   //---------------------------------------------------------------------
+   //! Load snapshot and replay journal into the empty tree of fs_state.
+   //! Usages are propagated upwards as after the initial scan.
+   //! Fails if the last full scan is more than max_age seconds old (0 for
+   //! no limit). On failure the tree is cleared and the reason is returned
+   //! in err.
+   //---------------------------------------------------------------------
+   bool Load(DataFsState &fs_state, time_t max_age, std::string &err);
+
+   //---------------------------------------------------------------------
+   //! Write snapshot of the tree and start a new, empty journal.
+   //! Must be called when usages are up to date with all processed records.
+   //! Without a prior Load() the tree is taken to come from a full scan.
+   //---------------------------------------------------------------------
+   bool WriteSnapshot(DataFsState &fs_state);
+
+   //---------------------------------------------------------------------
+   //! Queue journal entries. Usage is a delta to the directory's here-usage,
+   //! only m_StBlocks, m_NFiles and the last open / close times are used.
+   //---------------------------------------------------------------------
+   void AddUsageDelta(DirState *ds, const DirUsage &delta);
+   void AddDirRemoval(const std::string &dir_path);
+
+   //---------------------------------------------------------------------
+   //! Append queued entries as one record to the journal.
+   //---------------------------------------------------------------------
+   void FlushJournal();
+
+private:
+   XrdOss            &m_oss;
+   const std::string  m_dir;
+   const std::string  m_snap_path;
+   const std::string  m_jrnl_path;
+   XrdOssDF          *m_jrnl_file = nullptr;
+   long long          m_jrnl_offset = 0;
+   unsigned long long m_generation = 0;
+   time_t             m_scan_time = 0;  // of the full scan the tree descends from
+
+   std::string        m_pending;      // serialized journal entries
+   int                m_n_pending = 0;
+
+   XrdOssDF* open_file(const std::string &path, int oflags);
+   bool      read_file(const std::string &path, std::string &buf);
+   bool      start_journal();
+   bool      sync_dir();
+   void      invalidate();
+   int       replay_journal(DataFsState &fs_state);
+};
+
+}
+
+#endif
@@ -9,6 +9,9 @@
 #include "XrdOss/XrdOss.hh"
 #include "XrdOss/XrdOssAt.hh"
 
+#include <algorithm>
+#include <memory>
+
 // Temporary, extensive purge tracing
 // #define TRACE_PURGE(x) TRACE(Debug, x)
 // #define TRACE_PURGE(x) std::cout << "PURGE " << x << "\n"
@@ -18,75 +21,93 @@ using namespace XrdPfc;
 
 const char *FPurgeState::m_traceID = "Purge";
 
-//----------------------------------------------------------------------------
-//! Constructor.
-//----------------------------------------------------------------------------
-FPurgeState::FPurgeState(long long iNBytesReq, XrdOss &oss) :
-   m_oss(oss),
-   m_nStBlocksReq((iNBytesReq >> 9) + 1ll), m_nStBlocksAccum(0), m_nStBlocksTotal(0),
-   m_tMinTimeStamp(0), m_tMinUVKeepTimeStamp(0)
+namespace
 {
+   XrdSysTrace* GetTrace() { return Cache::GetInstance().GetTrace(); }
+
+   // Granularity of the access-time histogram used to place the early-unlink cut.
+   const time_t s_age_bucket = 600;
 
+   // Files that are not cold are unlinked early up to this fraction of the request,
+   // the extrapolated cut being too rough to be trusted with more. The purge asks
+   // for twice the volume it has to remove, so this is half of that volume.
+   const long long s_early_share_div = 4;
 }
 
+//==============================================================================
+// FPurgeState::ScanWorker
+//==============================================================================
+
 //----------------------------------------------------------------------------
-//! Move remaing entires to the member map.
-//! This is used for cold files and for files collected from purge plugin (really?).
+//! Traverses the subtrees handed to it and collects purge candidates
+//! found there in its own heap.
 //----------------------------------------------------------------------------
-void FPurgeState::MoveListEntriesToMap()
+class FPurgeState::ScanWorker
 {
-   for (list_i i = m_flist.begin(); i != m_flist.end(); ++i)
-   {
-      m_fmap.insert(std::make_pair(i->time, *i));
-   }
-   m_flist.clear();
-}
+public:
+   FPurgeState   &m_fps;
+   FsTraversal    m_fst;
+   CandidateHeap  m_heap;
+   list_t         m_flist;
+   long long      m_nStBlocksTotal = 0;
+   pthread_t      m_tid = 0;
+
+   // Scanned usage not yet folded into the shared histogram.
+   std::map<time_t, long long> m_age_hist;
+   long long      m_nStBlocksHist = 0;
+
+   ScanWorker(FPurgeState &fps, XrdOss &oss) : m_fps(fps), m_fst(oss) {}
+
+   void CheckFile(const char *fname, time_t atime, long long nblocks);
+   void ProcessDirAndRecurse();
+   bool ScanDir(const std::string &path);
+};
 
 //----------------------------------------------------------------------------
-//! Open info file. Look at the UV stams and last access time.
-//! Store the file in sorted map or in a list.s
-//! @param fname name of cache-info file
-//! @param Info object
-//! @param stat of the given file
-//!
+//! Cold files go to the unconditional list or directly to early unlinking,
+//! others are kept in the heap if they are among the oldest ones seen.
 //----------------------------------------------------------------------------
-void FPurgeState::CheckFile(const FsTraversal &fst, const char *fname, time_t atime, struct stat &fstat)
+void FPurgeState::ScanWorker::CheckFile(const char *fname, time_t atime, long long nblocks)
 {
-   long long nblocks = fstat.st_blocks;
-   // TRACE(Dump, trc_pfx << "FPurgeState::CheckFile checking " << fname << " accessTime  " << atime);
+   const long long req = m_fps.m_nStBlocksReq;
 
    m_nStBlocksTotal += nblocks;
 
-   // Could remove aged-out / uv-keep-failed files here ... or in the calling function that
-   // can aggreagate info for all files in the directory.
-
    // For now keep using 0 time as this is used in the purge loop to make sure we continue even if enough
    // disk-space has been freed.
 
-   if (m_tMinTimeStamp > 0 && atime < m_tMinTimeStamp)
+   if (m_fps.m_tMinTimeStamp > 0 && atime < m_fps.m_tMinTimeStamp)
    {
-      m_flist.push_back(PurgeCandidate(fst.m_current_path, fname, nblocks, 0));
-      m_nStBlocksAccum += nblocks;
+      PurgeCandidate pc(m_fst.m_current_path, fname, nblocks, 0);
+      m_heap.m_nStBlocksAccum += nblocks;
+      if ( ! m_fps.m_unlink_fn || ! m_fps.queue_early(std::move(pc), true))
+         m_flist.push_back(std::move(pc));
+      return;
    }
-   else if (m_nStBlocksAccum < m_nStBlocksReq || (!m_fmap.empty() && atime < m_fmap.rbegin()->first))
+
+   if (m_fps.m_nStBlocksEstimate > 0)
    {
-      m_fmap.insert(std::make_pair(atime, PurgeCandidate(fst.m_current_path, fname, nblocks, atime)));
-      m_nStBlocksAccum += nblocks;
+      m_age_hist[atime / s_age_bucket] += nblocks;
+      m_nStBlocksHist += nblocks;
 
-      // remove newest files from map if necessary
-      while (!m_fmap.empty() && m_nStBlocksAccum - m_fmap.rbegin()->second.nStBlocks >= m_nStBlocksReq)
+      if (atime < m_fps.m_early_cut.load(std::memory_order_relaxed) &&
+          m_fps.queue_early(PurgeCandidate(m_fst.m_current_path, fname, nblocks, atime), false))
       {
-         m_nStBlocksAccum -= m_fmap.rbegin()->second.nStBlocks;
-         m_fmap.erase(--(m_fmap.rbegin().base()));
+         return;
       }
    }
+
+   if (m_heap.wants(atime, req))
+   {
+      m_heap.add(PurgeCandidate(m_fst.m_current_path, fname, nblocks, atime), req);
+   }
 }
 
-void FPurgeState::ProcessDirAndRecurse(FsTraversal &fst)
+void FPurgeState::ScanWorker::ProcessDirAndRecurse()
 {
-   for (auto it = fst.m_current_files.begin(); it != fst.m_current_files.end(); ++it)
+   for (auto it = m_fst.m_current_files.begin(); it != m_fst.m_current_files.end(); ++it)
    {
-        // Check if the file is currently opened / purge-protected is done before unlinking of the file.
+      // Check if the file is currently opened / purge-protected is done before unlinking of the file.
       const std::string &f_name = it->first;
       const std::string  i_name = f_name + Info::s_infoExtension;
 
@@ -99,42 +120,322 @@ void FPurgeState::ProcessDirAndRecurse(FsTraversal &fst)
       }
 
       time_t atime = it->second.stat_cinfo.st_mtime;
-      CheckFile(fst, i_name.c_str(), atime, it->second.stat_data);
+      CheckFile(i_name.c_str(), atime, it->second.stat_data.st_blocks);
 
       // Protected top-directories are skipped.
    }
 
+   if (m_nStBlocksHist > 0)
+   {
+      m_fps.fold_age_hist(m_age_hist, m_nStBlocksHist);
+      m_nStBlocksHist = 0;
+   }
+
    std::vector<std::string> dirs;
-   dirs.swap(fst.m_current_dirs);
+   dirs.swap(m_fst.m_current_dirs);
    for (auto &dname : dirs)
    {
-      if (fst.cd_down(dname))
+      // Hand the subtree over if some worker is idle.
+      if (m_fps.offer_dir(m_fst.m_current_path + dname + "/"))
+         continue;
+
+      if (m_fst.cd_down(dname))
+      {
+        ProcessDirAndRecurse();
+        m_fst.cd_up();
+      }
+   }
+}
+
+bool FPurgeState::ScanWorker::ScanDir(const std::string &path)
+{
+   m_fst.m_protected_top_dirs.clear();
+   if (path == m_fps.m_root_path)
+   {
+      m_fst.m_protected_top_dirs.insert("pfc-stats"); // XXXX This should come from config. Also: N2N?
+                                                      // Also ... this onoly applies to /, not any root_path
+   }
+
+   bool ok = m_fst.begin_traversal(path.c_str());
+   if (ok)
+   {
+      ProcessDirAndRecurse();
+   }
+   m_fst.end_traversal();
+   return ok;
+}
+
+//==============================================================================
+// FPurgeState
+//==============================================================================
+
+//----------------------------------------------------------------------------
+//! Push a candidate into the heap and drop the newest ones that are not
+//! needed to reach the requested number of st-blocks.
+//----------------------------------------------------------------------------
+void FPurgeState::CandidateHeap::add(PurgeCandidate &&pc, long long req)
+{
+   auto cmp = [](const PurgeCandidate &a, const PurgeCandidate &b) { return a.time < b.time; };
+
+   m_nStBlocksAccum += pc.nStBlocks;
+   m_vec.emplace_back(std::move(pc));
+   std::push_heap(m_vec.begin(), m_vec.end(), cmp);
+
+   while ( ! m_vec.empty() && m_nStBlocksAccum - m_vec.front().nStBlocks >= req)
+   {
+      m_nStBlocksAccum -= m_vec.front().nStBlocks;
+      std::pop_heap(m_vec.begin(), m_vec.end(), cmp);
+      m_vec.pop_back();
+   }
+}
+
+//----------------------------------------------------------------------------
+//! Constructor.
+//----------------------------------------------------------------------------
+FPurgeState::FPurgeState(long long iNBytesReq, XrdOss &oss) :
+   m_oss(oss),
+   m_nStBlocksReq((iNBytesReq >> 9) + 1ll), m_nStBlocksAccum(0), m_nStBlocksTotal(0),
+   m_tMinTimeStamp(0), m_tMinUVKeepTimeStamp(0),
+   m_cond(0), m_early_cond(0)
+{
+
+}
+
+//----------------------------------------------------------------------------
+//! Move remaing entires to the member map.
+//! This is used for cold files and for files collected from purge plugin (really?).
+//----------------------------------------------------------------------------
+void FPurgeState::MoveListEntriesToMap()
+{
+   for (list_i i = m_flist.begin(); i != m_flist.end(); ++i)
+   {
+      m_fmap.insert(std::make_pair(i->time, *i));
+   }
+   m_flist.clear();
+}
+
+//----------------------------------------------------------------------------
+
+void* FPurgeState::scan_worker_thread(void *arg)
+{
+   ScanWorker *w = static_cast<ScanWorker*>(arg);
+   w->m_fps.worker_loop(*w);
+   return nullptr;
+}
+
+void FPurgeState::worker_loop(ScanWorker &w)
+{
+   XrdSysCondVarHelper _lck(m_cond);
+   while (true)
+   {
+      if ( ! m_dir_queue.empty())
+      {
+         std::string path = std::move(m_dir_queue.back());
+         m_dir_queue.pop_back();
+         ++m_n_busy;
+         _lck.UnLock();
+
+         bool ok = w.ScanDir(path);
+
+         _lck.Lock(&m_cond);
+         --m_n_busy;
+         if ( ! ok && path == m_root_path)
+            m_root_failed = true;
+         continue;
+      }
+      if (m_n_busy == 0)
+      {
+         if ( ! m_scan_done)
+         {
+            m_scan_done = true;
+            m_cond.Broadcast();
+
+            XrdSysCondVarHelper _elck(m_early_cond);
+            m_early_done = true;
+            m_early_cond.Signal();
+         }
+         break;
+      }
+      ++m_n_idle;
+      m_cond.Wait();
+      --m_n_idle;
+   }
+}
+
+bool FPurgeState::offer_dir(const std::string &dir_path)
+{
+   XrdSysCondVarHelper _lck(m_cond);
+   if (m_n_idle <= (int) m_dir_queue.size())
+      return false;
+   m_dir_queue.push_back(dir_path);
+   m_cond.Signal();
+   return true;
+}
+
+//----------------------------------------------------------------------------
+//! Queue a file for unlinking by the driving thread. Not-cold files are only
+//! taken while within a quarter of the requested volume.
+//----------------------------------------------------------------------------
+bool FPurgeState::queue_early(PurgeCandidate &&pc, bool cold)
+{
+   if ( ! cold)
+   {
+      XrdSysCondVarHelper _lck(m_cond);
+      if (m_nStBlocksEarly + pc.nStBlocks > m_nStBlocksReq / s_early_share_div)
+         return false;
+      m_nStBlocksEarly += pc.nStBlocks;
+   }
+
+   XrdSysCondVarHelper _lck(m_early_cond);
+   m_early_queue.emplace_back(std::move(pc));
+   m_early_cond.Signal();
+   return true;
+}
+
+void FPurgeState::fold_age_hist(std::map<time_t, long long> &hist, long long n_blocks)
+{
+   XrdSysCondVarHelper _lck(m_cond);
+   for (auto &[bucket, blocks] : hist)
+      m_age_hist[bucket] += blocks;
+   hist.clear();
+
+   m_nStBlocksScanned += n_blocks;
+   if (m_nStBlocksScanned >= m_nStBlocksNextCut)
+   {
+      update_early_cut();
+      m_nStBlocksNextCut = m_nStBlocksScanned + m_nStBlocksEstimate / 100;
+   }
+}
+
+//----------------------------------------------------------------------------
+//! Extrapolate the access-time distribution of the scanned part to the
+//! expected usage and put the cut at the end of the last bucket that still
+//! keeps the volume older than it within a quarter of the request.
+//! Called with m_cond locked.
+//----------------------------------------------------------------------------
+void FPurgeState::update_early_cut()
+{
+   static const char *trc_pfx = "FPurgeState::update_early_cut ";
+
+   if (m_nStBlocksScanned * 10 < m_nStBlocksEstimate)
+      return;
+
+   const double    scale  = (double) m_nStBlocksEstimate / m_nStBlocksScanned;
+   const long long budget = m_nStBlocksReq / s_early_share_div;
+
+   double accum = 0;
+   time_t cut   = 0;
+   for (auto &[bucket, blocks] : m_age_hist)
+   {
+      accum += scale * blocks;
+      if (accum > budget)
+         break;
+      cut = (bucket + 1) * s_age_bucket;
+   }
+
+   if (cut != m_early_cut.load(std::memory_order_relaxed))
+   {
+      TRACE(Debug, trc_pfx << "scanned " << 512ll * m_nStBlocksScanned << " of expected " << 512ll * m_nStBlocksEstimate
+                   << " bytes, unlinking files accessed before " << cut);
+      m_early_cut.store(cut, std::memory_order_relaxed);
+   }
+}
+
+//----------------------------------------------------------------------------
+//! Unlink queued files until the scan is done or, if not waiting, until
+//! the queue is empty.
+//----------------------------------------------------------------------------
+void FPurgeState::drain_early_queue(bool wait)
+{
+   XrdSysCondVarHelper _lck(m_early_cond);
+   while (true)
+   {
+      if ( ! m_early_queue.empty())
       {
-        ProcessDirAndRecurse(fst);
-        fst.cd_up();
+         list_t batch;
+         batch.swap(m_early_queue);
+         _lck.UnLock();
+
+         for (auto &pc : batch)
+            m_nStBlocksUnlinked += m_unlink_fn(pc);
+
+         _lck.Lock(&m_early_cond);
+         continue;
       }
+      if ( ! wait || m_early_done)
+         break;
+      m_early_cond.Wait();
    }
 }
 
+void FPurgeState::merge_worker(ScanWorker &w)
+{
+   for (auto &pc : w.m_heap.m_vec)
+   {
+      m_fmap.insert(std::make_pair(pc.time, std::move(pc)));
+   }
+   m_nStBlocksAccum += w.m_heap.m_nStBlocksAccum;
+   m_flist.splice(m_flist.end(), w.m_flist);
+   m_nStBlocksTotal += w.m_nStBlocksTotal;
+}
+
 bool FPurgeState::TraverseNamespace(const char *root_path)
 {
-   bool success_p = true;
+   static const char *trc_pfx = "FPurgeState::TraverseNamespace ";
 
-   FsTraversal fst(m_oss);
-   fst.m_protected_top_dirs.insert("pfc-stats"); // XXXX This should come from config. Also: N2N?
-                                                 // Also ... this onoly applies to /, not any root_path
-   if (fst.begin_traversal(root_path))
+   m_root_path   = root_path;
+   m_root_failed = false;
+   m_dir_queue.assign(1, m_root_path);
+   m_n_busy = m_n_idle = 0;
+   m_scan_done = m_early_done = false;
+
+   std::vector<std::unique_ptr<ScanWorker>> workers;
+   for (int i = 0; i < m_n_threads; ++i)
    {
-      ProcessDirAndRecurse(fst);
+      workers.emplace_back(new ScanWorker(*this, m_oss));
+      if (XrdSysThread::Run(&workers.back()->m_tid, scan_worker_thread, workers.back().get(),
+                            XRDSYSTHREAD_HOLD, "XrdPfc Purge Scan"))
+      {
+         TRACE(Warning, trc_pfx << "could not start scan thread, " << XrdSysE2T(errno));
+         workers.pop_back();
+         break;
+      }
+   }
+
+   if (workers.empty())
+   {
+      // Scan in this thread.
+      workers.emplace_back(new ScanWorker(*this, m_oss));
+      worker_loop(*workers.back());
    }
    else
    {
-      // Fail startup, can't open /.
-      success_p = false;
+      if (m_unlink_fn)
+         drain_early_queue(true);
+      for (auto &w : workers)
+         XrdSysThread::Join(w->m_tid, nullptr);
+   }
+   if (m_unlink_fn)
+      drain_early_queue(false);
+
+   for (auto &w : workers)
+      merge_worker(*w);
+
+   // remove newest files from map if necessary
+   while (!m_fmap.empty() && m_nStBlocksAccum - m_fmap.rbegin()->second.nStBlocks >= m_nStBlocksReq)
+   {
+      m_nStBlocksAccum -= m_fmap.rbegin()->second.nStBlocks;
+      m_fmap.erase(--(m_fmap.rbegin().base()));
+   }
+
+   m_age_hist.clear();
+
+   if (m_nStBlocksUnlinked > 0)
+   {
+      TRACE(Info, trc_pfx << "unlinked " << 512ll * m_nStBlocksUnlinked << " bytes while scanning " << root_path);
    }
-   fst.end_traversal();
 
-   return success_p;
+   return ! m_root_failed;
 }
 
 /*
@@ -1,10 +1,15 @@
 #ifndef __XRDPFC_FPURGESTATE_HH__
 #define __XRDPFC_FPURGESTATE_HH__
 
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <atomic>
 #include <ctime>
+#include <functional>
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <sys/stat.h>
 
@@ -38,6 +43,26 @@ public:
    using map_t  = std::multimap<time_t, PurgeCandidate>;
    using map_i  = map_t::iterator;
 
+   // Removes the files of a candidate, returns the number of freed st-blocks.
+   using unlink_fn_t = std::function<long long(const PurgeCandidate&)>;
+
+   //---------------------------------------------------------------------
+   //! Max-heap on access time holding the oldest files that sum up to at
+   //! least the requested number of st-blocks.
+   //---------------------------------------------------------------------
+   struct CandidateHeap
+   {
+      std::vector<PurgeCandidate> m_vec;
+      long long                   m_nStBlocksAccum = 0;
+
+      bool wants(time_t atime, long long req) const
+      { return m_nStBlocksAccum < req || (! m_vec.empty() && atime < m_vec.front().time); }
+
+      void add(PurgeCandidate &&pc, long long req);
+   };
+
+   class ScanWorker;
+
 private:
    XrdOss   &m_oss;
 
@@ -52,6 +77,41 @@ private:
    list_t  m_flist; // list of files to be removed unconditionally
    map_t   m_fmap; // map of files that are purge candidates
 
+   int         m_n_threads = 1;
+
+   // Early unlinking, enabled by setEarlyUnlink().
+   unlink_fn_t m_unlink_fn;
+   long long   m_nStBlocksEstimate = 0;    // expected total usage under the root path
+   long long   m_nStBlocksUnlinked = 0;    // freed by early unlinking
+
+   // Shared state of a parallel traversal, protected by m_cond.
+   XrdSysCondVar            m_cond;
+   std::vector<std::string> m_dir_queue;     // directories not yet claimed by a worker
+   int                      m_n_busy = 0;
+   int                      m_n_idle = 0;
+   bool                     m_scan_done = false;
+   long long                m_nStBlocksEarly = 0; // queued for early unlinking so far
+   std::map<time_t, long long> m_age_hist;   // st-blocks of scanned files per access-time bucket
+   long long                m_nStBlocksScanned = 0;
+   long long                m_nStBlocksNextCut = 0;
+   std::atomic<time_t>      m_early_cut {0}; // files accessed before this time are unlinked early
+
+   std::string              m_root_path;
+   bool                     m_root_failed = false;
+
+   XrdSysCondVar            m_early_cond;    // protects m_early_queue, signals the driving thread
+   list_t                   m_early_queue;   // files to be unlinked by the driving thread
+   bool                     m_early_done = false;
+
+   static void* scan_worker_thread(void *arg);
+   void worker_loop(ScanWorker &w);
+   bool offer_dir(const std::string &dir_path);
+   bool queue_early(PurgeCandidate &&pc, bool cold);
+   void fold_age_hist(std::map<time_t, long long> &hist, long long n_blocks);
+   void update_early_cut();
+   void drain_early_queue(bool wait);
+   void merge_worker(ScanWorker &w);
+
 public:
    FPurgeState(long long iNBytesReq, XrdOss &oss);
 
@@ -63,12 +123,32 @@ public:
    void      setUVKeepMinTime(time_t min_time) { m_tMinUVKeepTimeStamp = min_time; }
    long long getNStBlocksTotal() const { return m_nStBlocksTotal; }
    long long getNBytesTotal() const { return 512ll * m_nStBlocksTotal; }
+   long long getNStBlocksUnlinked() const { return m_nStBlocksUnlinked; }
+
+   void setNThreads(int n) { m_n_threads = n > 0 ? n : 1; }
+
+   //---------------------------------------------------------------------
+   //! Start removing files while the traversal is still running. Cold files
+   //! are passed to unlink_fn as they are found. Once a tenth of the expected
+   //! usage has been scanned, files older than the extrapolated access time
+   //! below which a quarter of the requested volume lies are passed on as
+   //! well, up to that quarter in total. As the purge requests twice the
+   //! volume it has to remove, that is half of the volume to remove.
+   //! unlink_fn is called from the thread running TraverseNamespace().
+   //---------------------------------------------------------------------
+   void setEarlyUnlink(long long nStBlocksEstimate, unlink_fn_t unlink_fn)
+   {
+      m_nStBlocksEstimate = nStBlocksEstimate;
+      m_unlink_fn = std::move(unlink_fn);
+   }
 
    void MoveListEntriesToMap();
 
-   void CheckFile(const FsTraversal &fst, const char *fname, time_t atime, struct stat &fstat);
-
-   void ProcessDirAndRecurse(FsTraversal &fst);
+   //---------------------------------------------------------------------
+   //! Scan the name-space under root_path with m_n_threads threads. Each
+   //! thread keeps its own candidate heap, these are merged into the map
+   //! when the scan is done.
+   //---------------------------------------------------------------------
    bool TraverseNamespace(const char *root_path);
 };
 
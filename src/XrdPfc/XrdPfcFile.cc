@@ -19,6 +19,7 @@
 
 #include "XrdPfcFile.hh"
 #include "XrdPfc.hh"
+#include "XrdPfcRamTier.hh"
 #include "XrdPfcResourceMonitor.hh"
 #include "XrdPfcIO.hh"
 #include "XrdPfcTrace.hh"
@@ -39,6 +40,7 @@
 #include <unordered_map>
 
 #include <fcntl.h>
+#include <sys/time.h>
 
 using namespace XrdPfc;
 
@@ -63,6 +65,7 @@ File::File(const std::string& path, long long iOffset, long long iFileSize) :
    m_filename(path),
    m_offset(iOffset),
    m_file_size(iFileSize),
+   m_data_dev(0),
    m_current_io(m_io_set.end()),
    m_ios_in_detach(0),
    m_non_flushed_cnt(0),
@@ -77,7 +80,10 @@ File::File(const std::string& path, long long iOffset, long long iFileSize) :
    m_prefetch_bytes(0),
    m_prefetch_read_cnt(0),
    m_prefetch_hit_cnt(0),
-   m_prefetch_score(0)
+   m_prefetch_score(0),
+   m_rate_bytes(0),
+   m_rate_time(0),
+   m_read_rate(0)
 {}
 
 File::~File()
@@ -116,6 +122,12 @@ void File::Close()
       m_data_file = nullptr;
    }
 
+   if (m_ram_tier_id)
+   {
+      cache()->GetRamTier()->ReleaseFileId(m_ram_tier_id);
+      m_ram_tier_id = 0;
+   }
+
    if (m_resmon_token >= 0)
    {
       // Last update of file stats has been sent from the final Sync unless we are in_shutdown --
@@ -135,7 +147,7 @@ void File::Close()
       Cache::ResMon().register_file_close(m_resmon_token, time(0), m_stats);
    }
 
-   TRACEF(Debug, "Close() finished, prefetch score = " <<  m_prefetch_score);
+   TRACEF(Debug, "Close() finished, prefetch score = " <<  GetPrefetchScore());
 }
 
 //------------------------------------------------------------------------------
@@ -447,7 +459,7 @@ bool File::Open(XrdOucCacheIO *inputIO)
    std::string ifn = m_filename + Info::s_infoExtension;
 
    bool data_existed = (myOss.Stat(m_filename.c_str(), &data_stat) == XrdOssOK);
-   bool info_existed = (myOss.Stat(ifn.c_str(),        &info_stat) == XrdOssOK);
+   bool info_existed = (cache()->StatInfoFile(ifn, info_stat) == XrdOssOK);
 
    // Create the data file itself.
    char size_str[32]; sprintf(size_str, "%lld", m_file_size);
@@ -472,22 +484,10 @@ bool File::Open(XrdOucCacheIO *inputIO)
       return false;
    }
 
-   myEnv.Put("oss.asize", "64k"); // Advisory, block-map and access list lengths vary.
-   myEnv.Put("oss.cgroup", conf.m_meta_space.c_str());
-   if ((res = myOss.Create(myUser, ifn.c_str(), 0600, myEnv, XRDOSS_mkpath)) != XrdOssOK)
-   {
-      TRACE(Error, tpfx << "Create failed for info file " << ifn << ERRNO_AND_ERRSTR(-res));
-      errno = -res;
-      m_data_file->Close(); delete m_data_file; m_data_file = 0;
-      return false;
-   }
-
-   m_info_file = myOss.newFile(myUser);
-   if ((res = m_info_file->Open(ifn.c_str(), O_RDWR, 0600, myEnv)) != XrdOssOK)
+   if ( ! (m_info_file = cache()->OpenInfoFile(ifn, O_RDWR | O_CREAT, res)))
    {
       TRACEF(Error, tpfx << "Failed for info file " << ifn  << ERRNO_AND_ERRSTR(-res));
       errno = -res;
-      delete m_info_file; m_info_file = 0;
       m_data_file->Close(); delete m_data_file;   m_data_file   = 0;
       return false;
    }
@@ -579,14 +579,24 @@ bool File::Open(XrdOucCacheIO *inputIO)
    }
    else
    {
-      if (futimens(m_info_file->getFD(), NULL)) {
-         TRACEF(Error, tpfx << "failed setting modification time " << ERRNO_AND_ERRSTR(errno));
+      struct timeval now[2];
+      gettimeofday(&now[0], nullptr);
+      now[1] = now[0];
+      if ((res = m_info_file->Fctl(XrdOssDF::Fctl_utimes, sizeof(now), (const char*) now))) {
+         TRACEF(Error, tpfx << "failed setting modification time " << ERRNO_AND_ERRSTR(-res));
       }
       if (pfc_blocksize != conf.m_bufferSize) {
          TRACEF(Info, tpfx << "URL CGI pfc.blocksize ignored for an already existing file");
       }
    }
 
+   if (RamTier *rt = cache()->GetRamTier())
+   {
+      if (initialize_info_file)
+         rt->Invalidate(m_filename);
+      m_ram_tier_id = rt->FileId(m_filename);
+   }
+
    m_cfi.WriteIOStatAttach();
    m_state_cond.Lock();
    m_block_size = m_cfi.GetBufferSize();
@@ -598,6 +608,7 @@ bool File::Open(XrdOucCacheIO *inputIO)
 
    m_data_file->Fstat(&data_stat);
    m_st_blocks = data_stat.st_blocks;
+   m_data_dev  = data_stat.st_dev;
 
    m_resmon_token = Cache::ResMon().register_file_open(m_filename, time(0), data_existed);
    constexpr long long MB = 1024 * 1024;
@@ -842,6 +853,35 @@ int File::ReadBlocksFromDisk(std::vector<XrdOucIOVec>& ioVec, int expected_size)
 
 //------------------------------------------------------------------------------
 
+bool File::ReadBlockViaRamTier(RamTier &rt, int idx, char *buf, int blk_off, int size)
+{
+   // Read the whole block from disk if the RAM tier would take it.
+
+   const long long blk_start = (long long) idx * m_block_size;
+   const int       blk_size  = (int) std::min((long long) m_block_size, m_file_size - blk_start);
+
+   if (blk_size <= 0 || ! rt.WouldAdmit(m_ram_tier_id, idx, blk_size, false))
+      return false;
+
+   char *blk = (char*) malloc(blk_size);
+   if ( ! blk)
+      return false;
+
+   ssize_t rs = m_data_file->Read(blk, blk_start, blk_size);
+   if (rs != blk_size)
+   {
+      TRACEF(Warning, "ReadBlockViaRamTier() read of block " << idx << " returned " << rs);
+      free(blk);
+      return false;
+   }
+
+   memcpy(buf, blk + blk_off, size);
+   rt.Insert(m_ram_tier_id, idx, blk, blk_size);
+   return true;
+}
+
+//------------------------------------------------------------------------------
+
 int File::Read(IO *io, char* iUserBuff, long long iUserOff, int iUserSize, ReadReqRH *rh)
 {
    // rrc_func is ONLY called from async processing.
@@ -922,7 +962,8 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
    //   - otherwise request and inc ref count (unless RAM full => request direct)
    // unlock
 
-   int prefetch_cnt = 0;
+   int       prefetch_cnt = 0;
+   long long bytes_asked  = 0;
 
    ReadRequest *read_req = nullptr;
    BlockList_t  blks_to_request;     // blocks we are issuing a new remote request for
@@ -931,9 +972,12 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
 
    std::vector<XrdOucIOVec> iovec_disk;
    std::vector<XrdOucIOVec> iovec_direct;
+   std::vector<XrdOucIOVec> iovec_ram;   // on-disk chunks to be looked up in the RAM tier first, info = block index
    int                      iovec_disk_total = 0;
    int                      iovec_direct_total = 0;
 
+   RamTier *ram_tier = cache()->GetRamTier();
+
    for (int iov_idx = 0; iov_idx < readVnum; ++iov_idx)
    {
       const XrdOucIOVec &iov = readV[iov_idx];
@@ -946,6 +990,9 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
 
       TRACEF(DumpXL, tpfx << "sid: " << Xrd::hex1 << rh->m_seq_id << " idx_first: " << idx_first << " idx_last: " << idx_last);
 
+      io->m_access_pattern.Record(idx_first, idx_last);
+      bytes_asked += iUserSize;
+
       enum LastBlock_e { LB_other, LB_disk, LB_direct };
 
       LastBlock_e lbe = LB_other;
@@ -956,9 +1003,9 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
          BlockMap_i bi = m_block_map.find(block_idx);
 
          // overlap and read
-         long long off;     // offset in user buffer
-         long long blk_off; // offset in block
-         int       size;    // size to copy
+         long long off     = 0; // offset in user buffer
+         long long blk_off = 0; // offset in block
+         int       size    = 0; // size to copy
 
          overlap(block_idx, m_block_size, iUserOff, iUserSize, off, blk_off, size);
 
@@ -998,16 +1045,24 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
          {
             TRACEF(DumpXL, tpfx << "read from disk " <<  (void*)iUserBuff << " idx = " << block_idx);
 
-            if (lbe == LB_disk)
-               iovec_disk.back().size += size;
+            if (ram_tier)
+            {
+               iovec_ram.push_back( { block_idx * m_block_size + blk_off, size, block_idx, iUserBuff + off } );
+               lbe = LB_other;
+            }
             else
-               iovec_disk.push_back( { block_idx * m_block_size + blk_off, size, 0, iUserBuff + off } );
-            iovec_disk_total += size;
+            {
+               if (lbe == LB_disk)
+                  iovec_disk.back().size += size;
+               else
+                  iovec_disk.push_back( { block_idx * m_block_size + blk_off, size, 0, iUserBuff + off } );
+               iovec_disk_total += size;
+
+               lbe = LB_disk;
+            }
 
             if (m_cfi.TestBitPrefetch(offsetIdx(block_idx)))
                ++prefetch_cnt;
-
-            lbe = LB_disk;
          }
          // Neither ... then we have to go get it ...
          else
@@ -1059,6 +1114,7 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
    } // end for over readV IOVec
 
    inc_prefetch_hit_cnt(prefetch_cnt);
+   update_read_rate(bytes_asked);
 
    m_state_cond.UnLock();
 
@@ -1096,7 +1152,27 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
       }
    }
 
-   // Fourth, read blocks from disk.
+   // Fourth, serve on-disk blocks held in the RAM tier, leave the rest for the disk read.
+   for (auto &v : iovec_ram)
+   {
+      const int blk_off = v.offset - (long long) v.info * m_block_size;
+
+      if (ram_tier->Read(m_ram_tier_id, v.info, v.data, blk_off, v.size) ||
+          ReadBlockViaRamTier(*ram_tier, v.info, v.data, blk_off, v.size))
+      {
+         bytes_read += v.size;
+         continue;
+      }
+
+      if ( ! iovec_disk.empty() && iovec_disk.back().offset + iovec_disk.back().size == v.offset &&
+           iovec_disk.back().data + iovec_disk.back().size == v.data)
+         iovec_disk.back().size += v.size;
+      else
+         iovec_disk.push_back( { v.offset, v.size, 0, v.data } );
+      iovec_disk_total += v.size;
+   }
+
+   // Fifth, read blocks from disk.
    if ( ! iovec_disk.empty())
    {
       int rc = ReadBlocksFromDisk(iovec_disk, iovec_disk_total);
@@ -1192,10 +1268,66 @@ void File::WriteBlockToDisk(Block* b)
       return;
    }
 
+   block_written(b);
+}
+
+//------------------------------------------------------------------------------
+
+void File::WriteBlocksToDisk(Block **blks, int n)
+{
+   // Checksummed caches need pgWrite(), these go block by block.
+   if (n == 1 || m_cfi.IsCkSumCache())
+   {
+      for (int i = 0; i < n; ++i)
+         WriteBlockToDisk(blks[i]);
+      return;
+   }
+
+   std::vector<XrdOucIOVec> iov(n);
+   long long total = 0;
+   for (int i = 0; i < n; ++i)
+   {
+      iov[i] = { blks[i]->m_offset - m_offset, blks[i]->get_size(), 0, blks[i]->get_buff() };
+      total += blks[i]->get_size();
+   }
+
+   ssize_t retval = m_data_file->WriteV(iov.data(), n);
+
+   if (retval != total)
+   {
+      TRACEF(Warning, "WriteToDisk() write of " << n << " blocks failed, ret=" << retval << ", retrying one by one");
+      for (int i = 0; i < n; ++i)
+         WriteBlockToDisk(blks[i]);
+      return;
+   }
+
+   // Once the last block is released this object may be gone.
+   for (int i = 0; i < n; ++i)
+      block_written(blks[i]);
+}
+
+//------------------------------------------------------------------------------
+
+void File::block_written(Block *b)
+{
    const int blk_idx =  (b->m_offset - m_offset) / m_block_size;
 
+   // Blocks requested by clients count as an access, prefetched ones do not.
+   if (RamTier *rt = cache()->GetRamTier())
+   {
+      const int ram_idx = b->m_offset / m_block_size;
+      if (rt->WouldAdmit(m_ram_tier_id, ram_idx, b->get_size(), ! b->m_prefetch))
+      {
+         if (char *copy = (char*) malloc(b->get_size()))
+         {
+            memcpy(copy, b->get_buff(), b->get_size());
+            rt->Insert(m_ram_tier_id, ram_idx, copy, b->get_size());
+         }
+      }
+   }
+
    // Set written bit.
-   TRACEF(Dump, "WriteToDisk() success set bit for block " <<  b->m_offset << " size=" <<  size);
+   TRACEF(Dump, "WriteToDisk() success set bit for block " <<  b->m_offset << " size=" <<  b->get_size());
 
    bool schedule_sync = false;
    {
@@ -1551,7 +1683,7 @@ void File::ProcessBlockResponse(Block *b, int res)
          inc_ref_count(b);
          m_delta_stats.AddWriteStats(b->get_size(), b->get_n_cksum_errors());
          // No check for writes, report-and-merge forced during Sync().
-         cache()->AddWriteTask(b, true);
+         cache()->AddWriteTask(b);
       }
 
       // Swap chunk-reqs vector out of Block, it will be processed outside of lock.
@@ -1652,8 +1784,8 @@ int File::offsetIdx(int iIdx) const
 void File::Prefetch()
 {
    // Check that block is not on disk and not in RAM.
-   // TODO: Could prefetch several blocks at once!
-   //       blks_max could be an argument
+   // Blocks predicted from the access pattern of the current IO are taken
+   // first, otherwise the first missing block of the file.
 
    BlockList_t blks;
 
@@ -1672,44 +1804,58 @@ void File::Prefetch()
          return;
       }
 
-      // Select block(s) to fetch.
-      for (int f = 0; f < m_num_blocks; ++f)
+      // Select block to fetch.
+      int f_act = -1;
+
+      const AccessPattern &ap = (*m_current_io)->m_access_pattern;
+      for (int k = 0; k < m_prefetch_max_blocks_in_flight; ++k)
       {
-         if ( ! m_cfi.TestBitWritten(f))
+         int idx = ap.Next(k);
+         int f   = offsetIdx(idx);
+         if (idx < 0 || f < 0 || f >= m_num_blocks)
+            break;
+
+         if ( ! m_cfi.TestBitWritten(f) && m_block_map.find(idx) == m_block_map.end())
          {
-            int f_act = f + m_offset / m_block_size;
+            TRACEF(DumpXL, "Prefetch predicted block " << idx << ", pattern " << ap.GetKind());
+            f_act = idx;
+            break;
+         }
+      }
 
-            BlockMap_i bi = m_block_map.find(f_act);
-            if (bi == m_block_map.end())
-            {
-               Block *b = PrepareBlockRequest(f_act, *m_current_io, nullptr, true);
-               if (b)
-               {
-                  TRACEF(Dump, "Prefetch take block " << f_act);
-                  blks.push_back(b);
-                  // Note: block ref_cnt not increased, it will be when placed into write queue.
+      for (int f = 0; f < m_num_blocks && f_act < 0; ++f)
+      {
+         if ( ! m_cfi.TestBitWritten(f))
+         {
+            int idx = f + m_offset / m_block_size;
 
-                  inc_prefetch_read_cnt(1);
-               }
-               else
-               {
-                  // This shouldn't happen as prefetching stops when RAM is 70% full.
-                  TRACEF(Warning, "Prefetch allocation failed for block " << f_act);
-               }
-               break;
-            }
+            if (m_block_map.find(idx) == m_block_map.end())
+               f_act = idx;
          }
       }
 
-      if (blks.empty())
+      if (f_act < 0)
       {
          TRACEF(Debug, "Prefetch file is complete, stopping prefetch.");
          m_prefetch_state = kComplete;
          cache()->DeRegisterPrefetchFile(this);
+         return;
+      }
+
+      Block *b = PrepareBlockRequest(f_act, *m_current_io, nullptr, true);
+      if (b)
+      {
+         TRACEF(Dump, "Prefetch take block " << f_act);
+         blks.push_back(b);
+         // Note: block ref_cnt not increased, it will be when placed into write queue.
+
+         inc_prefetch_read_cnt(1);
+         (*m_current_io)->m_active_prefetches += 1;
       }
       else
       {
-         (*m_current_io)->m_active_prefetches += (int) blks.size();
+         // This shouldn't happen as prefetching stops when RAM is 70% full.
+         TRACEF(Warning, "Prefetch allocation failed for block " << f_act);
       }
    }
 
@@ -1724,7 +1870,39 @@ void File::Prefetch()
 
 float File::GetPrefetchScore() const
 {
-   return m_prefetch_score;
+   return m_prefetch_score.load(std::memory_order_relaxed);
+}
+
+float File::GetReadRate() const
+{
+   // The rate is only updated on reads, let it decay while the file is idle.
+   // Rate and time are loaded separately; a rate paired with the time of the
+   // previous update only decays a little too fast for a moment.
+   float  rate = m_read_rate.load(std::memory_order_relaxed);
+   time_t idle = time(0) - m_rate_time.load(std::memory_order_relaxed);
+   return idle > 1 ? rate / idle : rate;
+}
+
+void File::update_read_rate(long long bytes)
+{
+   // Called under m_state_cond lock, the only writer of the rate fields.
+   // Bytes are accumulated for at least a second and then folded into
+   // an exponentially decaying average.
+
+   time_t now       = time(0);
+   time_t rate_time = m_rate_time.load(std::memory_order_relaxed);
+   if (rate_time == 0)
+      m_rate_time.store(rate_time = now, std::memory_order_relaxed);
+
+   m_rate_bytes += bytes;
+   if (now > rate_time)
+   {
+      float rate = m_read_rate.load(std::memory_order_relaxed);
+      m_read_rate.store(0.5f * rate + 0.5f * float(m_rate_bytes) / (now - rate_time),
+                        std::memory_order_relaxed);
+      m_rate_bytes = 0;
+      m_rate_time.store(now, std::memory_order_relaxed);
+   }
 }
 
 XrdSysError* File::GetLog() const
@@ -25,6 +25,8 @@
 #include "XrdOuc/XrdOucCache.hh"
 #include "XrdOuc/XrdOucIOVec.hh"
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <list>
 #include <map>
@@ -38,6 +40,7 @@ namespace XrdPfc
 {
 class File;
 class BlockResponseHandler;
+class RamTier;
 class DirectResponseHandler;
 class IO;
 
@@ -124,6 +127,8 @@ public:
 
    vChunkRequest_t     m_chunk_reqs;
 
+   std::chrono::steady_clock::time_point m_wq_time; // When put into the write queue.
+
    Block(File *f, IO *io, void *rid, char *buf, long long off, int size, int rsize,
          bool m_prefetch, bool cks_net) :
       m_file(f), m_io(io), m_req_id(rid),
@@ -252,9 +257,20 @@ public:
 
    void WriteBlockToDisk(Block *b);
 
+   //----------------------------------------------------------------------
+   //! Write n blocks that are adjacent in the file with a single call.
+   //! Falls back to WriteBlockToDisk() for each of them on error.
+   //----------------------------------------------------------------------
+   void WriteBlocksToDisk(Block **blks, int n);
+
    void Prefetch();
 
    float GetPrefetchScore() const;
+   int   GetPrefetchReadCnt() const { return m_prefetch_read_cnt; }
+   int   GetPrefetchHitCnt()  const { return m_prefetch_hit_cnt; }
+
+   //! Average rate of client reads in bytes/s, used to rank prefetching files.
+   float GetReadRate() const;
 
    //! Log path
    const char* lPath() const;
@@ -266,6 +282,9 @@ public:
 
    long long GetFileSize() const { return m_file_size; }
 
+   //! Device holding the data file, selects the write queue.
+   dev_t GetDataDevice() const { return m_data_dev; }
+
    void AddIO(IO *io);
    int  GetPrefetchCountOnIO(IO *io);
    void StopPrefetchingOnIO(IO *io);
@@ -315,6 +334,8 @@ private:
    const std::string    m_filename;     //!< filename of data file on disk
    const long long      m_offset;       //!< offset of cached file for block-based / hdfs operation
    const long long      m_file_size;    //!< size of cached disk file for block-based operation
+   dev_t                m_data_dev;     //!< device of the data file, set in Open()
+   uint64_t             m_ram_tier_id = 0; //!< id of this file in the RAM tier, set in Open()
 
    // IO objects attached to this file.
 
@@ -370,11 +391,19 @@ private:
    long long m_prefetch_bytes;
    int   m_prefetch_read_cnt;
    int   m_prefetch_hit_cnt;
-   float m_prefetch_score;              // cached
+   // The score, rate time and rate are written under m_state_cond but read
+   // by the prefetch scheduler without it, hence atomic.
+   std::atomic<float> m_prefetch_score; // cached
 
    void inc_prefetch_read_cnt(int prc) { if (prc) { m_prefetch_read_cnt += prc; calc_prefetch_score(); } }
    void inc_prefetch_hit_cnt (int phc) { if (phc) { m_prefetch_hit_cnt  += phc; calc_prefetch_score(); } }
-   void calc_prefetch_score() { m_prefetch_score = float(m_prefetch_hit_cnt) / m_prefetch_read_cnt; }
+   void calc_prefetch_score() { m_prefetch_score.store(float(m_prefetch_hit_cnt) / m_prefetch_read_cnt, std::memory_order_relaxed); }
+
+   long long           m_rate_bytes;    // bytes read since m_rate_time
+   std::atomic<time_t> m_rate_time;
+   std::atomic<float>  m_read_rate;     // cached, bytes/s
+
+   void update_read_rate(long long bytes);
 
    // Helpers
 
@@ -397,6 +426,7 @@ private:
    void   RequestBlocksDirect(IO *io, ReadRequest *read_req, std::vector<XrdOucIOVec>& ioVec, int expected_size);
 
    int    ReadBlocksFromDisk(std::vector<XrdOucIOVec>& ioVec, int expected_size);
+   bool   ReadBlockViaRamTier(RamTier &rt, int idx, char *buf, int blk_off, int size);
 
    int    ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
                              ReadReqRH *rh, const char *tpfx);
@@ -413,6 +443,7 @@ private:
    void inc_ref_count(Block* b);
    void dec_ref_count(Block* b, int count = 1);
    void free_block(Block*);
+   void block_written(Block *b);
 
    bool select_current_io_or_disable_prefetching(bool skip_current);
 
@@ -1,6 +1,7 @@
 #include "XrdPfcFsTraversal.hh"
 #include "XrdPfcDirState.hh"
 #include "XrdPfc.hh"
+#include "XrdPfcInfoStore.hh"
 #include "XrdPfcTrace.hh"
 
 #include "XrdOuc/XrdOucEnv.hh"
@@ -212,4 +213,21 @@ void FsTraversal::slurp_dir_ll(XrdOssDF &dh, int dir_level, const char *path, co
          }
       }
    }
+
+   // With the InfoStore in use the cinfo records are not in the directory.
+   if (InfoStore *is = Cache::TheOne().GetInfoStore())
+   {
+      std::string info_path;
+      for (auto &[name, fps] : m_current_files)
+      {
+         if ( ! fps.has_data || fps.has_cinfo)
+            continue;
+         info_path.assign(path);
+         if (info_path.empty() || info_path.back() != '/')
+            info_path.push_back('/');
+         info_path.append(name).append(info_ext);
+         if (is->Stat(info_path, fstat) == 0)
+            fps.set_cinfo(fstat);
+      }
+   }
 }
@@ -4,6 +4,7 @@
 class XrdSysTrace;
 
 #include "XrdPfc.hh"
+#include "XrdPfcAccessPattern.hh"
 #include "XrdOuc/XrdOucCache.hh"
 #include "XrdSys/XrdSysRAtomic.hh"
 
@@ -80,6 +81,7 @@ private:
    int    m_active_prefetches {0};
    bool   m_allow_prefetching {true};
    bool   m_in_detach         {false};
+   AccessPattern m_access_pattern; // Updated by File::ReadOpusCoalescere()
 
 protected:
    int                m_incomplete_count {0};
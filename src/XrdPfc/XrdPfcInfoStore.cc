@@ -0,0 +1,726 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdPfcInfoStore.hh"
+#include "XrdPfcInfo.hh"
+#include "XrdPfcTrace.hh"
+
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucCRC.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+using namespace XrdPfc;
+
+//==============================================================================
+// Log layout, all numbers in host byte order.
+//
+// The log is a sequence of records { header name value }. A record with
+// val_len < 0 removes the name. The crc32c covers the header fields after
+// it, the name and the value.
+//==============================================================================
+
+namespace
+{
+   struct RecHdr
+   {
+      uint32_t m_magic;
+      uint32_t m_crc;
+      int64_t  m_mtime;
+      uint32_t m_name_len;
+      int32_t  m_val_len;
+   };
+
+   const uint32_t  s_rec_magic   = 0x49666350;           // "PcfI"
+   const size_t    s_io_chunk    = 4 * 1024 * 1024;
+
+   const size_t    s_crc_skip    = offsetof(RecHdr, m_mtime);
+
+   uint32_t record_crc(const RecHdr &h, const char *name, const char *value)
+   {
+      uint32_t crc = XrdOucCRC::Calc32C((const char*) &h + s_crc_skip, sizeof(RecHdr) - s_crc_skip);
+      crc = XrdOucCRC::Calc32C(name, h.m_name_len, crc);
+      if (h.m_val_len > 0)
+         crc = XrdOucCRC::Calc32C(value, h.m_val_len, crc);
+      return crc;
+   }
+
+   void make_record(std::string &b, const std::string &name, const char *value, int len, time_t mtime)
+   {
+      RecHdr h;
+      h.m_magic    = s_rec_magic;
+      h.m_mtime    = mtime;
+      h.m_name_len = name.length();
+      h.m_val_len  = len;
+      h.m_crc      = record_crc(h, name.data(), value);
+
+      b.append((const char*) &h, sizeof(RecHdr));
+      b.append(name);
+      if (len > 0)
+         b.append(value, len);
+   }
+
+   long long record_size(size_t name_len, int val_len)
+   {
+      return sizeof(RecHdr) + name_len + (val_len > 0 ? val_len : 0);
+   }
+
+   void *InfoStoreFlusher(void *s)
+   {
+      ((InfoStore*) s)->FlusherThread();
+      return 0;
+   }
+
+//------------------------------------------------------------------------------
+// InfoStoreDF -- one record presented as a cinfo file.
+//
+// The record is read on Open() and kept in memory. Modifications are put
+// into the store on Fsync(), which waits for them to reach the disk, and on
+// Close(), which does not.
+//------------------------------------------------------------------------------
+
+class InfoStoreDF : public XrdOssDF
+{
+public:
+   InfoStoreDF(InfoStore &s) : XrdOssDF("", DF_isFile), m_store(s) {}
+
+   ~InfoStoreDF() { if (m_open) Close(); }
+
+   int Open(const char *path, int oflag, mode_t mode, XrdOucEnv &env) override
+   {
+      m_name = path;
+      int ret = m_store.Get(m_name, m_buf, &m_mtime);
+      if (ret == -ENOENT && (oflag & O_CREAT))
+      {
+         m_buf.clear();
+         m_mtime = time(0);
+         m_dirty = true;
+         ret     = 0;
+      }
+      m_open = (ret == 0);
+      return ret;
+   }
+
+   ssize_t Read(void *buff, off_t offset, size_t size) override
+   {
+      if (offset >= (off_t) m_buf.size())
+         return 0;
+      size_t n = std::min(size, m_buf.size() - offset);
+      memcpy(buff, m_buf.data() + offset, n);
+      return n;
+   }
+
+   ssize_t Write(const void *buff, off_t offset, size_t size) override
+   {
+      if (offset + size > m_buf.size())
+         m_buf.resize(offset + size);
+      memcpy(&m_buf[offset], buff, size);
+      m_mtime = time(0);
+      m_dirty = true;
+      return size;
+   }
+
+   int Ftruncate(unsigned long long flen) override
+   {
+      m_buf.resize(flen);
+      m_mtime = time(0);
+      m_dirty = true;
+      return XrdOssOK;
+   }
+
+   int Fstat(struct stat *buf) override
+   {
+      memset(buf, 0, sizeof(struct stat));
+      buf->st_mode   = S_IFREG | 0600;
+      buf->st_nlink  = 1;
+      buf->st_size   = m_buf.size();
+      buf->st_blocks = (m_buf.size() + 511) / 512;
+      buf->st_atime  = buf->st_mtime = buf->st_ctime = m_mtime;
+      return XrdOssOK;
+   }
+
+   int Fsync() override
+   {
+      if ( ! m_dirty)
+         return m_store.Sync();
+      m_dirty = false;
+      return m_store.Put(m_name, m_buf, m_mtime, true);
+   }
+
+   int Fctl(int cmd, int alen, const char *args, char **resp) override
+   {
+      if (cmd != Fctl_utimes)
+         return -ENOTSUP;
+      if (alen != sizeof(struct timeval)*2 || ! args)
+         return -EINVAL;
+      m_mtime = ((const struct timeval*) args)[1].tv_sec;
+      m_dirty = true;
+      return XrdOssOK;
+   }
+
+   int Close(long long *retsz=0) override
+   {
+      int ret = 0;
+      if (m_open && m_dirty)
+         ret = m_store.Put(m_name, m_buf, m_mtime, false);
+      m_open = m_dirty = false;
+      if (retsz) *retsz = m_buf.size();
+      return ret;
+   }
+
+private:
+   InfoStore   &m_store;
+   std::string  m_name;
+   std::string  m_buf;
+   time_t       m_mtime = 0;
+   bool         m_open  = false;
+   bool         m_dirty = false;
+};
+}
+
+//==============================================================================
+// InfoStore
+//==============================================================================
+
+const char *InfoStore::m_traceID = "InfoStore";
+
+InfoStore::InfoStore(XrdOss &oss, XrdSysTrace *trace, const std::string &user,
+                     const std::string &space, const std::string &path, int flush_delay,
+                     long long compact_min) :
+   m_oss(oss), m_trace(trace), m_user(user), m_space(space), m_path(path),
+   m_flush_delay(flush_delay), m_compact_min(compact_min),
+   m_cond(0)
+{}
+
+InfoStore::~InfoStore()
+{
+   Close();
+}
+
+XrdOssDF* InfoStore::open_log(const std::string &path, bool create)
+{
+   XrdOucEnv myEnv;
+   int       cret;
+
+   myEnv.Put("oss.cgroup", m_space.c_str());
+
+   if (create &&
+       (cret = m_oss.Create(m_user.c_str(), path.c_str(), 0600, myEnv, XRDOSS_mkpath)) != XrdOssOK)
+   {
+      TRACE(Error, "Create failed for " << path << ERRNO_AND_ERRSTR(-cret));
+      return nullptr;
+   }
+
+   XrdOssDF *file = m_oss.newFile(m_user.c_str());
+   if ((cret = file->Open(path.c_str(), O_RDWR, 0600, myEnv)) != XrdOssOK)
+   {
+      TRACE(Error, "Open failed for " << path << ERRNO_AND_ERRSTR(-cret));
+      delete file;
+      return nullptr;
+   }
+   return file;
+}
+
+//------------------------------------------------------------------------------
+
+bool InfoStore::Open(std::string &err)
+{
+   if ( ! (m_log_file = open_log(m_path, true)))
+   {
+      err = "can not open " + m_path;
+      return false;
+   }
+
+   struct stat st;
+   if (m_log_file->Fstat(&st) != XrdOssOK)
+   {
+      err = "can not stat " + m_path;
+      return false;
+   }
+
+   // Scan the log with a buffered reader, the last record for a name wins.
+   std::vector<char> buf(s_io_chunk);
+   long long buf_off = 0;
+   size_t    buf_len = 0;
+   auto fetch = [&](long long off, size_t len) -> const char* {
+      if (off < buf_off || off + (long long) len > buf_off + (long long) buf_len)
+      {
+         if (len > buf.size())
+            buf.resize(len);
+         ssize_t n = m_log_file->Read(buf.data(), off, buf.size());
+         buf_off = off;
+         buf_len = n > 0 ? n : 0;
+         if (len > buf_len)
+            return nullptr;
+      }
+      return buf.data() + (off - buf_off);
+   };
+
+   long long off = 0;
+   while (off < st.st_size)
+   {
+      const char *p = fetch(off, sizeof(RecHdr));
+      if ( ! p) break;
+
+      RecHdr h;
+      memcpy(&h, p, sizeof(RecHdr));
+      if (h.m_magic != s_rec_magic || h.m_name_len == 0 || h.m_name_len > 4096)
+         break;
+
+      long long rsize = record_size(h.m_name_len, h.m_val_len);
+      if (off + rsize > st.st_size || ! (p = fetch(off, rsize)))
+         break;
+
+      const char *name = p + sizeof(RecHdr);
+      if (record_crc(h, name, name + h.m_name_len) != h.m_crc)
+         break;
+
+      std::string key(name, h.m_name_len);
+      auto it = m_index.find(key);
+      if (it != m_index.end())
+      {
+         m_live_bytes -= record_size(key.length(), it->second.m_len);
+         if (h.m_val_len < 0)
+            m_index.erase(it);
+      }
+      if (h.m_val_len >= 0)
+      {
+         m_index[key] = { off, h.m_val_len, (time_t) h.m_mtime };
+         m_live_bytes += rsize;
+      }
+      off += rsize;
+   }
+
+   if (off < st.st_size)
+   {
+      TRACE(Warning, "Open() " << m_path << ": cutting off " << st.st_size - off <<
+                     " bytes of torn or corrupted records at offset " << off);
+      m_log_file->Ftruncate(off);
+   }
+   m_file_size = off;
+
+   TRACE(Info, "Open() " << m_path << ": " << m_index.size() << " records, " <<
+               m_live_bytes << " live bytes in " << m_file_size << " bytes of log");
+
+   pthread_t tid;
+   if (XrdSysThread::Run(&tid, InfoStoreFlusher, this, 0, "XrdPfc InfoStore Flusher"))
+   {
+      err = "can not start flusher thread";
+      return false;
+   }
+   m_flusher_running = true;
+
+   return true;
+}
+
+void InfoStore::Close()
+{
+   XrdSysCondVarHelper lock(m_cond);
+
+   m_stop = true;
+   m_cond.Broadcast();
+   while (m_flusher_running)
+      m_cond.Wait();
+
+   if (m_log_file)
+   {
+      m_log_file->Close();
+      delete m_log_file;
+      m_log_file = nullptr;
+   }
+}
+
+//------------------------------------------------------------------------------
+
+long long InfoStore::append_record(const std::string &name, const char *value, int len, time_t mtime)
+{
+   long long off = m_file_size + m_flushing.size() + m_pending.size();
+
+   if (m_pending.empty())
+      m_cond.Signal();
+
+   make_record(m_pending, name, value, len, mtime);
+   ++m_queued_seq;
+   ++m_stats.m_NPuts;
+
+   return off;
+}
+
+int InfoStore::read_value(const Entry &e, size_t name_len, std::string &value)
+{
+   long long voff = e.m_off + sizeof(RecHdr) + name_len;
+
+   value.resize(e.m_len);
+
+   if (voff >= m_file_size + (long long) m_flushing.size())
+   {
+      m_pending.copy(&value[0], e.m_len, voff - m_file_size - m_flushing.size());
+   }
+   else if (voff >= m_file_size)
+   {
+      m_flushing.copy(&value[0], e.m_len, voff - m_file_size);
+   }
+   else if (e.m_len > 0)
+   {
+      ssize_t n = m_log_file->Read(&value[0], voff, e.m_len);
+      if (n != e.m_len)
+      {
+         TRACE(Error, "read_value() short read at offset " << voff << ERRNO_AND_ERRSTR((n < 0 ? (int) -n : EIO)));
+         return n < 0 ? (int) n : -EIO;
+      }
+   }
+   return 0;
+}
+
+int InfoStore::wait_for_commit(long long seq)
+{
+   ++m_n_sync_waiters;
+   m_cond.Signal();
+
+   int ret = 0;
+   while (seq > m_committed_seq)
+   {
+      if ( ! m_flusher_running)
+      {
+         ret = -EIO;
+         break;
+      }
+      m_cond.Wait();
+      // A failed batch is kept queued and retried, the waiter gets the error.
+      if (seq > m_committed_seq && m_commit_error)
+      {
+         ret = m_commit_error;
+         break;
+      }
+   }
+
+   --m_n_sync_waiters;
+   return ret;
+}
+
+//------------------------------------------------------------------------------
+
+int InfoStore::Get(const std::string &name, std::string &value, time_t *mtime)
+{
+   XrdSysCondVarHelper lock(m_cond);
+
+   auto it = m_index.find(name);
+   if (it == m_index.end())
+      return -ENOENT;
+
+   if (mtime) *mtime = it->second.m_mtime;
+   return read_value(it->second, name.length(), value);
+}
+
+int InfoStore::Stat(const std::string &name, struct stat &st)
+{
+   XrdSysCondVarHelper lock(m_cond);
+
+   auto it = m_index.find(name);
+   if (it == m_index.end())
+      return -ENOENT;
+
+   memset(&st, 0, sizeof(struct stat));
+   st.st_mode   = S_IFREG | 0600;
+   st.st_nlink  = 1;
+   st.st_size   = it->second.m_len;
+   st.st_blocks = (it->second.m_len + 511) / 512;
+   st.st_atime  = st.st_mtime = st.st_ctime = it->second.m_mtime;
+   return 0;
+}
+
+int InfoStore::Put(const std::string &name, const std::string &value, time_t mtime, bool sync)
+{
+   XrdSysCondVarHelper lock(m_cond);
+
+   long long off = append_record(name, value.data(), value.length(), mtime);
+
+   auto it = m_index.find(name);
+   if (it != m_index.end())
+   {
+      m_live_bytes -= record_size(name.length(), it->second.m_len);
+      it->second = { off, (int) value.length(), mtime };
+   }
+   else
+   {
+      m_index.insert({ name, { off, (int) value.length(), mtime } });
+   }
+   m_live_bytes += record_size(name.length(), value.length());
+
+   return sync ? wait_for_commit(m_queued_seq) : 0;
+}
+
+int InfoStore::Remove(const std::string &name)
+{
+   XrdSysCondVarHelper lock(m_cond);
+
+   auto it = m_index.find(name);
+   if (it == m_index.end())
+      return -ENOENT;
+
+   m_live_bytes -= record_size(name.length(), it->second.m_len);
+   m_index.erase(it);
+
+   append_record(name, nullptr, -1, time(0));
+   return 0;
+}
+
+int InfoStore::Sync()
+{
+   XrdSysCondVarHelper lock(m_cond);
+
+   return wait_for_commit(m_queued_seq);
+}
+
+int InfoStore::PurgeOrphans()
+{
+   // Data files are created before their record and unlinked before it, so a
+   // record without a data file is left over from an interrupted unlink. The
+   // data files are looked up without the lock; a record that was written
+   // again meanwhile belongs to a new file and is kept.
+   std::vector<std::pair<std::string, long long>> recs;
+   {
+      XrdSysCondVarHelper lock(m_cond);
+      recs.reserve(m_index.size());
+      for (auto &i : m_index)
+         recs.push_back({ i.first, i.second.m_off });
+   }
+
+   const size_t ext_len = Info::s_infoExtensionLen;
+   struct stat  st;
+   int          n_purged = 0;
+
+   for (auto &[name, off] : recs)
+   {
+      if (name.length() <= ext_len || name.compare(name.length() - ext_len, ext_len, Info::s_infoExtension))
+         continue;
+      if (m_oss.Stat(name.substr(0, name.length() - ext_len).c_str(), &st) != -ENOENT)
+         continue;
+
+      XrdSysCondVarHelper lock(m_cond);
+      auto it = m_index.find(name);
+      if (it == m_index.end() || it->second.m_off != off)
+         continue;
+
+      m_live_bytes -= record_size(name.length(), it->second.m_len);
+      m_index.erase(it);
+      append_record(name, nullptr, -1, time(0));
+      ++n_purged;
+   }
+
+   if (n_purged)
+      TRACE(Info, "PurgeOrphans() " << m_path << ": removed " << n_purged << " records without data file");
+   return n_purged;
+}
+
+void InfoStore::List(std::vector<std::string> &names)
+{
+   XrdSysCondVarHelper lock(m_cond);
+
+   names.reserve(names.size() + m_index.size());
+   for (auto &i : m_index)
+      names.push_back(i.first);
+}
+
+void InfoStore::GetStats(Stats &s)
+{
+   XrdSysCondVarHelper lock(m_cond);
+
+   s = m_stats;
+   s.m_NRecords  = m_index.size();
+   s.m_LiveBytes = m_live_bytes;
+   s.m_LogBytes  = m_file_size + m_flushing.size() + m_pending.size();
+}
+
+XrdOssDF* InfoStore::newFile()
+{
+   return new InfoStoreDF(*this);
+}
+
+//------------------------------------------------------------------------------
+// Flusher
+//------------------------------------------------------------------------------
+
+void InfoStore::FlusherThread()
+{
+   XrdSysCondVarHelper lock(m_cond);
+
+   while (true)
+   {
+      while (m_pending.empty() && ! m_stop)
+         m_cond.Wait();
+
+      if (m_pending.empty())
+         break;
+
+      // Let more records join the batch unless somebody is waiting for them.
+      if (m_n_sync_waiters == 0 && ! m_stop)
+         m_cond.WaitMS(m_flush_delay);
+
+      commit_pending();
+
+      if (m_commit_error)
+      {
+         if (m_stop) break;
+         m_cond.WaitMS(1000);
+      }
+      else if (m_pending.empty() && m_file_size > m_compact_min && m_live_bytes < m_file_size / 2)
+      {
+         compact();
+      }
+   }
+
+   m_flusher_running = false;
+   m_cond.Broadcast();
+}
+
+void InfoStore::commit_pending()
+{
+   // Called with m_cond locked, m_flushing is empty.
+   m_flushing.swap(m_pending);
+
+   long long seq = m_queued_seq;
+   long long off = m_file_size;
+
+   m_cond.UnLock();
+
+   int     ret = 0;
+   ssize_t n   = m_log_file->Write(m_flushing.data(), off, m_flushing.size());
+   if (n != (ssize_t) m_flushing.size())
+      ret = n < 0 ? (int) n : -EIO;
+   else
+      ret = m_log_file->Fsync();
+
+   m_cond.Lock();
+
+   if (ret == 0)
+   {
+      m_file_size    += m_flushing.size();
+      m_committed_seq = seq;
+      m_commit_error  = 0;
+      ++m_stats.m_NCommits;
+   }
+   else
+   {
+      TRACE(Error, "commit_pending() write of " << m_flushing.size() << " bytes at offset " << off <<
+                   " failed" << ERRNO_AND_ERRSTR(-ret));
+      // Drop what might have made it to the log and queue the batch again.
+      m_log_file->Ftruncate(off);
+      m_pending.insert(0, m_flushing);
+      m_commit_error = ret;
+   }
+   m_flushing.clear();
+
+   m_cond.Broadcast();
+}
+
+bool InfoStore::compact()
+{
+   // Called by the flusher with m_cond locked and nothing queued. The flusher
+   // is the only writer of the log so [0, m_file_size) does not change while
+   // the live records are copied with the lock released; new records are
+   // queued meanwhile and committed to the new log. Records are only moved,
+   // so m_live_bytes stays as it is.
+   const std::string tmp_path = m_path + ".tmp";
+   const long long   old_size = m_file_size;
+
+   std::vector<std::pair<std::string, Entry>> live;
+   live.reserve(m_index.size());
+   for (auto &i : m_index)
+      live.push_back({ i.first, i.second });
+   std::sort(live.begin(), live.end(),
+             [](const auto &a, const auto &b) { return a.second.m_off < b.second.m_off; });
+
+   m_cond.UnLock();
+
+   std::unordered_map<long long, long long> new_offs; // old -> new offset
+   new_offs.reserve(live.size());
+
+   std::string buf;
+   long long   out_off = 0;
+   XrdOssDF   *tmp     = open_log(tmp_path, true);
+   bool        ok      = tmp && tmp->Ftruncate(0) == XrdOssOK;
+
+   for (auto i = live.begin(); ok && i != live.end(); ++i)
+   {
+      long long rsize = record_size(i->first.length(), i->second.m_len);
+      size_t    bpos  = buf.size();
+
+      new_offs[i->second.m_off] = out_off + bpos;
+      buf.resize(bpos + rsize);
+      if (m_log_file->Read(&buf[bpos], i->second.m_off, rsize) != rsize)
+      {
+         TRACE(Error, "compact() short read at offset " << i->second.m_off);
+         ok = false;
+         break;
+      }
+
+      if (buf.size() >= s_io_chunk)
+      {
+         ok = tmp->Write(buf.data(), out_off, buf.size()) == (ssize_t) buf.size();
+         out_off += buf.size();
+         buf.clear();
+      }
+   }
+   if (ok && ! buf.empty())
+   {
+      ok = tmp->Write(buf.data(), out_off, buf.size()) == (ssize_t) buf.size();
+      out_off += buf.size();
+   }
+   ok = ok && tmp->Fsync() == XrdOssOK;
+
+   m_cond.Lock();
+
+   ok = ok && m_oss.Rename(tmp_path.c_str(), m_path.c_str()) == XrdOssOK;
+
+   if ( ! ok)
+   {
+      TRACE(Error, "compact() failed, keeping current log " << m_path);
+      if (tmp) { tmp->Close(); delete tmp; }
+      m_oss.Unlink(tmp_path.c_str());
+      return false;
+   }
+
+   TRACE(Info, "compact() " << m_path << " from " << old_size << " to " << out_off << " bytes");
+
+   m_log_file->Close();
+   delete m_log_file;
+   m_log_file = tmp;
+
+   // Records still in the old log have been copied, the ones queued since
+   // follow the new log.
+   for (auto &i : m_index)
+   {
+      if (i.second.m_off < old_size)
+         i.second.m_off = new_offs[i.second.m_off];
+      else
+         i.second.m_off += out_off - old_size;
+   }
+   m_file_size = out_off;
+   ++m_stats.m_NCompactions;
+
+   return true;
+}
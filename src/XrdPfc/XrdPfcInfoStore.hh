@@ -0,0 +1,160 @@
+#ifndef __XRDPFC_INFOSTORE_HH__
+#define __XRDPFC_INFOSTORE_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <ctime>
+#include <sys/stat.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class XrdOss;
+class XrdOssDF;
+class XrdSysTrace;
+
+namespace XrdPfc
+{
+
+//----------------------------------------------------------------------------
+//! Consolidated store for the content of cinfo files.
+//!
+//! All records live in a single append-only log in the meta space, keyed by
+//! the cinfo file name. The record value is exactly what Info::Write() would
+//! have put into the cinfo file, so Info serialization remains the exchange
+//! format. An in-memory index maps names to log offsets.
+//!
+//! Writes are queued and committed by a flusher thread that writes and
+//! fsyncs them in batches: a batch is committed when a caller waits for
+//! durability or flush_delay ms after its first record was queued. The log
+//! is rewritten without overwritten and removed records when it is larger
+//! than compact_min and these take up more than half of it.
+//----------------------------------------------------------------------------
+
+class InfoStore
+{
+public:
+   struct Stats
+   {
+      long long m_NRecords    = 0;  //!< live records
+      long long m_LiveBytes   = 0;  //!< bytes of live records in log
+      long long m_LogBytes    = 0;  //!< total log size, including queued records
+      long long m_NPuts       = 0;  //!< records written
+      long long m_NCommits    = 0;  //!< write + fsync batches
+      long long m_NCompactions = 0;
+   };
+
+   InfoStore(XrdOss &oss, XrdSysTrace *trace, const std::string &user,
+             const std::string &space, const std::string &path, int flush_delay,
+             long long compact_min = 64ll * 1024 * 1024);
+   ~InfoStore();
+
+   //---------------------------------------------------------------------
+   //! Open or create the log, build the index and start the flusher.
+   //! A torn or corrupted tail of the log is cut off.
+   //---------------------------------------------------------------------
+   bool Open(std::string &err);
+
+   //---------------------------------------------------------------------
+   //! Commit queued records and stop the flusher.
+   //---------------------------------------------------------------------
+   void Close();
+
+   //---------------------------------------------------------------------
+   //! Record access. Functions returning int return 0 or -errno.
+   //! Put() with sync waits until the record is on disk.
+   //---------------------------------------------------------------------
+   int  Get (const std::string &name, std::string &value, time_t *mtime = nullptr);
+   int  Stat(const std::string &name, struct stat &st);
+   int  Put (const std::string &name, const std::string &value, time_t mtime, bool sync);
+   int  Remove(const std::string &name);
+
+   //---------------------------------------------------------------------
+   //! Wait until all records queued so far are on disk.
+   //---------------------------------------------------------------------
+   int  Sync();
+
+   //---------------------------------------------------------------------
+   //! Remove records whose data file does not exist, left behind when the
+   //! server stopped between the unlinks of a data file and its record.
+   //! Returns the number of records removed.
+   //---------------------------------------------------------------------
+   int  PurgeOrphans();
+
+   void List(std::vector<std::string> &names);
+   void GetStats(Stats &s);
+
+   //---------------------------------------------------------------------
+   //! File object presenting a single record as a cinfo file.
+   //---------------------------------------------------------------------
+   XrdOssDF* newFile();
+
+   void FlusherThread();
+
+   static const char *m_traceID;
+   XrdSysTrace* GetTrace() const { return m_trace; }
+
+private:
+   struct Entry
+   {
+      long long m_off;     //!< offset of record header in the log
+      int       m_len;     //!< length of value
+      time_t    m_mtime;
+   };
+
+   XrdOss            &m_oss;
+   XrdSysTrace       *m_trace;
+   const std::string  m_user;
+   const std::string  m_space;
+   const std::string  m_path;
+   const int          m_flush_delay;   //!< in ms
+   const long long    m_compact_min;   //!< do not bother compacting smaller logs
+
+   XrdOssDF          *m_log_file = nullptr;
+   XrdSysCondVar      m_cond;          //!< protects everything below, signals flusher and sync waiters
+
+   std::unordered_map<std::string, Entry> m_index;
+
+   // The log is [0, m_file_size) on disk, followed by m_flushing that is being
+   // written out and by m_pending that collects new records.
+   long long          m_file_size = 0;
+   std::string        m_flushing;
+   std::string        m_pending;
+   long long          m_live_bytes = 0;
+
+   long long          m_queued_seq    = 0;  //!< sequence number of the last queued record
+   long long          m_committed_seq = 0;  //!< all records up to this one are on disk
+   int                m_n_sync_waiters = 0;
+   int                m_commit_error   = 0;
+   bool               m_flusher_running = false;
+   bool               m_stop = false;
+
+   Stats              m_stats;
+
+   long long append_record(const std::string &name, const char *value, int len, time_t mtime);
+   int       read_value(const Entry &e, size_t name_len, std::string &value);
+   int       wait_for_commit(long long seq);
+   void      commit_pending();
+   bool      compact();
+   XrdOssDF* open_log(const std::string &path, bool create);
+};
+
+}
+
+#endif
@@ -0,0 +1,439 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// xrdpfc_infostore -- migrate cinfo files to and from the InfoStore log and
+// compare open / close rates of both backends.
+//
+// The cache must not be running while records are migrated.
+//------------------------------------------------------------------------------
+
+#include "XrdPfcInfo.hh"
+#include "XrdPfcInfoStore.hh"
+#include "XrdPfcStats.hh"
+
+#include "XrdOfs/XrdOfsConfigPI.hh"
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucArgs.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdOuc/XrdOucStream.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+#include "XrdSys/XrdSysTrace.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <string>
+#include <sys/time.h>
+#include <thread>
+#include <vector>
+
+using namespace XrdPfc;
+
+namespace
+{
+   const char *s_store_path = "/pfc-stats/InfoStore.log";
+
+   XrdOss      *g_oss;
+   XrdSysTrace  g_trace("xrdpfc_infostore");
+   const char  *g_user  = "nobody";
+   std::string  g_space = "public";
+
+   bool is_info_file(const std::string &name)
+   {
+      return name.size() > Info::s_infoExtensionLen &&
+             name.compare(name.size() - Info::s_infoExtensionLen, Info::s_infoExtensionLen, Info::s_infoExtension) == 0;
+   }
+
+   // Collect cinfo files below dir, the cache's own top-level directory is skipped.
+   void find_info_files(const std::string &dir, std::vector<std::string> &files)
+   {
+      XrdOucEnv env;
+      XrdOssDF *dh = g_oss->newDir(g_user);
+      if (dh->Opendir(dir.c_str(), env) != XrdOssOK)
+      {
+         delete dh;
+         return;
+      }
+
+      char name[1024];
+      while (dh->Readdir(name, sizeof(name)) == XrdOssOK && name[0])
+      {
+         if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+            continue;
+
+         std::string path = (dir == "/" ? dir : dir + "/") + name;
+         if (path == "/pfc-stats")
+            continue;
+
+         struct stat st;
+         if (g_oss->Stat(path.c_str(), &st) != XrdOssOK)
+            continue;
+         if (S_ISDIR(st.st_mode))
+            find_info_files(path, files);
+         else if (is_info_file(path))
+            files.push_back(path);
+      }
+      dh->Close();
+      delete dh;
+   }
+
+   XrdOssDF* open_oss_file(const std::string &path, int oflags)
+   {
+      XrdOucEnv env;
+      env.Put("oss.cgroup", g_space.c_str());
+      if ((oflags & O_CREAT) && g_oss->Create(g_user, path.c_str(), 0600, env, XRDOSS_mkpath) != XrdOssOK)
+         return nullptr;
+
+      XrdOssDF *fp = g_oss->newFile(g_user);
+      if (fp->Open(path.c_str(), oflags & ~O_CREAT, 0600, env) != XrdOssOK)
+      {
+         delete fp;
+         return nullptr;
+      }
+      return fp;
+   }
+
+   bool open_store(InfoStore &store)
+   {
+      std::string err;
+      if ( ! store.Open(err))
+      {
+         fprintf(stderr, "Can not open InfoStore %s: %s\n", s_store_path, err.c_str());
+         return false;
+      }
+      return true;
+   }
+
+//------------------------------------------------------------------------------
+
+   int do_import(const std::string &root, bool remove)
+   {
+      InfoStore store(*g_oss, &g_trace, g_user, g_space, s_store_path, 100);
+      if ( ! open_store(store))
+         return 1;
+
+      std::vector<std::string> files, imported;
+      find_info_files(root, files);
+
+      for (auto &f : files)
+      {
+         XrdOssDF *fp = open_oss_file(f, O_RDONLY);
+         struct stat st;
+         if ( ! fp || fp->Fstat(&st) != XrdOssOK)
+         {
+            fprintf(stderr, "Can not open %s, skipping.\n", f.c_str());
+            delete fp;
+            continue;
+         }
+
+         // Only take files that Info can parse.
+         Info info(&g_trace);
+         std::string buf(st.st_size, 0);
+         bool ok = fp->Read(&buf[0], 0, st.st_size) == st.st_size && info.Read(fp, f.c_str());
+         fp->Close();
+         delete fp;
+
+         if ( ! ok)
+         {
+            fprintf(stderr, "Can not read %s, skipping.\n", f.c_str());
+            continue;
+         }
+         store.Put(f, buf, st.st_mtime, false);
+         imported.push_back(f);
+      }
+
+      if (store.Sync())
+      {
+         fprintf(stderr, "Writing to InfoStore failed, cinfo files are kept.\n");
+         return 1;
+      }
+      if (remove)
+      {
+         for (auto &f : imported)
+            g_oss->Unlink(f.c_str());
+      }
+
+      printf("Imported %zu of %zu cinfo files%s.\n", imported.size(), files.size(), remove ? ", removed them" : "");
+      return imported.size() == files.size() ? 0 : 1;
+   }
+
+   int do_export(const std::string &root, bool remove)
+   {
+      InfoStore store(*g_oss, &g_trace, g_user, g_space, s_store_path, 100);
+      if ( ! open_store(store))
+         return 1;
+
+      std::vector<std::string> names;
+      store.List(names);
+
+      const std::string prefix = root == "/" ? root : root + "/";
+      int n_exported = 0, n_failed = 0;
+
+      for (auto &n : names)
+      {
+         if (n.compare(0, prefix.size(), prefix) != 0)
+            continue;
+
+         std::string value;
+         time_t      mtime;
+         XrdOssDF   *fp = nullptr;
+         bool ok = store.Get(n, value, &mtime) == 0 &&
+                   (fp = open_oss_file(n, O_RDWR | O_CREAT)) &&
+                   fp->Ftruncate(0) == XrdOssOK &&
+                   fp->Write(value.data(), 0, value.size()) == (ssize_t) value.size() &&
+                   fp->Fsync() == XrdOssOK;
+         if (ok)
+         {
+            struct timeval tv[2] = { {mtime, 0}, {mtime, 0} };
+            fp->Fctl(XrdOssDF::Fctl_utimes, sizeof(tv), (const char*) tv);
+         }
+         if (fp)
+         {
+            fp->Close();
+            delete fp;
+         }
+
+         if ( ! ok)
+         {
+            fprintf(stderr, "Can not export %s.\n", n.c_str());
+            ++n_failed;
+            continue;
+         }
+         ++n_exported;
+         if (remove)
+            store.Remove(n);
+      }
+
+      printf("Exported %d records%s, %d failed.\n", n_exported, remove ? " and removed them from the store" : "", n_failed);
+      return n_failed ? 1 : 0;
+   }
+
+   int do_stat()
+   {
+      InfoStore store(*g_oss, &g_trace, g_user, g_space, s_store_path, 100);
+      if ( ! open_store(store))
+         return 1;
+
+      InfoStore::Stats s;
+      store.GetStats(s);
+      printf("records     %lld\nlive bytes  %lld\nlog bytes   %lld\n", s.m_NRecords, s.m_LiveBytes, s.m_LogBytes);
+      return 0;
+   }
+
+//------------------------------------------------------------------------------
+// Benchmark
+//
+// Each of n_threads threads does n_files open / close cycles the way File does
+// them: the info is read on open and written and synced on close. The first
+// pass creates the records, the second one reopens them.
+//------------------------------------------------------------------------------
+
+   typedef std::function<XrdOssDF*(const std::string&, int)> open_func;
+
+   double bench_pass(open_func opener, const std::string &dir, int n_threads, int n_files, bool create)
+   {
+      auto worker = [&](int t)
+      {
+         for (int i = 0; i < n_files; ++i)
+         {
+            std::string name = dir + "/t" + std::to_string(t) + "/f" + std::to_string(i) + Info::s_infoExtension;
+
+            XrdOssDF *fp = opener(name, create ? O_RDWR | O_CREAT : O_RDWR);
+            if ( ! fp)
+            {
+               fprintf(stderr, "Open failed for %s\n", name.c_str());
+               return;
+            }
+            Info info(&g_trace);
+            if (create)
+            {
+               info.SetBufferSizeFileSizeAndCreationTime(1024*1024, 2ll*1024*1024*1024);
+               info.Write(fp, name.c_str());
+               fp->Fsync();
+            }
+            else
+            {
+               info.Read(fp, name.c_str());
+            }
+            info.WriteIOStatAttach();
+            Stats stats;
+            stats.m_BytesHit = 1024*1024;
+            info.WriteIOStatDetach(stats);
+            info.Write(fp, name.c_str());
+            fp->Fsync();
+            fp->Close();
+            delete fp;
+         }
+      };
+
+      auto start = std::chrono::steady_clock::now();
+      std::vector<std::thread> threads;
+      for (int t = 0; t < n_threads; ++t)
+         threads.emplace_back(worker, t);
+      for (auto &t : threads)
+         t.join();
+      std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+
+      return n_threads * n_files / secs.count();
+   }
+
+   int do_bench(const std::string &dir, int n_threads, int n_files)
+   {
+      printf("Benchmark with %d threads x %d files in %s\n", n_threads, n_files, dir.c_str());
+
+      double c1 = bench_pass(open_oss_file, dir + "/cinfo", n_threads, n_files, true);
+      double c2 = bench_pass(open_oss_file, dir + "/cinfo", n_threads, n_files, false);
+      printf("cinfo files  create %10.1f open/close per second, reopen %10.1f open/close per second\n", c1, c2);
+
+      std::vector<std::string> files;
+      find_info_files(dir + "/cinfo", files);
+      for (auto &f : files)
+         g_oss->Unlink(f.c_str());
+      for (int t = 0; t < n_threads; ++t)
+         g_oss->Remdir((dir + "/cinfo/t" + std::to_string(t)).c_str());
+      g_oss->Remdir((dir + "/cinfo").c_str());
+
+      const std::string log_path = dir + "/InfoStore.bench.log";
+      {
+         InfoStore store(*g_oss, &g_trace, g_user, g_space, log_path, 100);
+         std::string err;
+         if ( ! store.Open(err))
+         {
+            fprintf(stderr, "Can not open %s: %s\n", log_path.c_str(), err.c_str());
+            return 1;
+         }
+         open_func store_opener = [&](const std::string &name, int oflags) -> XrdOssDF* {
+            XrdOucEnv env;
+            XrdOssDF *fp = store.newFile();
+            if (fp->Open(name.c_str(), oflags, 0600, env) != XrdOssOK)
+            {
+               delete fp;
+               return nullptr;
+            }
+            return fp;
+         };
+
+         double s1 = bench_pass(store_opener, dir + "/store", n_threads, n_files, true);
+         double s2 = bench_pass(store_opener, dir + "/store", n_threads, n_files, false);
+
+         InfoStore::Stats s;
+         store.GetStats(s);
+         printf("InfoStore    create %10.1f open/close per second, reopen %10.1f open/close per second\n", s1, s2);
+         printf("             %lld records written in %lld fsync batches, log size %lld bytes\n",
+                s.m_NPuts, s.m_NCommits, s.m_LogBytes);
+      }
+      g_oss->Unlink(log_path.c_str());
+
+      return 0;
+   }
+}
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+   static const char* usage =
+      "Usage: xrdpfc_infostore [-h] [-c config_file] [-s meta_space] [-u user] [-r] command [path]\n"
+      "   import [path]    move cinfo files below path into the InfoStore (-r removes the files)\n"
+      "   export [path]    write InfoStore records below path as cinfo files (-r removes the records)\n"
+      "   stat             print InfoStore statistics\n"
+      "   bench  [path]    compare open / close rates of cinfo files and InfoStore,\n"
+      "                    -t threads (default 8), -n files per thread (default 1000)\n"
+      "The cache must not be running during import and export.\n";
+
+   const char *cfgn      = 0;
+   bool        remove    = false;
+   int         n_threads = 8;
+   int         n_files   = 1000;
+
+   XrdOucEnv    myEnv;
+   XrdSysLogger log;
+   XrdSysError  err(&log);
+
+   XrdOucStream Config(&err, getenv("XRDINSTANCE"), &myEnv, "=====> ");
+   XrdOucArgs   Spec(&err, "xrdpfc_infostore: ", "",
+                     "help",     1, "h",
+                     "config",   1, "c:",
+                     "space",    1, "s:",
+                     "user",     1, "u:",
+                     "remove",   1, "r",
+                     "threads",  1, "t:",
+                     "nfiles",   1, "n:",
+                     (const char *) 0);
+
+   Spec.Set(argc-1, &argv[1]);
+   char theOpt;
+
+   while ((theOpt = Spec.getopt()) != (char)-1)
+   {
+      switch (theOpt)
+      {
+      case 'c': {
+         cfgn = Spec.argval;
+         int fd = open(cfgn, O_RDONLY, 0);
+         Config.Attach(fd);
+         break;
+      }
+      case 's': g_space   = Spec.argval;            break;
+      case 'u': g_user    = Spec.argval;            break;
+      case 'r': remove    = true;                   break;
+      case 't': n_threads = std::atoi(Spec.argval); break;
+      case 'n': n_files   = std::atoi(Spec.argval); break;
+      case 'h':
+      default: {
+         printf("%s", usage);
+         exit(1);
+      }
+      }
+   }
+
+   const char *cmd  = Spec.getarg();
+   const char *path = Spec.getarg();
+   if ( ! cmd || n_threads < 1 || n_files < 1)
+   {
+      printf("%s", usage);
+      exit(1);
+   }
+
+   // suppress oss init messages
+   int efs = open("/dev/null",O_RDWR, 0);
+   XrdSysLogger ossLog(efs);
+   XrdSysError ossErr(&ossLog, "infostore");
+   XrdOfsConfigPI *ofsCfg = XrdOfsConfigPI::New(cfgn,&Config,&ossErr);
+   if ( ! ofsCfg->Load(XrdOfsConfigPI::theOssLib))
+   {
+      printf("can't load oss\n");
+      exit(1);
+   }
+   ofsCfg->Plugin(g_oss);
+
+   g_trace.SetLogger(&log);
+   g_trace.What = 2;
+
+   if (strcmp(cmd, "import") == 0) return do_import(path ? path : "/", remove);
+   if (strcmp(cmd, "export") == 0) return do_export(path ? path : "/", remove);
+   if (strcmp(cmd, "stat")   == 0) return do_stat();
+   if (strcmp(cmd, "bench")  == 0) return do_bench(path ? path : "/pfc-bench", n_threads, n_files);
+
+   printf("%s", usage);
+   return 1;
+}
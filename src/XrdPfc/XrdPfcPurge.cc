@@ -3,6 +3,8 @@
 #include "XrdPfcResourceMonitor.hh"
 #include "XrdPfcFPurgeState.hh"
 #include "XrdPfcPurgePin.hh"
+#include "XrdPfcRamTier.hh"
+#include "XrdPfcInfo.hh"
 #include "XrdPfcTrace.hh"
 
 #include "XrdOss/XrdOss.hh"
@@ -21,49 +23,46 @@ namespace
 namespace XrdPfc
 {
 
-long long UnlinkPurgeStateFilesInMap(FPurgeState& purgeState, long long bytes_to_remove, const std::string& root_path)
+//----------------------------------------------------------------------------
+//! Removes cinfo and data file of purge candidates and keeps the tally.
+//----------------------------------------------------------------------------
+struct PurgeUnlinker
 {
-   static const char *trc_pfx = "UnlinkPurgeStateFilesInMap ";
+   const Cache     &m_cache;
+   ResourceMonitor &m_resmon;
+   XrdOss          &m_oss;
 
-   struct stat fstat;
-   int         protected_cnt = 0;
-   int         deleted_file_count = 0;
-   long long   deleted_st_blocks = 0;
-   long long   protected_st_blocks = 0;
-   long long   st_blocks_to_remove = (bytes_to_remove >> 9) + 1ll;
-   
+   int         m_protected_cnt = 0;
+   int         m_deleted_file_count = 0;
+   long long   m_deleted_st_blocks = 0;
+   long long   m_protected_st_blocks = 0;
 
-   const auto &cache = Cache::TheOne();
-   auto &resmon = Cache::ResMon();
-   auto &oss = *cache.GetOss();
+   PurgeUnlinker() :
+      m_cache(Cache::TheOne()), m_resmon(Cache::ResMon()), m_oss(*m_cache.GetOss())
+   {}
 
-   TRACE(Info, trc_pfx << "Started, root_path = " << root_path << ", bytes_to_remove = " << bytes_to_remove);
-
-   // Loop over map and remove files with oldest values of access time.
-   for (FPurgeState::map_i it = purgeState.refMap().begin(); it != purgeState.refMap().end(); ++it)
+   // Returns the number of st-blocks of the removed data file.
+   long long Unlink(const FPurgeState::PurgeCandidate &pc)
    {
-      // Finish when enough space has been freed but not while age-based purging is in progress.
-      // Those files are marked with time-stamp = 0.
-      if (st_blocks_to_remove <= 0 && it->first != 0)
-      {
-         break;
-      }
+      static const char *trc_pfx = "UnlinkPurgeStateFilesInMap ";
+
+      struct stat fstat;
 
-      std::string &infoPath = it->second.path;
-      std::string  dataPath = infoPath.substr(0, infoPath.size() - Info::s_infoExtensionLen);
+      const std::string &infoPath = pc.path;
+      std::string        dataPath = infoPath.substr(0, infoPath.size() - Info::s_infoExtensionLen);
 
-      if (cache.IsFileActiveOrPurgeProtected(dataPath))
+      if (m_cache.IsFileActiveOrPurgeProtected(dataPath))
       {
-         ++protected_cnt;
-         protected_st_blocks += it->second.nStBlocks;
-         TRACE(Debug, trc_pfx << "File is active or purge-protected: " << dataPath << " size: " << 512ll * it->second.nStBlocks);
-         continue;
+         ++m_protected_cnt;
+         m_protected_st_blocks += pc.nStBlocks;
+         TRACE(Debug, trc_pfx << "File is active or purge-protected: " << dataPath << " size: " << 512ll * pc.nStBlocks);
+         return 0;
       }
 
       // remove info file
-      if (oss.Stat(infoPath.c_str(), &fstat) == XrdOssOK)
+      if (m_cache.StatInfoFile(infoPath, fstat) == XrdOssOK)
       {
-         oss.Unlink(infoPath.c_str());
+         m_cache.UnlinkInfoFile(infoPath);
          TRACE(Dump, trc_pfx << "Removed file: '" << infoPath << "' size: " << 512ll * fstat.st_size);
       }
       else
@@ -72,26 +71,53 @@ long long UnlinkPurgeStateFilesInMap(FPurgeState& purgeState, long long bytes_to
       }
 
       // remove data file
-      if (oss.Stat(dataPath.c_str(), &fstat) == XrdOssOK)
+      if (m_oss.Stat(dataPath.c_str(), &fstat) == XrdOssOK)
       {
-         st_blocks_to_remove -= it->second.nStBlocks;
-         deleted_st_blocks   += it->second.nStBlocks;
-         ++deleted_file_count;
+         if (RamTier *rt = m_cache.GetRamTier())
+            rt->Invalidate(dataPath);
+
+         m_deleted_st_blocks += pc.nStBlocks;
+         ++m_deleted_file_count;
+
+         m_oss.Unlink(dataPath.c_str());
+         TRACE(Dump, trc_pfx << "Removed file: '" << dataPath << "' size: " << 512ll * pc.nStBlocks << ", time: " << pc.time);
+
+         m_resmon.register_file_purge(dataPath, pc.nStBlocks);
+         return pc.nStBlocks;
+      }
+      return 0;
+   }
+};
 
-         oss.Unlink(dataPath.c_str());
-         TRACE(Dump, trc_pfx << "Removed file: '" << dataPath << "' size: " << 512ll * it->second.nStBlocks << ", time: " << it->first);
+long long UnlinkPurgeStateFilesInMap(FPurgeState& purgeState, long long bytes_to_remove, const std::string& root_path)
+{
+   static const char *trc_pfx = "UnlinkPurgeStateFilesInMap ";
 
-         resmon.register_file_purge(dataPath, it->second.nStBlocks);
+   long long   st_blocks_to_remove = (bytes_to_remove >> 9) + 1ll;
+   PurgeUnlinker unlinker;
+
+   TRACE(Info, trc_pfx << "Started, root_path = " << root_path << ", bytes_to_remove = " << bytes_to_remove);
+
+   // Loop over map and remove files with oldest values of access time.
+   for (FPurgeState::map_i it = purgeState.refMap().begin(); it != purgeState.refMap().end(); ++it)
+   {
+      // Finish when enough space has been freed but not while age-based purging is in progress.
+      // Those files are marked with time-stamp = 0.
+      if (st_blocks_to_remove <= 0 && it->first != 0)
+      {
+         break;
       }
+
+      st_blocks_to_remove -= unlinker.Unlink(it->second);
    }
-   if (protected_cnt > 0)
+   if (unlinker.m_protected_cnt > 0)
    {
-      TRACE(Info, trc_pfx << "Encountered " << protected_cnt << " protected files, sum of their size: " << 512ll * protected_st_blocks);
+      TRACE(Info, trc_pfx << "Encountered " << unlinker.m_protected_cnt << " protected files, sum of their size: " << 512ll * unlinker.m_protected_st_blocks);
    }
 
-   TRACE(Info, trc_pfx << "Finished, removed " << deleted_file_count << " data files, removed total size " << 512ll * deleted_st_blocks)
+   TRACE(Info, trc_pfx << "Finished, removed " << unlinker.m_deleted_file_count << " data files, removed total size " << 512ll * unlinker.m_deleted_st_blocks)
 
-   return deleted_st_blocks;
+   return unlinker.m_deleted_st_blocks;
 }
 
 // -------------------------------------------------------------------------------------
@@ -125,6 +151,7 @@ void OldStylePurgeDriver(DataFsPurgeshot &ps)
             TRACE(Debug, trc_pfx << "PurgePin scanning dir " << ppit->path.c_str() << " to remove " << ppit->nBytesToRecover << " bytes");
 
             FPurgeState fps(ppit->nBytesToRecover, oss);
+            fps.setNThreads(conf.m_purgeThreads);
             bool scan_ok = fps.TraverseNamespace(ppit->path.c_str());
             if ( ! scan_ok) {
                TRACE(Warning, trc_pfx << "purge-pin scan of directory failed for " << ppit->path);
@@ -158,6 +185,16 @@ void OldStylePurgeDriver(DataFsPurgeshot &ps)
       {
          purgeState.setUVKeepMinTime(time(0) - conf.m_cs_UVKeep);
       }
+      purgeState.setNThreads(conf.m_purgeThreads);
+
+      // Start freeing space while the scan is running. Cold files are always removed,
+      // the oldest ones only when there is a space-based purge.
+      PurgeUnlinker early_unlinker;
+      if (conf.m_purgeEarly)
+      {
+         purgeState.setEarlyUnlink(ps.m_space_based_purge ? ps.m_file_usage >> 9 : 0,
+                                   [&](const FPurgeState::PurgeCandidate &pc) { return early_unlinker.Unlink(pc); });
+      }
 
       // Make a map of file paths, sorted by access time.
       bool scan_ok = purgeState.TraverseNamespace("/");
@@ -169,8 +206,15 @@ void OldStylePurgeDriver(DataFsPurgeshot &ps)
 
       TRACE(Debug, trc_pfx << "default purge usage measured from cinfo files " << purgeState.getNBytesTotal() << " bytes.");
 
+      if (purgeState.getNStBlocksUnlinked() > 0)
+      {
+         TRACE(Info, trc_pfx << "removed " << early_unlinker.m_deleted_file_count << " files, total size "
+                     << 512ll * early_unlinker.m_deleted_st_blocks << " during the namespace traversal.");
+      }
+
       purgeState.MoveListEntriesToMap();
-      default_purge_blocks_removed = UnlinkPurgeStateFilesInMap(purgeState, bytes_to_remove, "/");
+      default_purge_blocks_removed = purgeState.getNStBlocksUnlinked() +
+         UnlinkPurgeStateFilesInMap(purgeState, bytes_to_remove - 512ll * purgeState.getNStBlocksUnlinked(), "/");
    }
 
    // print the total summary
@@ -0,0 +1,342 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdPfcRamTier.hh"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace XrdPfc;
+
+namespace
+{
+   inline uint64_t mix64(uint64_t x)
+   {
+      x ^= x >> 33;
+      x *= 0xff51afd7ed558ccdull;
+      x ^= x >> 33;
+      x *= 0xc4ceb9fe1a85ec53ull;
+      x ^= x >> 33;
+      return x;
+   }
+
+   const uint64_t s_sketch_seeds[4] = { 0x9e3779b97f4a7c15ull, 0xbf58476d1ce4e5b9ull,
+                                        0x94d049bb133111ebull, 0x2545f4914f6cdd1dull };
+}
+
+//==============================================================================
+// Sketch
+//==============================================================================
+
+void RamTier::Sketch::init(long long n_entries)
+{
+   // Four rows of counters, each row as wide as the next power of two
+   // above four times the expected number of resident blocks.
+   uint64_t width = 64;
+   while (width < (uint64_t) (4 * n_entries))
+      width <<= 1;
+
+   m_counts.assign(4 * width, 0);
+   m_mask     = width - 1;
+   m_n_incs   = 0;
+   m_reset_at = 10 * (long long) width;
+}
+
+void RamTier::Sketch::increment(uint64_t h)
+{
+   const uint64_t width = m_mask + 1;
+   for (int r = 0; r < 4; ++r)
+   {
+      uint8_t &c = m_counts[r * width + (mix64(h ^ s_sketch_seeds[r]) & m_mask)];
+      if (c < 15) ++c;
+   }
+
+   if (++m_n_incs >= m_reset_at)
+   {
+      for (auto &c : m_counts) c >>= 1;
+      m_n_incs /= 2;
+   }
+}
+
+int RamTier::Sketch::estimate(uint64_t h) const
+{
+   const uint64_t width = m_mask + 1;
+   int min = 15;
+   for (int r = 0; r < 4; ++r)
+   {
+      int c = m_counts[r * width + (mix64(h ^ s_sketch_seeds[r]) & m_mask)];
+      if (c < min) min = c;
+   }
+   return min;
+}
+
+//==============================================================================
+// RamTier
+//==============================================================================
+
+RamTier::RamTier(long long capacity, long long block_size) :
+   m_capacity(capacity),
+   m_shards(s_n_shards)
+{
+   const long long shard_cap = capacity / s_n_shards;
+   const long long n_entries = block_size > 0 ? shard_cap / block_size + 1 : 1024;
+
+   for (auto &s : m_shards)
+   {
+      s.m_capacity = shard_cap;
+      s.m_sketch.init(n_entries);
+   }
+}
+
+RamTier::~RamTier()
+{
+   for (auto &s : m_shards)
+   {
+      for (auto &kv : s.m_map)
+      {
+         free(kv.second->m_buf);
+         delete kv.second;
+      }
+   }
+}
+
+uint64_t RamTier::hash(const Key &k)
+{
+   return mix64(k.m_fid * 0x9e3779b97f4a7c15ull + (uint64_t) k.m_idx);
+}
+
+//------------------------------------------------------------------------------
+
+uint64_t RamTier::FileId(const std::string &path)
+{
+   XrdSysMutexHelper _lck(m_fid_mutex);
+
+   auto ir = m_fids.insert(std::make_pair(path, m_next_fid));
+   if (ir.second)
+      m_fid_infos[m_next_fid++].m_path = path;
+   ++m_fid_infos[ir.first->second].m_n_open;
+   return ir.first->second;
+}
+
+void RamTier::ReleaseFileId(uint64_t fid)
+{
+   XrdSysMutexHelper _lck(m_fid_mutex);
+
+   auto it = m_fid_infos.find(fid);
+   if (it == m_fid_infos.end())
+      return;
+   --it->second.m_n_open;
+   drop_fid_if_unused(it);
+}
+
+void RamTier::Invalidate(const std::string &path)
+{
+   XrdSysMutexHelper _lck(m_fid_mutex);
+
+   auto i = m_fids.find(path);
+   if (i == m_fids.end())
+      return;
+
+   auto it = m_fid_infos.find(i->second);
+   if (it != m_fid_infos.end())
+      it->second.m_path.clear();
+   m_fids.erase(i);
+}
+
+void RamTier::add_fid_blocks(uint64_t fid, int n)
+{
+   // Called with the shard mutex held.
+   XrdSysMutexHelper _lck(m_fid_mutex);
+
+   auto it = m_fid_infos.find(fid);
+   if (it == m_fid_infos.end())
+      it = m_fid_infos.insert(std::make_pair(fid, FidInfo())).first;
+   it->second.m_n_blocks += n;
+   drop_fid_if_unused(it);
+}
+
+void RamTier::drop_fid_if_unused(std::unordered_map<uint64_t, FidInfo>::iterator it)
+{
+   if (it->second.m_n_open > 0 || it->second.m_n_blocks > 0)
+      return;
+   if ( ! it->second.m_path.empty())
+      m_fids.erase(it->second.m_path);
+   m_fid_infos.erase(it);
+}
+
+//------------------------------------------------------------------------------
+
+RamTier::Slot* RamTier::victim(Shard &s) const
+{
+   if ( ! s.m_probation.empty()) return s.m_probation.back();
+   if ( ! s.m_protected.empty()) return s.m_protected.back();
+   return nullptr;
+}
+
+void RamTier::evict(Shard &s, Slot *slot)
+{
+   if (slot->m_protected)
+   {
+      s.m_protected.erase(slot->m_lru_pos);
+      s.m_protected_used -= slot->m_size;
+   }
+   else
+   {
+      s.m_probation.erase(slot->m_lru_pos);
+   }
+   s.m_used -= slot->m_size;
+   s.m_map.erase(slot->m_key);
+   add_fid_blocks(slot->m_key.m_fid, -1);
+
+   free(slot->m_buf);
+   delete slot;
+}
+
+void RamTier::touch(Shard &s, Slot *slot)
+{
+   if (slot->m_protected)
+   {
+      s.m_protected.splice(s.m_protected.begin(), s.m_protected, slot->m_lru_pos);
+      return;
+   }
+
+   // Second hit, promote to the protected segment and demote from there
+   // what no longer fits.
+   s.m_protected.splice(s.m_protected.begin(), s.m_probation, slot->m_lru_pos);
+   slot->m_protected = true;
+   s.m_protected_used += slot->m_size;
+
+   const long long protected_cap = s.m_capacity * 4 / 5;
+   while (s.m_protected_used > protected_cap && s.m_protected.size() > 1)
+   {
+      Slot *d = s.m_protected.back();
+      s.m_probation.splice(s.m_probation.begin(), s.m_protected, d->m_lru_pos);
+      d->m_protected = false;
+      s.m_protected_used -= d->m_size;
+   }
+}
+
+bool RamTier::admit(Shard &s, uint64_t h, int size) const
+{
+   if (size > s.m_capacity)
+      return false;
+   if (s.m_used + size <= s.m_capacity)
+      return true;
+
+   Slot *v = victim(s);
+   return v && s.m_sketch.estimate(h) > s.m_sketch.estimate(hash(v->m_key));
+}
+
+//------------------------------------------------------------------------------
+
+bool RamTier::Read(uint64_t fid, int idx, char *buf, int blk_off, int size)
+{
+   const Key      key { fid, idx };
+   const uint64_t h = hash(key);
+   Shard         &s = shard_for(h);
+
+   XrdSysMutexHelper _lck(s.m_mutex);
+
+   s.m_sketch.increment(h);
+
+   auto it = s.m_map.find(key);
+   if (it == s.m_map.end() || blk_off + size > it->second->m_size)
+   {
+      ++s.m_stats.m_Misses;
+      return false;
+   }
+
+   memcpy(buf, it->second->m_buf + blk_off, size);
+   touch(s, it->second);
+
+   ++s.m_stats.m_Hits;
+   s.m_stats.m_BytesHit += size;
+   return true;
+}
+
+bool RamTier::WouldAdmit(uint64_t fid, int idx, int size, bool count_access)
+{
+   const Key      key { fid, idx };
+   const uint64_t h = hash(key);
+   Shard         &s = shard_for(h);
+
+   XrdSysMutexHelper _lck(s.m_mutex);
+
+   if (count_access)
+      s.m_sketch.increment(h);
+
+   return s.m_map.find(key) == s.m_map.end() && admit(s, h, size);
+}
+
+bool RamTier::Insert(uint64_t fid, int idx, char *buf, int size)
+{
+   const Key      key { fid, idx };
+   const uint64_t h = hash(key);
+   Shard         &s = shard_for(h);
+
+   XrdSysMutexHelper _lck(s.m_mutex);
+
+   if (s.m_map.find(key) != s.m_map.end() || ! admit(s, h, size))
+   {
+      ++s.m_stats.m_Rejects;
+      _lck.UnLock();
+      free(buf);
+      return false;
+   }
+
+   while (s.m_used + size > s.m_capacity)
+   {
+      evict(s, victim(s));
+      ++s.m_stats.m_Evictions;
+   }
+
+   Slot *slot = new Slot { key, buf, size, false, lru_t::iterator() };
+   s.m_probation.push_front(slot);
+   slot->m_lru_pos = s.m_probation.begin();
+   s.m_map.insert(std::make_pair(key, slot));
+   s.m_used += size;
+   add_fid_blocks(fid, 1);
+
+   ++s.m_stats.m_Inserts;
+   return true;
+}
+
+//------------------------------------------------------------------------------
+
+void RamTier::GetStats(Stats &r, bool reset)
+{
+   r = Stats();
+   for (auto &s : m_shards)
+   {
+      XrdSysMutexHelper _lck(s.m_mutex);
+
+      r.m_Hits      += s.m_stats.m_Hits;
+      r.m_Misses    += s.m_stats.m_Misses;
+      r.m_BytesHit  += s.m_stats.m_BytesHit;
+      r.m_Inserts   += s.m_stats.m_Inserts;
+      r.m_Rejects   += s.m_stats.m_Rejects;
+      r.m_Evictions += s.m_stats.m_Evictions;
+      r.m_BytesUsed += s.m_used;
+      r.m_NBlocks   += (int) s.m_map.size();
+
+      if (reset)
+         s.m_stats = Stats();
+   }
+
+   XrdSysMutexHelper _lck(m_fid_mutex);
+   r.m_NFileIds = (int) m_fid_infos.size();
+}
@@ -0,0 +1,191 @@
+#ifndef __XRDPFC_RAMTIER_HH__
+#define __XRDPFC_RAMTIER_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace XrdPfc
+{
+
+//----------------------------------------------------------------------------
+//! RAM tier keeping copies of frequently read blocks of cached files.
+//!
+//! Blocks are offered when they have been written to disk or when a disk read
+//! for them would be admitted. Admission follows TinyLFU: a count-min sketch
+//! records how often each block was asked for and a new block only replaces
+//! the eviction victim if it was asked for more often. Resident blocks are
+//! kept in a segmented LRU, a probation segment for blocks hit once and a
+//! protected segment, 80% of the capacity, for blocks hit again.
+//!
+//! The tier is split into shards by block key, each with its own lock,
+//! sketch and LRU segments. Blocks are identified by a file id obtained via
+//! FileId() and the block index. Invalidate() gives a path a new id so
+//! blocks of a removed or reset file are never served again; they age out.
+//! An id is kept while the file is open or any of its blocks is held.
+//----------------------------------------------------------------------------
+
+class RamTier
+{
+public:
+   struct Stats
+   {
+      long long m_Hits        = 0;  //!< block reads served from RAM
+      long long m_Misses      = 0;  //!< block reads that went to disk
+      long long m_BytesHit    = 0;  //!< bytes served from RAM
+      long long m_Inserts     = 0;  //!< blocks admitted
+      long long m_Rejects     = 0;  //!< blocks refused by the admission filter
+      long long m_Evictions   = 0;  //!< blocks evicted to make room
+      long long m_BytesUsed   = 0;  //!< current usage, not reset
+      int       m_NBlocks     = 0;  //!< current number of blocks, not reset
+      int       m_NFileIds    = 0;  //!< current number of file ids in use, not reset
+   };
+
+   RamTier(long long capacity, long long block_size);
+   ~RamTier();
+
+   //---------------------------------------------------------------------
+   //! Id under which blocks of the file at path are stored. Every call
+   //! must be matched by a ReleaseFileId() when the file is closed.
+   //---------------------------------------------------------------------
+   uint64_t FileId(const std::string &path);
+   void     ReleaseFileId(uint64_t fid);
+
+   //---------------------------------------------------------------------
+   //! Drop the association of path with its current id.
+   //---------------------------------------------------------------------
+   void Invalidate(const std::string &path);
+
+   //---------------------------------------------------------------------
+   //! Copy size bytes from offset blk_off of a block into buf.
+   //! Returns false, and records the access, if the block is not held.
+   //---------------------------------------------------------------------
+   bool Read(uint64_t fid, int idx, char *buf, int blk_off, int size);
+
+   //---------------------------------------------------------------------
+   //! Whether a block not held would be admitted now. If count_access is
+   //! set this is recorded as a request for the block.
+   //---------------------------------------------------------------------
+   bool WouldAdmit(uint64_t fid, int idx, int size, bool count_access);
+
+   //---------------------------------------------------------------------
+   //! Offer a complete block. buf must come from malloc() and is taken
+   //! over; it is freed if the block is not admitted.
+   //---------------------------------------------------------------------
+   bool Insert(uint64_t fid, int idx, char *buf, int size);
+
+   //---------------------------------------------------------------------
+   //! Sum of shard statistics. Counters are reset if reset is set.
+   //---------------------------------------------------------------------
+   void GetStats(Stats &s, bool reset);
+
+   long long GetCapacity() const { return m_capacity; }
+
+private:
+   struct Key
+   {
+      uint64_t m_fid;
+      int      m_idx;
+
+      bool operator==(const Key &o) const { return m_fid == o.m_fid && m_idx == o.m_idx; }
+   };
+
+   struct KeyHash
+   {
+      size_t operator()(const Key &k) const { return hash(k); }
+   };
+
+   struct Slot;
+   using lru_t = std::list<Slot*>;
+
+   struct Slot
+   {
+      Key         m_key;
+      char       *m_buf;
+      int         m_size;
+      bool        m_protected;
+      lru_t::iterator m_lru_pos;
+   };
+
+   //---------------------------------------------------------------------
+   //! Count-min sketch with 4-bit saturating counters that are halved
+   //! after every 10 * width increments.
+   //---------------------------------------------------------------------
+   struct Sketch
+   {
+      std::vector<uint8_t> m_counts;
+      uint64_t             m_mask = 0;
+      long long            m_n_incs = 0;
+      long long            m_reset_at = 0;
+
+      void     init(long long n_entries);
+      void     increment(uint64_t h);
+      int      estimate(uint64_t h) const;
+   };
+
+   struct Shard
+   {
+      XrdSysMutex  m_mutex;
+      std::unordered_map<Key, Slot*, KeyHash> m_map;
+      lru_t        m_probation;   // front is most recently used
+      lru_t        m_protected;
+      long long    m_capacity = 0;
+      long long    m_used = 0;
+      long long    m_protected_used = 0;
+      Sketch       m_sketch;
+      Stats        m_stats;
+   };
+
+   static const int s_n_shards = 16;
+
+   const long long    m_capacity;
+   std::vector<Shard> m_shards;
+
+   struct FidInfo
+   {
+      std::string m_path;         //!< empty once the id was invalidated
+      int         m_n_open   = 0;
+      int         m_n_blocks = 0;
+   };
+
+   XrdSysMutex        m_fid_mutex;  //!< taken after a shard mutex, never before
+   std::unordered_map<std::string, uint64_t> m_fids;      //!< current id of path
+   std::unordered_map<uint64_t, FidInfo>     m_fid_infos; //!< ids in use
+   uint64_t           m_next_fid = 1;
+
+   static uint64_t hash(const Key &k);
+
+   Shard& shard_for(uint64_t h) { return m_shards[h % s_n_shards]; }
+
+   Slot* victim(Shard &s) const;
+   void  evict(Shard &s, Slot *slot);
+   void  touch(Shard &s, Slot *slot);
+   bool  admit(Shard &s, uint64_t h, int size) const;
+
+   void  add_fid_blocks(uint64_t fid, int n);
+   void  drop_fid_if_unused(std::unordered_map<uint64_t, FidInfo>::iterator it);
+};
+
+}
+
+#endif
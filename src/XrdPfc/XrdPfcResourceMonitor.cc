@@ -5,12 +5,16 @@
 #include "XrdPfcDirState.hh"
 #include "XrdPfcDirStateSnapshot.hh"
 #include "XrdPfcDirStatePurgeshot.hh"
+#include "XrdPfcDirStateStore.hh"
+#include "XrdPfcInfoStore.hh"
 #include "XrdPfcTrace.hh"
 #include "XrdPfcPurgePin.hh"
 
 #include "XrdOss/XrdOss.hh"
 
 #include <algorithm>
+#include <limits>
+#include <unordered_map>
 
 // #define RM_DEBUG
 #ifdef RM_DEBUG
@@ -36,6 +40,7 @@ ResourceMonitor::ResourceMonitor(XrdOss& oss) :
 
 ResourceMonitor::~ResourceMonitor()
 {
+   delete m_dir_state_store;
    delete &m_fs_state;
 }
 
@@ -173,22 +178,44 @@ bool ResourceMonitor::perform_initial_scan()
    // Called after PFC configuration is complete, but before full startup of the daemon.
    // Base line usages are accumulated as part of the file-system, traversal.
 
+   static const char *tpfx = "perform_initial_scan() ";
+
    update_vs_and_file_usage_info();
 
+   // Records left without data file would never be found by a purge.
+   if (InfoStore *is = Cache::TheOne().GetInfoStore())
+      is->PurgeOrphans();
+
    DirState   *root_ds = m_fs_state.get_root();
-   FsTraversal fst(m_oss);
-   fst.m_protected_top_dirs.insert("pfc-stats"); // XXXX This should come from config. Also: N2N?
 
-   if ( ! fst.begin_traversal(root_ds, "/"))
-      return false;
+   // Try the persisted DirState tree first, it also has the usages propagated.
+   bool loaded = false;
+   if (Cache::Conf().m_dirSnapshotInterval > 0)
+   {
+      m_dir_state_store = new DirStateStore(m_oss, "/pfc-stats");
+
+      std::string err;
+      loaded = m_dir_state_store->Load(m_fs_state, Cache::Conf().m_dirSnapshotMaxAge, err);
+      if ( ! loaded)
+         TRACE(Info, tpfx << "Not using directory state snapshot, " << err << "; doing full scan.");
+   }
+
+   if ( ! loaded)
+   {
+      FsTraversal fst(m_oss);
+      fst.m_protected_top_dirs.insert("pfc-stats"); // XXXX This should come from config. Also: N2N?
+
+      if ( ! fst.begin_traversal(root_ds, "/"))
+         return false;
 
-   // The following are initialized in ResourceMonitor.hh to avoid a race at startup:
-   //   m_dir_scan_in_progress = true;
-   //   m_dir_scan_check_counter = 0;
+      // The following are initialized in ResourceMonitor.hh to avoid a race at startup:
+      //   m_dir_scan_in_progress = true;
+      //   m_dir_scan_check_counter = 0;
 
-   scan_dir_and_recurse(fst);
+      scan_dir_and_recurse(fst);
 
-   fst.end_traversal();
+      fst.end_traversal();
+   }
 
    // We have all directories scanned, available in DirState tree, let all remaining files go
    // and then we shall do the upward propagation of usages.
@@ -210,11 +237,16 @@ bool ResourceMonitor::perform_initial_scan()
    }
 
    // Do upward propagation of usages.
-   root_ds->upward_propagate_initial_scan_usages();
+   if ( ! loaded)
+      root_ds->upward_propagate_initial_scan_usages();
    m_current_usage_in_st_blocks = root_ds->m_here_usage.m_StBlocks + 
                                   root_ds->m_recursive_subdir_usage.m_StBlocks;
    update_vs_and_file_usage_info();
 
+   // Start a new snapshot generation, later changes go to its journal.
+   if (m_dir_state_store)
+      m_dir_state_store->WriteSnapshot(m_fs_state);
+
    return true;
 }
 
@@ -244,6 +276,12 @@ int ResourceMonitor::process_queues()
       ++m_queue_swap_u1;
    }
 
+   // Usage changes per directory, for the journal of the persisted DirState tree.
+   std::unordered_map<DirState*, DirUsage> jrnl;
+   auto jrnl_delta = [&](DirState *ds) -> DirUsage* {
+      return m_dir_state_store ? &jrnl[ds] : nullptr;
+   };
+
    for (auto &i : m_file_open_q.read_queue())
    {
       // i.id: LFN, i.record: OpenRecord
@@ -270,6 +308,12 @@ int ResourceMonitor::process_queues()
       }
 
       ds->m_here_usage.m_LastOpenTime = i.record.m_open_time;
+
+      if (DirUsage *d = jrnl_delta(ds)) {
+         if ( ! i.record.m_existing_file)
+            d->m_NFiles += 1;
+         d->m_LastOpenTime = std::max(d->m_LastOpenTime, i.record.m_open_time);
+      }
    }
 
    for (auto &i : m_file_update_stats_q.read_queue())
@@ -283,6 +327,9 @@ int ResourceMonitor::process_queues()
 
       ds->m_here_stats.AddUp(i.record);
       m_current_usage_in_st_blocks += i.record.m_StBlocksAdded;
+
+      if (DirUsage *d = jrnl_delta(ds))
+         d->m_StBlocks += i.record.m_StBlocksAdded;
    }
 
    for (auto &i : m_file_close_q.read_queue())
@@ -296,6 +343,9 @@ int ResourceMonitor::process_queues()
       ds->m_here_stats.m_NFilesClosed += 1;
       ds->m_here_usage.m_LastCloseTime = i.record.m_close_time;
 
+      if (DirUsage *d = jrnl_delta(ds))
+         d->m_LastCloseTime = std::max(d->m_LastCloseTime, i.record.m_close_time);
+
       at.clear();
    }
    { // Release the AccessToken slots under lock.
@@ -311,6 +361,11 @@ int ResourceMonitor::process_queues()
       ds->m_here_stats.m_StBlocksRemoved += i.record.m_size_in_st_blocks;
       ds->m_here_stats.m_NFilesRemoved   += i.record.m_n_files;
       m_current_usage_in_st_blocks       -= i.record.m_size_in_st_blocks;
+
+      if (DirUsage *d = jrnl_delta(ds)) {
+         d->m_StBlocks -= i.record.m_size_in_st_blocks;
+         d->m_NFiles   -= i.record.m_n_files;
+      }
    }
    for (auto &i : m_file_purge_q2.read_queue())
    {
@@ -324,6 +379,11 @@ int ResourceMonitor::process_queues()
       ds->m_here_stats.m_StBlocksRemoved += i.record.m_size_in_st_blocks;
       ds->m_here_stats.m_NFilesRemoved   += i.record.m_n_files;
       m_current_usage_in_st_blocks       -= i.record.m_size_in_st_blocks;
+
+      if (DirUsage *d = jrnl_delta(ds)) {
+         d->m_StBlocks -= i.record.m_size_in_st_blocks;
+         d->m_NFiles   -= i.record.m_n_files;
+      }
    }
    for (auto &i : m_file_purge_q3.read_queue())
    {
@@ -336,6 +396,18 @@ int ResourceMonitor::process_queues()
       ds->m_here_stats.m_StBlocksRemoved += i.record;
       ds->m_here_stats.m_NFilesRemoved   += 1;
       m_current_usage_in_st_blocks       -= i.record;
+
+      if (DirUsage *d = jrnl_delta(ds)) {
+         d->m_StBlocks -= i.record;
+         d->m_NFiles   -= 1;
+      }
+   }
+
+   if (m_dir_state_store)
+   {
+      for (auto & [ds, d] : jrnl)
+         m_dir_state_store->AddUsageDelta(ds, d);
+      m_dir_state_store->FlushJournal();
    }
 
    // Read queues / vectors are cleared at swap time.
@@ -359,6 +431,7 @@ void ResourceMonitor::heart_beat()
    const int s_purge_check_interval  = 60;
    const int s_purge_report_interval = conf.m_purgeInterval;
    const int s_purge_cold_files_interval = conf.m_purgeInterval * conf.m_purgeAgeBasedPeriod;
+   const int s_dir_snapshot_interval = conf.m_dirSnapshotInterval;
 
    // initial scan performed as part of config
 
@@ -368,12 +441,15 @@ void ResourceMonitor::heart_beat()
    time_t next_purge_check_time      = now + s_purge_check_interval;
    time_t next_purge_report_time     = now + s_purge_report_interval;
    time_t next_purge_cold_files_time = now + s_purge_cold_files_interval;
+   time_t next_dir_snapshot_time     = m_dir_state_store ? now + s_dir_snapshot_interval
+                                                         : std::numeric_limits<time_t>::max();
 
    while (true)
    {
       time_t start = time(0);
       time_t next_event = std::min({ next_queue_proc_time, next_sshot_report_time,
-                                     next_purge_check_time, next_purge_report_time, next_purge_cold_files_time });
+                                     next_purge_check_time, next_purge_report_time, next_purge_cold_files_time,
+                                     next_dir_snapshot_time });
 
       if (next_event > start)
       {
@@ -411,9 +487,10 @@ void ResourceMonitor::heart_beat()
       bool do_purge_check      = next_purge_check_time <= now;
       bool do_purge_report     = next_purge_report_time <= now;
       bool do_purge_cold_files = next_purge_cold_files_time <= now;
+      bool do_dir_snapshot     = next_dir_snapshot_time <= now;
 
       // Update stats in usages if any secondary activity will happen.
-      if (do_sshot_report || do_purge_check || do_purge_report || do_purge_cold_files)
+      if (do_sshot_report || do_purge_check || do_purge_report || do_purge_cold_files || do_dir_snapshot)
       {
          unlink_func unlink_foo = [&](const std::string &dp)->int {
             int ret = m_oss.Unlink(dp.c_str());
@@ -421,6 +498,8 @@ void ResourceMonitor::heart_beat()
                TRACE(Info, tpfx << "Empty dir unlink error: " << ret << " at " << dp);
             } else {
                TRACE(Debug, tpfx << "Empty dir unlink success: " << dp);
+               if (m_dir_state_store)
+                  m_dir_state_store->AddDirRemoval(dp);
             }
             return ret;
          };
@@ -429,6 +508,17 @@ void ResourceMonitor::heart_beat()
          bool purge_leaf_dirs = do_sshot_report && ! m_purge_task_active;
          m_fs_state.update_stats_and_usages(queue_swap_time, purge_leaf_dirs, unlink_foo);
 
+         // Usages now include all processed records, which is what the snapshot needs.
+         if (do_dir_snapshot)
+         {
+            m_dir_state_store->WriteSnapshot(m_fs_state);
+            next_dir_snapshot_time = now + s_dir_snapshot_interval;
+         }
+         else if (m_dir_state_store)
+         {
+            m_dir_state_store->FlushJournal();
+         }
+
          // This reporting into log/stdout is to be removed.
          // Meaning of conf.is_dir_stat_reporting_on() etc is to be clarified / improved.
          if (do_sshot_report && conf.is_dir_stat_reporting_on())
@@ -447,6 +537,9 @@ void ResourceMonitor::heart_beat()
 
       if (do_sshot_report)
       {
+         Cache::GetInstance().ReportWriteQueues();
+         Cache::GetInstance().ReportRamTier();
+
          // Sshot reports are equidistant, at "full" reporting interval.
          next_sshot_report_time = ((now + 1) / s_sshot_report_interval) * s_sshot_report_interval + s_sshot_report_interval;
 
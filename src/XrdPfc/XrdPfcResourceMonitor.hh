@@ -19,6 +19,7 @@ struct DirStateElement;
 struct DataFsSnapshot;
 struct DirPurgeElement;
 struct DataFsPurgeshot;
+class DirStateStore;
 class FsTraversal;
 
 //==============================================================================
@@ -117,6 +118,8 @@ class ResourceMonitor
    DataFsState &m_fs_state;
    XrdOss      &m_oss;
 
+   DirStateStore *m_dir_state_store = nullptr; // persistent snapshot + journal, if enabled
+
    // Requests for File opens during name-space scans. Such LFNs are processed
    // with some priority
    struct LfnCondRecord
@@ -54,6 +54,7 @@
 #include "XrdPosix/XrdPosixInfo.hh"
 #include "XrdPosix/XrdPosixMap.hh"
 #include "XrdPosix/XrdPosixPrepIO.hh"
+#include "XrdPosix/XrdPosixShmCache.hh"
 #include "XrdPosix/XrdPosixStats.hh"
 #include "XrdPosix/XrdPosixTrace.hh"
 #include "XrdPosix/XrdPosixXrootd.hh"
@@ -232,6 +233,8 @@ bool XrdPosixConfig::initCCM(XrdOucPsx &parms)
 // optsf=<val> - optimize structured file: 1 = all, 0 = off, .<sfx> specific
 // optwr=1     - cache can be written to.
 // pagesz=n    - individual byte size of a page (can be suffized in k, m, g).
+// shmname=nm  - use the node-local cache shared by all processes using nm
+//               (only cachesz, debug, max2cache, and pagesz apply).
 //
 
 void XrdPosixConfig::initEnv(char *eData)
@@ -243,6 +246,13 @@ void XrdPosixConfig::initEnv(char *eData)
    long long Val;
    char * tP;
 
+// A shared cache replaces the process local one
+//
+   if ((tP = theEnv.Get("shmname")) && *tP)
+      {initShm(theEnv, tP);
+       return;
+      }
+
 // Get numeric type variable (errors force a default)
 //
    initEnv(theEnv, "aprcalc",   Val); if (Val >= 0) apParms.prRecalc  = Val;
@@ -330,6 +340,42 @@ void XrdPosixConfig::initEnv(XrdOucEnv &theEnv, const char *vName, long long &De
       }
 }
 
+/******************************************************************************/
+/* Private:                      i n i t S h m                                */
+/******************************************************************************/
+
+void XrdPosixConfig::initShm(XrdOucEnv &theEnv, const char *shmName)
+{
+   XrdPosixShmCache::Parms myParms;
+   long long Val;
+   char *tP;
+
+// Get numeric type variable (errors force a default)
+//
+   initEnv(theEnv, "cachesz",   Val); if (Val > 0) myParms.CacheSize = Val;
+   initEnv(theEnv, "max2cache", Val); if (Val > 0)
+                                         {if (Val > 0x7fffffff) Val = 0x7fffffff;
+                                          myParms.Max2Cache = Val;
+                                         }
+   initEnv(theEnv, "pagesz",    Val); if (Val > 0)
+                                         {if (Val > 0x7fffffff) Val = 0x7fffffff;
+                                          myParms.PageSize  = Val;
+                                         }
+
+// Get Debug setting
+//
+   if ((tP = theEnv.Get("debug")))
+      {if (*tP >= '0' && *tP <= '3') myParms.Debug = *tP - '0';
+          else DMSG("initShm", "'XRDPOSIX_CACHE=debug=" <<tP <<"' is invalid.");
+      }
+
+// Attach to the shared cache, creating it if need be
+//
+   if (!(XrdPosixGlobals::theCache = XrdPosixShmCache::Create(shmName, myParms)))
+      {DMSG("initShm", XrdSysE2T(errno) <<" attaching shared cache "
+                       <<shmName <<'.');}
+}
+
 /******************************************************************************/
 /*                              i n i t S t a t                               */
 /******************************************************************************/
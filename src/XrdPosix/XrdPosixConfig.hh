@@ -74,6 +74,7 @@ private:
 static bool initCCM(XrdOucPsx &parms);
 static void initEnv(char *eData);
 static void initEnv(XrdOucEnv &, const char *, long long &);
+static void initShm(XrdOucEnv &theEnv, const char *shmName);
 static void initXdev(dev_t &st_dev, dev_t &st_rdev);
 static void SetDebug(int val);
 static void SetIPV4(bool userv4);
@@ -30,6 +30,8 @@
 
 #include <cerrno>
 #include <fcntl.h>
+#include <new>
+#include <sched.h>
 #include <sys/resource.h>
 #include <sys/stat.h>
 
@@ -51,8 +53,11 @@ extern thread_local XrdOucECMsg ecMsg;
 /*                        S t a t i c   M e m b e r s                         */
 /******************************************************************************/
 
+XrdPosixObject::rdrCount  XrdPosixObject::rdrTab[XrdPosixObject::rdrNum];
+std::atomic<unsigned int> XrdPosixObject::rdrEpoch(0);
+
 XrdSysMutex      XrdPosixObject::fdMutex;
-XrdPosixObject **XrdPosixObject::myFiles  =  0;
+std::atomic<XrdPosixObject *> *XrdPosixObject::myFiles  =  0;
 int              XrdPosixObject::highFD   = -1;
 int              XrdPosixObject::lastFD   = -1;
 int              XrdPosixObject::baseFD   =  0;
@@ -74,23 +79,23 @@ bool XrdPosixObject::AssignFD(bool isStream)
 //
    if (baseFD)
       { if (isStream) return 0;
-        for (fd = freeFD; fd < posxFD && myFiles[fd]; fd++) {}
+        for (fd = freeFD; fd < posxFD && myFiles[fd].load(); fd++) {}
         if (fd >= posxFD) return 0;
         freeFD = fd+1;
       } else {
         do{if ((fd = dup(devNull)) < 0) return false;
            if (fd >= lastFD || (isStream && fd > 255))
               {close(fd); return 0;}
-           if (!myFiles[fd]) break;
+           if (!myFiles[fd].load()) break;
            DMSG("AssignFD", "FD " <<fd <<" closed outside of XrdPosix!");
           } while(1);
       }
 
 // Enter object in out vector of objects and assign it the FD
 //
-   myFiles[fd] = this;
-   if (fd > highFD) highFD = fd;
    fdNum  = fd + baseFD;
+   if (fd > highFD) highFD = fd;
+   myFiles[fd].store(this);
 
 // All done.
 //
@@ -105,6 +110,7 @@ XrdPosixDir *XrdPosixObject::Dir(int fd, bool glk)
 {
    XrdPosixDir    *dP;
    XrdPosixObject *oP;
+   std::atomic<int> *rdrP = 0;
    int  waitCount = 0;
    bool haveLock;
 
@@ -113,11 +119,16 @@ XrdPosixDir *XrdPosixObject::Dir(int fd, bool glk)
 do{if (fd >= lastFD || fd < baseFD)
       {errno = EBADF; return (XrdPosixDir *)0;}
 
-// Obtain the file object, if any
+// Obtain the file object, if any. Only a caller wanting to destroy the object
+// needs the global lock; everyone else finds it without locking the table.
 //
-   fdMutex.Lock();
-   if (!(oP = myFiles[fd - baseFD]) || !(oP->Who(&dP)))
-      {fdMutex.UnLock(); errno = EBADF; return (XrdPosixDir *)0;}
+   if (glk) fdMutex.Lock();
+      else  rdrP = rdrBeg();
+   if (!(oP = myFiles[fd - baseFD].load()) || !(oP->Who(&dP)))
+      {if (glk) fdMutex.UnLock();
+          else  rdrP->fetch_sub(1);
+       errno = EBADF; return (XrdPosixDir *)0;
+      }
 
 // Attempt to lock the object in the appropriate mode. If we fail, then we need
 // to retry this after dropping the global lock. We pause a bit to let the
@@ -127,18 +138,25 @@ do{if (fd >= lastFD || fd < baseFD)
    if (glk) haveLock = oP->objMutex.CondWriteLock();
       else  haveLock = oP->objMutex.CondReadLock();
    if (!haveLock)
-      {fdMutex.UnLock();
+      {if (glk) fdMutex.UnLock();
+          else  rdrP->fetch_sub(1);
        waitCount++;
        if (waitCount > 120) break;
        XrdSysTimer::Wait(500); // We wait 500 milliseconds
        continue;
       }
 
-// If the global lock is to be held, then release the object lock as this
-// is a call to destroy the object and there is no need for the local lock.
+// If the global lock is held, this is a call to destroy the object and the
+// write lock is kept until the object is out of the table (see Release()).
+// Otherwise, make sure the object was not removed while we were locking it.
 //
-   if (glk) oP->UnLock();
-      else  fdMutex.UnLock();
+   if (!glk)
+      {if (myFiles[fd - baseFD].load() != oP)
+          {oP->UnLock(); rdrP->fetch_sub(1);
+           errno = EBADF; return (XrdPosixDir *)0;
+          }
+       rdrP->fetch_sub(1);
+      }
    return dP;
   } while(1);
 
@@ -156,6 +174,7 @@ XrdPosixFile *XrdPosixObject::File(int fd, bool glk)
 {
    XrdPosixFile   *fP;
    XrdPosixObject *oP;
+   std::atomic<int> *rdrP = 0;
    int  waitCount = 0;
    bool haveLock;
 
@@ -164,11 +183,16 @@ XrdPosixFile *XrdPosixObject::File(int fd, bool glk)
 do{if (fd >= lastFD || fd < baseFD)
       {errno = EBADF; return (XrdPosixFile *)0;}
 
-// Obtain the file object, if any
+// Obtain the file object, if any. Only a caller wanting to destroy the object
+// needs the global lock; everyone else finds it without locking the table.
 //
-   fdMutex.Lock();
-   if (!(oP = myFiles[fd - baseFD]) || !(oP->Who(&fP)))
-      {fdMutex.UnLock(); errno = EBADF; return (XrdPosixFile *)0;}
+   if (glk) fdMutex.Lock();
+      else  rdrP = rdrBeg();
+   if (!(oP = myFiles[fd - baseFD].load()) || !(oP->Who(&fP)))
+      {if (glk) fdMutex.UnLock();
+          else  rdrP->fetch_sub(1);
+       errno = EBADF; return (XrdPosixFile *)0;
+      }
 
 // Attempt to lock the object in the appropriate mode. If we fail, then we need
 // to retry this after dropping the global lock. We pause a bit to let the
@@ -178,18 +202,25 @@ do{if (fd >= lastFD || fd < baseFD)
    if (glk) haveLock = oP->objMutex.CondWriteLock();
       else  haveLock = oP->objMutex.CondReadLock();
    if (!haveLock)
-      {fdMutex.UnLock();
+      {if (glk) fdMutex.UnLock();
+          else  rdrP->fetch_sub(1);
        waitCount++;
        if (waitCount > 120) break;
        XrdSysTimer::Wait(500); // We wait 500 milliseconds
        continue;
       }
 
-// If the global lock is to be held, then release the object lock as this
-// is a call to destroy the object and there is no need for the local lock.
+// If the global lock is held, this is a call to destroy the object and the
+// write lock is kept until the object is out of the table (see Release()).
+// Otherwise, make sure the object was not removed while we were locking it.
 //
-   if (glk) oP->UnLock();
-      else  fdMutex.UnLock();
+   if (!glk)
+      {if (myFiles[fd - baseFD].load() != oP)
+          {oP->UnLock(); rdrP->fetch_sub(1);
+           errno = EBADF; return (XrdPosixFile *)0;
+          }
+       rdrP->fetch_sub(1);
+      }
    return fP;
   } while(1);
 
@@ -198,7 +229,7 @@ do{if (fd >= lastFD || fd < baseFD)
    errno = ETIMEDOUT;
    return (XrdPosixFile *)0;
 }
-
+  
 /******************************************************************************/
 /*                                  I n i t                                   */
 /******************************************************************************/
@@ -207,7 +238,7 @@ int XrdPosixObject::Init(int fdnum)
 {
    static const int maxFD = 1048576;
    struct rlimit rlim;
-   int isize, limfd;
+   int limfd;
 
 // Initialize the /dev/null file descriptors, bail if we cannot
 //
@@ -235,12 +266,12 @@ int XrdPosixObject::Init(int fdnum)
 //
    if (fdnum < 0) {posxFD = fdnum = -fdnum; baseFD = limfd;}
       else         fdnum = limfd;
-   isize = fdnum * sizeof(XrdPosixFile *);
 
 // Allocate the table for fd-type pointers
 //
-   if (!(myFiles = (XrdPosixObject **)malloc(isize))) lastFD = -1;
-      else {memset((void *)myFiles, 0, isize); lastFD = fdnum+baseFD;}
+   if (!(myFiles = new(std::nothrow) std::atomic<XrdPosixObject *>[fdnum]()))
+      lastFD = -1;
+      else lastFD = fdnum+baseFD;
 
 // All done
 //
@@ -257,14 +288,17 @@ void XrdPosixObject::Release(XrdPosixObject *oP, bool needlk)
 //
    if (needlk) fdMutex.Lock();
 
-// Remove the object from the table
+// Remove the object from the table and wait until no lookup can still be
+// using it. Only then may the fd be reused and the object be deleted.
 //
    if (baseFD)
       {int myFD = oP->fdNum - baseFD;
+       myFiles[myFD].store(0);
+       Synchronize();
        if (myFD < freeFD) freeFD = myFD;
-       myFiles[myFD] = 0;
       } else {
-       myFiles[oP->fdNum] = 0;
+       myFiles[oP->fdNum].store(0);
+       Synchronize();
        close(oP->fdNum);
       }
 
@@ -289,6 +323,7 @@ XrdPosixDir *XrdPosixObject::ReleaseDir(int fd)
 // Release it and return the underlying object
 //
    Release((XrdPosixObject *)dP, false);
+   ((XrdPosixObject *)dP)->UnLock();
    return dP;
 }
 
@@ -307,9 +342,38 @@ XrdPosixFile *XrdPosixObject::ReleaseFile(int fd)
 // Release it and return the underlying object
 //
    Release((XrdPosixObject *)fP, false);
+   ((XrdPosixObject *)fP)->UnLock();
    return fP;
 }
   
+/******************************************************************************/
+/* Private:                          r d r B e g                              */
+/******************************************************************************/
+
+std::atomic<int> *XrdPosixObject::rdrBeg()
+{
+   static std::atomic<unsigned int> rdrNext(0);
+   static thread_local int rdrSlot = -1;
+   std::atomic<int> *rdrP;
+
+// Each thread uses its own readers counter, as far as there are counters
+//
+   if (rdrSlot < 0) rdrSlot = rdrNext.fetch_add(1) % rdrNum;
+
+// Announce ourselves in the current epoch. Should the epoch change before we
+// are counted, we may end up in the counters of an epoch that has already
+// been waited for, and a later Release() would not wait for us. So we check
+// that the epoch is still the one we are counted in and try again otherwise.
+//
+   do {unsigned int myE = rdrEpoch.load() & 1;
+       rdrP = &rdrTab[rdrSlot].Active[myE];
+       rdrP->fetch_add(1);
+       if ((rdrEpoch.load() & 1) == myE) break;
+       rdrP->fetch_sub(1);
+      } while(true);
+   return rdrP;
+}
+
 /******************************************************************************/
 /*                              S h u t d o w n                               */
 /******************************************************************************/
@@ -324,13 +388,31 @@ void XrdPosixObject::Shutdown()
    fdMutex.Lock();
    if (myFiles)
       {for (i = 0; i <= highFD; i++) 
-           if ((oP = myFiles[i]))
-              {myFiles[i] = 0;
+           if ((oP = myFiles[i].load()))
+              {myFiles[i].store(0);
+               Synchronize();
                if (oP->fdNum >= 0) close(oP->fdNum);
                oP->fdNum = -1;
                delete oP;
               };
-       free(myFiles); myFiles = 0;
+       delete [] myFiles; myFiles = 0;
       }
    fdMutex.UnLock();
 }
+
+/******************************************************************************/
+/* Private:                     S y n c h r o n i z e                         */
+/******************************************************************************/
+
+// Wait for the lookups that may have found an object just removed from the
+// table. Moving to the next epoch makes new lookups use the other counters,
+// so only lookups that started earlier remain in the previous epoch's
+// counters. Lookups never block, so the wait is short. Callers hold fdMutex.
+//
+void XrdPosixObject::Synchronize()
+{
+   unsigned int oldE = rdrEpoch.fetch_add(1) & 1;
+
+   for (int i = 0; i < rdrNum; i++)
+       while(rdrTab[i].Active[oldE].load()) sched_yield();
+}
@@ -30,6 +30,7 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <atomic>
 #include <sys/types.h>
 
 #include "XrdOuc/XrdOucECMsg.hh"
@@ -62,15 +63,9 @@ static  int           Init(int numfd);
                               else objMutex.ReadLock();
                           }
 
-        void          Ref()    {AtomicBeg(updMutex);
-                                AtomicInc(refCnt);
-                                AtomicEnd(updMutex);
-                               }
-        int           Refs()   {AtomicRet(updMutex, refCnt);}
-        void          unRef()  {AtomicBeg(updMutex);
-                                AtomicDec(refCnt);
-                                AtomicEnd(updMutex);
-                               }
+        void          Ref()    {refCnt.fetch_add(1);}
+        int           Refs()   {return refCnt.load();}
+        void          unRef()  {refCnt.fetch_sub(1);}
 
 static  void          Release(XrdPosixObject *oP, bool needlk=true);
 
@@ -84,7 +79,7 @@ static  void          Shutdown();
 
 static  bool          Valid(int fd)
                            {return fd >= baseFD && fd <= (highFD+baseFD)
-                                   && myFiles && myFiles[fd-baseFD];}
+                                   && myFiles && myFiles[fd-baseFD].load();}
 
 virtual bool          Who(XrdPosixDir  **dirP)  {return false;}
 
@@ -99,12 +94,25 @@ protected:
        XrdSysRecMutex   updMutex;
        XrdSysRWLock     objMutex;
        int              fdNum;
-       int              refCnt;
+       std::atomic<int> refCnt;
 
 private:
 
+static std::atomic<int> *rdrBeg();
+static void             Synchronize();
+
+// Lookups do not use fdMutex. A lookup announces itself in one of the readers
+// counters while it uses a table entry so that Release() can wait for any that
+// may still be looking at an object it has removed from the table.
+//
+struct alignas(64) rdrCount {std::atomic<int> Active[2];};
+
+static const int        rdrNum = 64;
+static rdrCount         rdrTab[rdrNum];
+static std::atomic<unsigned int> rdrEpoch;
+
 static XrdSysMutex      fdMutex;
-static XrdPosixObject **myFiles;
+static std::atomic<XrdPosixObject *> *myFiles;
 static int              lastFD;
 static int              highFD;
 static int              baseFD;
@@ -0,0 +1,627 @@
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d P o s i x S h m C a c h e . c c                    */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <new>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "XrdPosix/XrdPosixShmCache.hh"
+#include "XrdSys/XrdSysE2T.hh"
+#include "XrdSys/XrdSysHeaders.hh"
+
+/******************************************************************************/
+/*                         L o c a l   D e f i n e s                          */
+/******************************************************************************/
+
+// The segment is laid out as a header followed by the bucket array, the slot
+// array and the pages, each starting on a 4K boundary. Slots are grouped into
+// buckets of nWays; a page may only live in one of the slots of the bucket its
+// key hashes to. The bucket mutex serializes lookups and slot changes in the
+// bucket (which is what deduplicates concurrent misses) but is never held
+// while data is copied or read from the origin. A slot's sequence number is
+// odd while its page is being replaced so that readers, who copy without the
+// lock, can tell whether what they copied is still the page they looked up.
+//
+struct XrdPosixShmCache::Header
+      {unsigned long long     Magic;
+       int                    Version;
+       int                    pgSize;
+       int                    nBuckets;
+       int                    nWays;
+       long long              segSize;
+       std::atomic<long long> Clock;   // LRU stamp
+      };
+
+struct XrdPosixShmCache::Bucket
+      {pthread_mutex_t        Mutex;
+       pthread_cond_t         Ready;   // Signalled when a page load ends
+      };
+
+struct XrdPosixShmCache::Slot
+      {std::atomic<unsigned long long> Seq;
+       uint64_t               fKey;
+       long long              pNum;
+       long long              Used;
+       pid_t                  Loader;  // Process reading the page
+       int                    State;
+       int                    dLen;    // Valid bytes in the page
+       int                    Rsvd;
+      };
+
+namespace
+{
+const unsigned long long shmMagic   = 0x78726470736d6331ULL; // "xrdpsmc1"
+const int                shmVersion = 1;
+const int                nWays      = 4;
+
+const int                isEmpty    = 0;
+const int                isLoading  = 1;
+const int                isReady    = 2;
+
+inline long long Align(long long n) {return (n + 4095) & ~4095LL;}
+
+inline uint64_t Hash(uint64_t h, const void *data, size_t dlen)
+{
+   const unsigned char *dP = (const unsigned char *)data;
+
+// FNV-1a, continuing from the passed value
+//
+   while(dlen--) {h ^= *dP++; h *= 0x100000001b3ULL;}
+   return h;
+}
+
+inline uint64_t Mix(uint64_t fKey, long long pNum)
+{
+   uint64_t h = fKey ^ ((uint64_t)pNum * 0x9e3779b97f4a7c15ULL);
+   h ^= h >> 33; h *= 0xff51afd7ed558ccdULL; h ^= h >> 33;
+   return h;
+}
+
+#ifdef __linux__
+// Check whether the segment we have open is still the one under its name
+//
+bool isNamed(const char *shmName, const struct stat &sBuff)
+{
+   struct stat nBuff;
+   int fd = shm_open(shmName, O_RDONLY, 0600);
+
+   if (fd < 0) return false;
+   bool aOK = !fstat(fd, &nBuff) && nBuff.st_dev == sBuff.st_dev
+                                 && nBuff.st_ino == sBuff.st_ino;
+   close(fd);
+   return aOK;
+}
+#endif
+}
+
+/******************************************************************************/
+/*                 C l a s s   X r d P o s i x S h m C a c h e I O            */
+/******************************************************************************/
+
+/* The XrdPosixShmCacheIO object fronts an XrdOucCacheIO object and satisfies
+   reads from the shared segment. Everything else is passed through.
+*/
+
+class XrdPosixShmCacheIO : public XrdOucCacheIO
+{
+public:
+
+bool           Detach(XrdOucCacheIOCD &iocd) override;
+
+int            Fcntl(XrdOucCacheOp::Code opc, const std::string& args,
+                     std::string& resp) override
+                    {return ioObj->Fcntl(opc, args, resp);}
+
+long long      FSize() override {return ioObj->FSize();}
+
+int            Fstat(struct stat &sbuff) override
+                    {return ioObj->Fstat(sbuff);}
+
+const char    *Location(bool refresh=false) override
+                       {return ioObj->Location(refresh);}
+
+const char    *Path() override {return ioObj->Path();}
+
+using XrdOucCacheIO::Read;
+
+int            Read (char *Buffer, long long Offset, int Length) override;
+
+int            Sync() override {return ioObj->Sync();}
+
+int            Trunc(long long Offset) override {return ioObj->Trunc(Offset);}
+
+void           Update(XrdOucCacheIO &iocp) override {ioObj = &iocp;}
+
+int            Write(char *Buffer, long long Offset, int Length) override
+                    {return ioObj->Write(Buffer, Offset, Length);}
+
+               XrdPosixShmCacheIO(XrdPosixShmCache *cP, XrdOucCacheIO *ioP)
+                                 : Cache(cP), ioObj(ioP), fKey(0), fSize(0) {}
+
+private:
+              ~XrdPosixShmCacheIO() {}
+
+uint64_t       Key();
+
+XrdOucCacheStats  Statistics;
+XrdSysMutex       kMutex;
+XrdPosixShmCache *Cache;
+XrdOucCacheIO    *ioObj;
+uint64_t          fKey;
+long long         fSize;
+};
+
+/******************************************************************************/
+/*                                D e t a c h                                 */
+/******************************************************************************/
+
+bool XrdPosixShmCacheIO::Detach(XrdOucCacheIOCD &iocd)
+{
+   (void)iocd;
+
+// Nothing is ever outstanding on our behalf, so we can go away right now
+//
+   Cache->Statistics.Add(Statistics);
+   if (Cache->Dbg > 1)
+      std::cerr <<"ShmCache: " <<Statistics.X.Hits <<" hits " <<Statistics.X.Miss
+                <<" misses " <<Statistics.X.BytesGet <<" bytes from cache "
+                <<Statistics.X.BytesRead <<" bytes read for "
+                <<ioObj->Path() <<std::endl;
+   delete this;
+   return true;
+}
+
+/******************************************************************************/
+/* Private:                          K e y                                    */
+/******************************************************************************/
+
+uint64_t XrdPosixShmCacheIO::Key()
+{
+   XrdSysMutexHelper kHelp(kMutex);
+   struct stat sBuff;
+   const char *path, *cgi;
+
+// The key is computed on first use as, should the open have been deferred,
+// obtaining the size or modification time forces the actual open.
+//
+   if (fKey) return fKey;
+   if ((fSize = ioObj->FSize()) < 0) return 0;
+   if (ioObj->Fstat(sBuff)) sBuff.st_mtime = 0;
+
+// Different cgi may well refer to the same file
+//
+   path = ioObj->Path();
+   if (!(cgi = strchr(path, '?'))) cgi = path + strlen(path);
+   fKey = Hash(0xcbf29ce484222325ULL, path, cgi - path);
+   fKey = Hash(fKey, &fSize, sizeof(fSize));
+   fKey = Hash(fKey, &sBuff.st_mtime, sizeof(sBuff.st_mtime));
+   if (!fKey) fKey = 1;
+   return fKey;
+}
+
+/******************************************************************************/
+/*                                  R e a d                                   */
+/******************************************************************************/
+
+int XrdPosixShmCacheIO::Read(char *Buffer, long long Offset, int Length)
+{
+   long long pNum;
+   uint64_t  theKey;
+   int pgSize = Cache->pgSize, pOff, rLen, rc, Bytes = 0;
+
+// Large reads are better left alone as are files that are gone
+//
+   if (Length > Cache->max2Cache || !(theKey = Key()))
+      {if ((rc = ioObj->Read(Buffer, Offset, Length)) > 0)
+          {Statistics.Add(Statistics.X.BytesPass, rc);
+           Statistics.Count(Statistics.X.Pass);
+          }
+       return rc;
+      }
+
+// Satisfy the read page by page, stopping at end of file
+//
+   if (Offset >= fSize) return 0;
+   if (Length > fSize - Offset) Length = static_cast<int>(fSize - Offset);
+   while(Length > 0)
+        {pNum = Offset / pgSize;
+         pOff = static_cast<int>(Offset % pgSize);
+         rLen = (Length < pgSize - pOff ? Length : pgSize - pOff);
+         rc = Cache->Get(theKey, pNum, ioObj, Buffer, pOff, rLen, Statistics);
+         if (rc < 0) return (Bytes ? Bytes : rc);
+         Bytes += rc;
+         if (rc < rLen) break;
+         Buffer += rc; Offset += rc; Length -= rc;
+        }
+   return Bytes;
+}
+
+/******************************************************************************/
+/*                 C l a s s   X r d P o s i x S h m C a c h e                */
+/******************************************************************************/
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdPosixShmCache::XrdPosixShmCache(char *base, long long size, int m2c, int dbg)
+                                  : XrdOucCache("shm"), segSize(size),
+                                    max2Cache(m2c), Dbg(dbg)
+{
+   Hdr      = (Header *)base;
+   pgSize   = Hdr->pgSize;
+   nBuckets = Hdr->nBuckets;
+   nSlots   = nBuckets * nWays;
+   Buckets  = (Bucket *)(base + Align(sizeof(Header)));
+   Slots    = (Slot   *)((char *)Buckets + Align(sizeof(Bucket) * nBuckets));
+   Pages    = (char   *)Slots + Align(sizeof(Slot) * nSlots);
+   if (max2Cache < pgSize) max2Cache = pgSize;
+}
+
+/******************************************************************************/
+/*                                A t t a c h                                 */
+/******************************************************************************/
+
+XrdOucCacheIO *XrdPosixShmCache::Attach(XrdOucCacheIO *ioP, int opts)
+{
+
+// We only cache files that cannot change under us
+//
+   if (opts & XrdOucCache::optRW) return ioP;
+
+   Statistics.Count(Statistics.X.FilesOpened);
+   return new XrdPosixShmCacheIO(this, ioP);
+}
+
+/******************************************************************************/
+/*                                C r e a t e                                 */
+/******************************************************************************/
+
+#if !defined(__linux__)
+XrdPosixShmCache *XrdPosixShmCache::Create(const char *name, Parms &parms)
+{
+   (void)name; (void)parms;
+   errno = ENOTSUP;
+   return 0;
+}
+#else
+XrdPosixShmCache *XrdPosixShmCache::Create(const char *name, Parms &parms)
+{
+   pthread_mutexattr_t mAttr;
+   pthread_condattr_t  cAttr;
+   struct stat sBuff;
+   Header *hP;
+   char *base, shmName[128];
+   long long pgSize, nBkts, segSize;
+   int fd, rc = 0;
+
+// Validate the name; it becomes part of a file name
+//
+   if (!name || !*name || strlen(name) > 64
+   ||  strspn(name, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                    "0123456789._-") != strlen(name))
+      {errno = EINVAL; return 0;}
+
+// Compute the geometry we would use should we be the creator. The page size
+// must be a power of two between 4K and 16M.
+//
+   pgSize = 4096;
+   while(pgSize < parms.PageSize && pgSize < 16*1024*1024) pgSize <<= 1;
+   nBkts = parms.CacheSize / pgSize / nWays;
+   if (nBkts < 16) nBkts = 16;
+   if (nBkts > 0x7fffffff / nWays) nBkts = 0x7fffffff / nWays;
+   segSize = Align(sizeof(Header)) + Align(sizeof(Bucket) * nBkts)
+           + Align(sizeof(Slot) * nBkts * nWays) + pgSize * nBkts * nWays;
+
+// Open the segment. Each user gets their own as the data is not otherwise
+// protected against other users.
+//
+   snprintf(shmName, sizeof(shmName), "/xrdposix.%s.%u", name,
+            (unsigned int)getuid());
+
+// Find a segment we can use. An existing one whose magic number, version or
+// size does not match ours may still be mapped by other processes, so it is
+// never resized; its name is removed and a new segment is created under it
+// (processes that have it mapped keep using the old one until they detach).
+// Only a segment that has never been sized, and thus cannot be in use, is
+// initialized in place.
+//
+   for (int tries = 0; ; tries++)
+       {if (tries >= 8) {errno = EBUSY; return 0;}
+        if ((fd = shm_open(shmName, O_RDWR, 0600)) < 0)
+           {if (errno != ENOENT) return 0;
+            if ((fd = shm_open(shmName, O_RDWR|O_CREAT|O_EXCL, 0600)) < 0)
+               {if (errno == EEXIST) continue;
+                return 0;
+               }
+           }
+
+    // Serialize initialization among all the processes doing this right now.
+    // The segment may have been replaced while we waited for the lock.
+    //
+        if (flock(fd, LOCK_EX) || fstat(fd, &sBuff))
+           {rc = errno; close(fd); errno = rc; return 0;}
+        if (!isNamed(shmName, sBuff)) {close(fd); continue;}
+
+        hP = 0;
+        if (!sBuff.st_size) break;
+        if (sBuff.st_size >= (off_t)sizeof(Header)
+        &&  (hP = (Header *)mmap(0, sizeof(Header), PROT_READ, MAP_SHARED,
+                                 fd, 0)) != MAP_FAILED)
+           {if (hP->Magic == shmMagic && hP->Version == shmVersion
+            &&  hP->segSize == sBuff.st_size) break;
+            munmap(hP, sizeof(Header));
+           }
+        if (parms.Debug)
+           std::cerr <<"ShmCache: replacing incompatible " <<shmName <<std::endl;
+        shm_unlink(shmName);
+        close(fd);
+       }
+
+// If the segment is new, size and initialize it. The magic number is set last
+// so a segment whose initialization was cut short is replaced by the next
+// creator. The space is
+// allocated up front as touching a page of a sparse segment for which there
+// is no room left in the file system raises SIGBUS. Should that fail, the
+// segment is removed so that the space is returned.
+//
+   if (!hP)
+      {if ((rc = posix_fallocate(fd, 0, segSize)))
+                  {shm_unlink(shmName);
+                   if (parms.Debug)
+                      std::cerr <<"ShmCache: unable to allocate " <<segSize
+                                <<" bytes for " <<shmName <<"; "
+                                <<XrdSysE2T(rc) <<std::endl;
+                  }
+          else if ((base = (char *)mmap(0, segSize, PROT_READ|PROT_WRITE,
+                                        MAP_SHARED, fd, 0)) == MAP_FAILED)
+                  rc = errno;
+          else {hP = (Header *)base;
+                hP->Version  = shmVersion;
+                hP->pgSize   = pgSize;
+                hP->nBuckets = nBkts;
+                hP->nWays    = nWays;
+                hP->segSize  = segSize;
+                new (&hP->Clock) std::atomic<long long>(0);
+                pthread_mutexattr_init(&mAttr);
+                pthread_mutexattr_setpshared(&mAttr, PTHREAD_PROCESS_SHARED);
+                pthread_mutexattr_setrobust(&mAttr, PTHREAD_MUTEX_ROBUST);
+                pthread_condattr_init(&cAttr);
+                pthread_condattr_setpshared(&cAttr, PTHREAD_PROCESS_SHARED);
+                pthread_condattr_setclock(&cAttr, CLOCK_MONOTONIC);
+                Bucket *bP = (Bucket *)(base + Align(sizeof(Header)));
+                for (long long i = 0; i < nBkts; i++)
+                    {pthread_mutex_init(&bP[i].Mutex, &mAttr);
+                     pthread_cond_init (&bP[i].Ready, &cAttr);
+                    }
+                pthread_mutexattr_destroy(&mAttr);
+                pthread_condattr_destroy(&cAttr);
+                Slot *sP = (Slot *)((char *)bP + Align(sizeof(Bucket)*nBkts));
+                for (long long i = 0; i < nBkts * nWays; i++)
+                    new (&sP[i].Seq) std::atomic<unsigned long long>(0);
+                std::atomic_thread_fence(std::memory_order_release);
+                hP->Magic = shmMagic;
+                if (parms.Debug)
+                   std::cerr <<"ShmCache: created " <<shmName <<" size "
+                             <<segSize <<" page size " <<pgSize <<std::endl;
+               }
+      } else {
+       munmap(hP, sizeof(Header));
+       segSize = sBuff.st_size;
+       if ((base = (char *)mmap(0, segSize, PROT_READ|PROT_WRITE,
+                                MAP_SHARED, fd, 0)) == MAP_FAILED) rc = errno;
+          else if (parms.Debug)
+                  std::cerr <<"ShmCache: attached " <<shmName <<" size "
+                            <<segSize <<std::endl;
+      }
+
+// We no longer need the file descriptor; the mapping stays
+//
+   flock(fd, LOCK_UN);
+   close(fd);
+   if (rc) {errno = rc; return 0;}
+
+   return new XrdPosixShmCache(base, segSize, parms.Max2Cache, parms.Debug);
+}
+#endif
+
+/******************************************************************************/
+/* Private:                          G e t                                    */
+/******************************************************************************/
+
+int XrdPosixShmCache::Get(uint64_t fKey, long long pNum, XrdOucCacheIO *ioP,
+                          char *buff, int pOff, int rLen,
+                          XrdOucCacheStats &Stats)
+{
+   uint64_t h  = Mix(fKey, pNum);
+   Bucket  *bP = &Buckets[h % nBuckets];
+   Slot    *sBeg = &Slots[(h % nBuckets) * nWays], *sP, *vP;
+   char    *pAddr;
+   unsigned long long seq;
+   int dLen = 0, rc;
+   bool waited = false;
+
+do{Lock(bP);
+
+// Look for the page in the bucket
+//
+   for (sP = sBeg; sP < sBeg + nWays; sP++)
+       if (sP->State != isEmpty && sP->fKey == fKey && sP->pNum == pNum) break;
+
+// If the page is there, copy it out without holding the lock and make sure
+// that it was not replaced while we were copying it.
+//
+   if (sP < sBeg + nWays && sP->State == isReady)
+      {seq  = sP->Seq.load(std::memory_order_acquire);
+       dLen = sP->dLen;
+       sP->Used = Hdr->Clock.fetch_add(1, std::memory_order_relaxed);
+       pthread_mutex_unlock(&bP->Mutex);
+       pAddr = Pages + (long long)(sP - Slots) * pgSize;
+       rc = (pOff >= dLen ? 0 : (dLen - pOff < rLen ? dLen - pOff : rLen));
+       if (rc) memcpy(buff, pAddr + pOff, rc);
+       std::atomic_thread_fence(std::memory_order_acquire);
+       if (sP->Seq.load(std::memory_order_relaxed) == seq)
+          {if (!waited) Stats.Count(Stats.X.Hits);
+           Stats.Add(Stats.X.BytesGet, rc);
+           return rc;
+          }
+       continue;
+      }
+
+// If someone is reading the page, wait for them to finish. If they died
+// doing so, discard the page and try again.
+//
+   if (sP < sBeg + nWays)
+      {if (kill(sP->Loader, 0) && errno == ESRCH)
+          {sP->State = isEmpty;
+           sP->Seq.fetch_add(1, std::memory_order_release);
+          } else if (!waited)
+                    {Stats.Count(Stats.X.Hits); waited = true;}
+       Wait(bP);
+       pthread_mutex_unlock(&bP->Mutex);
+       continue;
+      }
+
+// This is a miss. Pick the empty or least recently used slot that is not
+// being loaded. If all of them are being loaded, simply read the data.
+//
+   vP = 0;
+   for (sP = sBeg; sP < sBeg + nWays; sP++)
+       {if (sP->State == isEmpty) {vP = sP; break;}
+        if (sP->State == isReady && (!vP || sP->Used < vP->Used)) vP = sP;
+       }
+   if (!vP)
+      {pthread_mutex_unlock(&bP->Mutex);
+       if ((rc = ioP->Read(buff, pNum * pgSize + pOff, rLen)) > 0)
+          {Stats.Add(Stats.X.BytesPass, rc);
+           Stats.Count(Stats.X.Pass);
+          }
+       return rc;
+      }
+
+// Claim the slot, after which readers of its previous page will back off
+//
+   seq = vP->Seq.fetch_add(1, std::memory_order_relaxed) + 1;
+   std::atomic_thread_fence(std::memory_order_release);
+   vP->State  = isLoading;
+   vP->fKey   = fKey;
+   vP->pNum   = pNum;
+   vP->Loader = getpid();
+   pthread_mutex_unlock(&bP->Mutex);
+
+// Read the full page and copy out what the caller wants before publishing it
+//
+   pAddr = Pages + (long long)(vP - Slots) * pgSize;
+   rc = ioP->Read(pAddr, pNum * pgSize, pgSize);
+   if (rc >= 0)
+      {dLen = rc;
+       rc = (pOff >= dLen ? 0 : (dLen - pOff < rLen ? dLen - pOff : rLen));
+       if (rc) memcpy(buff, pAddr + pOff, rc);
+      }
+
+// Should the slot have been taken away from us (we were thought to be dead)
+// it may now hold someone else's page, possibly written over by our read.
+// Leave it alone and read what the caller wants directly.
+//
+   Lock(bP);
+   if (vP->Seq.load(std::memory_order_relaxed) != seq
+   ||  vP->State != isLoading || vP->Loader != getpid())
+      {pthread_mutex_unlock(&bP->Mutex);
+       if ((rc = ioP->Read(buff, pNum * pgSize + pOff, rLen)) > 0)
+          {Stats.Add(Stats.X.BytesPass, rc);
+           Stats.Count(Stats.X.Pass);
+          }
+       return rc;
+      }
+   if (rc >= 0)
+      {Stats.Count(Stats.X.Miss);
+       Stats.Add(Stats.X.BytesRead, dLen);
+       Stats.Add(Stats.X.BytesGet,  rc);
+      }
+
+// Publish the outcome and wake up anyone waiting for it
+//
+   if (rc < 0) vP->State = isEmpty;
+      else {vP->dLen  = dLen;
+            vP->State = isReady;
+            vP->Used  = Hdr->Clock.fetch_add(1, std::memory_order_relaxed);
+           }
+   vP->Seq.fetch_add(1, std::memory_order_release);
+   pthread_cond_broadcast(&bP->Ready);
+   pthread_mutex_unlock(&bP->Mutex);
+   return rc;
+
+  } while(true);
+}
+
+/******************************************************************************/
+/* Private:                         L o c k                                   */
+/******************************************************************************/
+
+void XrdPosixShmCache::Lock(Bucket *bP)
+{
+
+// The previous owner may have died holding the lock. The bucket is still
+// consistent as slots being loaded by the dead process are reclaimed.
+//
+#if defined(__linux__)
+   if (pthread_mutex_lock(&bP->Mutex) == EOWNERDEAD)
+      pthread_mutex_consistent(&bP->Mutex);
+#else
+   pthread_mutex_lock(&bP->Mutex);
+#endif
+}
+
+/******************************************************************************/
+/* Private:                         W a i t                                   */
+/******************************************************************************/
+
+// Wait for a page load in the bucket to end. The wait is bounded so that the
+// death of the loading process is noticed.
+//
+void XrdPosixShmCache::Wait(Bucket *bP)
+{
+   struct timespec tOut;
+
+   clock_gettime(CLOCK_MONOTONIC, &tOut);
+   tOut.tv_sec += 1;
+#if defined(__linux__)
+   if (pthread_cond_timedwait(&bP->Ready, &bP->Mutex, &tOut) == EOWNERDEAD)
+      pthread_mutex_consistent(&bP->Mutex);
+#else
+   pthread_cond_timedwait(&bP->Ready, &bP->Mutex, &tOut);
+#endif
+}
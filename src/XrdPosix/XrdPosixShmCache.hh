@@ -0,0 +1,129 @@
+#ifndef __XRDPOSIXSHMCACHE_HH__
+#define __XRDPOSIXSHMCACHE_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d P o s i x S h m C a c h e . h h                    */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstdint>
+
+#include "XrdOuc/XrdOucCache.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/*! The class defined here implements a node-local read-only memory cache that
+    lives in a named shared memory segment. Every process that creates a cache
+    with the same name (and runs under the same uid) attaches to the same
+    segment, so that data read by one process is available to all of them.
+    This is meant for many processes on a node (e.g. via the preload library)
+    reading the same files.
+
+    Notes:
+
+    1.  Pages are identified by the file's url (less cgi), size, and
+        modification time together with the page number. Hence, files that
+        change are not served stale data as long as their size or mtime change.
+    2.  A page being read from the origin is marked as such in the segment.
+        Any other thread or process wanting the same page waits for that read
+        to complete instead of issuing its own. Should the reading process die,
+        the page is reclaimed by the next process wanting it.
+    3.  Hits are copied directly from the mapped segment into the caller's
+        buffer; no other copy or inter-process communication is involved.
+    4.  Files opened read/write are not cached.
+    5.  The segment persists until removed (i.e. /dev/shm/xrdposix.<name>.<uid>)
+        and its geometry is fixed by the process that created it; the size and
+        page size of subsequent creators are ignored.
+    6.  The segment requires process-shared robust mutexes and is only
+        supported on Linux. Elsewhere Create() fails with ENOTSUP.
+*/
+
+class XrdPosixShmCache : public XrdOucCache
+{
+friend class XrdPosixShmCacheIO;
+public:
+
+//-----------------------------------------------------------------------------
+//! Parameters for a shared memory cache.
+//-----------------------------------------------------------------------------
+
+struct Parms
+      {long long CacheSize; //!< Size of cache in bytes     (default 1GB)
+       int       PageSize;  //!< Size of each page in bytes (default 1MB)
+       int       Max2Cache; //!< Largest read to cache      (default 64MB)
+       int       Debug;     //!< Debug level 0 to 3         (default 0)
+
+                 Parms() : CacheSize(1073741824LL), PageSize(1048576),
+                           Max2Cache(67108864), Debug(0) {}
+      };
+
+XrdOucCacheIO *Attach(XrdOucCacheIO *ioP, int opts=0) override;
+
+//-----------------------------------------------------------------------------
+//! Create or attach to a shared memory cache.
+//!
+//! @param  name    The name of the cache; the segment is named after it and
+//!                 the real uid. Only [A-Za-z0-9._-] characters are allowed.
+//! @param  parms   Reference to the cache parameters.
+//!
+//! @return Success: a pointer to the cache.
+//!         Failure: a null pointer is returned and errno set to the reason.
+//-----------------------------------------------------------------------------
+
+static XrdPosixShmCache *Create(const char *name, Parms &parms);
+
+//-----------------------------------------------------------------------------
+//! Return the segment geometry actually in use.
+//-----------------------------------------------------------------------------
+
+long long      CacheSize() {return (long long)pgSize * nSlots;}
+
+int            PageSize()  {return pgSize;}
+
+private:
+struct Bucket;
+struct Header;
+struct Slot;
+
+               XrdPosixShmCache(char *base, long long size, int m2c, int dbg);
+              ~XrdPosixShmCache() {} // Never gets deleted
+
+int            Get(uint64_t fKey,  long long pNum, XrdOucCacheIO *ioP,
+                   char *buff, int pOff, int rLen, XrdOucCacheStats &Stats);
+
+static void    Lock(Bucket *bP);
+static void    Wait(Bucket *bP);
+
+Header        *Hdr;
+Bucket        *Buckets;
+Slot          *Slots;
+char          *Pages;
+long long      segSize;
+int            pgSize;
+int            nBuckets;
+int            nSlots;
+int            max2Cache;
+int            Dbg;
+};
+#endif
@@ -52,6 +52,7 @@
 
 #include "XrdNet/XrdNetSecurity.hh"
 #include "XrdPss/XrdPss.hh"
+#include "XrdPss/XrdPssMetaCache.hh"
 #include "XrdPss/XrdPssTrace.hh"
 #include "XrdPss/XrdPssUrlInfo.hh"
 #include "XrdPss/XrdPssUtils.hh"
@@ -113,6 +114,8 @@ static XrdPssSys   XrdProxySS;
 
        XrdSecsssID  *idMapper = 0;    // -> Auth ID mapper
 
+       XrdPssMetaCache *metaCache = 0; // -> Metadata cache, if any
+
 static const char   *ofslclCGI = "ofs.lcl=1";
 
 static const char   *osslclCGI = "oss.lcl=1";
@@ -438,9 +441,11 @@ int XrdPssSys::Mkdir(const char *path, mode_t mode, int mkpath, XrdOucEnv *eP)
     DEBUG(uInfo.Tident(),"url="<<urlObf);
   }
 
-// Simply return the proxied result here
+// Issue the mkdir and tell the cache the directory may now exist
 //
-   return (XrdPosixXrootd::Mkdir(pbuff, mode) ? Info(errno) : XrdOssOK);
+   rc = (XrdPosixXrootd::Mkdir(pbuff, mode) ? Info(errno) : XrdOssOK);
+   if (metaCache) metaCache->Invalidate(path);
+   return rc;
 }
   
 /******************************************************************************/
@@ -486,7 +491,9 @@ int XrdPssSys::Remdir(const char *path, int Opts, XrdOucEnv *eP)
   }
 // Issue unlink and return result
 //
-   return (XrdPosixXrootd::Rmdir(pbuff) ? Info(errno) : XrdOssOK);
+   rc = (XrdPosixXrootd::Rmdir(pbuff) ? Info(errno) : XrdOssOK);
+   if (metaCache) metaCache->Invalidate(path);
+   return rc;
 }
 
 /******************************************************************************/
@@ -533,9 +540,15 @@ int XrdPssSys::Rename(const char *oldname, const char *newname,
   }
 
 
-// Execute the rename and return result
+// Execute the rename and return result. Either name may be a directory so
+// everything cached below either one is discarded as well.
 //
-   return (XrdPosixXrootd::Rename(oldName, newName) ? Info(errno) : XrdOssOK);
+   rc = (XrdPosixXrootd::Rename(oldName, newName) ? Info(errno) : XrdOssOK);
+   if (metaCache)
+      {metaCache->Invalidate(oldname, true);
+       metaCache->Invalidate(newname, true);
+      }
+   return rc;
 }
 
 /******************************************************************************/
@@ -553,7 +566,8 @@ int XrdPssSys::Rename(const char *oldname, const char *newname,
 
   Output:   Returns XrdOssOK upon success and -errno upon failure.
 
-  Notes:    The XRDOSS_resonly flag in Opts is not supported.
+  Notes:    The XRDOSS_resonly flag in Opts is not supported. Such requests
+            bypass the metadata cache.
 */
 
 int XrdPssSys::Stat(const char *path, struct stat *buff, int Opts, XrdOucEnv *eP)
@@ -562,6 +576,7 @@ int XrdPssSys::Stat(const char *path, struct stat *buff, int Opts, XrdOucEnv *eP
    const char *Cgi = "";
    int rc;
    char pbuff[PBsz];
+   bool mcUse = metaCache && *path == '/' && !(Opts & XRDOSS_resonly);
 
 // Setup any required special cgi information
 //
@@ -578,9 +593,21 @@ int XrdPssSys::Stat(const char *path, struct stat *buff, int Opts, XrdOucEnv *eP
    if (idMapAll) uInfo.setID();
       else if (sidP) uInfo.setID(sidP);
 
+// Use the cached result if we have one. The answer depends on the identity
+// the origin sees and the client's cgi may carry credentials, so such requests
+// always go to the origin. Otherwise, we are now responsible for supplying the
+// result to the cache whatever the outcome.
+//
+   const char *mcID = uInfo.getMapID();
+   if (mcUse && uInfo.hasUsrCGI()) mcUse = false;
+   if (mcUse && metaCache->StatFind(path, *buff, rc, mcID)) return rc;
+
 // Convert path to URL
 //
-   if ((rc = P2URL(pbuff, PBsz, uInfo, xLfn2Pfn))) return rc;
+   if ((rc = P2URL(pbuff, PBsz, uInfo, xLfn2Pfn)))
+      {if (mcUse) metaCache->StatDone(path, rc, 0, mcID);
+       return rc;
+      }
 
 // Do some tracing
 //
@@ -591,7 +618,9 @@ int XrdPssSys::Stat(const char *path, struct stat *buff, int Opts, XrdOucEnv *eP
 
 // Return proxied stat
 //
-   return (XrdPosixXrootd::Stat(pbuff, buff) ? Info(errno) : XrdOssOK);
+   rc = (XrdPosixXrootd::Stat(pbuff, buff) ? Info(errno) : XrdOssOK);
+   if (mcUse) metaCache->StatDone(path, rc, buff, mcID);
+   return rc;
 }
 
 /******************************************************************************/
@@ -651,7 +680,9 @@ int XrdPssSys::Truncate(const char *path, unsigned long long flen,
 // Return proxied truncate. We only do this on a single machine because the
 // redirector will forbid the trunc() if multiple copies exist.
 //
-   return (XrdPosixXrootd::Truncate(pbuff, flen) ? Info(errno) : XrdOssOK);
+   rc = (XrdPosixXrootd::Truncate(pbuff, flen) ? Info(errno) : XrdOssOK);
+   if (metaCache) metaCache->Invalidate(path);
+   return rc;
 }
   
 /******************************************************************************/
@@ -698,7 +729,9 @@ int XrdPssSys::Unlink(const char *path, int Opts, XrdOucEnv *envP)
 
 // Unlink the file and return result.
 //
-   return (XrdPosixXrootd::Unlink(pbuff) ? Info(errno) : XrdOssOK);
+   rc = (XrdPosixXrootd::Unlink(pbuff) ? Info(errno) : XrdOssOK);
+   if (metaCache) metaCache->Invalidate(path);
+   return rc;
 }
 
 /******************************************************************************/
@@ -724,7 +757,7 @@ int XrdPssDir::Opendir(const char *dir_path, XrdOucEnv &Env)
 
 // Return an error if this object is already open
 //
-   if (myDir) return -XRDOSS_E8001;
+   if (myDir || mcList) return -XRDOSS_E8001;
 
 // Open directories are not supported for object id's
 //
@@ -747,6 +780,21 @@ int XrdPssDir::Opendir(const char *dir_path, XrdOucEnv &Env)
     DEBUG(uInfo.Tident(),"url="<<urlObf);
   }
 
+// If the listing is in the metadata cache we will use it. We keep the url in
+// case the listing lacks stat information and we must go to the origin. As
+// for stat, listings requested with client cgi are never cached.
+//
+   bool mcUse = metaCache && !uInfo.hasUsrCGI();
+   if (mcUse)
+      {mcPath = dir_path;
+       mcID   = uInfo.getMapID();
+       if ((mcList = metaCache->DirFind(dir_path, mcGen, mcID.c_str())))
+          {mcURL  = pbuff;
+           mcNext = 0;
+           return XrdOssOK;
+          }
+      }
+
 // Open the directory
 //
    myDir = XrdPosixXrootd::Opendir(pbuff);
@@ -755,6 +803,10 @@ int XrdPssDir::Opendir(const char *dir_path, XrdOucEnv &Env)
        lastEtrc = XrdPosixXrootd::QueryError(lastEtext);
        return rc;
       }
+
+// Collect the listing for the metadata cache
+//
+   if (mcUse) mcFill = new XrdPssMetaCache::DirList;
    return XrdOssOK;
 }
 
@@ -779,6 +831,17 @@ int XrdPssDir::Opendir(const char *dir_path, XrdOucEnv &Env)
 */
 int XrdPssDir::Readdir(char *buff, int blen)
 {
+// Check if we are returning a cached listing
+//
+   if (mcList)
+      {if (mcNext >= mcList->names.size()) *buff = 0;
+          else {strlcpy(buff, mcList->names[mcNext].c_str(), blen);
+                if (mcStat) *mcStat = mcList->stats[mcNext];
+                mcNext++;
+               }
+       return XrdOssOK;
+      }
+
 // Check if we are directly reading the directory
 //
    if (myDir)
@@ -786,10 +849,24 @@ int XrdPssDir::Readdir(char *buff, int blen)
        int    rc = XrdPosixXrootd::Readdir_r(myDir, &myEnt, &entP);
        if (rc)
           {lastEtrc = XrdPosixXrootd::QueryError(lastEtext, myDir);
+           if (mcFill) {delete mcFill; mcFill = 0;}
            return -rc;
           }
        if (!entP) *buff = 0;
           else strlcpy(buff, myEnt.d_name, blen);
+
+// Add the entry to the listing being collected. Once we have all of it, hand
+// it off to the metadata cache.
+//
+       if (mcFill)
+          {if (entP)
+              {mcFill->names.push_back(myEnt.d_name);
+               if (mcStat) mcFill->stats.push_back(*mcStat);
+              } else {
+               metaCache->DirAdd(mcPath.c_str(), mcFill, mcGen, mcID.c_str());
+               mcFill = 0;
+              }
+          }
        return XrdOssOK;
       }
 
@@ -803,10 +880,32 @@ int XrdPssDir::Readdir(char *buff, int blen)
 /******************************************************************************/
 int XrdPssDir::StatRet(struct stat *buff)
 {
+// A cached listing can only be used if it has stat information. Otherwise,
+// read the listing from the origin after all; it then replaces the cached one.
+//
+   if (mcList)
+      {if (mcList->names.size() == mcList->stats.size())
+          {mcStat = buff;
+           return XrdOssOK;
+          }
+       mcList.reset();
+       if (!(myDir = XrdPosixXrootd::Opendir(mcURL.c_str())))
+          {int rc = -errno;
+           lastEtrc = XrdPosixXrootd::QueryError(lastEtext);
+           return rc;
+          }
+       mcFill = new XrdPssMetaCache::DirList;
+      }
+
    if (!myDir) return -XRDOSS_E8002;
 
    auto rc = XrdPosixXrootd::StatRet(myDir, buff);
    if (rc) return -rc;
+
+// Stat information must accompany every name collected for the cache
+//
+   if (mcFill && !mcFill->names.empty()) {delete mcFill; mcFill = 0;}
+   mcStat = buff;
    return XrdOssOK;
 }
 
@@ -825,6 +924,16 @@ int XrdPssDir::Close(long long *retsz)
 {
    DIR *theDir;
 
+// Drop any listing that came from or was destined for the metadata cache. An
+// incomplete listing is of no use to anyone.
+//
+   if (mcFill) {delete mcFill; mcFill = 0;}
+   mcStat = 0;
+   if (mcList)
+      {mcList.reset();
+       return XrdOssOK;
+      }
+
 // Close the directory proper if it exists. POSIX specified that directory
 // stream is no longer available after closedir() regardless if return value.
 //
@@ -909,6 +1018,14 @@ int XrdPssFile::Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &Env)
           }
       }
 
+// Anything cached about a file being written becomes stale when it is opened
+// and again when it is closed, so remember it for the metadata cache.
+//
+   if (metaCache && *path == '/' && (Oflag & O_ACCMODE) != O_RDONLY)
+      {if (mcPath) free(mcPath);
+       mcPath = strdup(path);
+      }
+
    // check CGI cache-control paramters
    if (cacheFSctl)
    {
@@ -1005,6 +1122,7 @@ int XrdPssFile::Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &Env)
 
 // All done
 //
+   if (mcPath) metaCache->Invalidate(mcPath);
    return XrdOssOK;
 }
 
@@ -1026,6 +1144,14 @@ int XrdPssFile::Close(long long *retsz)
 //
     if (retsz) *retsz = 0;
 
+// Whatever was cached about a file we were writing is no longer valid
+//
+    if (mcPath)
+       {metaCache->Invalidate(mcPath);
+        free(mcPath);
+        mcPath = 0;
+       }
+
 // If the file is not open, then this may be OK if it is a 3rd party copy
 //
     if (fd < 0)
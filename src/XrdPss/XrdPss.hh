@@ -33,6 +33,7 @@
 #include <cerrno>
 #include <unistd.h>
 #include <sys/types.h>
+#include <memory>
 #include <string>
 #include <vector>
 #include "XrdSys/XrdSysHeaders.hh"
@@ -43,6 +44,7 @@
 #include "XrdOuc/XrdOucPList.hh"
 #include "XrdOuc/XrdOucSid.hh"
 #include "XrdOss/XrdOss.hh"
+#include "XrdPss/XrdPssMetaCache.hh"
 
 /******************************************************************************/
 /*                             X r d P s s D i r                              */
@@ -66,13 +68,29 @@ int     StatRet(struct stat *buf) override;
         // Constructor and destructor
         XrdPssDir(const char *tid)
                  : XrdOssDF(tid, XrdOssDF::DF_isDir|XrdOssDF::DF_isProxy),
-                   myDir(0), lastEtrc(0) {}
+                   myDir(0), lastEtrc(0), mcFill(0), mcStat(0), mcGen(0),
+                   mcNext(0) {}
 
-       ~XrdPssDir() {if (myDir) Close();}
+       ~XrdPssDir() {if (myDir || mcList) Close();
+                     if (mcFill) delete mcFill;
+                    }
 private:
          DIR       *myDir;
     std::string    lastEtext;
          int       lastEtrc;
+
+// When the listing comes from the metadata cache, mcList holds it and mcURL
+// the origin's url in case it must be read after all. When the listing comes
+// from the origin, it is collected in mcFill to be added to the cache.
+//
+std::shared_ptr<const XrdPssMetaCache::DirList> mcList;
+XrdPssMetaCache::DirList *mcFill;
+struct stat   *mcStat;
+std::string    mcPath;
+std::string    mcID;
+std::string    mcURL;
+uint64_t       mcGen;
+size_t         mcNext;
 };
   
 /******************************************************************************/
@@ -117,11 +135,13 @@ int     Write(XrdSfsAio *aiop) override;
          // Constructor and destructor
          XrdPssFile(const char *tid)
                    : XrdOssDF(tid, XrdOssDF::DF_isFile|XrdOssDF::DF_isProxy),
-                     rpInfo(0), tpcPath(0), entity(0), lastEtrc(0) {}
+                     rpInfo(0), tpcPath(0), mcPath(0), entity(0),
+                     lastEtrc(0) {}
 
 virtual ~XrdPssFile() {if (fd >= 0) Close();
                        if (rpInfo) delete(rpInfo);
                        if (tpcPath) free(tpcPath);
+                       if (mcPath) free(mcPath);
                       }
 
 private:
@@ -139,6 +159,7 @@ struct tprInfo
       } *rpInfo;
 
       char         *tpcPath;
+      char         *mcPath;   // Path to invalidate in the metadata cache
 const XrdSecEntity *entity;
 std::string         lastEtext;
 int                 lastEtrc;
@@ -245,6 +266,7 @@ int    xconf(XrdSysError *Eroute, XrdOucStream &Config);
 int    xdef( XrdSysError *Eroute, XrdOucStream &Config);
 int    xdca( XrdSysError *errp,   XrdOucStream &Config);
 int    xexp( XrdSysError *Eroute, XrdOucStream &Config);
+int    xmeta(XrdSysError *errp,   XrdOucStream &Config);
 int    xperm(XrdSysError *errp,   XrdOucStream &Config);
 int    xpers(XrdSysError *errp,   XrdOucStream &Config);
 int    xorig(XrdSysError *errp,   XrdOucStream &Config);
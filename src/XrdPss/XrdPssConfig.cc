@@ -45,6 +45,7 @@
 #include "XrdNet/XrdNetSecurity.hh"
 
 #include "XrdPss/XrdPss.hh"
+#include "XrdPss/XrdPssMetaCache.hh"
 #include "XrdPss/XrdPssTrace.hh"
 #include "XrdPss/XrdPssUrlInfo.hh"
 #include "XrdPss/XrdPssUtils.hh"
@@ -128,6 +129,8 @@ extern XrdOucEnv       *envP;
 
 extern XrdSecsssID     *idMapper; // -> Auth ID mapper
 
+extern XrdPssMetaCache *metaCache;
+
 extern int              rpFD;
 
 extern bool             idMapAll;
@@ -147,6 +150,8 @@ XrdOucPsx *psxConfig;
 
 XrdSecsssID::authType sssMap;      // persona setting
 
+XrdPssMetaCache::Parms *mcParms = 0;  // metacache setting
+
 std::vector<const char *> protVec;    // Additional wanted protocols
 }
 
@@ -227,6 +232,22 @@ int XrdPssSys::Configure(const char *cfn, XrdOucEnv *envP)
 //
    if (sssMap && !ConfigMapID()) return 1;
 
+// Create the metadata cache if so wanted. Results obtained with a client's
+// persona cannot be shared with other clients so the cache is not used then.
+//
+   if (mcParms)
+      {if (idMapper)
+          {eDest.Say("Config warning: ignoring 'pss.metacache'; it is not "
+                     "supported with client personas!");
+          } else {
+           XrdXrootdGStream *gsP = 0;
+           if (envP) gsP = (XrdXrootdGStream *)envP->GetPtr("oss.gStream*");
+           metaCache = new XrdPssMetaCache(*mcParms, gsP);
+          }
+       delete mcParms;
+       mcParms = 0;
+      }
+
 // Handle the local root here
 //
    if (LocalRoot) psxConfig->SetRoot(LocalRoot);
@@ -513,6 +534,7 @@ int XrdPssSys::ConfigXeq(char *var, XrdOucStream &Config)
    TS_DBG("debug",         TRACEPSS_Debug);
    TS_Xeq("export",        xexp);
    TS_PSX("inetmode",      ParseINet);
+   TS_Xeq("metacache",     xmeta);
    TS_Xeq("origin",        xorig);
    TS_Xeq("permit",        xperm);
    TS_Xeq("persona",       xpers);
@@ -696,6 +718,74 @@ int XrdPssSys::xexp(XrdSysError *Eroute, XrdOucStream &Config)
    return 0;
 }
 
+/******************************************************************************/
+/*                                 x m e t a                                  */
+/******************************************************************************/
+
+/* Function: xmeta
+
+   Purpose:  To parse the directive: metacache {off | <opts>}
+
+             <opts>: [stat <tm>] [neg <tm>] [dir <tm>] [max <num>]
+                     [report <tm>]
+
+             off       do not cache metadata (the default).
+             stat      how long a successful stat result is kept.
+             neg       how long a file not found stat result is kept.
+             dir       how long a directory listing is kept.
+             max       maximum number of stat results and of listings kept.
+             report    interval at which statistics are sent to the oss
+                       g-stream, 0 means never.
+
+             A zero time disables caching of that item.
+
+   Output: 0 upon success or 1 upon failure.
+*/
+
+int XrdPssSys::xmeta(XrdSysError *errp, XrdOucStream &Config)
+{
+   static const int maxtm = 0x7fffffff;
+   XrdPssMetaCache::Parms parms;
+   char *val;
+
+// Check if caching is being turned off
+//
+   if ((val = Config.GetWord()) && !strcmp(val, "off"))
+      {if (mcParms) {delete mcParms; mcParms = 0;}
+       return 0;
+      }
+
+// Process the options
+//
+   while(val)
+        {int *vP = 0;
+              if (!strcmp(val, "stat"))   vP = &parms.statTTL;
+         else if (!strcmp(val, "neg"))    vP = &parms.negTTL;
+         else if (!strcmp(val, "dir"))    vP = &parms.dirTTL;
+         else if (!strcmp(val, "report")) vP = &parms.rptIntv;
+         else if (strcmp(val, "max"))
+                 {errp->Emsg("Config","invalid metacache option -", val);
+                  return 1;
+                 }
+         if (!(val = Config.GetWord()))
+            {errp->Emsg("Config", "metacache value not specified"); return 1;}
+         if (vP)
+            {if (XrdOuca2x::a2tm(*errp,"metacache time",val,vP,0,maxtm))
+                return 1;
+            } else {
+             if (XrdOuca2x::a2i(*errp,"metacache max",val,&parms.maxEnt,1))
+                return 1;
+            }
+         val = Config.GetWord();
+        }
+
+// Record the settings
+//
+   if (!mcParms) mcParms = new XrdPssMetaCache::Parms;
+   *mcParms = parms;
+   return 0;
+}
+
 /******************************************************************************/
 /*                                 x o r i g                                  */
 /******************************************************************************/
@@ -0,0 +1,397 @@
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d P s s M e t a C a c h e . c c                     */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "XrdPss/XrdPssMetaCache.hh"
+#include "XrdSys/XrdSysTimer.hh"
+#include "XrdXrootd/XrdXrootdGStream.hh"
+
+/******************************************************************************/
+/*                         L o c a l   D e f i n e s                          */
+/******************************************************************************/
+
+namespace
+{
+void *ReportThread(void *carg)
+      {XrdPssMetaCache *mcP = (XrdPssMetaCache *)carg;
+       mcP->Report();
+       return (void *)0;
+      }
+
+// Erase every entry whose key starts with the prefix
+//
+template<typename T>
+void EraseTree(std::map<std::string, T> &theMap, const std::string &prefix)
+{
+   auto it = theMap.lower_bound(prefix);
+   while(it != theMap.end() && !it->first.compare(0, prefix.size(), prefix))
+        it = theMap.erase(it);
+}
+
+// Erase every entry for a path, whatever the identity
+//
+template<typename T>
+void ErasePath(std::map<std::string, T> &theMap, const std::string &key)
+{
+   theMap.erase(key);
+   EraseTree(theMap, key + '\0');
+}
+}
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdPssMetaCache::XrdPssMetaCache(const Parms &parms, XrdXrootdGStream *gsP)
+                                : mcCond(0), curGen(0), trimGen(0),
+                                  lastPurge(0), lastTrim(0),
+                                  Config(parms), gStream(gsP)
+{
+   pthread_t tid;
+
+   memset(&Stat, 0, sizeof(Stat));
+
+// Start the thread that periodically reports our statistics, if need be
+//
+   if (gStream && Config.rptIntv > 0
+   &&  XrdSysThread::Run(&tid, ReportThread, (void *)this, 0, "pss metacache"))
+      gStream = 0;
+}
+
+/******************************************************************************/
+/*                                D i r A d d                                 */
+/******************************************************************************/
+
+void XrdPssMetaCache::DirAdd(const char *path, DirList *list, uint64_t gen,
+                             const char *ident)
+{
+   std::shared_ptr<const DirList> theList(list);
+   std::string key = Key(path, ident);
+   time_t now = time(0);
+
+// Do not keep a listing that may have missed a change made while it was read
+//
+   if (Config.dirTTL <= 0) return;
+   XrdSysCondVarHelper cHelp(mcCond);
+   if (Stale(Key(path), gen)) return;
+
+// Make room if we need to, we simply skip caching if we cannot
+//
+   if ((int)dirMap.size() >= Config.maxEnt && now != lastPurge) Purge(now);
+   if ((int)dirMap.size() >= Config.maxEnt) return;
+
+// Add the listing
+//
+   dEnt &theEnt = dirMap[key];
+   theEnt.expire = now + Config.dirTTL;
+   theEnt.list   = theList;
+}
+
+/******************************************************************************/
+/*                               D i r F i n d                                */
+/******************************************************************************/
+
+std::shared_ptr<const XrdPssMetaCache::DirList>
+XrdPssMetaCache::DirFind(const char *path, uint64_t &gen, const char *ident)
+{
+   XrdSysCondVarHelper cHelp(mcCond);
+   std::shared_ptr<const DirList> theList;
+   auto it = dirMap.find(Key(path, ident));
+
+// Return the listing if we have an unexpired one
+//
+   gen = curGen;
+   if (it != dirMap.end())
+      {if (it->second.expire > time(0))
+          {Stat.dirHits++;
+           return it->second.list;
+          }
+       dirMap.erase(it);
+      }
+   Stat.dirMiss++;
+   return theList;
+}
+
+/******************************************************************************/
+/*                              G e t S t a t s                               */
+/******************************************************************************/
+
+void XrdPssMetaCache::GetStats(XrdPssMetaCache::Stats &stats)
+{
+   XrdSysCondVarHelper cHelp(mcCond);
+
+   stats = Stat;
+   stats.entries = statMap.size() + dirMap.size();
+}
+
+/******************************************************************************/
+/*                            I n v a l i d a t e                             */
+/******************************************************************************/
+
+void XrdPssMetaCache::Invalidate(const char *path, bool tree)
+{
+   std::string key = Key(path);
+   size_t pos = key.rfind('/');
+   XrdSysCondVarHelper cHelp(mcCond);
+   time_t now = time(0);
+   iEnt stamp = {++curGen, now};
+
+// Forget invalidations no request can still care about
+//
+   Stat.invals++;
+   if (now != lastTrim) Trim(now);
+
+// Discard the path and, as its contents changed, the parent directory. Results
+// for these being obtained from the origin right now may be out of date.
+//
+   ErasePath(statMap, key);
+   ErasePath(dirMap,  key);
+   invPath[key] = stamp;
+   if (pos != std::string::npos)
+      {std::string parent(key, 0, (pos ? pos : 1));
+       ErasePath(statMap, parent);
+       ErasePath(dirMap,  parent);
+       invPath[parent] = stamp;
+      }
+
+// Discard everything below the path if so wanted
+//
+   if (tree)
+      {invTree[key] = stamp;
+       if (key != "/") key += '/';
+       EraseTree(statMap, key);
+       EraseTree(dirMap,  key);
+      }
+}
+
+/******************************************************************************/
+/* Private:                          K e y                                    */
+/******************************************************************************/
+
+std::string XrdPssMetaCache::Key(const char *path, const char *ident)
+{
+   std::string key(path);
+
+// Equivalent paths must have the same key. The identity follows a null byte
+// so that all of a path's entries can be found by prefix.
+//
+   while(key.size() > 1 && key.back() == '/') key.pop_back();
+   if (*ident) {key += '\0'; key += ident;}
+   return key;
+}
+
+/******************************************************************************/
+/* Private:                        P u r g e                                  */
+/******************************************************************************/
+
+// The caller must hold mcCond
+//
+void XrdPssMetaCache::Purge(time_t now)
+{
+   for (auto it = statMap.begin(); it != statMap.end();)
+       {if (it->second.expire <= now) it = statMap.erase(it);
+           else ++it;
+       }
+   for (auto it = dirMap.begin(); it != dirMap.end();)
+       {if (it->second.expire <= now) it = dirMap.erase(it);
+           else ++it;
+       }
+   Trim(now);
+   lastPurge = now;
+}
+
+/******************************************************************************/
+/*                                R e p o r t                                 */
+/******************************************************************************/
+
+void XrdPssMetaCache::Report()
+{
+   static const char *fmt = "{\"event\":\"pss_metacache\","
+          "\"stat_hits\":%lld,\"neg_hits\":%lld,\"stat_miss\":%lld,"
+          "\"coalesced\":%lld,\"dir_hits\":%lld,\"dir_miss\":%lld,"
+          "\"invalidations\":%lld,\"entries\":%lld}";
+   char buff[512];
+   Stats st;
+   int n;
+
+// Periodically send our statistics and, while here, drop expired entries
+//
+   while(true)
+        {XrdSysTimer::Snooze(Config.rptIntv);
+         mcCond.Lock();
+         Purge(time(0));
+         mcCond.UnLock();
+         GetStats(st);
+         n = snprintf(buff, sizeof(buff), fmt, st.statHits, st.negHits,
+                      st.statMiss, st.coalesced, st.dirHits, st.dirMiss,
+                      st.invals, st.entries);
+         if (n < (int)sizeof(buff)) gStream->Insert(buff, n+1);
+        }
+}
+
+/******************************************************************************/
+/* Private:                        S t a l e                                  */
+/******************************************************************************/
+
+// The caller must hold mcCond
+//
+bool XrdPssMetaCache::Stale(const std::string &path, uint64_t gen)
+{
+   std::string dir(path);
+   size_t pos;
+
+// Should we have forgotten an invalidation made after the request started we
+// can't tell whether it applied, so assume the worst.
+//
+   if (gen < trimGen) return true;
+
+// Check whether the path itself was invalidated
+//
+   auto it = invPath.find(path);
+   if (it != invPath.end() && it->second.gen > gen) return true;
+
+// Check whether the path or any of its ancestors was invalidated as a tree
+//
+   if (!invTree.empty())
+      do {if ((it = invTree.find(dir)) != invTree.end()
+          &&  it->second.gen > gen) return true;
+          if ((pos = dir.rfind('/')) == std::string::npos || dir == "/") break;
+          dir.erase(pos ? pos : 1);
+         } while(true);
+   return false;
+}
+
+/******************************************************************************/
+/*                              S t a t D o n e                               */
+/******************************************************************************/
+
+void XrdPssMetaCache::StatDone(const char *path, int rc, const struct stat *st,
+                               const char *ident)
+{
+   std::string key = Key(path, ident);
+   XrdSysCondVarHelper cHelp(mcCond);
+   auto it = pendMap.find(key);
+   sPend *pP;
+   time_t now;
+   int ttl;
+
+// Find the pending request and post its result to anyone waiting for it
+//
+   if (it == pendMap.end()) return;
+   pP = it->second;
+   pendMap.erase(it);
+   pP->rc   = rc;
+   pP->done = true;
+   if (!rc && st) pP->st = *st;
+   mcCond.Broadcast();
+
+// Only "not found" is a cacheable failure. The result is also not cached when
+// anything was invalidated while the request was outstanding.
+//
+   if (!rc) ttl = (st ? Config.statTTL : 0);
+      else ttl = (rc == -ENOENT ? Config.negTTL : 0);
+   if (ttl > 0 && !Stale(Key(path), pP->gen))
+      {now = time(0);
+       if ((int)statMap.size() >= Config.maxEnt && now != lastPurge) Purge(now);
+       if ((int)statMap.size() < Config.maxEnt)
+          {sEnt &theEnt = statMap[key];
+           theEnt.expire = now + ttl;
+           theEnt.rc     = rc;
+           if (!rc) theEnt.st = *st;
+          }
+      }
+
+// Drop our reference to the pending request
+//
+   if (!(--pP->refs)) delete pP;
+}
+
+/******************************************************************************/
+/*                              S t a t F i n d                               */
+/******************************************************************************/
+
+bool XrdPssMetaCache::StatFind(const char *path, struct stat &st, int &rc,
+                               const char *ident)
+{
+   std::string key = Key(path, ident);
+   XrdSysCondVarHelper cHelp(mcCond);
+   auto it = statMap.find(key);
+
+// Return the result if we have an unexpired one
+//
+   if (it != statMap.end())
+      {if (it->second.expire > time(0))
+          {if ((rc = it->second.rc)) Stat.negHits++;
+              else {Stat.statHits++; st = it->second.st;}
+           return true;
+          }
+       statMap.erase(it);
+      }
+
+// If someone is already asking the origin, wait for their answer
+//
+   auto pit = pendMap.find(key);
+   if (pit != pendMap.end())
+      {sPend *pP = pit->second;
+       pP->refs++;
+       Stat.coalesced++;
+       while(!pP->done) mcCond.Wait();
+       if (!(rc = pP->rc)) st = pP->st;
+       if (!(--pP->refs)) delete pP;
+       return true;
+      }
+
+// The caller must ask the origin
+//
+   Stat.statMiss++;
+   pendMap[key] = new sPend(curGen);
+   return false;
+}
+
+/******************************************************************************/
+/* Private:                         T r i m                                   */
+/******************************************************************************/
+
+// The caller must hold mcCond
+//
+void XrdPssMetaCache::Trim(time_t now)
+{
+   std::map<std::string, iEnt> *invMap[] = {&invPath, &invTree};
+
+   for (auto mP : invMap)
+       for (auto it = mP->begin(); it != mP->end();)
+           {if (it->second.when + maxFill > now) ++it;
+               else {if (it->second.gen > trimGen) trimGen = it->second.gen;
+                     it = mP->erase(it);
+                    }
+           }
+   lastTrim = now;
+}
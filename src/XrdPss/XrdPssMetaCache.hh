@@ -0,0 +1,246 @@
+#ifndef __XRDPSS_METACACHE_HH__
+#define __XRDPSS_METACACHE_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d P s s M e t a C a c h e . h h                     */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdXrootdGStream;
+
+//------------------------------------------------------------------------------
+//! The XrdPssMetaCache class holds the results of stat() and directory listing
+//! requests sent to the origin so that repeated requests for the same path are
+//! answered locally for a limited time. Successful stat results, "not found"
+//! results, and listings each have their own lifetime. Concurrent stat misses
+//! for the same path are coalesced so that only one request goes to the origin
+//! and every requester receives its result.
+//!
+//! Entries are keyed by logical path and by the identity under which the
+//! origin was asked, if any, as the origin's answer may depend on who asks.
+//! Changes made through the proxy must be reported via Invalidate() so that
+//! they are visible immediately; changes made at the origin by others become
+//! visible when the entry expires.
+//------------------------------------------------------------------------------
+
+class XrdPssMetaCache
+{
+public:
+
+struct Parms
+      {int  statTTL;   //!< Seconds a successful stat result is kept
+       int  negTTL;    //!< Seconds a not found stat result is kept
+       int  dirTTL;    //!< Seconds a directory listing is kept
+       int  maxEnt;    //!< Maximum number of stat results and of listings
+       int  rptIntv;   //!< Seconds between g-stream reports (0 -> none)
+
+            Parms() : statTTL(30), negTTL(10), dirTTL(30), maxEnt(100000),
+                      rptIntv(60) {}
+      };
+
+struct Stats
+      {long long statHits;   //!< Stat requests answered by a positive entry
+       long long negHits;    //!< Stat requests answered by a negative entry
+       long long statMiss;   //!< Stat requests sent to the origin
+       long long coalesced;  //!< Stat requests that waited for another's
+       long long dirHits;    //!< Listings served from the cache
+       long long dirMiss;    //!< Listings read from the origin
+       long long invals;     //!< Invalidations
+       long long entries;    //!< Stat results and listings currently held
+      };
+
+//------------------------------------------------------------------------------
+//! A directory listing. When the listing was obtained with stat information
+//! there is one stat structure per name, otherwise the stat vector is empty.
+//------------------------------------------------------------------------------
+
+struct DirList
+      {std::vector<std::string> names;
+       std::vector<struct stat> stats;
+      };
+
+//------------------------------------------------------------------------------
+//! Add a directory listing obtained from the origin.
+//!
+//! @param  path   the directory's logical path.
+//! @param  list   the complete listing, the cache takes ownership of it.
+//! @param  gen    the generation returned by DirFind() before the listing was
+//!                started. The listing is not kept should the directory have
+//!                been invalidated since then as it may be out of date.
+//! @param  ident  the identity passed to DirFind().
+//------------------------------------------------------------------------------
+
+void   DirAdd(const char *path, DirList *list, uint64_t gen,
+              const char *ident="");
+
+//------------------------------------------------------------------------------
+//! Find a directory listing.
+//!
+//! @param  path   the directory's logical path.
+//! @param  gen    receives the current generation to be passed to DirAdd().
+//! @param  ident  the identity under which the origin is asked, if any.
+//!
+//! @return The listing, which remains valid for as long as it is referenced,
+//!         or nil when the listing is not in the cache.
+//------------------------------------------------------------------------------
+
+std::shared_ptr<const DirList> DirFind(const char *path, uint64_t &gen,
+                                       const char *ident="");
+
+//------------------------------------------------------------------------------
+//! Obtain usage statistics.
+//------------------------------------------------------------------------------
+
+void   GetStats(Stats &stats);
+
+//------------------------------------------------------------------------------
+//! Discard everything cached about a path that has been changed.
+//!
+//! @param  path   the logical path that was created, changed or removed. The
+//!                parent directory's listing and stat result are discarded
+//!                as well. This applies to every identity.
+//! @param  tree   when true, everything below path is also discarded (e.g.
+//!                path is a directory that was renamed).
+//------------------------------------------------------------------------------
+
+void   Invalidate(const char *path, bool tree=false);
+
+//------------------------------------------------------------------------------
+//! Send statistics to the g-stream (used internally by the report thread).
+//------------------------------------------------------------------------------
+
+void   Report();
+
+//------------------------------------------------------------------------------
+//! Complete a stat request after StatFind() returned false. This must be
+//! called exactly once for every such request, whatever its outcome.
+//!
+//! @param  path   the logical path passed to StatFind().
+//! @param  rc     the result of the stat request, 0 or -errno.
+//! @param  st     the stat information when rc is zero.
+//! @param  ident  the identity passed to StatFind().
+//------------------------------------------------------------------------------
+
+void   StatDone(const char *path, int rc, const struct stat *st,
+                const char *ident="");
+
+//------------------------------------------------------------------------------
+//! Find a stat result. Should another thread be obtaining it from the origin,
+//! wait for that request to complete and use its result.
+//!
+//! @param  path   the logical path.
+//! @param  st     receives the stat information when true and rc is zero.
+//! @param  rc     receives the result when true is returned, 0 or -errno.
+//! @param  ident  the identity under which the origin is asked, if any.
+//!
+//! @return true   the result was found, it is in rc and st.
+//!         false  the result was not found; the caller must obtain it and
+//!                report it via StatDone().
+//------------------------------------------------------------------------------
+
+bool   StatFind(const char *path, struct stat &st, int &rc,
+                const char *ident="");
+
+//------------------------------------------------------------------------------
+//! Constructor.
+//!
+//! @param  parms  the configuration.
+//! @param  gsP    the g-stream to which statistics are periodically sent.
+//------------------------------------------------------------------------------
+
+       XrdPssMetaCache(const Parms &parms, XrdXrootdGStream *gsP=0);
+
+//------------------------------------------------------------------------------
+//! Destructor. The XrdPssMetaCache object is not designed to be deleted as
+//! its report thread may be running.
+//------------------------------------------------------------------------------
+
+      ~XrdPssMetaCache() {} // Never gets deleted
+
+private:
+
+struct sEnt
+      {time_t       expire;
+       int          rc;
+       struct stat  st;
+      };
+
+struct dEnt
+      {time_t       expire;
+       std::shared_ptr<const DirList> list;
+      };
+
+struct iEnt
+      {uint64_t     gen;
+       time_t       when;
+      };
+
+struct sPend
+      {uint64_t     gen;
+       int          rc;
+       int          refs;
+       bool         done;
+       struct stat  st;
+
+                    sPend(uint64_t g) : gen(g), rc(0), refs(1), done(false) {}
+      };
+
+static std::string Key(const char *path, const char *ident="");
+void               Purge(time_t now);
+bool               Stale(const std::string &path, uint64_t gen);
+void               Trim(time_t now);
+
+// A result obtained from the origin is out of date when its path was
+// invalidated after the request was started. So, we remember when each path
+// and tree was last invalidated, though only for as long as a request may
+// reasonably take; anything started before a forgotten invalidation is stale.
+//
+static const int   maxFill = 60;
+
+XrdSysCondVar      mcCond;   // Protects everything below, signals completions
+std::map<std::string, sEnt>    statMap;
+std::map<std::string, dEnt>    dirMap;
+std::map<std::string, sPend *> pendMap;
+std::map<std::string, iEnt>    invPath;
+std::map<std::string, iEnt>    invTree;
+uint64_t           curGen;
+uint64_t           trimGen;
+time_t             lastPurge;
+time_t             lastTrim;
+Parms              Config;
+Stats              Stat;
+XrdXrootdGStream  *gStream;
+};
+#endif
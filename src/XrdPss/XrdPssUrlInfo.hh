@@ -44,8 +44,15 @@ public:
 
 const char *getID() {return theID;}
 
+// Returns the client identity that setID() placed in the url, if any. It is
+// the null string when the origin sees the server's identity.
+//
+const char *getMapID() {return (idMapped ? theID : "");}
+
       bool  hasCGI() {return CgiSsz || CgiUsz;}
 
+      bool  hasUsrCGI() {return CgiUsz != 0;}
+
       void  setID(const char *tid=0);
 
       void  setID(XrdOucSid *sP)
@@ -78,6 +85,7 @@ const char       *CgiUsr;
 unsigned
       int         entityID;
       bool        eIDvalid;
+      bool        idMapped;
       char        theID[13];
 XrdOucSid::theSid idVal;
       char        CgiSfx[512];
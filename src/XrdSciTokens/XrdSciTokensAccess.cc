@@ -9,12 +9,17 @@
 #include "XrdTls/XrdTlsContext.hh"
 #include "XrdVersion.hh"
 
+#include <array>
 #include <cctype>
+#include <condition_variable>
 #include <ctime>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 #include <sstream>
 #include <fstream>
@@ -28,6 +33,7 @@
 #include "scitokens/scitokens.h"
 #include "XrdSciTokens/XrdSciTokensHelper.hh"
 #include "XrdSciTokens/XrdSciTokensMon.hh"
+#include "XrdSciTokens/XrdSciTokensPathIndex.hh"
 
 // The status-quo to retrieve the default object is to copy/paste the
 // linker definition and invoke directly.
@@ -383,27 +389,10 @@ public:
 
     ~XrdAccRules() {}
 
-    bool apply(Access_Operation oper, std::string path) {
-      for (const auto & rule : m_rules) {
-        // Skip rules that don't match the current operation
-        if (rule.first != oper)
-          continue;
-
-        // If the rule allows any path, allow the operation
-        if (rule.second == "/")
-          return true;
-
-        // Allow operation if path is a subdirectory of the rule's path
-        if (is_subdirectory(rule.second, path)) {
-          return true;
-        } else {
-          // Allow stat and mkdir of parent directories to comply with WLCG token specs
-          if (oper == AOP_Stat || oper == AOP_Mkdir)
-            if (is_subdirectory(path, rule.second))
-              return true;
-        }
-      }
-      return false;
+    bool apply(Access_Operation oper, const std::string &path) const {
+      if (static_cast<unsigned>(oper) > AOP_LastOp) {return false;}
+      // Allow stat and mkdir of parent directories to comply with WLCG token specs
+      return m_index[oper].allows(path, oper == AOP_Stat || oper == AOP_Mkdir);
     }
 
     bool expired() const {return monotonic_time() > m_expiry_time;}
@@ -412,6 +401,9 @@ public:
         m_rules.reserve(rules.size());
         for (const auto &entry : rules) {
             m_rules.emplace_back(entry.first, entry.second);
+            if (static_cast<unsigned>(entry.first) <= AOP_LastOp) {
+                m_index[entry.first].insert(entry.second);
+            }
         }
     }
 
@@ -461,6 +453,7 @@ public:
 private:
     uint32_t m_authz_strategy;
     AccessRulesRaw m_rules;
+    std::array<PathRuleIndex, AOP_LastOp + 1> m_index;
     uint64_t m_expiry_time{0};
     const std::string m_username;
     const std::string m_token_subject;
@@ -488,7 +481,6 @@ public:
     XrdAccSciTokens(XrdSysLogger *lp, const char *parms, XrdAccAuthorize* chain, XrdOucEnv *envP) :
         m_chain(chain),
         m_parms(parms ? parms : ""),
-        m_next_clean(monotonic_time() + m_expiry_secs),
         m_log(lp, "scitokens_")
     {
         pthread_rwlock_init(&m_config_lock, nullptr);
@@ -497,9 +489,18 @@ public:
         if (!Config(envP)) {
             throw std::runtime_error("Failed to configure SciTokens authorization.");
         }
+        m_cleaner = std::thread(&XrdAccSciTokens::Cleaner, this);
     }
 
     virtual ~XrdAccSciTokens() {
+        if (m_cleaner.joinable()) {
+            {
+                std::lock_guard<std::mutex> guard(m_clean_mutex);
+                m_shutdown = true;
+            }
+            m_clean_cv.notify_one();
+            m_cleaner.join();
+        }
         if (m_config_lock_initialized) {
             pthread_rwlock_destroy(&m_config_lock);
         }
@@ -531,11 +532,13 @@ public:
         m_log.Log(LogMask::Debug, "Access", "Trying token-based access control");
         std::shared_ptr<XrdAccRules> access_rules;
         uint64_t now = monotonic_time();
-        Check(now);
+        const std::string_view token(authz);
+        const size_t token_hash = TokenHash()(token);
+        TokenCacheShard &shard = m_map[token_hash % m_cache_shards];
         {
-            std::lock_guard<std::mutex> guard(m_map_mutex);
-            const auto iter = m_map.find(authz);
-            if (iter != m_map.end() && !iter->second->expired()) {
+            std::shared_lock<std::shared_mutex> guard(shard.mutex);
+            const auto iter = shard.map.find(token);
+            if (iter != shard.map.end() && !iter->second->expired()) {
                 access_rules = iter->second;
             }
         }
@@ -564,8 +567,8 @@ public:
                 m_log.Log(LogMask::Warning, "Access", "Error generating ACLs for authorization", exc.what());
                 return OnMissing(Entity, path, oper, env);
             }
-            std::lock_guard<std::mutex> guard(m_map_mutex);
-            m_map[authz] = access_rules;
+            std::unique_lock<std::shared_mutex> guard(shard.mutex);
+            shard.map[std::string(token)] = access_rules;
         } else if (m_log.getMsgMask() & LogMask::Debug) {
             m_log.Log(LogMask::Debug, "Access", "Cached token", access_rules->str().c_str());
         }
@@ -1403,43 +1406,62 @@ private:
         return true;
     }
 
-    void Check(uint64_t now)
+    // Periodically drop expired tokens and pick up configuration changes.
+    // This runs on its own thread so that no request ever waits on it.
+    void Cleaner()
     {
-        // Bail out if another thread is already checking
-        std::unique_lock<std::mutex> lock(m_check_mutex, std::try_to_lock);
-        if (!lock.owns_lock()) {return;}
-
-        // Check if cleaning is required
-        if (now <= m_next_clean) {return;}
-
-        // Clean expired m_map entries
+        std::unique_lock<std::mutex> lock(m_clean_mutex);
+        while (!m_clean_cv.wait_for(lock, std::chrono::seconds(m_expiry_secs),
+                                    [this]{return m_shutdown;}))
         {
-            std::lock_guard<std::mutex> guard(m_map_mutex);
-            for (auto iter = m_map.begin(); iter != m_map.end(); ) {
-                if (iter->second->expired()) {
-                    iter = m_map.erase(iter);
-                } else {
-                    ++iter;
+            lock.unlock();
+            for (auto &shard : m_map) {
+                std::unique_lock<std::shared_mutex> guard(shard.mutex);
+                for (auto iter = shard.map.begin(); iter != shard.map.end(); ) {
+                    if (iter->second->expired()) {
+                        iter = shard.map.erase(iter);
+                    } else {
+                        ++iter;
+                    }
                 }
             }
+            Reconfig();
+            lock.lock();
         }
-        Reconfig();
-
-        m_next_clean = monotonic_time() + m_expiry_secs;
     }
 
+    // Hash functor usable for lookups with a string_view of the token so
+    // that a cache hit does not copy the token.
+    struct TokenHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view token) const
+            {return std::hash<std::string_view>()(token);}
+    };
+
+    // The token cache is split into shards, each with its own reader/writer
+    // lock, so that concurrent lookups neither serialize nor contend.
+    struct TokenCacheShard
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<XrdAccRules>,
+                           TokenHash, std::equal_to<>> map;
+    };
+
     bool m_config_lock_initialized{false};
     pthread_rwlock_t m_config_lock;
     std::vector<std::string> m_audiences;
     std::vector<const char *> m_audiences_array;
-    std::map<std::string, std::shared_ptr<XrdAccRules>> m_map;
-    std::mutex m_check_mutex;
-    std::mutex m_map_mutex;
+    static constexpr size_t m_cache_shards = 16;
+    std::array<TokenCacheShard, m_cache_shards> m_map;
+    std::thread m_cleaner;
+    std::mutex m_clean_mutex;
+    std::condition_variable m_clean_cv;
+    bool m_shutdown{false};
     XrdAccAuthorize* m_chain;
     const std::string m_parms;
     std::vector<const char*> m_valid_issuers_array;
     std::unordered_map<std::string, IssuerConfig> m_issuers;
-    uint64_t m_next_clean{0};
     XrdSysError m_log;
     AuthzBehavior m_authz_behavior{AuthzBehavior::PASSTHROUGH};
     std::string m_cfg_file;
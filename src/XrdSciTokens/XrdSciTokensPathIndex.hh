@@ -0,0 +1,102 @@
+#ifndef __XrdSciTokensPathIndex_hh__
+#define __XrdSciTokensPathIndex_hh__
+/******************************************************************************/
+/*                                                                            */
+/*              X r d S c i T o k e n s P a t h I n d e x . h h               */
+/*                                                                            */
+/******************************************************************************/
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "XrdOuc/XrdOucPrivateUtils.hh"
+
+// Index of the paths a token authorizes for a single operation.  Paths are
+// stored as a tree of path components so that a request is resolved with one
+// walk over its own components rather than a scan over every rule.  The
+// result is identical to testing is_subdirectory() against each rule.
+class PathRuleIndex
+{
+public:
+    void insert(const std::string &rule)
+    {
+        if (rule == "/") {
+            m_any = true;
+            return;
+        }
+        // Rules that are not in canonical form cannot be split into components
+        // without changing their meaning; keep those for a direct comparison.
+        if (rule.empty() || rule[0] != '/' || rule.back() == '/' ||
+            rule.find("//") != std::string::npos) {
+            m_other.push_back(rule);
+            return;
+        }
+        Node *node = &m_root;
+        std::string_view rest(rule);
+        rest.remove_prefix(1);
+        while (true) {
+            const auto pos = rest.find('/');
+            const auto comp = rest.substr(0, pos);
+            auto iter = node->kids.find(comp);
+            if (iter == node->kids.end()) {
+                iter = node->kids.emplace(std::string(comp), std::make_unique<Node>()).first;
+            }
+            node = iter->second.get();
+            if (pos == std::string_view::npos) {break;}
+            rest.remove_prefix(pos + 1);
+        }
+        node->terminal = true;
+    }
+
+        // Return true if some rule is the path or one of its parents or, when
+        // parents is set, if the path is a parent of some rule.
+    bool allows(const std::string &path, bool parents) const
+    {
+        if (m_any) {return true;}
+        for (const auto &rule : m_other) {
+            if (is_subdirectory(rule, path)) {return true;}
+            if (parents && is_subdirectory(path, rule)) {return true;}
+        }
+        if (path.empty() || path[0] != '/' || m_root.kids.empty()) {return false;}
+
+        // Empty components (from "//" or a trailing slash) never match a
+        // canonical rule, which is exactly how is_subdirectory() treats them.
+        const Node *node = &m_root;
+        std::string_view rest(path);
+        rest.remove_prefix(1);
+        while (true) {
+            const auto pos = rest.find('/');
+            if (pos == std::string_view::npos) {
+                if (rest.empty()) {
+                    // Path ends with a slash: every rule below it is a child.
+                    return parents;
+                }
+                const auto iter = node->kids.find(rest);
+                if (iter == node->kids.end()) {return false;}
+                // Any node present leads to at least one rule below the path.
+                return iter->second->terminal || parents;
+            }
+            const auto iter = node->kids.find(rest.substr(0, pos));
+            if (iter == node->kids.end()) {return false;}
+            node = iter->second.get();
+            if (node->terminal) {return true;}
+            rest.remove_prefix(pos + 1);
+        }
+    }
+
+private:
+    struct Node
+    {
+        std::map<std::string, std::unique_ptr<Node>, std::less<>> kids;
+        bool terminal{false};
+    };
+
+    Node m_root;
+    std::vector<std::string> m_other;
+    bool m_any{false};
+};
+
+#endif
@@ -607,6 +607,14 @@ char *XrdSecProtocolgsi::Init(gsiOptions opt, XrdOucErrInfo *erp)
                   cryptName[ncrypt].insert(cf->Name(),0,strlen(cf->Name())+1);
                   cf->SetTrace(trace);
                   cf->Notify();
+                  // Pre-generated keys for handshakes
+                  if (Server) {
+                     int nrsa = opt.keypoolrsa;
+                     if (nrsa < 0) nrsa = (opt.dlgpxy > dlgIgnore) ? 4 : 0;
+                     if (cf->SetKeyPool(opt.keypooldh, nrsa))
+                        DEBUG("key pool for module "<<ncpt<<": "<<opt.keypooldh
+                              <<" DH, "<<nrsa<<" RSA keys");
+                  }
                   // Ref cipher
                   if (!(refcip[ncrypt] = cf->Cipher(0,0,0))) {
                      PRINT("ref cipher for module "<<ncpt<<
@@ -2351,6 +2359,9 @@ void gsiOptions::Print(XrdOucTrace *t)
       if (!hashcomp)
          POPTS(t, " Name hashing algorithm compatibility OFF");
       POPTS(t, " Show DN option: "<<showDN);
+      POPTS(t, " Pre-generated DH keys: "<<keypooldh);
+      if (keypoolrsa >= 0)
+         POPTS(t, " Pre-generated RSA keys: "<<keypoolrsa);
    }
    // Crypto options
    POPTS(t, " Crypto modules: "<< (clist ? clist : XrdSecProtocolgsi::DefCrypto));
@@ -2607,6 +2618,7 @@ char *XrdSecProtocolgsiInit(const char mode,
       //              [-vomsfunparms:<voms_function_init_parameters>]
       //              [-defaulthash]
       //              [-trustdns:<0|1>]
+      //              [-keypool:<dh_keys>[,<rsa_keys>]]
       //
       int debug = -1;
       String clist = "";
@@ -2639,6 +2651,8 @@ char *XrdSecProtocolgsiInit(const char mode,
       int hashcomp = 1;
       int trustdns = false;
       int showDN = false;
+      int keypooldh = 16;
+      int keypoolrsa = -1;
       char *op = 0;
       while (inParms.GetLine()) { 
          while ((op = inParms.GetToken())) {
@@ -2711,6 +2725,10 @@ char *XrdSecProtocolgsiInit(const char mode,
                trustdns = getOptVal(tdnsOpts, op+10);
             } else if (!strncmp(op, "-showdn:",8)) {
                showDN = getOptVal(tdnsOpts, op+8);
+            } else if (!strncmp(op, "-keypool:",9)) {
+               keypooldh = atoi(op+9);
+               const char *cp = strchr(op+9, ',');
+               if (cp) keypoolrsa = atoi(cp+1);
             } else {
                PRINT("ignoring unknown switch: "<<op);
             }
@@ -2745,6 +2763,8 @@ char *XrdSecProtocolgsiInit(const char mode,
       opts.hashcomp = hashcomp;
       opts.trustdns = (trustdns <= 0) ? false : true;
       opts.showDN = (showDN > 0) ? true : false;
+      opts.keypooldh = (keypooldh > 0) ? keypooldh : 0;
+      opts.keypoolrsa = keypoolrsa;
       if (clist.length() > 0)
          opts.clist = (char *)clist.c_str();
       if (certdir.length() > 0)
@@ -214,6 +214,9 @@ public:
 
    bool   trustdns; // [cs] 'true' if DNS is trusted [true]
    bool   showDN;   // [cs] 'true' display the dn
+   int    keypooldh;  // [s] pre-generated DH keys for handshakes [16]
+   int    keypoolrsa; // [s] pre-generated RSA keys for proxy requests [4 if
+                      //     delegated proxies are accepted, 0 otherwise]
 
    gsiOptions() { debug = -1; mode = 's'; clist = 0; 
                   certdir = 0; crldir = 0; crlext = 0; cert = 0; key = 0;
@@ -225,7 +228,8 @@ public:
                   ogmap = 1; dlgpxy = 0; sigpxy = 1; srvnames = 0;
                   exppxy = 0; authzpxy = 0;
                   vomsat = 1; vomsfun = 0; vomsfunparms = 0; moninfo = 0;
-                  hashcomp = 1; trustdns = true; showDN = false; createpxy = 1;}
+                  hashcomp = 1; trustdns = true; showDN = false; createpxy = 1;
+                  keypooldh = 16; keypoolrsa = -1;}
    virtual ~gsiOptions() { } // Cleanup inside XrdSecProtocolgsiInit
    void Print(XrdOucTrace *t); // Print summary of gsi option status
 };
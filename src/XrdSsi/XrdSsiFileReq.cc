@@ -890,7 +890,7 @@ int XrdSsiFileReq::Send(XrdSfsDio *sfDio, XrdSfsXferSize blen)
                if (blen > 0)
                   {sfVec[1].buffer = (char *)Resp->buff+respOff;
                    sfVec[1].fdnum  = -1;
-                   if (blen > respLen)
+                   if (blen >= respLen)
                       {blen = respLen; myState = odRsp;
                       } else {
                        respLen -= blen; respOff += blen;
@@ -903,7 +903,7 @@ int XrdSsiFileReq::Send(XrdSfsDio *sfDio, XrdSfsXferSize blen)
           case XrdSsiRespInfo::isFile:
                if (fileSz > 0)
                   {sfVec[1].offset = respOff; sfVec[1].fdnum = Resp->fdnum;
-                   if (blen > fileSz)
+                   if (blen >= fileSz)
                       {blen = fileSz; myState = odRsp;}
                    respOff += blen; fileSz -= blen;
                   } else blen = 0;
@@ -951,8 +951,11 @@ int XrdSsiFileReq::sendStrmA(XrdSsiStream *strmP,
    if (!strBuff)
       {respLen = blen;
        if (strmEOF || !(strBuff = strmP->GetBuff(eObj, respLen, strmEOF)))
-          {myState = odRsp; strmEOF = true;
-           if (!strmEOF) Emsg(epname, eObj, "read stream");
+          {if (!strmEOF)
+              {myState = erRsp; strmEOF = true;
+               return Emsg(epname, eObj, "read stream");
+              }
+           myState = odRsp;
            return 1;
           }
        respOff = 0;
@@ -601,19 +601,25 @@ int XrdSsiFileSess::SendData(XrdSfsDio         *sfDio,
    unsigned int reqID = rInfo.Id();
    int rc;
 
-// Find the request object
+// Find the request object. If not there we may have encountered an eof. We
+// send nothing so that the caller falls back to read(), which reports it.
 //
    if (!(rqstP = rTab.LookUp(reqID)))
-      return XrdSsiUtils::Emsg(epname, ESRCH, "send", gigID, *eInfo);
+      {if (eofVec.IsSet(reqID)) return SFS_OK;
+       return XrdSsiUtils::Emsg(epname, ESRCH, "send", gigID, *eInfo);
+      }
 
 // Simply effect the send via the request object
 //
    rc = rqstP->Send(sfDio, size);
 
-// Determine how this ended
+// Determine how this ended. As with read(), a completed request is remembered
+// so that a client reading past the end of the response gets an eof.
 //
    if (rc > 0) rc = SFS_OK;
-      else rTab.DelFinalize(std::move(rqstP));
+      else {rTab.DelFinalize(std::move(rqstP));
+            eofVec.Set(reqID);
+           }
 
    return rc;
 }
@@ -206,6 +206,9 @@ inline Status  SetNilResponse() {return SetResponse((const char *)0,0);}
 //!
 //! @param  buff  pointer to a buffer holding the response. The buffer must
 //!               remain valid until XrdSsiResponder::Finished() is called.
+//!               Server-side, the data is written to the client directly
+//!               from this buffer, so it may be memory mapped or be the
+//!               data area of an XrdOucBuffer recycled in Finished().
 //! @param  blen  the length of the response in buff that is to be sent.
 //!
 //! @return       See Status enum for possible values.
@@ -217,7 +220,8 @@ inline Status  SetNilResponse() {return SetResponse((const char *)0,0);}
 //! Set a file containing data as the response.
 //!
 //! @param  fsize the size of the file containing the response.
-//! @param  fdnum the file descriptor of the open file.
+//! @param  fdnum the file descriptor of the open file. Server-side, the data
+//!               is sent using sendfile() when the connection allows it.
 //!
 //! @return       See Status enum for possible values.
 //-----------------------------------------------------------------------------
@@ -17,11 +17,20 @@
 //------------------------------------------------------------------------------
 
 #include <cstdio>
+#include <cstring>
+#include <map>
 #include <openssl/bio.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
 #include <openssl/opensslv.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#else
+#include <openssl/hmac.h>
+#endif
 #include <sys/stat.h>
 
 #include "XrdOuc/XrdOucUtils.hh"
@@ -51,6 +60,17 @@ extern XrdSysTrace SysTrace;
 /*                      X r d T l s C o n t e x t I m p l                     */
 /******************************************************************************/
 
+// Session ticket keys are generated here and rotated periodically. A ticket
+// encrypted with the previous key is still accepted but is then renewed.
+//
+struct XrdTlsTicketKey
+{
+    unsigned char                 name[16];
+    unsigned char                 aesKey[32];
+    unsigned char                 macKey[32];
+    time_t                        born;
+};
+
 struct XrdTlsContextImpl
 {
     XrdTlsContextImpl(XrdTlsContext *p)
@@ -60,6 +80,7 @@ struct XrdTlsContextImpl
    ~XrdTlsContextImpl() {if (ctx)     SSL_CTX_free(ctx);
                          if (ctxnew)  delete ctxnew;
                          if (flsCVar) delete flsCVar;
+                         for (auto &it : cliSess) SSL_SESSION_free(it.second);
                         }
 
     SSL_CTX                      *ctx;
@@ -74,6 +95,13 @@ struct XrdTlsContextImpl
     time_t                        lastCertModTime = 0;
     int                           sessionCacheOpts = -1;
     std::string                   sessionCacheId;
+    XrdSysMutex                   tktMutex;
+    XrdTlsTicketKey               tktKeys[2];   // [0] current, [1] previous
+    int                           tktNum = 0;
+    XrdSysMutex                   cliMutex;
+    std::map<std::string, SSL_SESSION *> cliSess;
+    RAtomic_ullong                hsFull{0};
+    RAtomic_ullong                hsResumed{0};
 };
   
 /******************************************************************************/
@@ -239,8 +267,10 @@ do{tStart = time(0);
 //
    if (TRACING(XrdTls::dbgCTX))
       {char mBuff[512];
-       snprintf(mBuff, sizeof(mBuff), "sess=%d hits=%d miss=%d timeouts=%d",
-               sesn, hits, miss, tmos);
+       snprintf(mBuff, sizeof(mBuff), "sess=%d hits=%d miss=%d timeouts=%d "
+               "handshakes full=%llu resumed=%llu", sesn, hits, miss, tmos,
+               static_cast<unsigned long long>(ctxImpl->hsFull),
+               static_cast<unsigned long long>(ctxImpl->hsResumed));
        DBG_CTX("Cache flushed; " <<mBuff);
       }
   } while(true);
@@ -291,11 +321,202 @@ bool Setup_Flusher(XrdTlsContextImpl *pImpl, int flushT)
 // Finish up
 //
    pImpl->flsRunning = true;
-   SSL_CTX_set_session_cache_mode(pImpl->ctx, SSL_SESS_CACHE_NO_AUTO_CLEAR);
+   SSL_CTX_set_session_cache_mode(pImpl->ctx,
+                                  SSL_CTX_get_session_cache_mode(pImpl->ctx)
+                                | SSL_SESS_CACHE_NO_AUTO_CLEAR);
    return true;
 }
 }
   
+/******************************************************************************/
+/*                 S e s s i o n   R e u s e   S u p p o r t                  */
+/******************************************************************************/
+
+namespace XrdTlsSess
+{
+// Index of the XrdTlsContextImpl pointer in the SSL_CTX. It must follow the
+// implementation across a context refresh, see XrdTlsContext::Session().
+//
+int implIndex = SSL_CTX_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+
+// Index of the client session key (e.g. host:port) in an SSL object.
+//
+void keyFree(void *parent, void *ptr, CRYPTO_EX_DATA *ad, int idx,
+             long argl, void *argp) {free(ptr);}
+
+int keyIndex = SSL_get_ex_new_index(0, NULL, NULL, NULL, keyFree);
+
+// Ticket keys rotate hourly so a ticket is good for one to two hours.
+//
+const int    tktRotate = 60*60;
+
+// Maximum number of client sessions we hold on to.
+//
+const size_t cliMax = 256;
+
+inline XrdTlsContextImpl *getImpl(SSL *ssl)
+{
+   return static_cast<XrdTlsContextImpl *>
+          (SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), implIndex));
+}
+
+/******************************************************************************/
+/*                                I n f o C B                                 */
+/******************************************************************************/
+
+// Count full versus resumed handshakes on both sides of a connection.
+//
+void InfoCB(const SSL *ssl, int where, int ret)
+{
+   if (!(where & SSL_CB_HANDSHAKE_DONE)) return;
+
+   XrdTlsContextImpl *ctxImpl = static_cast<XrdTlsContextImpl *>
+           (SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), implIndex));
+   if (!ctxImpl) return;
+
+   if (SSL_session_reused(const_cast<SSL *>(ssl))) ctxImpl->hsResumed++;
+      else ctxImpl->hsFull++;
+}
+
+/******************************************************************************/
+/*                               N e w K e y                                  */
+/******************************************************************************/
+
+// Must be called with tktMutex held.
+//
+bool NewKey(XrdTlsContextImpl *ctxImpl, time_t tNow)
+{
+   XrdTlsTicketKey newKey;
+
+   if (RAND_bytes(newKey.name,   sizeof(newKey.name))   != 1
+   ||  RAND_bytes(newKey.aesKey, sizeof(newKey.aesKey)) != 1
+   ||  RAND_bytes(newKey.macKey, sizeof(newKey.macKey)) != 1) return false;
+   newKey.born = tNow;
+
+   if (ctxImpl->tktNum) ctxImpl->tktKeys[1] = ctxImpl->tktKeys[0];
+   ctxImpl->tktKeys[0] = newKey;
+   if (ctxImpl->tktNum < 2) ctxImpl->tktNum++;
+   return true;
+}
+
+/******************************************************************************/
+/*                              T i c k e t C B                               */
+/******************************************************************************/
+
+// Encrypt (enc=1) or decrypt (enc=0) a session ticket. For decryption we
+// return 0 if the key is unknown (full handshake), 1 if the ticket is good,
+// and 2 if it is good but should be replaced. We replace tickets whose key is
+// retiring and always under TLS 1.3 as clients use a ticket only once and
+// OpenSSL sends no new ticket after a resumption unless asked to.
+//
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+int TicketCB(SSL *ssl, unsigned char *kName, unsigned char *iv,
+             EVP_CIPHER_CTX *cctx, EVP_MAC_CTX *hctx, int enc)
+#else
+int TicketCB(SSL *ssl, unsigned char *kName, unsigned char *iv,
+             EVP_CIPHER_CTX *cctx, HMAC_CTX *hctx, int enc)
+#endif
+{
+   XrdTlsContextImpl *ctxImpl = getImpl(ssl);
+   XrdTlsTicketKey theKey;
+   time_t tNow = time(0);
+   int rc = 1;
+
+   if (!ctxImpl) return -1;
+
+// Select the key to use, rotating the current one if it has grown old
+//
+  {XrdSysMutexHelper tktHelper(ctxImpl->tktMutex);
+   if (enc)
+      {if ((!ctxImpl->tktNum || tNow - ctxImpl->tktKeys[0].born >= tktRotate)
+       &&  !NewKey(ctxImpl, tNow)) return -1;
+       theKey = ctxImpl->tktKeys[0];
+       memcpy(kName, theKey.name, sizeof(theKey.name));
+      } else {
+       int i;
+       for (i = 0; i < ctxImpl->tktNum; i++)
+           if (!memcmp(kName, ctxImpl->tktKeys[i].name, sizeof(theKey.name)))
+              break;
+       if (i >= ctxImpl->tktNum
+       ||  tNow - ctxImpl->tktKeys[i].born >= 2*tktRotate) return 0;
+       theKey = ctxImpl->tktKeys[i];
+       if (i || tNow - theKey.born >= tktRotate
+       ||  SSL_version(ssl) == TLS1_3_VERSION) rc = 2;
+      }
+  }
+
+// Initialize the cipher
+//
+   if (enc)
+      {if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1
+       ||  !EVP_EncryptInit_ex(cctx, EVP_aes_256_cbc(), 0, theKey.aesKey, iv))
+          return -1;
+      } else {
+       if (!EVP_DecryptInit_ex(cctx, EVP_aes_256_cbc(), 0, theKey.aesKey, iv))
+          return -1;
+      }
+
+// Initialize the MAC
+//
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+   OSSL_PARAM parms[3];
+   parms[0] = OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY,
+                                       theKey.macKey, sizeof(theKey.macKey));
+   parms[1] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST,
+                                              const_cast<char *>("SHA256"), 0);
+   parms[2] = OSSL_PARAM_construct_end();
+   if (!EVP_MAC_CTX_set_params(hctx, parms)) return -1;
+#else
+   if (!HMAC_Init_ex(hctx, theKey.macKey, sizeof(theKey.macKey),
+                     EVP_sha256(), 0)) return -1;
+#endif
+   return rc;
+}
+
+/******************************************************************************/
+/*                              N e w S e s s                                 */
+/******************************************************************************/
+
+// Save a client session under the key set for the connection. Returning one
+// tells OpenSSL that we have taken the reference to the session.
+//
+int NewSess(SSL *ssl, SSL_SESSION *sess)
+{
+   XrdTlsContextImpl *ctxImpl = getImpl(ssl);
+   const char *sKey = static_cast<const char *>(SSL_get_ex_data(ssl, keyIndex));
+
+   if (!ctxImpl || !sKey) return 0;
+
+   XrdSysMutexHelper cliHelper(ctxImpl->cliMutex);
+   auto it = ctxImpl->cliSess.find(sKey);
+   if (it != ctxImpl->cliSess.end())
+      {SSL_SESSION_free(it->second);
+       it->second = sess;
+       return 1;
+      }
+
+// Make room if need be. Expired sessions go first, otherwise any one will do.
+//
+   if (ctxImpl->cliSess.size() >= cliMax)
+      {time_t tNow = time(0);
+       for (it = ctxImpl->cliSess.begin(); it != ctxImpl->cliSess.end(); )
+           {if (SSL_SESSION_get_time(it->second)
+              + SSL_SESSION_get_timeout(it->second) <= tNow)
+               {SSL_SESSION_free(it->second);
+                it = ctxImpl->cliSess.erase(it);
+               } else ++it;
+           }
+       if (ctxImpl->cliSess.size() >= cliMax)
+          {it = ctxImpl->cliSess.begin();
+           SSL_SESSION_free(it->second);
+           ctxImpl->cliSess.erase(it);
+          }
+      }
+   ctxImpl->cliSess[sKey] = sess;
+   return 1;
+}
+}
+
 /******************************************************************************/
 /*                 S S L   T h r e a d i n g   S u p p o r t                  */
 /******************************************************************************/
@@ -670,6 +891,11 @@ XrdTlsContext::XrdTlsContext(const char *cert,  const char *key,
 
    //Add the XrdTlsContext object as extra information for OpenSSL callback re-use
    SSL_CTX_set_ex_data(pImpl->ctx, ctxIndex, this);
+   SSL_CTX_set_ex_data(pImpl->ctx, XrdTlsSess::implIndex, pImpl);
+
+// Keep track of how many handshakes were resumed
+//
+   SSL_CTX_set_info_callback(pImpl->ctx, XrdTlsSess::InfoCB);
 
 // Always prohibit SSLv2 & SSLv3 as these are not secure.
 //
@@ -782,6 +1008,51 @@ XrdTlsContext::~XrdTlsContext()
       } else delete pImpl;
 }
 
+/******************************************************************************/
+/*                         C l i e n t S e s s i o n                          */
+/******************************************************************************/
+
+bool XrdTlsContext::ClientSession(void *ssl, const char *key)
+{
+   SSL *sslP = static_cast<SSL *>(ssl);
+   SSL_SESSION *sess;
+   char *sKey;
+   bool keep;
+
+// This only applies if the client session cache has been turned on
+//
+   if (!sslP || !key
+   ||  !(SSL_CTX_get_session_cache_mode(SSL_get_SSL_CTX(sslP))
+         & SSL_SESS_CACHE_CLIENT)) return false;
+
+// Record the key so that any session we get is saved under it
+//
+   free(SSL_get_ex_data(sslP, XrdTlsSess::keyIndex));
+   if (!(sKey = strdup(key))) return false;
+   SSL_set_ex_data(sslP, XrdTlsSess::keyIndex, sKey);
+
+// Find a previous session. A TLS 1.3 ticket is meant to be used only once;
+// the server sends a new one after each handshake so we discard it now.
+//
+  {XrdSysMutexHelper cliHelper(pImpl->cliMutex);
+   auto it = pImpl->cliSess.find(key);
+   if (it == pImpl->cliSess.end()) return false;
+   sess = it->second;
+   keep = SSL_SESSION_is_resumable(sess)
+       && SSL_SESSION_get_time(sess) + SSL_SESSION_get_timeout(sess) > time(0);
+   if (!keep || SSL_SESSION_get_protocol_version(sess) == TLS1_3_VERSION)
+      pImpl->cliSess.erase(it);
+      else SSL_SESSION_up_ref(sess);
+  }
+
+// Offer the session if it is still usable. SSL_set_session() takes its own
+// reference so we always release ours.
+//
+   if (keep) keep = SSL_set_session(sslP, sess) == 1;
+   SSL_SESSION_free(sess);
+   return keep;
+}
+
 /******************************************************************************/
 /*                                 C l o n e                                  */
 /******************************************************************************/
@@ -842,6 +1113,17 @@ const XrdTlsContext::CTX_Params *XrdTlsContext::GetParams()
   return &pImpl->Parm;
 }
 
+/******************************************************************************/
+/*                        H a n d s h a k e S t a t s                         */
+/******************************************************************************/
+
+void XrdTlsContext::HandshakeStats(unsigned long long &full,
+                                   unsigned long long &resumed)
+{
+   full    = pImpl->hsFull;
+   resumed = pImpl->hsResumed;
+}
+
 /******************************************************************************/
 /*                                  I n i t                                   */
 /******************************************************************************/
@@ -932,8 +1214,10 @@ void *XrdTlsContext::Session()
    pImpl->ctx = ctxnew->pImpl->ctx;
 
    //Update ex_data to point to this (the surviving owner), not the
-   //cloned context which is about to be deleted.
+   //cloned context which is about to be deleted. This keeps the session
+   //ticket keys and client sessions across the refresh.
    SSL_CTX_set_ex_data(pImpl->ctx, ctxIndex, this);
+   SSL_CTX_set_ex_data(pImpl->ctx, XrdTlsSess::implIndex, pImpl);
 
    //In the destructor of XrdTlsContextImpl, SSL_CTX_Free() is
    //called if ctx is != 0. As this new ctx is used by the session
@@ -968,7 +1252,7 @@ int XrdTlsContext::SessionCache(int opts, const char *id, int idlen)
    int flushT = opts & scFMax;
 
    pImpl->sessionCacheOpts = opts;
-   pImpl->sessionCacheId = id;
+   if (id) pImpl->sessionCacheId = id;
 
 // If initialization failed there is nothing to do
 //
@@ -979,7 +1263,10 @@ int XrdTlsContext::SessionCache(int opts, const char *id, int idlen)
    if (opts & doSet)
       {if (opts & scOff) sslopt = SSL_SESS_CACHE_OFF;
           else {if (opts & scSrvr) sslopt  = SSL_SESS_CACHE_SERVER;
-                if (opts & scClnt) sslopt |= SSL_SESS_CACHE_CLIENT;
+                if (opts & scClnt)
+                   {sslopt |= SSL_SESS_CACHE_CLIENT;
+                    if (!(opts & scSrvr)) sslopt |= SSL_SESS_CACHE_NO_INTERNAL_STORE;
+                   }
                }
       }
 
@@ -990,6 +1277,23 @@ int XrdTlsContext::SessionCache(int opts, const char *id, int idlen)
             if (opts & scOff) SSL_CTX_set_options(pImpl->ctx, SSL_OP_NO_TICKET);
            }
 
+// Server-side we issue session tickets using keys that we rotate as the ones
+// OpenSSL generates never change. Client-side we hold on to the sessions
+// ourselves so that they can be matched to the server they came from.
+//
+   if ((opts & doSet) && !(opts & scOff))
+      {if (opts & scSrvr)
+          {SSL_CTX_clear_options(pImpl->ctx, SSL_OP_NO_TICKET);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+           SSL_CTX_set_tlsext_ticket_key_evp_cb(pImpl->ctx, XrdTlsSess::TicketCB);
+#else
+           SSL_CTX_set_tlsext_ticket_key_cb(pImpl->ctx, XrdTlsSess::TicketCB);
+#endif
+          }
+       if (opts & scClnt)
+          SSL_CTX_sess_set_new_cb(pImpl->ctx, XrdTlsSess::NewSess);
+      }
+
 // Compute what he previous cache options were
 //
    opts = scNone;
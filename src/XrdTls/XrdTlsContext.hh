@@ -37,6 +37,24 @@ class XrdTlsContext
 {
 public:
 
+//------------------------------------------------------------------------
+//! Offer a previously saved session when connecting to a server and save
+//! any new session the server hands out for later reuse.
+//!
+//! @param  ssl      Pointer to the SSL session object (see Session()) that
+//!                  has not yet been connected.
+//! @param  key      Identifies the server, typically as host:port. Sessions
+//!                  are only offered to a connection using the same key.
+//!
+//! @return True if a saved session will be offered and false otherwise.
+//!
+//! @note   This only applies when the client cache has been enabled via
+//!         SessionCache(scClnt). Server identity is still verified as the
+//!         resumed session carries the original peer certificate.
+//------------------------------------------------------------------------
+
+bool            ClientSession(void *ssl, const char *key);
+
 //------------------------------------------------------------------------
 //! Clone a new context from this context.
 //!
@@ -87,6 +105,17 @@ struct CTX_Params
 const
 CTX_Params     *GetParams();
 
+//------------------------------------------------------------------------
+//! Get the handshake counters for sessions created from this context.
+//!
+//! @param  full     Receives the number of full handshakes.
+//! @param  resumed  Receives the number of handshakes that resumed a
+//!                  previous session.
+//------------------------------------------------------------------------
+
+void            HandshakeStats(unsigned long long &full,
+                               unsigned long long &resumed);
+
 //------------------------------------------------------------------------
 //! Simply initialize the TLS library.
 //!
@@ -127,6 +156,9 @@ void           *Session();
 //!         If the context has been pprroperly initialized, zero is returned.
 //!         By default, the session cache is disabled as it is impossible to
 //!         verify a peer certificate chain when a cached session is reused.
+//!         In server mode session tickets are issued using keys that are
+//!         rotated hourly. In client mode sessions are saved for servers
+//!         identified via ClientSession().
 //------------------------------------------------------------------------
 
 static const int scNone = 0x00000000; //!< Do not change any option settings
@@ -689,6 +689,22 @@ XrdTls::RC XrdTlsSocket::Read( char *buffer, size_t size, int &bytesRead )
     return XrdTls::TLS_SYS_Error;
   }
 
+/******************************************************************************/
+/*                         R e s u m e S e s s i o n                          */
+/******************************************************************************/
+
+bool XrdTlsSocket::ResumeSession(const char *key)
+{
+   EPNAME("ResumeSession");
+
+   if (!pImpl->ssl || !pImpl->tlsctx || !pImpl->isClient) return false;
+
+   bool aOK = pImpl->tlsctx->ClientSession(pImpl->ssl, key);
+   DBG_SOK((aOK ? "Offering saved session for " : "No saved session for ")
+           <<key);
+   return aOK;
+}
+
 /******************************************************************************/
 /*                            S e t T r a c e I D                             */
 /******************************************************************************/
@@ -115,6 +115,18 @@ enum HS_Mode
 
   XrdTls::RC Connect(const char *thehost=0, std::string *eWhy=0);
 
+//------------------------------------------------------------------------
+//! Offer a previously saved session to the server. This must be called
+//! prior to Connect() and only has an effect when the client session cache
+//! is enabled in the associated context (see XrdTlsContext::ClientSession).
+//!
+//! @param  key      - Identifies the server, typically as host:port.
+//!
+//! @return true if a saved session will be offered; false otherwise.
+//------------------------------------------------------------------------
+
+  bool ResumeSession(const char *key);
+
 //------------------------------------------------------------------------
 //! Obtain context associated with this connection.
 //!
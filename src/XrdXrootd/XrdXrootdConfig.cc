@@ -2119,6 +2119,7 @@ int XrdXrootdProtocol::xtlsr(XrdOucStream &Config)
                 else if (num > XrdTlsContext::scFMax)
                          num = XrdTlsContext::scFMax;
              tlsCache |= num;
+             return 0;
             }
       }
 
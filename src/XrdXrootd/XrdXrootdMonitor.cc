@@ -29,6 +29,7 @@
 /******************************************************************************/
 
 #include <cerrno>
+#include <cstddef>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
@@ -38,6 +39,7 @@
 #include "XrdVersion.hh"
 
 #include "XrdNet/XrdNetMsg.hh"
+#include "XrdNet/XrdNetMsgQueue.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucUtils.hh"
 #include "XrdSys/XrdSysError.hh"
@@ -60,6 +62,8 @@ XrdNetMsg         *XrdXrootdMonitor::InetDest1  = 0;
 char              *XrdXrootdMonitor::Dest2      = 0;
 int                XrdXrootdMonitor::monMode2   = 0;
 XrdNetMsg         *XrdXrootdMonitor::InetDest2  = 0;
+XrdNetMsgQueue    *XrdXrootdMonitor::monQueue   = 0;
+int                XrdXrootdMonitor::monSendQ   = 0;
 XrdXrootdMonitor  *XrdXrootdMonitor::altMon     = 0;
 XrdSysMutex        XrdXrootdMonitor::windowMutex;
 int                XrdXrootdMonitor::monRlen    = 0;
@@ -529,7 +533,8 @@ void XrdXrootdMonitor::Defaults(char *dest1, int mode1, char *dest2, int mode2)
 
 void XrdXrootdMonitor::Defaults(int msz,   int rsz,   int wsz,
                                 int flush, int flash, int idt, int rnm,
-                                int fbsz, int fsint, int fsopt, int fsion)
+                                int fbsz, int fsint, int fsopt, int fsion,
+                                int sendq)
 {
 
 // Set default window size and flush time
@@ -547,6 +552,10 @@ void XrdXrootdMonitor::Defaults(int msz,   int rsz,   int wsz,
    XrdXrootdMonFile::Defaults(fsint, fsopt, fsion, fbsz);
    monFSTAT = fsint != 0;
 
+// Set the depth of the send queue, zero means messages are sent in-line
+//
+   monSendQ = (sendq < 0 ? 0 : sendq);
+
 // Set default monitor buffer size
 //
    if (msz <= 0) msz = 16384;
@@ -755,6 +764,18 @@ int XrdXrootdMonitor::Init()
           }
       }
 
+// If so configured, records are sent by a dedicated thread. Buffers are
+// handed off to it so no client waits for the network or for other clients
+// sending their buffers. The queue also numbers the packets for each
+// destination. Dest2 is only set when Dest1 is, so the mask bits are 1 & 2.
+//
+   if (monSendQ && InetDest1)
+      {monQueue = new XrdNetMsgQueue(eDest, monSendQ,
+                                     offsetof(XrdXrootdMonHeader, pseq));
+       monQueue->AddDest(InetDest1);
+       if (InetDest2) monQueue->AddDest(InetDest2);
+      }
+
 // Now schedule the first identification record
 //
    if (Sched && monIdent >= 0) Sched->Schedule((XrdJob *)&MonIdent);
@@ -1210,6 +1231,18 @@ int XrdXrootdMonitor::Send(int monMode, void *buff, int blen, bool setseq)
 //
    if (setseq) mHdr = static_cast<XrdXrootdMonHeader*>(buff);
 
+// When we have a send queue the buffer is copied into it and the sequence
+// number is filled in just before it is sent. The caller may reuse the
+// buffer as soon as we return.
+//
+   if (monQueue)
+      {int dMask = (monMode & monMode1 && InetDest1 ? 1 : 0)
+                 | (monMode & monMode2 && InetDest2 ? 2 : 0);
+       if (dMask) monQueue->Send(dMask, (const char *)buff, blen, setseq);
+       TRACE(DEBUG,blen <<" bytes queued for dest mask " <<dMask);
+       return 0;
+      }
+
     sendMutex.Lock();
     if (monMode & monMode1 && InetDest1)
        {if (mHdr) mHdr->pseq = (seq1++) & 0xff;
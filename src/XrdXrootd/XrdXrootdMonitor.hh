@@ -71,6 +71,7 @@
 
 class XrdScheduler;
 class XrdNetMsg;
+class XrdNetMsgQueue;
 class XrdXrootdMonFile;
   
 /******************************************************************************/
@@ -120,7 +121,8 @@ inline void              Add_wr(kXR_unt32 dictid,
 static void              Defaults(char *dest1, int m1, char *dest2, int m2);
 static void              Defaults(int msz,     int rsz,     int wsz,
                                   int flush,   int flash,   int iDent, int rnm,
-                                  int fbsz, int fsint=0, int fsopt=0, int fsion=0);
+                                  int fbsz, int fsint=0, int fsopt=0, int fsion=0,
+                                  int sendq=0);
 
 static int               Flushing() {return autoFlush;}
 
@@ -282,6 +284,8 @@ static XrdNetMsg         *InetDest1;
 static char              *Dest2;
 static int                monMode2;
 static XrdNetMsg         *InetDest2;
+static XrdNetMsgQueue    *monQueue;
+static int                monSendQ;
        XrdXrootdMonBuff  *monBuff;
 static int                monBlen;
        int                nextEnt;
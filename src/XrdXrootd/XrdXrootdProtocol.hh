@@ -254,6 +254,7 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_Close();
        int   do_Dirlist();
        int   do_DirStat(XrdSfsDirectory *dp, char *pbuff, char *opaque);
+       int   do_DirTree(XrdSfsDirectory *dp, char *opaque);
        int   do_Endsess();
        int   do_FAttr();
        int   do_gpFile();
@@ -763,6 +763,11 @@ int XrdXrootdProtocol::do_Dirlist()
        return rc;
       }
 
+// Check if the caller wants the whole subtree. We don't do this when digging.
+//
+   if (!doDig && (Request.dirlist.options[0] & kXR_drecurse))
+      return do_DirTree(dp, opaque);
+
 // Check if the caller wants stat information as well
 //
    if (Request.dirlist.options[0] & (kXR_dstat | kXR_dcksm))
@@ -918,6 +923,195 @@ int XrdXrootdProtocol::do_DirStat(XrdSfsDirectory *dp, char *pbuff,
    return rc;
 }
 
+/******************************************************************************/
+/*                            d o _ D i r T r e e                             */
+/******************************************************************************/
+
+// List the subtree rooted at the requested directory with stat information
+// (and checksums if so wanted). The tree is walked depth first holding one
+// open directory per level so that memory use is bounded by the depth, not by
+// the size, of the tree. Entries are sent in kXR_oksofar chunks as the buffer
+// fills. Each entry is named by its path relative to the requested directory
+// and a directory's entries immediately follow the directory itself.
+//
+int XrdXrootdProtocol::do_DirTree(XrdSfsDirectory *dp, char *opaque)
+{
+   static const int maxDepth = 128;
+   static const char leadIn[] = ".\n0 0 0 0\n./\n0 0 0 0\n";
+   struct dirLevel
+         {XrdSfsDirectory *dp;
+          struct stat      aStat;   // Filled in by autostat, if supported
+          size_t           pLen;    // Length of the full path to this level
+          size_t           rLen;    // Length of the relative path to it
+          dev_t            dDev;
+          ino_t            dIno;
+          bool             manStat;
+         };
+   XrdOucErrInfo myError(Link->ID, Monitor.Did, clientPV);
+   std::vector<dirLevel> dirStack;
+   std::string fPath(argp->buff), rPath;
+   struct stat Stat, *sP;
+   char *buff, *algT = 0;
+   const char *csData, *dname;
+   int bleft, rc = 0, dlen, cnt = 0, statSz = 160;
+   bool tooDeep = false, failed = false;
+   struct {char ebuff[16384]; char epad[512];} XB;
+
+// Preprocess checksum request. If we don't support checksums or if the
+// requested checksum type is not supported, ignore it.
+//
+   if ((Request.dirlist.options[0] & kXR_dcksm) && JobLCL)
+      {char cksT[64];
+       algT = getCksType(opaque, cksT, sizeof(cksT));
+       if (!algT)
+          {char ebuf[1024];
+           snprintf(ebuf, sizeof(ebuf), "%s checksum not supported.", cksT);
+           dp->close();
+           delete dp;
+           return Response.Send(kXR_ServerError, ebuf);
+          }
+       statSz += XrdCksData::NameSize + (XrdCksData::ValuSize*2) + 8;
+      }
+
+// Note the identity of the top directory so we recognize it should a symlink
+// lead back to it. The stack never grows so dirLevel addresses are stable.
+//
+   if (osFS->stat(argp->buff, &Stat, myError, CRED, opaque) != SFS_OK)
+      memset(&Stat, 0, sizeof(Stat));
+   if (fPath.back() != '/') fPath += '/';
+   dirStack.reserve(maxDepth);
+   dirStack.push_back({dp, {}, fPath.size(), 0, Stat.st_dev, Stat.st_ino,
+                       false});
+   dirStack.back().manStat = (dp->autoStat(&dirStack.back().aStat) != SFS_OK);
+
+// The initial leadin is the dstat leadin followed by a "./" entry telling the
+// client that the listing is recursive. Older servers ignore the option and
+// return the top directory only; it's up to the client to recurse then.
+//
+   strcpy(XB.ebuff, leadIn);
+   buff = XB.ebuff+sizeof(leadIn)-1; bleft = sizeof(XB.ebuff)-sizeof(leadIn)+1;
+
+// Walk the tree. We continue with the directory on top of the stack and pop
+// it when it has no more entries. No errors are reflected for entries that
+// vanish or subdirectories we cannot open as these are listed regardless.
+//
+   while(!rc && !dirStack.empty())
+        {dirLevel &dLvl = dirStack.back();
+         if (!(dname = dLvl.dp->nextEntry()))
+            {dLvl.dp->close();
+             delete dLvl.dp;
+             dirStack.pop_back();
+             continue;
+            }
+         dlen = strlen(dname);
+         if (dlen <= 2 && dname[0] == '.' && (dlen == 1 || dname[1] == '.'))
+            continue;
+
+      // Construct the full and relative paths of this entry
+      //
+         fPath.resize(dLvl.pLen); fPath += dname;
+         rPath.resize(dLvl.rLen); rPath += dname;
+
+      // Get the stat information for this entry
+      //
+         if (!dLvl.manStat) sP = &dLvl.aStat;
+            else {rc = osFS->stat(fPath.c_str(), &Stat, myError, CRED, opaque);
+                  if (rc == SFS_ERROR && myError.getErrInfo() == ENOENT)
+                     {rc = 0; continue;}
+                  if (rc != SFS_OK)
+                     {rc = fsError(rc, XROOTD_MON_STAT, myError,
+                                   argp->buff, opaque);
+                      failed = true;
+                      break;
+                     }
+                  sP = &Stat;
+                 }
+
+      // If we cannot fit the entry in the buffer, send what we have. An entry
+      // that would not fit even then (i.e. insanely long path) is skipped.
+      //
+         if ((int)rPath.size() + 1 + statSz > (int)sizeof(XB.ebuff)) continue;
+         if ((int)rPath.size() + 1 + statSz > bleft)
+            {rc = Response.Send(kXR_oksofar, XB.ebuff, buff-XB.ebuff);
+             buff = XB.ebuff; bleft = sizeof(XB.ebuff);
+             TRACEP(FS, "dirtree sofar n=" <<cnt <<" path=" <<argp->buff);
+             if (rc) break;
+            }
+
+      // Format the entry
+      //
+         dlen = rPath.size();
+         memcpy(buff, rPath.c_str(), dlen); buff += dlen; *buff = '\n';
+         buff++; bleft -= dlen+1; cnt++;
+         dlen = StatGen(*sP, buff, sizeof(XB.epad));
+         bleft -= dlen; buff += (dlen-1);
+         if (algT)
+            {int ec = osFS->chksum(XrdSfsFileSystem::csGet, algT,
+                                   fPath.c_str(), myError, CRED, opaque);
+             csData = myError.getErrText();
+             if (ec != SFS_OK || !(*csData) || *csData == '!') csData = "none";
+             int n = snprintf(buff,sizeof(XB.epad)," [ %s:%s ]", algT, csData);
+             buff += n; bleft -= n;
+            }
+         *buff = '\n'; buff++;
+
+      // Descend into a subdirectory unless it leads back to a directory we
+      // are already in (symlink loop) or the tree is too deep.
+      //
+         if (!S_ISDIR(sP->st_mode)) continue;
+         if (sP->st_ino)
+            {bool isLoop = false;
+             for (auto &aLvl : dirStack)
+                 if (aLvl.dIno == sP->st_ino && aLvl.dDev == sP->st_dev)
+                    {isLoop = true; break;}
+             if (isLoop) continue;
+            }
+         if ((int)dirStack.size() >= maxDepth) {tooDeep = true; continue;}
+
+         XrdSfsDirectory *cdp = osFS->newDir(Link->ID, Monitor.Did);
+         if (!cdp) continue;
+         cdp->error.setUCap(clientPV);
+         if (cdp->open(fPath.c_str(), CRED, opaque))
+            {TRACEP(FS, "dirtree skipping " <<fPath.c_str() <<"; "
+                        <<cdp->error.getErrText());
+             delete cdp;
+             continue;
+            }
+         dev_t dDev = sP->st_dev;
+         ino_t dIno = sP->st_ino;
+         fPath += '/'; rPath += '/';
+         dirStack.push_back({cdp, {}, fPath.size(), rPath.size(), dDev, dIno,
+                              false});
+         dirStack.back().manStat =
+                     (cdp->autoStat(&dirStack.back().aStat) != SFS_OK);
+        }
+
+// Close whatever directories remain open should we have stopped early
+//
+   for (auto &aLvl : dirStack) {aLvl.dp->close(); delete aLvl.dp;}
+   if (rc || failed) return rc;
+
+// Send the ending packet. Should the tree have been pruned, say so instead.
+//
+   if (tooDeep)
+      {if (XB.ebuff != buff)
+          rc = Response.Send(kXR_oksofar, XB.ebuff, buff-XB.ebuff);
+       if (!rc)
+          {char ebuf[256];
+           snprintf(ebuf, sizeof(ebuf), "Directory tree deeper than %d levels;"
+                                        " listing is incomplete.", maxDepth);
+           rc = Response.Send(kXR_ServerError, ebuf);
+          }
+      } else {
+       if (XB.ebuff == buff) rc = Response.Send();
+          else {*(buff-1) = '\0';
+                rc = Response.Send((void *)XB.ebuff, buff-XB.ebuff);
+               }
+      }
+   if (!rc) {TRACEP(FS, "dirtree entries=" <<cnt <<" path=" <<argp->buff);}
+   return rc;
+}
+
 /******************************************************************************/
 /*                            d o _ E n d s e s s                             */
 /******************************************************************************/
@@ -2582,11 +2776,14 @@ int XrdXrootdProtocol::do_Read()
    if (!IO.IOLen) return Response.Send();
 
 // There are many competing ways to accomplish a read. Pick the one we
-// will use and if possible, do a fast dispatch.
+// will use and if possible, do a fast dispatch. Files that deliver their
+// data via SendData() (e.g. SSI responses) have no meaningful size so the
+// read is bounded by what SendData() has, not by the file size.
 //
         if (IO.File->isMMapped) IO.Mode = XrdXrootd::IOParms::useMMap;
    else if (IO.File->sfEnabled && !isTLS && IO.IOLen >= as_minsfsz
-        &&  IO.Offset+IO.IOLen <= IO.File->Stats.fSize)
+        &&  (IO.File->fdNum == (int)SFS_SFIO_FDVAL
+         ||  IO.Offset+IO.IOLen <= IO.File->Stats.fSize))
            IO.Mode = XrdXrootd::IOParms::useSF;
    else if (IO.File->AsyncMode && IO.IOLen >= as_miniosz
         &&  IO.Offset+IO.IOLen <= IO.File->Stats.fSize+as_seghalf
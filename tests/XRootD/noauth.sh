@@ -94,6 +94,20 @@ function test_noauth() {
 	    fi
 	done
 
+	# copies within the server and between local files do not need to read the
+	# data, but must give the same result whether that works out or not
+
+	for i in $FILES; do
+		assert xrdcp -np "${HOST}/${TMPDIR}/${i}.ref" "${HOST}/${TMPDIR}/${i}.dup"
+		assert xrdcp -np -f "${HOST}/${TMPDIR}/${i}.dup" "${TMPDIR}/${i}.dat"
+		assert xrdcp -np "${TMPDIR}/${i}.dat" "${TMPDIR}/${i}.cpy"
+		assert xrdfs "${HOST}" rm "${TMPDIR}/${i}.dup"
+
+		REFA32=$(xrdadler32 < "${TMPDIR}/${i}.ref" | cut -d' '  -f1)
+		NEWA32=$(xrdadler32 < "${TMPDIR}/${i}.cpy" | cut -d' '  -f1)
+		assert_eq "${REFA32}" "${NEWA32}" "adler32 checksum check failed for copy of ${i}.ref"
+	done
+
 	assert xrdfs "${HOST}" ls -R /
 
 	for i in $FILES; do
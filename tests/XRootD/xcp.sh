@@ -0,0 +1,81 @@
+#!/usr/bin/env bash
+
+# Multi-source copy (xrdcp --sources) from three replicas of the same file
+# served at very different rates: the main server is not throttled while two
+# extra servers, sharing its data directory, are throttled to 4MB/s and 1MB/s.
+
+XCP_PORTS=(3195 3196)
+XCP_RATES=(4m 1m)
+
+function setup_xcp() {
+	require_commands openssl
+	for i in 0 1; do
+		local port=${XCP_PORTS[$i]}
+		cat > "${NAME}/xcp-${port}.cfg" <<-EOF
+		all.export /
+		all.adminpath ${PWD}/${NAME}/xcp-${port}
+		all.pidpath   ${PWD}/${NAME}/xcp-${port}
+		oss.localroot ${REMOTE_DIR}
+		xrootd.fslib throttle default
+		throttle.throttle data ${XCP_RATES[$i]}
+		xrd.port ${port}
+		EOF
+		xrootd -b -l "${PWD}/${NAME}/xcp-${port}.log" -s "${PWD}/${NAME}/xcp-${port}.pid" \
+			-c "${NAME}/xcp-${port}.cfg" -n "xcp-${port}" || error "failed to start throttled server"
+	done
+}
+
+function test_xcp() {
+	echo
+	echo "client: XRootD $(assert xrdcp --version 2>&1)"
+	echo "server: XRootD $(assert xrdfs "${HOST}" query config version 2>&1)"
+	echo
+
+	TMPDIR=$(mktemp -d "${PWD}/${NAME}/test-XXXXXX")
+	assert xrdfs "${HOST}" mkdir -p "${TMPDIR}"
+
+	assert openssl rand -out "${TMPDIR}/xcp.ref" $((64 * 1024 * 1024))
+	assert xrdcp -np "${TMPDIR}/xcp.ref" "${HOST}/${TMPDIR}/xcp.ref"
+
+	# list the slowest replica first so that it gets work from the start
+	cat > "${TMPDIR}/xcp.meta4" <<-EOF
+	<?xml version="1.0" encoding="UTF-8"?>
+	<metalink xmlns="urn:ietf:params:xml:ns:metalink">
+	  <file name="xcp.ref">
+	    <url priority="1">root://localhost:${XCP_PORTS[1]}/${TMPDIR}/xcp.ref</url>
+	    <url priority="2">root://localhost:${XCP_PORTS[0]}/${TMPDIR}/xcp.ref</url>
+	    <url priority="3">root://localhost:${XRD_PORT}/${TMPDIR}/xcp.ref</url>
+	  </file>
+	</metalink>
+	EOF
+
+	# Blocks are handed out by throughput and slow sources keep little data in
+	# flight, so most of the file must come from the fast server rather than
+	# from the throttled replicas. Each source logs how much it delivered when
+	# the copy is over; the wall clock time is only reported.
+	export XRD_XCPBLOCKSIZE=$((16 * 1024 * 1024))
+	START=$(date +%s)
+	XRD_LOGLEVEL=Debug XRD_LOGFILE="${TMPDIR}/xcp.log" \
+		assert xrdcp -f -np --sources 3 "${TMPDIR}/xcp.meta4" "${TMPDIR}/xcp.dat"
+	ELAPSED=$(( $(date +%s) - START ))
+	echo "multi-source copy took ${ELAPSED}s"
+
+	REFA32=$(xrdadler32 < "${TMPDIR}/xcp.ref" | cut -d' ' -f1)
+	NEWA32=$(xrdadler32 < "${TMPDIR}/xcp.dat" | cut -d' ' -f1)
+	assert_eq "${REFA32}" "${NEWA32}" "adler32 checksum of the multi-source copy"
+
+	FAST=0
+	for port in ${XRD_PORT} "${XCP_PORTS[@]}"; do
+		BYTES=$(sed -n "s|.*Received \([0-9]*\) bytes from root://localhost:${port}/.*|\1|p" \
+			"${TMPDIR}/xcp.log" | awk '{ n += $1 } END { print n + 0 }')
+		echo "received ${BYTES} bytes from port ${port}"
+		[[ ${port} == "${XRD_PORT}" ]] && FAST=${BYTES}
+	done
+
+	if (( FAST * 2 <= 64 * 1024 * 1024 )); then
+		error "multi-source copy got most of the data from the throttled replicas"
+	fi
+
+	assert xrdfs "${HOST}" rm "${TMPDIR}/xcp.ref"
+	assert xrdfs "${HOST}" rmdir "${TMPDIR}"
+}
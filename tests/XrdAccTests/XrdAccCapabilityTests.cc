@@ -0,0 +1,61 @@
+#undef NDEBUG
+
+#include "XrdAccTestRules.hh"
+
+#include "XrdAcc/XrdAccCapability.hh"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(XrdAccCapabilityTests, CompiledMatchesListWalk)
+{
+  std::mt19937 rng(1234);
+
+  for (size_t nrules : {3, 9, 50, 500}) {
+    std::vector<XrdAccTestRule> rules = MakeRules(nrules, rng);
+    std::vector<XrdAccTestRule> trules = MakeRules(10, rng);
+    XrdAccCapability *tmplt = MakeList(trules);
+    XrdAccCapability *walk = MakeList(rules, tmplt, nrules / 2);
+    XrdAccCapability *comp = MakeList(rules, tmplt, nrules / 2);
+    comp->Compile();
+
+    for (const std::string &p : MakePaths(5000, rng)) {
+      XrdAccPrivCaps c1, c2;
+      int r1 = walk->Privs(c1, p.c_str());
+      int r2 = comp->Privs(c2, p.c_str());
+      ASSERT_EQ(r1, r2) << p;
+      ASSERT_EQ(c1.pprivs, c2.pprivs) << p;
+      ASSERT_EQ(c1.nprivs, c2.nprivs) << p;
+    }
+    delete walk;
+    delete comp;
+    delete tmplt;
+  }
+}
+
+TEST(XrdAccCapabilityTests, FirstMatchWins)
+{
+  XrdAccPrivs rd = XrdAccPriv_Read, all = XrdAccPriv_All;
+  std::vector<XrdAccTestRule> rules = {{"/a/b", rd, XrdAccPriv_None},
+                             {"/a", all, XrdAccPriv_None},
+                             {"/a/b/c", all, XrdAccPriv_None}};
+  for (int i = 0; i < 8; i++) rules.push_back({"/z" + std::to_string(i), all, XrdAccPriv_None});
+  XrdAccCapability *comp = MakeList(rules);
+  comp->Compile();
+
+  XrdAccPrivCaps c;
+  EXPECT_EQ(comp->Privs(c, "/a/b/c/d"), 1);
+  EXPECT_EQ(c.pprivs, rd);
+
+  XrdAccPrivCaps c2;
+  EXPECT_EQ(comp->Privs(c2, "/abc"), 1);
+  EXPECT_EQ(c2.pprivs, all);
+
+  XrdAccPrivCaps c3;
+  EXPECT_EQ(comp->Privs(c3, "/b"), 0);
+  EXPECT_EQ(c3.pprivs, XrdAccPriv_None);
+  delete comp;
+}
@@ -0,0 +1,76 @@
+#ifndef __XRDACC_TESTRULES_HH__
+#define __XRDACC_TESTRULES_HH__
+
+#include "XrdAcc/XrdAccCapability.hh"
+
+#include <random>
+#include <string>
+#include <vector>
+
+// Random capability lists and paths to look up in them, for tests and
+// benchmarks of XrdAccCapability.
+
+struct XrdAccTestRule
+{
+  std::string path;
+  XrdAccPrivs pprivs;
+  XrdAccPrivs nprivs;
+};
+
+// Build a capability list from the rules, in order, as XrdAccConfig does.
+inline XrdAccCapability *MakeList(const std::vector<XrdAccTestRule> &rules,
+                                  XrdAccCapability *tmplt = nullptr,
+                                  size_t tpos = 0)
+{
+  XrdAccPrivCaps none;
+  XrdAccCapability head((char *)"", none), *last = &head;
+
+  for (size_t i = 0; i < rules.size(); i++) {
+    if (tmplt && i == tpos) {
+      XrdAccCapability *tcap = new XrdAccCapability(tmplt);
+      last->Add(tcap);
+      last = tcap;
+    }
+    XrdAccPrivCaps pc;
+    pc.pprivs = rules[i].pprivs;
+    pc.nprivs = rules[i].nprivs;
+    XrdAccCapability *cap = new XrdAccCapability((char *)rules[i].path.c_str(), pc);
+    last->Add(cap);
+    last = cap;
+  }
+  XrdAccCapability *list = head.Next();
+  head.Add(nullptr);
+  return list;
+}
+
+inline std::vector<XrdAccTestRule> MakeRules(size_t n, std::mt19937 &rng)
+{
+  static const char *tops[] = {"/store", "/data", "/database", "/user", "/"};
+  std::vector<XrdAccTestRule> rules;
+  for (size_t i = 0; i < n; i++) {
+    std::string p = tops[rng() % 5];
+    int depth = rng() % 4;
+    for (int d = 0; d < depth; d++)
+      p += (p.back() == '/' ? "" : "/") + std::string("d") + std::to_string(rng() % 12);
+    if (rng() % 3 == 0) p += "/";
+    rules.push_back({p, (XrdAccPrivs)(1 + rng() % 0x7ff),
+                     (XrdAccPrivs)(rng() % 8 == 0 ? rng() % 0x7ff : 0)});
+  }
+  return rules;
+}
+
+inline std::vector<std::string> MakePaths(size_t n, std::mt19937 &rng)
+{
+  static const char *tops[] = {"/store", "/data", "/database", "/user", "/x", ""};
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < n; i++) {
+    std::string p = tops[rng() % 6];
+    int depth = rng() % 6;
+    for (int d = 0; d < depth; d++)
+      p += "/d" + std::to_string(rng() % 14);
+    paths.push_back(p);
+  }
+  return paths;
+}
+
+#endif
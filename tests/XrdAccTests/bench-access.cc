@@ -0,0 +1,130 @@
+#undef NDEBUG
+
+#include "XrdAccTestRules.hh"
+
+#include "XrdAcc/XrdAccAuthorize.hh"
+#include "XrdAcc/XrdAccCapability.hh"
+#include "XrdNet/XrdNetAddr.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdSec/XrdSecEntity.hh"
+#include "XrdSys/XrdSysLogger.hh"
+#include "XrdVersion.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Measures XrdAccAccess::Access() for users with growing numbers of path
+// rules in the authdb, whose lists are compiled into prefix indexes when the
+// authdb is loaded. For reference, the same rules are also looked up by
+// walking an uncompiled capability list, which is what Access() did before.
+//
+// Usage: xrdacc-bench-access [lookups per rule count]
+
+extern XrdAccAuthorize *XrdAccDefaultAuthorizeObject(XrdSysLogger   *lp,
+                                                     const char     *cfn,
+                                                     const char     *parm,
+                                                     XrdVersionInfo &myVer);
+
+namespace
+{
+const int nRules[] = {8, 64, 512, 5000};
+
+const XrdAccPrivs rlPrivs = (XrdAccPrivs)(XrdAccPriv_Read | XrdAccPriv_Lookup);
+
+template<typename F>
+double Time(const std::vector<std::string> &paths, F lookup, int &hits)
+{
+  hits = 0;
+  auto tBeg = std::chrono::steady_clock::now();
+  for (const std::string &p : paths) hits += (lookup(p) != 0);
+  std::chrono::duration<double, std::micro> tDiff =
+    std::chrono::steady_clock::now() - tBeg;
+  return tDiff.count() / paths.size();
+}
+}
+
+int main(int argc, char *argv[])
+{
+  static XrdVERSIONINFODEF(myVer, XrdAccBench, XrdVNUMBER, XrdVERSION);
+  int nLookups = 20000;
+  if (argc > 1) nLookups = atoi(argv[1]);
+  if (nLookups < 1) nLookups = 1;
+
+  std::mt19937 rng(42);
+  std::vector<std::vector<XrdAccTestRule> > rules;
+  for (int n : nRules) {
+    rules.push_back(MakeRules(n, rng));
+    for (auto &r : rules.back()) {r.pprivs = rlPrivs; r.nprivs = XrdAccPriv_None;}
+  }
+  std::vector<std::string> paths = MakePaths(nLookups, rng);
+
+  // An authdb with one user per rule count, one rule per line
+  char dir[] = "/tmp/xrdacc-bench-XXXXXX";
+  if (!mkdtemp(dir)) {
+    perror("mkdtemp");
+    return EXIT_FAILURE;
+  }
+  std::string dbFN = std::string(dir) + "/authdb";
+  std::string cfFN = std::string(dir) + "/acc.cf";
+  FILE *fp = fopen(dbFN.c_str(), "w");
+  for (size_t u = 0; u < rules.size(); u++) {
+    fprintf(fp, "u u%d", nRules[u]);
+    for (auto &r : rules[u]) fprintf(fp, " \\\n  %s rl", r.path.c_str());
+    fprintf(fp, "\n");
+  }
+  fclose(fp);
+  fp = fopen(cfFN.c_str(), "w");
+  fprintf(fp, "acc.authdb %s\n", dbFN.c_str());
+  fclose(fp);
+
+  static XrdSysLogger logger(open("/dev/null", O_WRONLY));
+  XrdOucEnv::Export("XRDINSTANCE", "xrootd anon@localhost");
+  XrdAccAuthorize *authP = XrdAccDefaultAuthorizeObject(&logger, cfFN.c_str(),
+                                                        0, myVer);
+  unlink(dbFN.c_str());
+  unlink(cfFN.c_str());
+  rmdir(dir);
+  if (!authP) {
+    fprintf(stderr, "unable to configure authorization\n");
+    return EXIT_FAILURE;
+  }
+
+  XrdNetAddr netAddr;
+  netAddr.Set("localhost", 0);
+  XrdSecEntity entity("host");
+  entity.addrInfo = &netAddr;
+  entity.host     = (char *)"localhost";
+  entity.tident   = (char *)"bench.1:1@localhost";
+
+  for (size_t u = 0; u < rules.size(); u++) {
+    std::string user = "u" + std::to_string(nRules[u]);
+    entity.name = (char *)user.c_str();
+    int hAcc, hWalk;
+    double tAcc = Time(paths, [&](const std::string &p)
+                       {return authP->Access(&entity, p.c_str(), AOP_Read);},
+                       hAcc);
+
+    XrdAccCapability *walk = MakeList(rules[u]);
+    double tWalk = Time(paths, [&](const std::string &p)
+                        {XrdAccPrivCaps c;
+                         walk->Privs(c, p.c_str(), p.size());
+                         return (int)c.pprivs;},
+                        hWalk);
+    delete walk;
+
+    printf("%5d rules: Access() %7.3f us/lookup, list walk %7.3f us/lookup "
+           "(%d/%d granted)\n", nRules[u], tAcc, tWalk, hAcc, hWalk);
+    if (hAcc != hWalk) {
+      fprintf(stderr, "Access() and the list walk disagree\n");
+      return EXIT_FAILURE;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "XrdCl/XrdClCopyPacer.hh"
+
+#include <algorithm>
+#include <deque>
+
+using namespace XrdCl;
+
+namespace
+{
+  const uint32_t MB = 1024 * 1024;
+
+  //----------------------------------------------------------------------------
+  // A link with a given round trip time and bottleneck bandwidth emulated in
+  // virtual time: requests reach the server after half the round trip, the
+  // answers are serialized on the bottleneck and arrive at the client after
+  // the other half. The client keeps the pipeline full the way the copy job
+  // does and counts what it gets.
+  //----------------------------------------------------------------------------
+  struct Link
+  {
+    Link( uint64_t rtt, double bandwidth ): rtt( rtt ), bandwidth( bandwidth )
+    {
+    }
+
+    struct Result
+    {
+      double   throughput;  // bytes/s over the second half of the run
+      uint64_t maxQueued;   // most bytes requested but not consumed
+    };
+
+    Result Run( CopyPacer &pacer, uint64_t duration )
+    {
+      struct Request
+      {
+        CopyPacer::Sample sample;
+        uint32_t          size;
+        uint64_t          done;
+      };
+
+      std::deque<Request> inflight;
+      uint64_t now = 0, linkFree = 0, queued = 0, half = 0;
+      Result   result{ 0, 0 };
+
+      while( now < duration )
+      {
+        //----------------------------------------------------------------------
+        // Issue requests as long as the pacer lets us
+        //----------------------------------------------------------------------
+        while( true )
+        {
+          uint32_t chunk = pacer.GetChunkSize();
+          if( !inflight.empty() && queued + chunk > pacer.GetInFlight() )
+            break;
+          Request req;
+          req.sample = pacer.OnSend( now );
+          req.size   = chunk;
+          uint64_t start = std::max( now + rtt / 2, linkFree );
+          linkFree = start + uint64_t( chunk / bandwidth * 1e6 );
+          req.done = linkFree + rtt / 2;
+          inflight.push_back( req );
+          queued += chunk;
+          result.maxQueued = std::max( result.maxQueued, queued );
+        }
+
+        //----------------------------------------------------------------------
+        // Wait for the oldest one
+        //----------------------------------------------------------------------
+        Request req = inflight.front();
+        inflight.pop_front();
+        now = req.done;
+        pacer.OnDelivered( req.sample, req.size, now );
+        queued -= req.size;
+        if( now >= duration / 2 ) half += req.size;
+      }
+
+      result.throughput = half / ( ( duration - duration / 2 ) / 1e6 );
+      return result;
+    }
+
+    uint64_t rtt;
+    double   bandwidth;
+  };
+
+  const double   TenGbit = 1.25e9;
+  const uint64_t Second  = 1000000;
+}
+
+//------------------------------------------------------------------------------
+// A long fat link needs far more than the default 4 x 8MB in flight
+//------------------------------------------------------------------------------
+TEST(CopyPacerTest, FillsLongFatLink)
+{
+  Link link( 100000, TenGbit );  // 100ms
+
+  CopyPacer fixed( 8 * MB, 4, 32 * MB ); // behaves like the fixed pipeline
+  Link::Result base = link.Run( fixed, 10 * Second );
+  EXPECT_LT( base.throughput, 0.3 * TenGbit );
+
+  CopyPacer pacer( 8 * MB, 4, 256 * MB );
+  Link::Result res = link.Run( pacer, 30 * Second );
+  EXPECT_GT( res.throughput, 0.9 * TenGbit );
+  EXPECT_LE( res.maxQueued, 256ull * MB );
+  EXPECT_EQ( pacer.GetChunkSize(), 8 * MB );
+
+  EXPECT_NEAR( pacer.GetBandwidth(), TenGbit, 0.1 * TenGbit );
+  EXPECT_GE( pacer.GetMinRtt(), 0.1 );
+  EXPECT_LT( pacer.GetMinRtt(), 0.12 );
+}
+
+//------------------------------------------------------------------------------
+// On a LAN small chunks and little memory do
+//------------------------------------------------------------------------------
+TEST(CopyPacerTest, SavesMemoryOnLan)
+{
+  Link link( 200, TenGbit );  // 0.2ms
+
+  // long enough for the round trip time to be probed again
+  CopyPacer pacer( 8 * MB, 4, 256 * MB );
+  Link::Result res = link.Run( pacer, 15 * Second );
+  EXPECT_GT( res.throughput, 0.9 * TenGbit );
+  EXPECT_LT( pacer.GetChunkSize(), 8 * MB );
+  EXPECT_GE( pacer.GetChunkSize(), CopyPacer::MinChunkSize );
+  EXPECT_LE( pacer.GetInFlight(), 8ull * MB );
+}
+
+//------------------------------------------------------------------------------
+// Memory limit always wins
+//------------------------------------------------------------------------------
+TEST(CopyPacerTest, HonoursMemoryLimit)
+{
+  Link link( 100000, TenGbit );
+
+  CopyPacer pacer( 8 * MB, 4, 64 * MB );
+  Link::Result res = link.Run( pacer, 5 * Second );
+  EXPECT_LE( res.maxQueued, 64ull * MB );
+  EXPECT_EQ( pacer.GetInFlight(), 64ull * MB );
+  // but the link is used as well as the limit allows
+  EXPECT_GT( res.throughput, 0.8 * 64 * MB / 0.1 );
+}
+
+//------------------------------------------------------------------------------
+// Failed requests carry no information
+//------------------------------------------------------------------------------
+TEST(CopyPacerTest, IgnoresFailures)
+{
+  CopyPacer pacer( 8 * MB, 4, 256 * MB );
+  CopyPacer::Sample s = pacer.OnSend( 1000 );
+  pacer.OnDelivered( s, 0, 2000 );
+  EXPECT_EQ( pacer.GetChunkSize(), CopyPacer::MinChunkSize );
+  EXPECT_EQ( pacer.GetInFlight(), 32ull * MB );
+  EXPECT_EQ( pacer.GetBandwidth(), 0 );
+  EXPECT_EQ( pacer.ToString(), "chunk 512kB x 64 in flight" );
+}
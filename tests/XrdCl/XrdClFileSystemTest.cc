@@ -47,6 +47,7 @@ class FileSystemTest: public ::testing::Test
     void ProtocolTest();
     void DeepLocateTest();
     void DirListTest();
+    void RecursiveDirListTest();
     void SendInfoTest();
     void PrepareTest();
     void XAttrTest();
@@ -115,6 +116,11 @@ TEST_F(FileSystemTest, DirListTest)
   DirListTest();
 }
 
+TEST_F(FileSystemTest, RecursiveDirListTest)
+{
+  RecursiveDirListTest();
+}
+
 TEST_F(FileSystemTest, SendInfoTest)
 {
   SendInfoTest();
@@ -146,6 +152,7 @@ TEST_F(FileSystemTest, PlugInTest)
   ProtocolTest();
   DeepLocateTest();
   DirListTest();
+  RecursiveDirListTest();
   SendInfoTest();
   PrepareTest();
   XrdCl::DefaultEnv::GetPlugInManager()->RegisterDefaultFactory(0);
@@ -605,6 +612,85 @@ void FileSystemTest::DirListTest()
   info = 0;
 }
 
+//------------------------------------------------------------------------------
+// Recursive dir list
+//------------------------------------------------------------------------------
+void FileSystemTest::RecursiveDirListTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Get the environment variables
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  EXPECT_TRUE( testEnv->GetString( "MainServerURL", address ) );
+  EXPECT_TRUE( testEnv->GetString( "DataPath", dataPath ) );
+
+  URL url( address );
+  EXPECT_TRUE( url.IsValid() );
+
+  //----------------------------------------------------------------------------
+  // Create a small tree on one of the data servers
+  //----------------------------------------------------------------------------
+  std::string treePath = dataPath + "/rtree";
+  std::vector<std::string> dirs = { "a", "a/b", "a/b/c", "a/d", "e" };
+
+  FileSystem fs( url );
+  EXPECT_XRDST_OK( fs.MkDir( treePath, MkDirFlags::None, Access::None ) );
+  LocationInfo *info = 0;
+  EXPECT_XRDST_OK( fs.DeepLocate( treePath, OpenFlags::PrefName, info ) );
+  ASSERT_TRUE( info );
+  ASSERT_TRUE( info->GetSize() );
+  FileSystem fs1( info->Begin()->GetAddress() );
+  delete info;
+
+  for( auto &dir : dirs )
+    EXPECT_XRDST_OK( fs1.MkDir( treePath + "/" + dir, MkDirFlags::None,
+                                Access::None ) );
+
+  std::set<std::string> expected( dirs.begin(), dirs.end() );
+
+  //----------------------------------------------------------------------------
+  // List it in one go
+  //----------------------------------------------------------------------------
+  DirectoryList *list = 0;
+  EXPECT_XRDST_OK( fs1.DirList( treePath, DirListFlags::Recursive, list ) );
+  ASSERT_TRUE( list );
+
+  std::set<std::string> dirls1;
+  for( auto itr = list->Begin(); itr != list->End(); ++itr )
+  {
+    ASSERT_TRUE( (*itr)->GetStatInfo() );
+    EXPECT_TRUE( (*itr)->GetStatInfo()->TestFlags( StatInfo::IsDir ) );
+    dirls1.insert( (*itr)->GetName() );
+  }
+  delete list;
+  EXPECT_EQ( dirls1, expected );
+
+  //----------------------------------------------------------------------------
+  // Now stream it
+  //----------------------------------------------------------------------------
+  std::set<std::string> dirls2;
+  EXPECT_XRDST_OK( fs1.DirListStream( treePath, DirListFlags::Recursive,
+                     [&dirls2]( DirectoryList &batch )
+                     {
+                       for( auto itr = batch.Begin(); itr != batch.End(); ++itr )
+                         dirls2.insert( (*itr)->GetName() );
+                     } ) );
+  EXPECT_EQ( dirls2, expected );
+
+  //----------------------------------------------------------------------------
+  // Clean up
+  //----------------------------------------------------------------------------
+  for( auto itr = dirs.rbegin(); itr != dirs.rend(); ++itr )
+    EXPECT_XRDST_OK( fs1.RmDir( treePath + "/" + *itr ) );
+  EXPECT_XRDST_OK( fs.RmDir( treePath ) );
+}
+
 
 //------------------------------------------------------------------------------
 // Set
@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "XrdCl/XrdClCheckSumManager.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClEnv.hh"
+#include "XrdCl/XrdClParallelCheckSum.hh"
+#include "XrdCl/XrdClUtils.hh"
+#include "XrdCks/XrdCksCalc.hh"
+#include "XrdCks/XrdCksData.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace XrdCl;
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Checksum computed the usual way, in the "type:value" notation
+  //----------------------------------------------------------------------------
+  std::string Serial( const std::string &type, const std::string &data )
+  {
+    CheckSumManager *cksMan = DefaultEnv::GetCheckSumManager();
+    std::unique_ptr<XrdCksCalc> calc( cksMan->GetCalculator( type ) );
+    calc->Update( data.data(), data.size() );
+    int size = 0;
+    calc->Type( size );
+    XrdCksData ckSum;
+    ckSum.Set( type.c_str() );
+    ckSum.Set( (void*)calc->Final(), size );
+    char buffer[265];
+    ckSum.Get( buffer, 256 );
+    return type + ":" + Utils::NormalizeChecksum( type, buffer );
+  }
+
+  //----------------------------------------------------------------------------
+  // Blocks of uneven sizes covering the data, in random order
+  //----------------------------------------------------------------------------
+  std::vector<std::pair<uint64_t, uint32_t>> Blocks( const std::string &data )
+  {
+    std::mt19937 gen( 4321 );
+    std::vector<std::pair<uint64_t, uint32_t>> blocks;
+    for( uint64_t offset = 0; offset < data.size(); )
+    {
+      uint32_t size = std::min<uint64_t>( 1 + gen() % 300000,
+                                          data.size() - offset );
+      blocks.emplace_back( offset, size );
+      offset += size;
+    }
+    std::shuffle( blocks.begin(), blocks.end(), gen );
+    return blocks;
+  }
+
+  class ParallelCheckSumTest : public ::testing::TestWithParam<int>
+  {
+    protected:
+      void SetUp() override
+      {
+        DefaultEnv::GetEnv()->PutInt( "CpCksThreads", GetParam() );
+        std::mt19937 gen( 1234 );
+        data.resize( 5 * 1024 * 1024 + 77 );
+        for( char &c : data ) c = char( gen() );
+      }
+
+      void TearDown() override
+      {
+        DefaultEnv::GetEnv()->PutInt( "CpCksThreads", DefaultCpCksThreads );
+      }
+
+      std::string data;
+  };
+}
+
+//------------------------------------------------------------------------------
+// Blocks handed over out of order give the same checksums as a serial pass
+//------------------------------------------------------------------------------
+TEST_P(ParallelCheckSumTest, OutOfOrder)
+{
+  ParallelCheckSum cks( { "adler32", "crc32c", "adler32" } );
+  ASSERT_TRUE( cks.Initialize().IsOK() );
+  EXPECT_TRUE( cks.Has( "adler32" ) );
+  EXPECT_FALSE( cks.Has( "md5" ) );
+
+  std::atomic<int> done( 0 );
+  auto blocks = Blocks( data );
+  for( auto &b : blocks )
+    cks.Update( b.first, data.data() + b.first, b.second, [&done]{ ++done; } );
+  cks.Wait();
+  EXPECT_EQ( done, (int)blocks.size() );
+
+  for( std::string type : { "adler32", "crc32c" } )
+  {
+    std::string checkSum;
+    ASSERT_TRUE( cks.GetCheckSum( type, checkSum ).IsOK() );
+    EXPECT_EQ( checkSum, Serial( type, data ) );
+  }
+}
+
+//------------------------------------------------------------------------------
+// A missing block is an error rather than a wrong checksum
+//------------------------------------------------------------------------------
+TEST_P(ParallelCheckSumTest, Gap)
+{
+  ParallelCheckSum cks( { "crc32c" } );
+  ASSERT_TRUE( cks.Initialize().IsOK() );
+  auto blocks = Blocks( data );
+  blocks.pop_back();
+  for( auto &b : blocks )
+    cks.Update( b.first, data.data() + b.first, b.second );
+
+  std::string checkSum;
+  EXPECT_FALSE( cks.GetCheckSum( "crc32c", checkSum ).IsOK() );
+}
+
+//------------------------------------------------------------------------------
+// Checksums that cannot be combined are refused
+//------------------------------------------------------------------------------
+TEST_P(ParallelCheckSumTest, NotCombinable)
+{
+  EXPECT_TRUE( ParallelCheckSum::IsSupported( "adler32" ) );
+  EXPECT_TRUE( ParallelCheckSum::IsSupported( "crc32c" ) );
+  EXPECT_FALSE( ParallelCheckSum::IsSupported( "md5" ) );
+
+  ParallelCheckSum cks( { "adler32", "md5" } );
+  XRootDStatus st = cks.Initialize();
+  EXPECT_EQ( st.code, errNotSupported );
+}
+
+//------------------------------------------------------------------------------
+// Checksum of a local file
+//------------------------------------------------------------------------------
+TEST_P(ParallelCheckSumTest, LocalFile)
+{
+  const char *tmp = getenv( "TMPDIR" );
+  std::string path = std::string( tmp ? tmp : "/tmp" ) + "/xrdcl-cks-XXXXXX";
+  int fd = mkstemp( &path[0] );
+  ASSERT_NE( fd, -1 );
+  ASSERT_EQ( write( fd, data.data(), data.size() ), (ssize_t)data.size() );
+  close( fd );
+
+  for( std::string type : { "adler32", "crc32c", "md5" } )
+  {
+    std::string checkSum;
+    EXPECT_TRUE( Utils::GetLocalCheckSum( checkSum, type, path ).IsOK() );
+    EXPECT_EQ( checkSum, Serial( type, data ) );
+  }
+  unlink( path.c_str() );
+}
+
+INSTANTIATE_TEST_SUITE_P(Threads, ParallelCheckSumTest, ::testing::Values( 0, 4 ));
@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClCopyProcess.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClEnv.hh"
+
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+using namespace XrdCl;
+
+//------------------------------------------------------------------------------
+// Copies between local files on a scratch directory
+//------------------------------------------------------------------------------
+class ZeroCopyTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+      const char *tmp = getenv( "TMPDIR" );
+      std::string templ = std::string( tmp ? tmp : "/tmp" ) + "/xrdcl-zerocopy-XXXXXX";
+      ASSERT_NE( mkdtemp( &templ[0] ), nullptr );
+      dir = templ;
+
+      //------------------------------------------------------------------------
+      // Not a multiple of the block size, so that the tail is special
+      //------------------------------------------------------------------------
+      std::mt19937 gen( 1234 );
+      data.resize( 3 * 1024 * 1024 + 123 );
+      for( char &c : data ) c = char( gen() );
+      std::ofstream( dir + "/src.dat", std::ios::binary ) << data;
+    }
+
+    void TearDown() override
+    {
+      DefaultEnv::GetEnv()->PutInt( "CpZeroCopy", DefaultCpZeroCopy );
+      std::string cmd = "rm -rf " + dir;
+      EXPECT_EQ( system( cmd.c_str() ), 0 );
+    }
+
+    XRootDStatus Copy( const std::string &target, PropertyList &results,
+                       const std::string &cksum = "" )
+    {
+      CopyProcess  process;
+      PropertyList properties;
+      properties.Set( "source", "file://localhost" + dir + "/src.dat" );
+      properties.Set( "target", "file://localhost" + dir + "/" + target );
+      if( !cksum.empty() )
+      {
+        properties.Set( "checkSumMode", "end2end" );
+        properties.Set( "checkSumType", cksum );
+      }
+      XRootDStatus st = process.AddJob( properties, &results );
+      if( !st.IsOK() ) return st;
+      st = process.Prepare();
+      if( !st.IsOK() ) return st;
+      st = process.Run( 0 );
+      if( !st.IsOK() ) return st;
+      return results.Get<XRootDStatus>( "status" );
+    }
+
+    std::string Read( const std::string &name )
+    {
+      std::ifstream in( dir + "/" + name, std::ios::binary );
+      std::ostringstream o;
+      o << in.rdbuf();
+      return o.str();
+    }
+
+    std::string dir;
+    std::string data;
+};
+
+//------------------------------------------------------------------------------
+// The data do not pass through the client
+//------------------------------------------------------------------------------
+TEST_F(ZeroCopyTest, LocalToLocal)
+{
+  PropertyList results;
+  ASSERT_TRUE( Copy( "dst.dat", results ).IsOK() );
+  EXPECT_EQ( Read( "dst.dat" ), data );
+  EXPECT_EQ( results.Get<uint64_t>( "size" ), data.size() );
+
+  std::string method;
+#ifdef HAVE_COPY_FILE_RANGE
+  ASSERT_TRUE( results.Get( "zeroCopy", method ) );
+#else
+  if( !results.Get( "zeroCopy", method ) )
+    GTEST_SKIP() << "No way to copy without reading the data";
+#endif
+  EXPECT_TRUE( method == "reflink" || method == "copy_file_range" ) << method;
+}
+
+//------------------------------------------------------------------------------
+// The checksums of both ends are computed from the files
+//------------------------------------------------------------------------------
+TEST_F(ZeroCopyTest, EndToEndChecksum)
+{
+  PropertyList results;
+  XRootDStatus st = Copy( "dst.dat", results, "adler32" );
+  ASSERT_TRUE( st.IsOK() ) << st.ToString();
+  EXPECT_EQ( Read( "dst.dat" ), data );
+
+  std::string srcCks, dstCks;
+  ASSERT_TRUE( results.Get( "sourceCheckSum", srcCks ) );
+  ASSERT_TRUE( results.Get( "targetCheckSum", dstCks ) );
+  EXPECT_EQ( srcCks, dstCks );
+}
+
+//------------------------------------------------------------------------------
+// Disabled, the data are copied chunk by chunk
+//------------------------------------------------------------------------------
+TEST_F(ZeroCopyTest, Disabled)
+{
+  DefaultEnv::GetEnv()->PutInt( "CpZeroCopy", 0 );
+  PropertyList results;
+  ASSERT_TRUE( Copy( "dst.dat", results ).IsOK() );
+  EXPECT_EQ( Read( "dst.dat" ), data );
+  EXPECT_FALSE( results.HasProperty( "zeroCopy" ) );
+}
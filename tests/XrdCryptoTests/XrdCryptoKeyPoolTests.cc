@@ -0,0 +1,153 @@
+#undef NDEBUG
+
+#include "XrdCryptoTestKeys.hh"
+
+#include "XrdCrypto/XrdCryptosslKeyPool.hh"
+
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class XrdCryptoKeyPoolTests : public ::testing::Test
+{
+protected:
+  static EVP_PKEY *dhParams;
+  static EVP_PKEY *otherParams;
+
+  static void SetUpTestSuite()
+  {
+    dhParams    = MakeDHParams(NID_ffdhe3072);
+    otherParams = MakeDHParams(NID_ffdhe2048);
+  }
+
+  void TearDown() override {XrdCryptosslKeyPool::Configure(0, 0);}
+};
+
+EVP_PKEY *XrdCryptoKeyPoolTests::dhParams    = nullptr;
+EVP_PKEY *XrdCryptoKeyPoolTests::otherParams = nullptr;
+
+TEST_F(XrdCryptoKeyPoolTests, DisabledPoolGivesNothing)
+{
+  ASSERT_NE(dhParams, nullptr);
+  XrdCryptosslKeyPool::Configure(0, 0);
+  EXPECT_EQ(XrdCryptosslKeyPool::GetDH(dhParams), nullptr);
+  EXPECT_EQ(XrdCryptosslKeyPool::GetRSA(2048), nullptr);
+}
+
+TEST_F(XrdCryptoKeyPoolTests, KeysAreHandedOutOnce)
+{
+  ASSERT_NE(dhParams, nullptr);
+  ASSERT_NE(otherParams, nullptr);
+  XrdCryptosslKeyPool::Configure(4, 2);
+
+  // The first requests register what to generate
+  EVP_PKEY *key = XrdCryptosslKeyPool::GetDH(dhParams);
+  EVP_PKEY_free(key);
+  key = XrdCryptosslKeyPool::GetRSA(2048);
+  EVP_PKEY_free(key);
+  ASSERT_TRUE(WaitFilled(4, 2));
+
+  XrdCryptosslKeyPool::Stats st0, st;
+  XrdCryptosslKeyPool::GetStats(st0, true);
+  EXPECT_EQ(st0.dhAvail, 4);
+  EXPECT_EQ(st0.rsaAvail, 2);
+
+  // Keys for other parameters are never handed out
+  EXPECT_EQ(XrdCryptosslKeyPool::GetDH(otherParams), nullptr);
+
+  EVP_PKEY *k1 = XrdCryptosslKeyPool::GetDH(dhParams);
+  EVP_PKEY *k2 = XrdCryptosslKeyPool::GetDH(dhParams);
+  ASSERT_NE(k1, nullptr);
+  ASSERT_NE(k2, nullptr);
+  EXPECT_NE(k1, k2);
+  EXPECT_EQ(EVP_PKEY_parameters_eq(k1, dhParams), 1);
+  EXPECT_NE(EVP_PKEY_eq(k1, k2), 1);
+
+  EVP_PKEY *r1 = XrdCryptosslKeyPool::GetRSA(2048);
+  ASSERT_NE(r1, nullptr);
+  EXPECT_EQ(EVP_PKEY_bits(r1), 2048);
+
+  // A DH key from the pool derives the same secret as a fresh one would
+  EVP_PKEY *peer = NewDH(dhParams);
+  unsigned char s1[512], s2[512];
+  size_t l1 = sizeof(s1), l2 = sizeof(s2);
+  EVP_PKEY_CTX *c1 = EVP_PKEY_CTX_new(k1, nullptr);
+  EVP_PKEY_derive_init(c1);
+  EVP_PKEY_derive_set_peer(c1, peer);
+  EXPECT_EQ(EVP_PKEY_derive(c1, s1, &l1), 1);
+  EVP_PKEY_CTX *c2 = EVP_PKEY_CTX_new(peer, nullptr);
+  EVP_PKEY_derive_init(c2);
+  EVP_PKEY_derive_set_peer(c2, k1);
+  EXPECT_EQ(EVP_PKEY_derive(c2, s2, &l2), 1);
+  EXPECT_EQ(l1, l2);
+  EXPECT_EQ(memcmp(s1, s2, l1), 0);
+  EVP_PKEY_CTX_free(c1);
+  EVP_PKEY_CTX_free(c2);
+
+  XrdCryptosslKeyPool::GetStats(st);
+  EXPECT_EQ(st.dhTaken, 2);
+  EXPECT_EQ(st.rsaTaken, 1);
+
+  EVP_PKEY_free(peer);
+  EVP_PKEY_free(k1);
+  EVP_PKEY_free(k2);
+  EVP_PKEY_free(r1);
+}
+
+TEST_F(XrdCryptoKeyPoolTests, DepletionIsCounted)
+{
+  ASSERT_NE(dhParams, nullptr);
+  XrdCryptosslKeyPool::Configure(1, 0);
+  EVP_PKEY_free(XrdCryptosslKeyPool::GetDH(dhParams));
+  ASSERT_TRUE(WaitFilled(1, 0));
+
+  XrdCryptosslKeyPool::Stats st;
+  XrdCryptosslKeyPool::GetStats(st, true);
+  EVP_PKEY *k1 = XrdCryptosslKeyPool::GetDH(dhParams);
+  EVP_PKEY *k2 = XrdCryptosslKeyPool::GetDH(dhParams);
+  XrdCryptosslKeyPool::GetStats(st);
+  EXPECT_NE(k1, nullptr);
+  EXPECT_EQ(st.dhTaken + st.dhMissed, 2);
+  EXPECT_GE(st.dhMissed, k2 ? 0 : 1);
+  EVP_PKEY_free(k1);
+  EVP_PKEY_free(k2);
+}
+
+TEST_F(XrdCryptoKeyPoolTests, PoolIsRefilled)
+{
+  ASSERT_NE(dhParams, nullptr);
+  XrdCryptosslKeyPool::Configure(3, 2);
+  EVP_PKEY_free(XrdCryptosslKeyPool::GetDH(dhParams));
+  EVP_PKEY_free(XrdCryptosslKeyPool::GetRSA(2048));
+
+  // Empty the pool twice over, each time it comes back full
+  std::vector<EVP_PKEY *> dhKeys, rsaKeys;
+  for (int round = 0; round < 2; round++) {
+    ASSERT_TRUE(WaitFilled(3, 2)) << "round " << round;
+    for (int i = 0; i < 3; i++) {
+      EVP_PKEY *k = XrdCryptosslKeyPool::GetDH(dhParams);
+      ASSERT_NE(k, nullptr) << "round " << round;
+      EXPECT_EQ(EVP_PKEY_parameters_eq(k, dhParams), 1);
+      dhKeys.push_back(k);
+    }
+    for (int i = 0; i < 2; i++) {
+      EVP_PKEY *k = XrdCryptosslKeyPool::GetRSA(2048);
+      ASSERT_NE(k, nullptr) << "round " << round;
+      EXPECT_EQ(EVP_PKEY_bits(k), 2048);
+      rsaKeys.push_back(k);
+    }
+  }
+
+  // No key was handed out twice
+  for (auto *keys : {&dhKeys, &rsaKeys})
+    for (size_t i = 0; i < keys->size(); i++)
+      for (size_t j = i + 1; j < keys->size(); j++)
+        EXPECT_NE(EVP_PKEY_eq((*keys)[i], (*keys)[j]), 1) << i << " " << j;
+
+  for (auto *k : dhKeys)  EVP_PKEY_free(k);
+  for (auto *k : rsaKeys) EVP_PKEY_free(k);
+}
@@ -0,0 +1,96 @@
+#ifndef __XRDCRYPTO_TESTKEYS_HH__
+#define __XRDCRYPTO_TESTKEYS_HH__
+
+#include "XrdCrypto/XrdCryptosslKeyPool.hh"
+
+#include <openssl/dh.h>
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <sys/stat.h>
+
+// Key material for exercising XrdCryptosslKeyPool in tests and benchmarks.
+
+inline EVP_PKEY *MakeDHParams(int nid)
+{
+  EVP_PKEY *params = nullptr;
+  EVP_PKEY_CTX *pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_DH, nullptr);
+  if (pctx && EVP_PKEY_paramgen_init(pctx) > 0
+  &&  EVP_PKEY_CTX_set_dh_nid(pctx, nid) > 0)
+    EVP_PKEY_paramgen(pctx, &params);
+  EVP_PKEY_CTX_free(pctx);
+  return params;
+}
+
+inline EVP_PKEY *NewDH(EVP_PKEY *params)
+{
+  EVP_PKEY *key = nullptr;
+  EVP_PKEY_CTX *kctx = EVP_PKEY_CTX_new(params, nullptr);
+  EVP_PKEY_keygen_init(kctx);
+  EVP_PKEY_keygen(kctx, &key);
+  EVP_PKEY_CTX_free(kctx);
+  return key;
+}
+
+// Write a self-signed certificate and its key, standing in for the
+// certificate of a client delegating a proxy.
+inline bool MakeCert(const std::string &certFN, const std::string &keyFN)
+{
+  EVP_PKEY *pkey = nullptr;
+  EVP_PKEY_CTX *kctx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, nullptr);
+  if (!kctx || EVP_PKEY_keygen_init(kctx) <= 0
+  ||  EVP_PKEY_CTX_set_rsa_keygen_bits(kctx, 2048) <= 0
+  ||  EVP_PKEY_keygen(kctx, &pkey) <= 0) {
+    EVP_PKEY_CTX_free(kctx);
+    return false;
+  }
+  EVP_PKEY_CTX_free(kctx);
+
+  X509 *x509 = X509_new();
+  ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+  X509_gmtime_adj(X509_getm_notBefore(x509), -60);
+  X509_gmtime_adj(X509_getm_notAfter(x509), 24*60*60);
+  X509_set_pubkey(x509, pkey);
+  X509_NAME *name = X509_get_subject_name(x509);
+  X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                             (const unsigned char *)"Test User", -1, -1, 0);
+  X509_set_issuer_name(x509, name);
+  bool aOK = X509_sign(x509, pkey, EVP_sha256()) > 0;
+
+  FILE *fp;
+  if (aOK && (aOK = (fp = fopen(certFN.c_str(), "w")))) {
+    aOK = PEM_write_X509(fp, x509) == 1;
+    fclose(fp);
+  }
+  if (aOK && (aOK = (fp = fopen(keyFN.c_str(), "w")))) {
+    aOK = PEM_write_PrivateKey(fp, pkey, nullptr, nullptr, 0, nullptr, nullptr) == 1;
+    fclose(fp);
+  }
+  chmod(keyFN.c_str(), 0600);
+  X509_free(x509);
+  EVP_PKEY_free(pkey);
+  return aOK;
+}
+
+// Wait until the pool holds the wanted number of keys; false if it did not
+// get there within 'secs' seconds.
+inline bool WaitFilled(int dh, int rsa, int secs = 60)
+{
+  XrdCryptosslKeyPool::Stats st;
+  auto end = std::chrono::steady_clock::now() + std::chrono::seconds(secs);
+  do {
+    XrdCryptosslKeyPool::GetStats(st);
+    if (st.dhAvail >= dh && st.rsaAvail >= rsa) return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  } while (std::chrono::steady_clock::now() < end);
+  return false;
+}
+
+#endif
@@ -0,0 +1,98 @@
+#undef NDEBUG
+
+#include "XrdCryptoTestKeys.hh"
+
+#include "XrdCrypto/XrdCryptoX509Req.hh"
+#include "XrdCrypto/XrdCryptosslAux.hh"
+#include "XrdCrypto/XrdCryptosslKeyPool.hh"
+#include "XrdCrypto/XrdCryptosslRSA.hh"
+#include "XrdCrypto/XrdCryptosslX509.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <unistd.h>
+
+// Measures the server side key work of GSI handshakes asking for a delegated
+// proxy, with and without the key pool: a DH key to agree on the session key
+// and the key of the proxy request.
+//
+// Usage: xrdcrypto-bench-keypool [handshakes per pass]
+
+namespace
+{
+bool       failed = false;
+EVP_PKEY  *dhParams;
+EVP_PKEY  *client;
+
+double Handshakes(XrdCryptosslX509 &cert, int nHS)
+{
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < nHS; i++) {
+    EVP_PKEY *dh = XrdCryptosslKeyPool::GetDH(dhParams);
+    if (!dh) dh = NewDH(dhParams);
+    unsigned char secret[512];
+    size_t slen = sizeof(secret);
+    EVP_PKEY_CTX *dctx = EVP_PKEY_CTX_new(dh, nullptr);
+    EVP_PKEY_derive_init(dctx);
+    EVP_PKEY_derive_set_peer(dctx, client);
+    if (EVP_PKEY_derive(dctx, secret, &slen) != 1) failed = true;
+    EVP_PKEY_CTX_free(dctx);
+    EVP_PKEY_free(dh);
+
+    XrdCryptoX509Req *req = nullptr;
+    XrdCryptoRSA *key = nullptr;
+    if (XrdCryptosslX509CreateProxyReq(&cert, &req, &key)) failed = true;
+    delete req;
+    delete key;
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+}
+
+int main(int argc, char *argv[])
+{
+  int nHS = 8;
+  if (argc > 1) nHS = atoi(argv[1]);
+  if (nHS < 1) nHS = 1;
+
+  char dir[] = "/tmp/xrdkeypool.XXXXXX";
+  if (!mkdtemp(dir)) {
+    perror("mkdtemp");
+    return EXIT_FAILURE;
+  }
+  std::string certFN = std::string(dir) + "/usercert.pem";
+  std::string keyFN  = std::string(dir) + "/userkey.pem";
+  bool certOK = MakeCert(certFN, keyFN);
+  XrdCryptosslX509 cert(certFN.c_str(), keyFN.c_str());
+  unlink(certFN.c_str());
+  unlink(keyFN.c_str());
+  rmdir(dir);
+
+  dhParams = MakeDHParams(NID_ffdhe3072);
+  client   = dhParams ? NewDH(dhParams) : nullptr;
+  if (!certOK || !cert.Opaque() || !client) {
+    fprintf(stderr, "unable to create test keys\n");
+    return EXIT_FAILURE;
+  }
+
+  XrdCryptosslKeyPool::Configure(0, 0);
+  double tCold = Handshakes(cert, nHS);
+
+  XrdCryptosslKeyPool::Configure(nHS, nHS);
+  EVP_PKEY_free(XrdCryptosslKeyPool::GetDH(dhParams));
+  EVP_PKEY_free(XrdCryptosslKeyPool::GetRSA(2048));
+  if (!WaitFilled(nHS, nHS)) fprintf(stderr, "the pool was not filled in time\n");
+  double tPool = Handshakes(cert, nHS);
+
+  printf("handshakes/s without pool: %.1f, with pool: %.1f\n",
+         nHS / tCold, nHS / tPool);
+
+  XrdCryptosslKeyPool::Configure(0, 0);
+  EVP_PKEY_free(client);
+  EVP_PKEY_free(dhParams);
+  if (failed) fprintf(stderr, "some handshakes failed\n");
+  return failed ? EXIT_FAILURE : 0;
+}
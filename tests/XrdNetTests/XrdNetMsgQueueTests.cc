@@ -0,0 +1,211 @@
+#undef NDEBUG
+
+#include "XrdNet/XrdNetMsg.hh"
+#include "XrdNet/XrdNetMsgQueue.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Messages are laid out like monitoring records: a code byte, the sequence
+// byte filled in by the queue, then the producer number and its counter.
+namespace
+{
+struct TestMsg
+{
+  unsigned char code;
+  unsigned char pseq;
+  unsigned char producer;
+  unsigned char pad;
+  uint32_t      counter;
+  char          body[120];
+};
+
+XrdSysLogger logger;
+XrdSysError  eDest(&logger, "NetMsgQueueTest");
+
+// A local UDP sink that records everything it receives
+class Sink
+{
+public:
+  Sink()
+  {
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int rbsz = 4 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rbsz, sizeof(rbsz));
+    socklen_t rlen = sizeof(rbsz);
+    getsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rbsz, &rlen);
+    // Allow for the kernel's per-datagram overhead on the loopback device
+    window = rbsz / 2048;
+    if (window < 8) window = 8;
+
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family      = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, (sockaddr *)&sa, sizeof(sa));
+    socklen_t slen = sizeof(sa);
+    getsockname(fd, (sockaddr *)&sa, &slen);
+    char buff[64];
+    snprintf(buff, sizeof(buff), "127.0.0.1:%d", ntohs(sa.sin_port));
+    dest = buff;
+
+    reader = std::thread([this] { Read(); });
+  }
+
+  ~Sink()
+  {
+    stop = true;
+    reader.join();
+    close(fd);
+  }
+
+  // Wait until n messages arrived or nothing arrived for a while
+  void WaitFor(int n)
+  {
+    int last = -1;
+    while (received.load() < n && received.load() != last)
+    {
+      last = received.load();
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+  }
+
+  std::vector<TestMsg> msgs;   // only read after WaitFor()
+  std::atomic<int>     received{0};
+  std::string          dest;
+  int                  window;
+
+private:
+  void Read()
+  {
+    pollfd pfd = {fd, POLLIN, 0};
+    TestMsg msg;
+    while (!stop)
+    {
+      if (poll(&pfd, 1, 50) <= 0) continue;
+      if (recv(fd, &msg, sizeof(msg), 0) != (ssize_t)sizeof(msg)) continue;
+      msgs.push_back(msg);
+      received++;
+    }
+  }
+
+  int               fd;
+  std::atomic<bool> stop{false};
+  std::thread       reader;
+};
+
+TestMsg MakeMsg(int producer, uint32_t counter)
+{
+  TestMsg msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.code     = 'r';
+  msg.producer = producer;
+  msg.counter  = counter;
+  return msg;
+}
+}
+
+TEST(XrdNetMsgQueueTests, NoLossNoReorder)
+{
+  const int nProducers = 4, nPerProducer = 5000;
+  Sink sink;
+  XrdNetMsg *dest = new XrdNetMsg(&eDest, sink.dest.c_str());
+  // A small ring so that producers regularly find it full
+  XrdNetMsgQueue *queue = new XrdNetMsgQueue(&eDest, 64, 1);
+  ASSERT_EQ(queue->AddDest(dest), 0);
+
+  // Producers keep no more messages in flight than the sink's socket buffer
+  // holds as UDP gives no flow control of its own.
+  std::atomic<int> queued{0};
+  std::vector<std::thread> producers;
+  for (int p = 0; p < nProducers; p++)
+    producers.emplace_back([&, p] {
+      for (int i = 0; i < nPerProducer; i++)
+      {
+        while (queued.load() - sink.received.load() >= sink.window)
+          std::this_thread::yield();
+        TestMsg msg = MakeMsg(p, i);
+        queued++;
+        ASSERT_TRUE(queue->Send(1, (const char *)&msg, sizeof(msg)));
+      }
+    });
+  for (auto &t : producers) t.join();
+  queue->Drain();
+  sink.WaitFor(nProducers * nPerProducer);
+
+  ASSERT_EQ(sink.received.load(), nProducers * nPerProducer);
+
+  // Packets are numbered in the order they were sent, and each producer's
+  // messages arrive in the order they were queued.
+  std::vector<uint32_t> next(nProducers, 0);
+  unsigned char pseq = 0;
+  for (const TestMsg &msg : sink.msgs)
+  {
+    ASSERT_EQ(msg.pseq, pseq++);
+    ASSERT_LT(msg.producer, nProducers);
+    ASSERT_EQ(msg.counter, next[msg.producer]++);
+  }
+
+  XrdNetMsgQueue::Stats st;
+  queue->GetStats(st);
+  EXPECT_EQ(st.msgsQueued, nProducers * nPerProducer);
+  EXPECT_EQ(st.msgsSent,   nProducers * nPerProducer);
+  EXPECT_EQ(st.sendErrs,   0);
+  EXPECT_LE(st.sendCalls,  st.msgsSent);
+  printf("%lld messages sent with %lld calls, ring full %lld times\n",
+         st.msgsSent, st.sendCalls, st.fullWaits);
+}
+
+TEST(XrdNetMsgQueueTests, DestinationsAreNumberedSeparately)
+{
+  Sink sink1, sink2;
+  XrdNetMsg *dest1 = new XrdNetMsg(&eDest, sink1.dest.c_str());
+  XrdNetMsg *dest2 = new XrdNetMsg(&eDest, sink2.dest.c_str());
+  XrdNetMsgQueue *queue = new XrdNetMsgQueue(&eDest, 128, 1);
+  ASSERT_EQ(queue->AddDest(dest1), 0);
+  ASSERT_EQ(queue->AddDest(dest2), 1);
+
+  // Messages go to the first, the second, or both destinations in turn;
+  // the last ones are not numbered.
+  for (int i = 0; i < 300; i++)
+  {
+    TestMsg msg = MakeMsg(0, i);
+    msg.pseq = 0xee;
+    queue->Send(1 + i % 3, (const char *)&msg, sizeof(msg), i < 270);
+  }
+  EXPECT_FALSE(queue->Send(0, "x", 1));
+  queue->Drain();
+  sink1.WaitFor(200);
+  sink2.WaitFor(200);
+
+  ASSERT_EQ(sink1.received.load(), 200);
+  ASSERT_EQ(sink2.received.load(), 200);
+
+  unsigned char pseq = 0;
+  for (const TestMsg &msg : sink1.msgs)
+  {
+    EXPECT_NE(msg.counter % 3, 1u);
+    EXPECT_EQ(msg.pseq, msg.counter < 270 ? pseq++ : 0xee);
+  }
+  pseq = 0;
+  for (const TestMsg &msg : sink2.msgs)
+  {
+    EXPECT_NE(msg.counter % 3, 0u);
+    EXPECT_EQ(msg.pseq, msg.counter < 270 ? pseq++ : 0xee);
+  }
+}
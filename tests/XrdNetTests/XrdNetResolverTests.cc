@@ -0,0 +1,173 @@
+#undef NDEBUG
+
+#include "XrdNet/XrdNetAddr.hh"
+#include "XrdNet/XrdNetCache.hh"
+#include "XrdNet/XrdNetResolver.hh"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Stub DNS used in place of getnameinfo(). It answers after a delay, knows
+// only addresses in 10.1.0.0/16 and times out for those in 10.2.0.0/16.
+namespace
+{
+std::atomic<int> stubQueries{0};
+std::atomic<int> stubDelayMS{0};
+
+int StubDNS(const struct sockaddr *sAddr, SOCKLEN_t, char *hBuff, int hBLen)
+{
+  stubQueries++;
+  std::this_thread::sleep_for(std::chrono::milliseconds(stubDelayMS.load()));
+
+  const sockaddr_in *s4 = (const sockaddr_in *)sAddr;
+  unsigned int ip = ntohl(s4->sin_addr.s_addr);
+  if ((ip >> 16) == ((10u << 8) | 2u)) return EAI_AGAIN;
+  if ((ip >> 16) != ((10u << 8) | 1u)) return EAI_NONAME;
+
+  snprintf(hBuff, hBLen, "Host-%u.Example.ORG", ip & 0xffff);
+  return 0;
+}
+
+XrdNetAddr MakeAddr(const char *ip)
+{
+  sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_port   = htons(1094);
+  inet_pton(AF_INET, ip, &sa.sin_addr);
+  return XrdNetAddr(&sa);
+}
+}
+
+TEST(XrdNetResolverTests, ResolvesAndCaches)
+{
+  XrdNetCache::SetKT(3600);
+  XrdNetCache *cache = new XrdNetCache;
+  XrdNetResolver *res = new XrdNetResolver(cache, 2, -1, StubDNS);
+  stubQueries = 0; stubDelayMS = 0;
+
+  XrdNetAddr addr = MakeAddr("10.1.0.7");
+  char hBuff[NI_MAXHOST];
+  ASSERT_EQ(res->Lookup(addr, hBuff, sizeof(hBuff)), 0);
+  EXPECT_STREQ(hBuff, "host-7.example.org");
+
+  char *cached = cache->Find(&addr);
+  ASSERT_NE(cached, nullptr);
+  EXPECT_STREQ(cached, "host-7.example.org");
+  free(cached);
+  EXPECT_EQ(stubQueries.load(), 1);
+}
+
+TEST(XrdNetResolverTests, CoalescesConcurrentLookups)
+{
+  XrdNetCache *cache = new XrdNetCache;
+  XrdNetResolver *res = new XrdNetResolver(cache, 4, -1, StubDNS);
+  stubQueries = 0; stubDelayMS = 200;
+
+  std::vector<std::thread> threads;
+  std::atomic<int> good{0};
+  for (int i = 0; i < 16; i++)
+    threads.emplace_back([&] {
+      XrdNetAddr addr = MakeAddr("10.1.0.9");
+      char hBuff[NI_MAXHOST];
+      if (!res->Lookup(addr, hBuff, sizeof(hBuff))
+      &&  !strcmp(hBuff, "host-9.example.org")) good++;
+    });
+  for (auto &t : threads) t.join();
+
+  EXPECT_EQ(good.load(), 16);
+  EXPECT_EQ(stubQueries.load(), 1);
+}
+
+TEST(XrdNetResolverTests, NumericAddressWhileResolving)
+{
+  XrdNetCache::SetKT(3600);
+  XrdNetCache *cache = new XrdNetCache;
+  XrdNetResolver *res = new XrdNetResolver(cache, 1, 0, StubDNS);
+  stubQueries = 0; stubDelayMS = 100;
+
+  XrdNetAddr addr = MakeAddr("10.1.0.11");
+  char hBuff[NI_MAXHOST];
+  EXPECT_EQ(res->Lookup(addr, hBuff, sizeof(hBuff)), EAI_AGAIN);
+  EXPECT_EQ(cache->Find(&addr), nullptr);
+
+  // The lookup completes in the background and fills the cache
+  char *cached = 0;
+  for (int i = 0; i < 50 && !(cached = cache->Find(&addr)); i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_NE(cached, nullptr);
+  EXPECT_STREQ(cached, "host-11.example.org");
+  free(cached);
+  EXPECT_EQ(stubQueries.load(), 1);
+}
+
+TEST(XrdNetResolverTests, BoundedWait)
+{
+  XrdNetCache *cache = new XrdNetCache;
+  XrdNetResolver *res = new XrdNetResolver(cache, 1, 50, StubDNS);
+  stubQueries = 0; stubDelayMS = 500;
+
+  XrdNetAddr addr = MakeAddr("10.1.0.12");
+  char hBuff[NI_MAXHOST];
+  auto t0 = std::chrono::steady_clock::now();
+  EXPECT_EQ(res->Lookup(addr, hBuff, sizeof(hBuff)), EAI_AGAIN);
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - t0).count();
+  EXPECT_LT(ms, 400);
+}
+
+TEST(XrdNetResolverTests, NegativeEntries)
+{
+  XrdNetCache::SetKT(3600);
+  XrdNetCache::SetNKT(600);
+  XrdNetCache *cache = new XrdNetCache;
+  XrdNetResolver *res = new XrdNetResolver(cache, 2, -1, StubDNS);
+  stubQueries = 0; stubDelayMS = 0;
+
+  char hBuff[NI_MAXHOST];
+  for (const char *ip : {"10.2.0.1", "10.3.0.1"}) {
+    XrdNetAddr addr = MakeAddr(ip);
+    EXPECT_NE(res->Lookup(addr, hBuff, sizeof(hBuff)), 0);
+    char *cached = cache->Find(&addr);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_STREQ(cached, ip);
+    free(cached);
+  }
+  EXPECT_EQ(stubQueries.load(), 2);
+
+  // Without a negative keep time failures are not remembered
+  XrdNetCache::SetNKT(0);
+  XrdNetAddr addr = MakeAddr("10.2.0.2");
+  EXPECT_NE(res->Lookup(addr, hBuff, sizeof(hBuff)), 0);
+  EXPECT_EQ(cache->Find(&addr), nullptr);
+  XrdNetCache::SetNKT(600);
+}
+
+TEST(XrdNetResolverTests, ShardedCache)
+{
+  XrdNetCache::SetKT(3600);
+  XrdNetCache *cache = new XrdNetCache(2, 3);
+
+  for (int i = 0; i < 5000; i++) {
+    std::string ip = "10.9." + std::to_string(i / 256) + "." + std::to_string(i % 256);
+    XrdNetAddr addr = MakeAddr(ip.c_str());
+    cache->Add(&addr, ("h" + std::to_string(i)).c_str());
+  }
+  for (int i = 0; i < 5000; i++) {
+    std::string ip = "10.9." + std::to_string(i / 256) + "." + std::to_string(i % 256);
+    XrdNetAddr addr = MakeAddr(ip.c_str());
+    char *name = cache->Find(&addr);
+    ASSERT_NE(name, nullptr);
+    EXPECT_EQ(std::string(name), "h" + std::to_string(i));
+    free(name);
+  }
+}
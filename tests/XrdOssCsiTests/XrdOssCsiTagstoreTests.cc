@@ -0,0 +1,262 @@
+#undef NDEBUG
+
+#include "XrdOssCsi/XrdOssCsiTagstoreFile.hh"
+#include "XrdOssCsi/XrdOssCsiTrace.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+static XrdSysLogger  logger;
+static XrdSysError   eroute(&logger, "csitest_");
+XrdOucTrace          OssCsiTrace(&eroute);
+
+namespace
+{
+// An in-memory file whose contents outlive the handle, so that the state left
+// behind after a "crash" (dropping the handle without close) can be inspected.
+struct MemStore
+{
+  std::vector<uint8_t> data;
+  int reads = 0;
+  int writes = 0;
+  bool failWrites = false;
+};
+
+class MemFile : public XrdOssDF
+{
+public:
+  MemFile(std::shared_ptr<MemStore> st) : st_(st) {}
+
+  int Open(const char *, int, mode_t, XrdOucEnv &) override { return 0; }
+  int Close(long long * = 0) override { return 0; }
+  int Fsync() override { return 0; }
+  int Fstat(struct stat *buf) override
+  {
+    memset(buf, 0, sizeof(*buf));
+    buf->st_size = st_->data.size();
+    return 0;
+  }
+  int Ftruncate(unsigned long long flen) override
+  {
+    st_->data.resize(flen, 0);
+    return 0;
+  }
+  ssize_t Read(void *buff, off_t off, size_t sz) override
+  {
+    st_->reads++;
+    if ((size_t)off >= st_->data.size()) return 0;
+    const size_t n = std::min(sz, st_->data.size() - off);
+    memcpy(buff, &st_->data[off], n);
+    return n;
+  }
+  ssize_t Write(const void *buff, off_t off, size_t sz) override
+  {
+    st_->writes++;
+    if (st_->failWrites) return -EIO;
+    if (st_->data.size() < off + sz) st_->data.resize(off + sz, 0);
+    memcpy(&st_->data[off], buff, sz);
+    return sz;
+  }
+
+private:
+  std::shared_ptr<MemStore> st_;
+};
+
+const off_t pgSize = XrdSys::PageSize;
+
+std::unique_ptr<XrdOssCsiTagstoreFile> OpenTS(std::shared_ptr<MemStore> st,
+                                              off_t dsize, size_t cache,
+                                              bool wb)
+{
+  XrdOucEnv env;
+  std::unique_ptr<XrdOssCsiTagstoreFile> ts(new XrdOssCsiTagstoreFile(
+      "/test", std::unique_ptr<XrdOssDF>(new MemFile(st)), "test", cache, wb));
+  EXPECT_EQ(ts->Open("/test.xrdt", dsize, O_RDWR | O_CREAT, env), 0);
+  return ts;
+}
+
+std::vector<uint32_t> Tags(size_t n, uint32_t seed)
+{
+  std::vector<uint32_t> v(n);
+  for (size_t i = 0; i < n; i++) v[i] = seed * 0x9e3779b9U + i;
+  return v;
+}
+} // namespace
+
+class XrdOssCsiTagstoreTests : public ::testing::TestWithParam<std::pair<size_t, bool>> {};
+
+TEST_P(XrdOssCsiTagstoreTests, ReadBackAndReopen)
+{
+  auto st = std::make_shared<MemStore>();
+  const size_t cache = GetParam().first;
+  const bool wb = GetParam().second;
+  const size_t ntags = 5000;
+  std::vector<uint32_t> tags = Tags(ntags, 1), rd(ntags);
+
+  {
+    auto ts = OpenTS(st, 0, cache, wb);
+    // scattered writes spanning several cache blocks, some overlapping
+    for (size_t off = 0; off < ntags; off += 700)
+      EXPECT_EQ(ts->WriteTags(&tags[off], off, std::min<size_t>(700, ntags - off)),
+                (ssize_t)std::min<size_t>(700, ntags - off));
+    EXPECT_EQ(ts->WriteTags(&tags[1000], 1000, 3000), 3000);
+    EXPECT_EQ(ts->SetTrackedSize(ntags * pgSize), 0);
+    EXPECT_EQ(ts->ReadTags(rd.data(), 0, ntags), (ssize_t)ntags);
+    EXPECT_EQ(rd, tags);
+    EXPECT_EQ(ts->ReadTags(rd.data(), ntags - 1, 2), -EDOM);
+    EXPECT_EQ(ts->Close(), 0);
+  }
+
+  auto ts = OpenTS(st, ntags * pgSize, cache, wb);
+  EXPECT_EQ(ts->GetTrackedTagSize(), (off_t)(ntags * pgSize));
+  std::fill(rd.begin(), rd.end(), 0);
+  EXPECT_EQ(ts->ReadTags(rd.data(), 0, ntags), (ssize_t)ntags);
+  EXPECT_EQ(rd, tags);
+
+  // shrink and grow again: the dropped tags must read back as zero
+  EXPECT_EQ(ts->Truncate(1500 * pgSize + 1, true), 0);
+  EXPECT_EQ(ts->Truncate(2000 * pgSize, true), 0);
+  EXPECT_EQ(ts->ReadTags(rd.data(), 0, 2000), 2000);
+  for (size_t i = 0; i < 2000; i++) EXPECT_EQ(rd[i], i < 1501 ? tags[i] : 0U) << i;
+  EXPECT_EQ(ts->Close(), 0);
+  EXPECT_EQ(st->data.size(), 20U + 4 * 2000);
+}
+
+INSTANTIATE_TEST_SUITE_P(CacheModes, XrdOssCsiTagstoreTests,
+                         ::testing::Values(std::make_pair(0, false),
+                                           std::make_pair(2, false),
+                                           std::make_pair(16, false),
+                                           std::make_pair(2, true),
+                                           std::make_pair(16, true)));
+
+TEST(XrdOssCsiTagCache, ReadsServedFromCache)
+{
+  // Count the tag file I/Os for small random reads with and without the cache
+  const size_t ntags = 4096;
+  std::vector<uint32_t> tags = Tags(ntags, 2);
+  int reads[2];
+
+  for (int c = 0; c < 2; c++)
+  {
+    auto st = std::make_shared<MemStore>();
+    auto ts = OpenTS(st, 0, c ? 16 : 0, false);
+    EXPECT_EQ(ts->WriteTags(tags.data(), 0, ntags), (ssize_t)ntags);
+    EXPECT_EQ(ts->SetTrackedSize(ntags * pgSize), 0);
+    st->reads = 0;
+    uint32_t v;
+    for (size_t i = 0; i < 1000; i++)
+    {
+      const size_t idx = (i * 7919) % ntags;
+      EXPECT_EQ(ts->ReadTags(&v, idx, 1), 1);
+      EXPECT_EQ(v, tags[idx]);
+    }
+    reads[c] = st->reads;
+    EXPECT_EQ(ts->Close(), 0);
+  }
+  EXPECT_EQ(reads[0], 1000);
+  EXPECT_LE(reads[1], 4);
+}
+
+TEST(XrdOssCsiTagCache, WriteBackCoalesces)
+{
+  auto st = std::make_shared<MemStore>();
+  auto ts = OpenTS(st, 0, 16, true);
+  const int hdrWrites = st->writes;
+  std::vector<uint32_t> tags = Tags(2048, 3);
+
+  // page-at-a-time appends, as for a sequential writer
+  for (size_t i = 0; i < 2048; i++)
+  {
+    EXPECT_EQ(ts->WriteTags(&tags[i], i, 1), 1);
+    EXPECT_EQ(ts->SetTrackedSize((i + 1) * pgSize), 0);
+  }
+  EXPECT_EQ(st->writes, hdrWrites);
+  EXPECT_EQ(ts->Fsync(), 0);
+  // one write per dirty block followed by the header
+  EXPECT_EQ(st->writes, hdrWrites + 3);
+  EXPECT_EQ(ts->Close(), 0);
+}
+
+TEST(XrdOssCsiTagCache, CrashConsistency)
+{
+  // After a crash, i.e. the handle is lost without close, the tag file must
+  // never have a header whose tracked length covers tags not yet written. It
+  // must reflect at least everything up to the last Fsync.
+  auto st = std::make_shared<MemStore>();
+  std::vector<uint32_t> tags = Tags(6000, 4), rd(6000);
+  std::vector<uint8_t> image;
+
+  {
+    auto ts = OpenTS(st, 0, 2, true);
+    EXPECT_EQ(ts->WriteTags(tags.data(), 0, 3000), 3000);
+    EXPECT_EQ(ts->SetTrackedSize(3000 * pgSize), 0);
+    EXPECT_EQ(ts->Fsync(), 0);
+
+    // more appends, enough to force evictions of dirty blocks
+    for (size_t i = 3000; i < 6000; i += 100)
+    {
+      EXPECT_EQ(ts->WriteTags(&tags[i], i, 100), 100);
+      EXPECT_EQ(ts->SetTrackedSize((i + 100) * pgSize), 0);
+    }
+
+    // the crash: take the on-disk image while the handle still holds dirty
+    // state; the header written at the last flush point must be intact
+    image = st->data;
+  }
+
+  auto crashed = std::make_shared<MemStore>();
+  crashed->data = image;
+  uint64_t tracked;
+  memcpy(&tracked, &image[4], 8);
+  EXPECT_GE(tracked, 3000U * pgSize);
+  EXPECT_LE(20 + 4 * ((tracked + pgSize - 1) / pgSize), image.size());
+
+  auto ts = OpenTS(crashed, tracked, 2, true);
+  EXPECT_EQ(ts->GetTrackedTagSize(), (off_t)tracked);
+  const size_t n = tracked / pgSize;
+  EXPECT_EQ(ts->ReadTags(rd.data(), 0, n), (ssize_t)n);
+  for (size_t i = 0; i < n; i++) EXPECT_EQ(rd[i], tags[i]) << i;
+  EXPECT_EQ(ts->Close(), 0);
+}
+
+TEST(XrdOssCsiTagCache, FlushErrorsAreReported)
+{
+  auto st = std::make_shared<MemStore>();
+  std::vector<uint32_t> tags = Tags(100, 5), rd(100);
+
+  // a failure during Flush is reported once, by the next Fsync
+  {
+    auto ts = OpenTS(st, 0, 16, true);
+    EXPECT_EQ(ts->WriteTags(tags.data(), 0, 100), 100);
+    EXPECT_EQ(ts->SetTrackedSize(100 * pgSize), 0);
+    st->failWrites = true;
+    ts->Flush();
+    st->failWrites = false;
+    EXPECT_EQ(ts->Fsync(), -EIO);
+    EXPECT_EQ(ts->Fsync(), 0);
+    EXPECT_EQ(ts->Close(), 0);
+  }
+
+  // or by Close, and the tags still reach the file once writes succeed
+  {
+    auto ts = OpenTS(st, 100 * pgSize, 16, true);
+    EXPECT_EQ(ts->WriteTags(tags.data(), 0, 50), 50);
+    st->failWrites = true;
+    ts->Flush();
+    st->failWrites = false;
+    EXPECT_EQ(ts->Close(), -EIO);
+  }
+
+  auto ts = OpenTS(st, 100 * pgSize, 0, false);
+  EXPECT_EQ(ts->ReadTags(rd.data(), 0, 100), 100);
+  EXPECT_EQ(rd, tags);
+  EXPECT_EQ(ts->Close(), 0);
+}
@@ -0,0 +1,226 @@
+#undef NDEBUG
+
+#include "XrdOss/XrdOssCache.hh"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Simulates file placement on a server with a dozen data disks. The disks are
+// defined as usual via XrdOssCache_FS but each is given its own simulated
+// partition data so that they look like separate devices. Files arrive at a
+// steady rate, are placed by XrdOssCache::Alloc(), and then share the write
+// bandwidth of their disk until written. The OSS load counters are updated as
+// XrdOssFile does, using the simulated write latency.
+namespace
+{
+const int       nDisks   = 12;
+const long long GB       = 1024LL * 1024 * 1024;
+const long long fileSize = 4 * GB;
+const double    diskMBs  = 200.0;   // bandwidth of each disk
+const double    chunkMB  = 8.0;     // size of each write
+const int       interval = 3;       // seconds between new files (60% busy)
+const int       simSecs  = 3600;
+
+struct Disk
+{
+  XrdOssCache_FSData *fsd;
+  long long           free;      // initial free space
+  std::vector<double> left;      // MB left to write per open file
+  double              writerSecs = 0;
+  int                 maxWriters = 0;
+  int                 files      = 0;
+};
+
+std::vector<Disk> disks;
+
+// Create the disks once; the OSS cache tables are never torn down
+void MakeDisks()
+{
+  if (!disks.empty()) return;
+  char base[] = "/tmp/xrdosscache-XXXXXX";
+  ASSERT_NE(mkdtemp(base), nullptr);
+
+  for (int i = 0; i < nDisks; i++)
+  {
+    std::string path = std::string(base) + "/disk" + std::to_string(i);
+    ASSERT_EQ(mkdir(path.c_str(), 0755), 0);
+    int rc;
+    XrdOssCache_FS *fsp = new XrdOssCache_FS(rc, "public", path.c_str(),
+                                             XrdOssCache_FS::None);
+    ASSERT_EQ(rc, 0);
+
+    // The first disk is the emptiest, the others are progressively fuller
+    Disk disk;
+    disk.free = (i ? 12 - i / 2 : 16) * 1024 * GB;
+    STATFS_t fsb;
+    memset(&fsb, 0, sizeof(fsb));
+    fsb.FS_BLKSZ = 4096;
+    fsb.f_blocks = 20 * 1024 * GB / 4096;
+    fsb.f_bavail = disk.free / 4096;
+    fsp->fsdata = disk.fsd = new XrdOssCache_FSData(path.c_str(), fsb, 1000 + i);
+    disks.push_back(disk);
+  }
+}
+
+void Reset()
+{
+  for (Disk &disk : disks)
+  {
+    disk.fsd->frsz   = disk.free;
+    disk.fsd->wrOpen = 0;
+    disk.fsd->wrBusy = 0;
+    disk.fsd->wrLatc = 0;
+    disk.left.clear();
+    disk.writerSecs = 0;
+    disk.maxWriters = 0;
+    disk.files      = 0;
+  }
+}
+
+int Place(const char *lfn)
+{
+  char pfn[1024];
+  XrdOssCache::allocInfo aInfo(lfn, pfn, sizeof(pfn));
+  aInfo.cgName = "public";
+  aInfo.cgSize = fileSize;
+  EXPECT_EQ(XrdOssCache::Alloc(aInfo), 0);
+  for (int i = 0; i < nDisks; i++)
+    if (aInfo.cgFSp && aInfo.cgFSp->fsdata == disks[i].fsd) return i;
+  ADD_FAILURE() << "file placed on an unknown disk";
+  return 0;
+}
+
+// Record one write of chunkMB that took as long as sharing the disk implies
+void Write(Disk &disk)
+{
+  long long usec = static_cast<long long>(chunkMB / diskMBs * 1e6)
+                 * static_cast<long long>(disk.left.size());
+  long long tBeg = disk.fsd->WriteBeg();
+  disk.fsd->WriteEnd(tBeg - usec);
+}
+
+struct Result
+{
+  double meanXfer;   // average seconds to write a file
+  double imbalance;  // max/mean of the average writers per disk
+  int    maxWriters;
+  int    disksUsed;
+};
+
+Result Simulate(int loadWeight)
+{
+  XrdOssCache::Init(0, 0, 0, loadWeight);
+  Reset();
+
+  std::map<int, std::vector<int>> startOf;   // disk -> file start times
+  double totXfer = 0;
+  int done = 0;
+
+  for (int t = 0; t < simSecs; t++)
+  {
+    if (!(t % interval))
+    {
+      Disk &disk = disks[Place("/store/file")];
+      disk.fsd->wrOpen++;
+      disk.left.push_back(fileSize / (1024.0 * 1024.0));
+      startOf[&disk - &disks[0]].push_back(t);
+      disk.files++;
+    }
+
+    for (int d = 0; d < nDisks; d++)
+    {
+      Disk &disk = disks[d];
+      int n = static_cast<int>(disk.left.size());
+      if (!n) continue;
+      disk.writerSecs += n;
+      if (n > disk.maxWriters) disk.maxWriters = n;
+      Write(disk);
+      std::vector<int> &starts = startOf[d];
+      for (size_t f = 0; f < disk.left.size();)
+      {
+        if ((disk.left[f] -= diskMBs / n) > 0) {f++; continue;}
+        totXfer += t + 1 - starts[f];
+        done++;
+        disk.left.erase(disk.left.begin() + f);
+        starts.erase(starts.begin() + f);
+        disk.fsd->wrOpen--;
+      }
+    }
+  }
+
+  Result res = {0, 0, 0, 0};
+  double sum = 0, peak = 0;
+  for (Disk &disk : disks)
+  {
+    double avg = disk.writerSecs / simSecs;
+    sum += avg;
+    if (avg > peak) peak = avg;
+    if (disk.maxWriters > res.maxWriters) res.maxWriters = disk.maxWriters;
+    if (disk.files) res.disksUsed++;
+  }
+  res.meanXfer  = (done ? totXfer / done : 0);
+  res.imbalance = peak / (sum / nDisks);
+  return res;
+}
+}
+
+TEST(XrdOssCacheAllocTests, FreeSpaceOnlyWhenLoadIgnored)
+{
+  MakeDisks();
+  XrdOssCache::Init(0, 0, 0, 0);
+  Reset();
+
+  // Load does not matter: the emptiest disk is chosen even when busy
+  disks[0].fsd->wrOpen = 50;
+  disks[0].fsd->wrLatc = 1000000;
+  EXPECT_EQ(Place("/f"), 0);
+
+  // With load considered, an idle disk that is nearly as empty wins
+  XrdOssCache::Init(0, 0, 0, 50);
+  EXPECT_NE(Place("/f"), 0);
+
+  // Equally loaded disks are chosen by free space alone
+  Reset();
+  EXPECT_EQ(Place("/f"), 0);
+}
+
+TEST(XrdOssCacheAllocTests, LoadIsSpreadAcrossDisks)
+{
+  MakeDisks();
+
+  printf("%d disks at %.0f MB/s, a %lld GB file every %d seconds\n",
+         nDisks, diskMBs, fileSize / GB, interval);
+  printf("load weight  mean write (s)  max/mean busy  max writers  disks used\n");
+  std::vector<Result> results;
+  for (int weight : {0, 25, 50, 100})
+  {
+    Result res = Simulate(weight);
+    printf("%11d  %14.1f  %13.2f  %11d  %10d\n", weight, res.meanXfer,
+           res.imbalance, res.maxWriters, res.disksUsed);
+    results.push_back(res);
+  }
+
+  // Placing by free space alone piles nearly everything onto the emptiest disk
+  EXPECT_LE(results[0].disksUsed, 2);
+  EXPECT_GT(results[0].maxWriters, 100);
+
+  // A light load weight only helps disks with nearly as much free space. With
+  // enough weight every disk is used, no disk gets more than a few writers,
+  // and files are written many times sooner.
+  for (size_t i = 2; i < results.size(); i++)
+  {
+    EXPECT_EQ(results[i].disksUsed, nDisks);
+    EXPECT_LE(results[i].maxWriters, 4);
+    EXPECT_LT(results[i].meanXfer, results[0].meanXfer / 4);
+  }
+}
@@ -0,0 +1,107 @@
+#undef NDEBUG
+
+#include "XrdOuc/XrdOucCRC.hh"
+#include "XrdOuc/XrdOucCRC32C.hh"
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class XrdOucCRCTests : public ::testing::Test {};
+
+static std::vector<uint8_t> MakeData(size_t len)
+{
+  std::vector<uint8_t> data(len);
+  for (size_t i = 0; i < len; i++)
+    data[i] = (uint8_t)((i * 2654435761U) >> 13);
+  return data;
+}
+
+TEST(XrdOucCRCTests, KnownValue)
+{
+  const char *check = "123456789";
+  EXPECT_EQ(XrdOucCRC::Calc32C(check, 9), 0xe3069283U);
+  EXPECT_EQ(crc32c_sw(0, check, 9), 0xe3069283U);
+}
+
+TEST(XrdOucCRCTests, MultiPageMatchesSinglePage)
+{
+  const size_t pgsz = XrdSys::PageSize;
+
+  // Cover fewer pages than one interleaved batch, exact batches, leftovers
+  // and a trailing partial page.
+  for (size_t npages : {1, 7, 8, 9, 17, 64, 65, 257}) {
+    for (size_t tail : {(size_t)0, (size_t)1, pgsz - 1}) {
+      std::vector<uint8_t> data = MakeData(npages * pgsz + tail);
+      size_t ncs = npages + (tail != 0);
+      std::vector<uint32_t> csvec(ncs), expect(ncs);
+
+      for (size_t i = 0; i < npages; i++)
+        expect[i] = crc32c_sw(0, data.data() + i * pgsz, pgsz);
+      if (tail) expect[npages] = crc32c_sw(0, data.data() + npages * pgsz, tail);
+
+      XrdOucCRC::Calc32C(data.data(), data.size(), csvec.data());
+      EXPECT_EQ(csvec, expect) << npages << " pages, tail " << tail;
+
+      // Unaligned buffers must give the same result
+      std::vector<uint8_t> odd(data.size() + 3);
+      std::copy(data.begin(), data.end(), odd.begin() + 3);
+      std::vector<uint32_t> oddvec(ncs);
+      crc32c_pages(odd.data() + 3, pgsz, npages, oddvec.data());
+      for (size_t i = 0; i < npages; i++)
+        EXPECT_EQ(oddvec[i], expect[i]) << "page " << i;
+    }
+  }
+}
+
+TEST(XrdOucCRCTests, MultiPageVerify)
+{
+  const size_t pgsz = XrdSys::PageSize;
+  const size_t npages = 150;
+  std::vector<uint8_t> data = MakeData(npages * pgsz + 100);
+  std::vector<uint32_t> csvec(npages + 1), valcs(npages + 1);
+  std::vector<char> valok(npages + 1);
+  uint32_t badcs = 0;
+
+  XrdOucCRC::Calc32C(data.data(), data.size(), csvec.data());
+  EXPECT_EQ(XrdOucCRC::Ver32C(data.data(), data.size(), csvec.data(), badcs), -1);
+  EXPECT_TRUE(XrdOucCRC::Ver32C(data.data(), data.size(), csvec.data(),
+                                (bool *)valok.data()));
+  EXPECT_TRUE(XrdOucCRC::Ver32C(data.data(), data.size(), csvec.data(),
+                                valcs.data()));
+  EXPECT_EQ(valcs, csvec);
+
+  // Corrupt pages in the second batch and in the trailing partial page
+  data[70 * pgsz + 5] ^= 0x01;
+  data[130 * pgsz + 9] ^= 0x80;
+  data[npages * pgsz + 1] ^= 0x10;
+
+  EXPECT_EQ(XrdOucCRC::Ver32C(data.data(), data.size(), csvec.data(), badcs), 70);
+  EXPECT_EQ(badcs, crc32c_sw(0, data.data() + 70 * pgsz, pgsz));
+
+  EXPECT_FALSE(XrdOucCRC::Ver32C(data.data(), data.size(), csvec.data(),
+                                 (bool *)valok.data()));
+  for (size_t i = 0; i <= npages; i++)
+    EXPECT_EQ((bool)valok[i], !(i == 70 || i == 130 || i == npages)) << i;
+
+  EXPECT_FALSE(XrdOucCRC::Ver32C(data.data(), data.size(), csvec.data(),
+                                 valcs.data()));
+  EXPECT_NE(valcs[130], csvec[130]);
+  EXPECT_EQ(valcs[129], csvec[129]);
+}
+
+TEST(XrdOucCRCTests, Combine)
+{
+  std::vector<uint8_t> data = MakeData(100000);
+  const uint32_t whole = crc32c(0, data.data(), data.size());
+
+  for (size_t split : {size_t(0), size_t(1), size_t(4095), size_t(50000),
+                       data.size() - 1, data.size()})
+  {
+    uint32_t crc1 = crc32c(0, data.data(), split);
+    uint32_t crc2 = crc32c(0, data.data() + split, data.size() - split);
+    EXPECT_EQ(crc32c_combine(crc1, crc2, data.size() - split), whole)
+      << "split at " << split;
+  }
+}
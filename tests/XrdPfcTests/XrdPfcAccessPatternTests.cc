@@ -0,0 +1,62 @@
+#include "XrdPfc/XrdPfcAccessPattern.hh"
+
+#include <gtest/gtest.h>
+
+using namespace XrdPfc;
+
+TEST(AccessPatternTest, Forward)
+{
+    AccessPattern ap;
+    ap.Record(0, 0);
+    ap.Record(0, 1);
+    EXPECT_EQ(ap.GetKind(), AccessPattern::kUnknown);
+    EXPECT_EQ(ap.Next(0), -1);
+    ap.Record(2, 3);
+    ASSERT_EQ(ap.GetKind(), AccessPattern::kForward);
+    EXPECT_EQ(ap.Next(0), 4);
+    EXPECT_EQ(ap.Next(5), 9);
+
+    // Repeated reads within the same blocks keep the pattern.
+    ap.Record(2, 3);
+    EXPECT_EQ(ap.GetKind(), AccessPattern::kForward);
+}
+
+TEST(AccessPatternTest, Backward)
+{
+    AccessPattern ap;
+    ap.Record(10, 10);
+    ap.Record(9, 9);
+    ap.Record(7, 8);
+    ASSERT_EQ(ap.GetKind(), AccessPattern::kBackward);
+    EXPECT_EQ(ap.Next(0), 6);
+    EXPECT_EQ(ap.Next(6), 0);
+    EXPECT_EQ(ap.Next(7), -1);
+}
+
+TEST(AccessPatternTest, Strided)
+{
+    AccessPattern ap;
+    ap.Record(0, 1);
+    ap.Record(10, 11);
+    ap.Record(20, 21);
+    ASSERT_EQ(ap.GetKind(), AccessPattern::kStrided);
+    EXPECT_EQ(ap.GetStride(), 10);
+    EXPECT_EQ(ap.Next(0), 30);
+    EXPECT_EQ(ap.Next(1), 31);
+    EXPECT_EQ(ap.Next(2), 40);
+
+    // A different stride has to be confirmed again.
+    ap.Record(25, 26);
+    EXPECT_EQ(ap.GetKind(), AccessPattern::kUnknown);
+    ap.Record(30, 31);
+    EXPECT_EQ(ap.GetKind(), AccessPattern::kStrided);
+    EXPECT_EQ(ap.Next(0), 35);
+}
+
+TEST(AccessPatternTest, Random)
+{
+    AccessPattern ap;
+    for (int idx : { 17, 3, 42, 8, 99, 0, 55 })
+        ap.Record(idx, idx);
+    EXPECT_EQ(ap.GetKind(), AccessPattern::kUnknown);
+}
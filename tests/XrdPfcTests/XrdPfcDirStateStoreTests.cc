@@ -0,0 +1,218 @@
+#undef NDEBUG
+
+#include "XrdPfcTestCache.hh"
+#include "XrdPfcTestOss.hh"
+
+#include "XrdPfc/XrdPfcDirState.hh"
+#include "XrdPfc/XrdPfcDirStateStore.hh"
+
+#include <cstdint>
+#include <ctime>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace XrdPfc;
+
+namespace
+{
+DirUsage Usage(long long blocks, int files)
+{
+  DirUsage u;
+  u.m_StBlocks = blocks;
+  u.m_NFiles   = files;
+  return u;
+}
+
+// A DirState snapshot and journal on local disk, loaded again by a new store
+// as after a restart.
+class DirStateStoreTest : public ::testing::Test
+{
+protected:
+  XrdPfcTestOss m_local;
+
+  void SetUp() override
+  {
+    TestCache();
+    ASSERT_TRUE(m_local.Init("xrdpfc-dirstate"));
+    ASSERT_EQ(mkdir((m_local.root + "/pfc-stats").c_str(), 0755), 0);
+  }
+
+  std::unique_ptr<DirStateStore> NewStore()
+  {
+    return std::unique_ptr<DirStateStore>(new DirStateStore(*m_local.oss, "/pfc-stats"));
+  }
+
+  // /a with 10 blocks in 1 file, /a/b with 20 blocks in 2 files, /c empty
+  void MakeTree(DataFsState &fs)
+  {
+    DirState *a = fs.get_root()->find_dir("a", true);
+    a->m_here_usage = Usage(10, 1);
+    a->find_dir("b", true)->m_here_usage = Usage(20, 2);
+    fs.get_root()->find_dir("c", true);
+  }
+
+  std::string Path(const char *name)
+  {
+    return m_local.root + "/pfc-stats/" + name;
+  }
+
+  long long FileSize(const char *name)
+  {
+    struct stat st;
+    return stat(Path(name).c_str(), &st) ? -1 : st.st_size;
+  }
+
+  DirUsage Total(DataFsState &fs)
+  {
+    DirState *root = fs.get_root();
+    return DirUsage(root->m_here_usage, root->m_recursive_subdir_usage);
+  }
+};
+}
+
+TEST_F(DirStateStoreTest, SnapshotRoundTrip)
+{
+  {
+    DataFsState fs;
+    MakeTree(fs);
+    ASSERT_TRUE(NewStore()->WriteSnapshot(fs));
+  }
+
+  DataFsState fs;
+  std::string err;
+  ASSERT_TRUE(NewStore()->Load(fs, 0, err)) << err;
+
+  DirState *a = fs.get_root()->find_dir("a", false);
+  ASSERT_NE(a, nullptr);
+  EXPECT_EQ(a->m_here_usage.m_StBlocks, 10);
+  EXPECT_EQ(a->m_recursive_subdir_usage.m_StBlocks, 20);
+  ASSERT_NE(a->find_dir("b", false), nullptr);
+  EXPECT_EQ(a->find_dir("b", false)->m_here_usage.m_NFiles, 2);
+  EXPECT_NE(fs.get_root()->find_dir("c", false), nullptr);
+  EXPECT_EQ(Total(fs).m_StBlocks, 30);
+  EXPECT_EQ(Total(fs).m_NFiles, 3);
+  EXPECT_EQ(Total(fs).m_NDirectories, 3);
+}
+
+TEST_F(DirStateStoreTest, JournalIsReplayed)
+{
+  {
+    DataFsState fs;
+    MakeTree(fs);
+    auto store = NewStore();
+    ASSERT_TRUE(store->WriteSnapshot(fs));
+
+    DirState *b = fs.get_root()->find_path("/a/b", -1, false, false);
+    ASSERT_NE(b, nullptr);
+    store->AddUsageDelta(b, Usage(5, 1));
+    store->AddDirRemoval("/c");
+    store->FlushJournal();
+  }
+
+  DataFsState fs;
+  std::string err;
+  ASSERT_TRUE(NewStore()->Load(fs, 0, err)) << err;
+  EXPECT_EQ(Total(fs).m_StBlocks, 35);
+  EXPECT_EQ(Total(fs).m_NFiles, 4);
+  EXPECT_EQ(fs.get_root()->find_dir("c", false), nullptr);
+}
+
+TEST_F(DirStateStoreTest, TruncatedJournalIsIgnored)
+{
+  {
+    DataFsState fs;
+    MakeTree(fs);
+    auto store = NewStore();
+    ASSERT_TRUE(store->WriteSnapshot(fs));
+    store->AddUsageDelta(fs.get_root()->find_dir("a", false), Usage(5, 1));
+    store->FlushJournal();
+  }
+
+  // Cut within the journal header: the journal no longer belongs to the
+  // snapshot, which loads on its own
+  ASSERT_EQ(truncate(Path("DirState.jrnl").c_str(), 10), 0);
+
+  DataFsState fs;
+  std::string err;
+  ASSERT_TRUE(NewStore()->Load(fs, 0, err)) << err;
+  EXPECT_EQ(Total(fs).m_StBlocks, 30);
+}
+
+TEST_F(DirStateStoreTest, CrashDuringJournalWrite)
+{
+  long long first_end;
+  {
+    DataFsState fs;
+    MakeTree(fs);
+    auto store = NewStore();
+    ASSERT_TRUE(store->WriteSnapshot(fs));
+    store->AddUsageDelta(fs.get_root()->find_dir("a", false), Usage(5, 1));
+    store->FlushJournal();
+    first_end = FileSize("DirState.jrnl");
+    store->AddUsageDelta(fs.get_root()->find_dir("a", false), Usage(7, 1));
+    store->FlushJournal();
+  }
+  long long second_end = FileSize("DirState.jrnl");
+  ASSERT_GT(second_end, first_end);
+
+  // Every partial write of the second record leaves the first one in place
+  for (long long len = first_end + 1; len < second_end; ++len)
+  {
+    ASSERT_EQ(truncate(Path("DirState.jrnl").c_str(), len), 0);
+    DataFsState fs;
+    std::string err;
+    ASSERT_TRUE(NewStore()->Load(fs, 0, err)) << err;
+    EXPECT_EQ(Total(fs).m_StBlocks, 35) << "journal cut at " << len;
+  }
+
+  // So does a record whose bytes did not all make it to disk
+  ASSERT_EQ(truncate(Path("DirState.jrnl").c_str(), second_end), 0);
+  int fd = open(Path("DirState.jrnl").c_str(), O_WRONLY);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(pwrite(fd, "\0\0\0\0", 4, second_end - 4), 4);
+  close(fd);
+
+  DataFsState fs;
+  std::string err;
+  ASSERT_TRUE(NewStore()->Load(fs, 0, err)) << err;
+  EXPECT_EQ(Total(fs).m_StBlocks, 35);
+}
+
+TEST_F(DirStateStoreTest, MaxAgeCountsFromTheLastFullScan)
+{
+  {
+    DataFsState fs;
+    MakeTree(fs);
+    ASSERT_TRUE(NewStore()->WriteSnapshot(fs));
+  }
+
+  // Pretend the full scan was done an hour ago; the scan time follows the
+  // generation and the snapshot time in the header
+  int fd = open(Path("DirState.snap").c_str(), O_WRONLY);
+  ASSERT_GE(fd, 0);
+  int64_t scan_time = time(0) - 3600;
+  ASSERT_EQ(pwrite(fd, &scan_time, sizeof(scan_time), 24), (ssize_t) sizeof(scan_time));
+  close(fd);
+
+  // A restart loads the snapshot and writes a new one of the loaded tree
+  {
+    DataFsState fs;
+    std::string err;
+    auto store = NewStore();
+    ASSERT_TRUE(store->Load(fs, 7200, err)) << err;
+    ASSERT_TRUE(store->WriteSnapshot(fs));
+  }
+
+  // That new snapshot still counts as an hour old
+  DataFsState fs;
+  std::string err;
+  EXPECT_FALSE(NewStore()->Load(fs, 600, err));
+  EXPECT_TRUE(fs.get_root()->m_subdirs.empty());
+  ASSERT_TRUE(NewStore()->Load(fs, 7200, err)) << err;
+  EXPECT_EQ(Total(fs).m_StBlocks, 30);
+}
@@ -0,0 +1,195 @@
+#undef NDEBUG
+
+#include "XrdPfcTestCache.hh"
+#include "XrdPfcTestOss.hh"
+
+#include "XrdPfc/XrdPfcInfoStore.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace XrdPfc;
+
+namespace
+{
+// An InfoStore log on local disk, opened and reopened as after a restart.
+class InfoStoreTest : public ::testing::Test
+{
+protected:
+  XrdPfcTestOss              m_local;
+  std::unique_ptr<InfoStore> m_store;
+
+  void SetUp() override
+  {
+    TestCache();
+    ASSERT_TRUE(m_local.Init("xrdpfc-infostore"));
+  }
+
+  void TearDown() override
+  {
+    m_store.reset();
+  }
+
+  void Reopen(long long compact_min = 64ll * 1024 * 1024)
+  {
+    m_store.reset();
+    m_store.reset(new InfoStore(*m_local.oss, TestCache().GetTrace(), "", "public",
+                                "/InfoStore.log", 1, compact_min));
+    std::string err;
+    ASSERT_TRUE(m_store->Open(err)) << err;
+  }
+
+  std::string Get(const std::string &name)
+  {
+    std::string value;
+    int ret = m_store->Get(name, value);
+    return ret ? "<" + std::to_string(ret) + ">" : value;
+  }
+
+  off_t LogSize() const
+  {
+    struct stat st;
+    return stat((m_local.root + "/InfoStore.log").c_str(), &st) ? -1 : st.st_size;
+  }
+};
+}
+
+TEST_F(InfoStoreTest, RecordsSurviveReopen)
+{
+  Reopen();
+  ASSERT_EQ(m_store->Put("/a.cinfo", "first", 1000, true), 0);
+  ASSERT_EQ(m_store->Put("/b.cinfo", "bee", 2000, false), 0);
+  ASSERT_EQ(m_store->Put("/c.cinfo", "", 3000, false), 0);
+  ASSERT_EQ(m_store->Put("/a.cinfo", "second", 4000, false), 0);
+  ASSERT_EQ(m_store->Remove("/b.cinfo"), 0);
+  EXPECT_EQ(m_store->Remove("/b.cinfo"), -ENOENT);
+
+  // Queued records are read back before they are committed
+  EXPECT_EQ(Get("/a.cinfo"), "second");
+  EXPECT_EQ(m_store->Sync(), 0);
+
+  Reopen();
+  time_t mtime = 0;
+  std::string value;
+  EXPECT_EQ(m_store->Get("/a.cinfo", value, &mtime), 0);
+  EXPECT_EQ(value, "second");
+  EXPECT_EQ(mtime, 4000);
+  EXPECT_EQ(Get("/b.cinfo"), "<" + std::to_string(-ENOENT) + ">");
+  EXPECT_EQ(Get("/c.cinfo"), "");
+
+  struct stat st;
+  ASSERT_EQ(m_store->Stat("/a.cinfo", st), 0);
+  EXPECT_EQ(st.st_size, 6);
+  EXPECT_EQ(st.st_mtime, 4000);
+
+  InfoStore::Stats s;
+  m_store->GetStats(s);
+  EXPECT_EQ(s.m_NRecords, 2);
+  EXPECT_EQ(s.m_LogBytes, LogSize());
+}
+
+TEST_F(InfoStoreTest, TornTailIsCutOff)
+{
+  Reopen();
+  ASSERT_EQ(m_store->Put("/a.cinfo", "alpha", 1000, true), 0);
+  ASSERT_EQ(m_store->Put("/b.cinfo", "beta", 1000, true), 0);
+  const off_t good_size = LogSize();
+
+  // A record that only partly made it to the disk
+  ASSERT_EQ(m_store->Put("/c.cinfo", "gamma", 1000, true), 0);
+  m_store.reset();
+  ASSERT_EQ(truncate((m_local.root + "/InfoStore.log").c_str(), LogSize() - 3), 0);
+
+  Reopen();
+  EXPECT_EQ(LogSize(), good_size);
+  EXPECT_EQ(Get("/a.cinfo"), "alpha");
+  EXPECT_EQ(Get("/b.cinfo"), "beta");
+  EXPECT_EQ(Get("/c.cinfo"), "<" + std::to_string(-ENOENT) + ">");
+
+  // A complete record with a damaged value
+  ASSERT_EQ(m_store->Put("/c.cinfo", "gamma", 1000, true), 0);
+  m_store.reset();
+  int fd = open((m_local.root + "/InfoStore.log").c_str(), O_WRONLY);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(pwrite(fd, "G", 1, LogSize() - 5), 1);
+  close(fd);
+
+  Reopen();
+  EXPECT_EQ(LogSize(), good_size);
+  EXPECT_EQ(Get("/c.cinfo"), "<" + std::to_string(-ENOENT) + ">");
+
+  // The log is appended to after the cut
+  ASSERT_EQ(m_store->Put("/d.cinfo", "delta", 1000, true), 0);
+  Reopen();
+  EXPECT_EQ(Get("/a.cinfo"), "alpha");
+  EXPECT_EQ(Get("/d.cinfo"), "delta");
+}
+
+TEST_F(InfoStoreTest, CompactionKeepsLiveRecords)
+{
+  Reopen(16 * 1024);
+
+  // Overwrite all records over and over, while earlier rounds are compacted
+  const int n_names = 200, n_rounds = 30;
+  for (int r = 0; r < n_rounds; ++r)
+  {
+    for (int i = 0; i < n_names; ++i)
+    {
+      std::string name = "/f" + std::to_string(i) + ".cinfo";
+      ASSERT_EQ(m_store->Put(name, name + " round " + std::to_string(r), r, false), 0);
+    }
+    if (r % 3 == 0)
+    {
+      ASSERT_EQ(m_store->Remove("/f0.cinfo"), 0);
+    }
+    ASSERT_EQ(m_store->Sync(), 0);
+  }
+
+  InfoStore::Stats s;
+  m_store->GetStats(s);
+  EXPECT_GT(s.m_NCompactions, 0);
+  EXPECT_EQ(s.m_NRecords, n_names);
+
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    for (int i = 0; i < n_names; ++i)
+    {
+      std::string name = "/f" + std::to_string(i) + ".cinfo";
+      EXPECT_EQ(Get(name), name + " round " + std::to_string(n_rounds - 1)) << pass;
+    }
+    Reopen(16 * 1024);
+  }
+
+  // The flusher compacts after the last commit before it stops
+  m_store->GetStats(s);
+  EXPECT_LE(LogSize(), 2 * s.m_LiveBytes);
+}
+
+TEST_F(InfoStoreTest, OrphansArePurged)
+{
+  Reopen();
+  mkdir((m_local.root + "/d").c_str(), 0755);
+  int fd = open((m_local.root + "/d/kept").c_str(), O_CREAT | O_WRONLY, 0644);
+  ASSERT_GE(fd, 0);
+  close(fd);
+
+  ASSERT_EQ(m_store->Put("/d/kept.cinfo", "data", 1000, false), 0);
+  ASSERT_EQ(m_store->Put("/d/orphan.cinfo", "none", 1000, false), 0);
+  ASSERT_EQ(m_store->Put("/d/other", "no cinfo", 1000, false), 0);
+
+  EXPECT_EQ(m_store->PurgeOrphans(), 1);
+  EXPECT_EQ(m_store->PurgeOrphans(), 0);
+  ASSERT_EQ(m_store->Sync(), 0);
+
+  Reopen();
+  EXPECT_EQ(Get("/d/kept.cinfo"), "data");
+  EXPECT_EQ(Get("/d/orphan.cinfo"), "<" + std::to_string(-ENOENT) + ">");
+  EXPECT_EQ(Get("/d/other"), "no cinfo");
+}
@@ -0,0 +1,231 @@
+#undef NDEBUG
+
+#include "XrdPfcTestCache.hh"
+#include "XrdPfcTestOss.hh"
+
+#include "XrdPfc/XrdPfcFPurgeState.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XrdPfc;
+
+namespace
+{
+FPurgeState::PurgeCandidate Candidate(const char *name, long long nblocks, time_t atime)
+{
+  return FPurgeState::PurgeCandidate("/", name, nblocks, atime);
+}
+
+struct TestFile
+{
+  std::string path; // relative to the cache root, with the cinfo extension
+  long long   nStBlocks;
+  time_t      atime;
+};
+
+// A cache name-space on local disk: data files with their cinfo files, whose
+// modification time is the access time the purge goes by.
+class PurgeScanTest : public ::testing::Test
+{
+protected:
+  XrdPfcTestOss          m_local;
+  std::vector<TestFile>  m_files;
+  time_t                 m_now = time(0);
+
+  void SetUp() override
+  {
+    TestCache();
+
+    ASSERT_TRUE(m_local.Init("xrdpfc-purge"));
+
+    // 15 top directories with two levels of subdirectories, files at every level
+    std::mt19937 rng(1234);
+    std::vector<char> buf(8 * 4096, 'x');
+    int n = 0;
+    for (int a = 0; a < 15; ++a)
+      for (int b = -1; b < 3; ++b)
+        for (int c = -1; c < (b < 0 ? 0 : 2); ++c)
+        {
+          std::string dir = "/d" + std::to_string(a);
+          if (b >= 0) dir += "/e" + std::to_string(b);
+          if (c >= 0) dir += "/f" + std::to_string(c);
+          MakeDirs(dir);
+          for (int i = 0; i < 4; ++i, ++n)
+          {
+            std::string name = dir + "/file" + std::to_string(n);
+            size_t size = 4096 * (1 + rng() % 8);
+            time_t atime = m_now - 600 - (time_t)(rng() % (200 * 3600));
+            WriteFile(name, buf.data(), size, 0);
+            WriteFile(name + ".cinfo", buf.data(), 100, atime);
+
+            struct stat st;
+            ASSERT_EQ(stat((m_local.root + name).c_str(), &st), 0);
+            m_files.push_back({name + ".cinfo", (long long)st.st_blocks, atime});
+          }
+        }
+  }
+
+  void MakeDirs(const std::string &dir)
+  {
+    std::string path = m_local.root;
+    size_t pos = 0;
+    while ((pos = dir.find('/', pos + 1)) != std::string::npos)
+      mkdir((path + dir.substr(0, pos)).c_str(), 0755);
+    mkdir((path + dir).c_str(), 0755);
+  }
+
+  void WriteFile(const std::string &name, const char *buf, size_t size, time_t mtime)
+  {
+    std::string path = m_local.root + name;
+    int fd = open(path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, buf, size), (ssize_t)size);
+    close(fd);
+    if (mtime)
+    {
+      struct timeval tv[2] = {{mtime, 0}, {mtime, 0}};
+      ASSERT_EQ(utimes(path.c_str(), tv), 0);
+    }
+  }
+
+  long long TotalStBlocks() const
+  {
+    long long n = 0;
+    for (auto &f : m_files) n += f.nStBlocks;
+    return n;
+  }
+
+  // The oldest files that together reach the request, as the purge must find them.
+  std::set<std::string> OldestFiles(long long nStBlocksReq) const
+  {
+    std::vector<TestFile> files(m_files);
+    std::sort(files.begin(), files.end(),
+              [](const TestFile &a, const TestFile &b) { return a.atime < b.atime; });
+    std::set<std::string> oldest;
+    long long accum = 0;
+    for (auto &f : files)
+    {
+      if (accum >= nStBlocksReq) break;
+      oldest.insert(f.path);
+      accum += f.nStBlocks;
+    }
+    return oldest;
+  }
+
+  static std::set<std::string> Paths(FPurgeState &fps)
+  {
+    std::set<std::string> paths;
+    for (auto &[atime, pc] : fps.refMap()) paths.insert(pc.path);
+    return paths;
+  }
+};
+}
+
+TEST(CandidateHeapTest, KeepsTheOldestFilesCoveringTheRequest)
+{
+  FPurgeState::CandidateHeap heap;
+  const long long req = 100;
+
+  // Until the request is covered, everything is wanted
+  EXPECT_TRUE(heap.wants(50, req));
+  heap.add(Candidate("a", 60, 50), req);
+  heap.add(Candidate("b", 30, 40), req);
+  EXPECT_TRUE(heap.wants(60, req));
+  heap.add(Candidate("c", 30, 60), req);
+  EXPECT_EQ(heap.m_vec.size(), 3u);
+  EXPECT_EQ(heap.m_nStBlocksAccum, 120);
+
+  // Now only files older than the newest one held are
+  EXPECT_FALSE(heap.wants(70, req));
+  EXPECT_TRUE(heap.wants(10, req));
+
+  // An older file makes the newest ones unnecessary
+  heap.add(Candidate("d", 80, 10), req);
+  std::set<std::string> held;
+  for (auto &pc : heap.m_vec) held.insert(pc.path);
+  EXPECT_EQ(held, (std::set<std::string>{"/d", "/b"}));
+  EXPECT_EQ(heap.m_nStBlocksAccum, 110);
+  EXPECT_EQ(heap.m_vec.front().time, 40);
+}
+
+TEST(CandidateHeapTest, NeverDropsBelowTheRequest)
+{
+  FPurgeState::CandidateHeap heap;
+  const long long req = 1000;
+  std::mt19937 rng(42);
+  long long total = 0;
+
+  for (int i = 0; i < 2000; ++i)
+  {
+    time_t atime = rng() % 100000;
+    long long nblocks = 1 + rng() % 50;
+    total += nblocks;
+    if (heap.wants(atime, req))
+      heap.add(Candidate("f", nblocks, atime), req);
+    ASSERT_GE(heap.m_nStBlocksAccum, std::min(total, req));
+    ASSERT_LT(heap.m_nStBlocksAccum - heap.m_vec.front().nStBlocks, req);
+  }
+}
+
+TEST_F(PurgeScanTest, ParallelScanFindsTheSameCandidatesAsSerial)
+{
+  const long long req = TotalStBlocks() / 5;
+  const std::set<std::string> oldest = OldestFiles(req);
+
+  for (int n_threads : {1, 4})
+  {
+    FPurgeState fps(512ll * req, *m_local.oss);
+    fps.setNThreads(n_threads);
+    ASSERT_TRUE(fps.TraverseNamespace("/"));
+
+    EXPECT_EQ(fps.getNStBlocksTotal(), TotalStBlocks()) << n_threads << " threads";
+    EXPECT_EQ(Paths(fps), oldest) << n_threads << " threads";
+    EXPECT_TRUE(fps.refList().empty());
+  }
+}
+
+TEST_F(PurgeScanTest, ColdFilesAndEarlyUnlinks)
+{
+  const long long req = TotalStBlocks() / 5;
+  const time_t    cold = m_now - 150 * 3600;
+
+  FPurgeState fps(512ll * req, *m_local.oss);
+  fps.setNThreads(4);
+  fps.setMinTime(cold);
+
+  std::set<std::string> unlinked;
+  long long nStBlocksEarly = 0;
+  fps.setEarlyUnlink(TotalStBlocks(), [&](const FPurgeState::PurgeCandidate &pc) {
+    unlinked.insert(pc.path);
+    if (pc.time) nStBlocksEarly += pc.nStBlocks;
+    return pc.nStBlocks;
+  });
+  ASSERT_TRUE(fps.TraverseNamespace("/"));
+
+  // Cold files are all passed on as they are found
+  for (auto &f : m_files)
+  {
+    if (f.atime < cold) { EXPECT_EQ(unlinked.count(f.path), 1u) << f.path; }
+  }
+  EXPECT_TRUE(fps.refList().empty());
+
+  // Others only up to a quarter of the request, and never also kept in the map
+  EXPECT_GT(nStBlocksEarly, 0);
+  EXPECT_LE(nStBlocksEarly, req / 4);
+  for (auto &path : Paths(fps))
+    EXPECT_EQ(unlinked.count(path), 0u) << path;
+}
@@ -0,0 +1,163 @@
+#undef NDEBUG
+
+#include "XrdPfc/XrdPfcRamTier.hh"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XrdPfc;
+
+namespace
+{
+const int       kBlockSize = 4096;
+const long long kCapacity  = 16 * 4 * kBlockSize; // four blocks in each of the 16 shards
+
+char *MakeBlock(uint64_t fid, int idx)
+{
+  char *buf = (char *) malloc(kBlockSize);
+  memset(buf, (int) (fid * 31 + idx) & 0xff, kBlockSize);
+  buf[0] = (char) idx;
+  return buf;
+}
+
+bool HoldsBlock(RamTier &rt, uint64_t fid, int idx)
+{
+  std::vector<char> buf(kBlockSize);
+  if ( ! rt.Read(fid, idx, buf.data(), 0, kBlockSize))
+    return false;
+  char *expected = MakeBlock(fid, idx);
+  bool same = memcmp(buf.data(), expected, kBlockSize) == 0;
+  free(expected);
+  return same;
+}
+
+void Request(RamTier &rt, uint64_t fid, int idx, int n)
+{
+  char c;
+  for (int i = 0; i < n; ++i)
+    rt.Read(fid, idx, &c, 0, 1);
+}
+}
+
+TEST(RamTierTest, CapacityIsAccountedAndNeverExceeded)
+{
+  RamTier rt(kCapacity, kBlockSize);
+  const uint64_t fid = rt.FileId("/a");
+
+  for (int idx = 0; idx < 1000; ++idx)
+  {
+    Request(rt, fid, idx, 2);
+    rt.Insert(fid, idx, MakeBlock(fid, idx), kBlockSize);
+
+    RamTier::Stats s;
+    rt.GetStats(s, false);
+    ASSERT_LE(s.m_BytesUsed, kCapacity);
+    ASSERT_EQ(s.m_BytesUsed, (long long) s.m_NBlocks * kBlockSize);
+    ASSERT_EQ(s.m_Inserts - s.m_Evictions, s.m_NBlocks);
+    ASSERT_EQ(s.m_Inserts + s.m_Rejects, idx + 1);
+  }
+
+  RamTier::Stats s;
+  rt.GetStats(s, true);
+  EXPECT_GT(s.m_Evictions, 0);
+  EXPECT_GT(s.m_NBlocks, 0);
+
+  // Counters are reset, usage is not
+  RamTier::Stats r;
+  rt.GetStats(r, false);
+  EXPECT_EQ(r.m_Inserts, 0);
+  EXPECT_EQ(r.m_Misses, 0);
+  EXPECT_EQ(r.m_BytesUsed, s.m_BytesUsed);
+
+  // A block larger than a shard is never taken
+  EXPECT_FALSE(rt.Insert(fid, 5000, (char *) malloc(kCapacity), kCapacity));
+  rt.ReleaseFileId(fid);
+}
+
+TEST(RamTierTest, FrequentBlocksAreAdmittedAndKept)
+{
+  RamTier rt(kCapacity, kBlockSize);
+  const uint64_t fid = rt.FileId("/a");
+
+  // Blocks that were asked for often fill the tier
+  const int n_hot = 200;
+  for (int idx = 0; idx < n_hot; ++idx)
+  {
+    Request(rt, fid, idx, 5);
+    rt.Insert(fid, idx, MakeBlock(fid, idx), kBlockSize);
+  }
+  std::vector<int> held;
+  for (int idx = 0; idx < n_hot; ++idx)
+    if (HoldsBlock(rt, fid, idx))
+      held.push_back(idx);
+  RamTier::Stats s;
+  rt.GetStats(s, true);
+  ASSERT_EQ((int) held.size(), s.m_NBlocks);
+  ASSERT_EQ(s.m_BytesUsed, kCapacity);
+
+  // Blocks nobody asked for do not displace them
+  for (int idx = n_hot; idx < n_hot + 100; ++idx)
+  {
+    EXPECT_FALSE(rt.WouldAdmit(fid, idx, kBlockSize, false)) << idx;
+    EXPECT_FALSE(rt.Insert(fid, idx, MakeBlock(fid, idx), kBlockSize)) << idx;
+  }
+  for (int idx : held)
+    EXPECT_TRUE(HoldsBlock(rt, fid, idx)) << idx;
+
+  // A block asked for more often than the others does, evicting one
+  const int hot = n_hot + 100;
+  Request(rt, fid, hot, 15);
+  EXPECT_TRUE(rt.WouldAdmit(fid, hot, kBlockSize, false));
+  EXPECT_TRUE(rt.Insert(fid, hot, MakeBlock(fid, hot), kBlockSize));
+  EXPECT_TRUE(HoldsBlock(rt, fid, hot));
+  EXPECT_FALSE(rt.WouldAdmit(fid, hot, kBlockSize, false));
+
+  rt.GetStats(s, false);
+  EXPECT_EQ(s.m_Rejects, 100);
+  EXPECT_EQ(s.m_Evictions, 1);
+  EXPECT_EQ(s.m_BytesUsed, kCapacity);
+  rt.ReleaseFileId(fid);
+}
+
+TEST(RamTierTest, FileIdsAreDroppedWhenUnused)
+{
+  RamTier rt(kCapacity, kBlockSize);
+
+  // An id is shared by opens of a path and kept while blocks are held
+  const uint64_t fid = rt.FileId("/a");
+  EXPECT_EQ(rt.FileId("/a"), fid);
+  Request(rt, fid, 0, 1);
+  ASSERT_TRUE(rt.Insert(fid, 0, MakeBlock(fid, 0), kBlockSize));
+  rt.ReleaseFileId(fid);
+  rt.ReleaseFileId(fid);
+  EXPECT_EQ(rt.FileId("/a"), fid);
+  EXPECT_TRUE(HoldsBlock(rt, fid, 0));
+  rt.ReleaseFileId(fid);
+
+  // An invalidated path gets a new id, the old one goes with its blocks
+  rt.Invalidate("/a");
+  const uint64_t fid2 = rt.FileId("/a");
+  EXPECT_NE(fid2, fid);
+  EXPECT_FALSE(HoldsBlock(rt, fid2, 0));
+  rt.ReleaseFileId(fid2);
+
+  RamTier::Stats s;
+  rt.GetStats(s, false);
+  EXPECT_EQ(s.m_NFileIds, 1);
+
+  // Many files passing through keep no more ids than blocks held
+  for (int i = 0; i < 5000; ++i)
+  {
+    const uint64_t f = rt.FileId("/f" + std::to_string(i));
+    Request(rt, f, 0, 2 + i % 3);
+    rt.Insert(f, 0, MakeBlock(f, 0), kBlockSize);
+    rt.ReleaseFileId(f);
+  }
+  rt.GetStats(s, false);
+  EXPECT_GT(s.m_NBlocks, 0);
+  EXPECT_LE(s.m_NFileIds, s.m_NBlocks);
+}
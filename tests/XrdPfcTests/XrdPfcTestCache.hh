@@ -0,0 +1,16 @@
+#ifndef __XRDPFC_TESTCACHE_HH__
+#define __XRDPFC_TESTCACHE_HH__
+
+#include "XrdPfc/XrdPfc.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+// The cache singleton that XrdPfc components reach for their tracing. It is
+// created once for the whole test program and never configured.
+inline XrdPfc::Cache &TestCache()
+{
+  static XrdSysLogger logger;
+  static XrdPfc::Cache &cache = XrdPfc::Cache::CreateInstance(&logger, nullptr);
+  return cache;
+}
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef __XRDPFC_TESTOSS_HH__
+#define __XRDPFC_TESTOSS_HH__
+
+#include "XrdOss/XrdOssApi.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ftw.h>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+// A fresh directory under /tmp and an Oss whose local root it is, for tests
+// of XrdPfc components that keep their files through the Oss. The directory
+// and everything in it is removed when the object goes away.
+class XrdPfcTestOss
+{
+public:
+  std::string                root;
+  std::unique_ptr<XrdOssSys> oss;
+
+  // Returns false if the directory or the Oss could not be set up.
+  bool Init(const char *tag)
+  {
+    std::string tmpl = std::string("/tmp/") + tag + "-XXXXXX";
+    if ( ! mkdtemp(&tmpl[0])) return false;
+    root = tmpl;
+
+    std::string cfn = root + ".cfg";
+    FILE *cfg = fopen(cfn.c_str(), "w");
+    if ( ! cfg) return false;
+    fprintf(cfg, "all.export /\noss.localroot %s\n", root.c_str());
+    fclose(cfg);
+
+    // Configuration files are only read as part of a server instance
+    static XrdSysLogger logger;
+    setenv("XRDINSTANCE", "xrdpfc-unit-tests anon", 0);
+    oss.reset(new XrdOssSys());
+    int rc = oss->Init(&logger, cfn.c_str());
+    unlink(cfn.c_str());
+    return rc == 0;
+  }
+
+  ~XrdPfcTestOss()
+  {
+    if (root.empty()) return;
+    nftw(root.c_str(), [](const char *path, const struct stat *, int, struct FTW *)
+                       { return remove(path); }, 16, FTW_DEPTH | FTW_PHYS);
+  }
+};
+
+#endif
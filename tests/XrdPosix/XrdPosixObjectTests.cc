@@ -0,0 +1,127 @@
+#undef NDEBUG
+
+#include "XrdPosix/XrdPosixFile.hh"
+#include "XrdPosix/XrdPosixObject.hh"
+#include "XrdPosix/XrdPosixXrootd.hh"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Exercises the lookup of file objects by descriptor while they are being
+// released. The files are never opened. See bench-pread.cc for the overhead
+// of these lookups.
+namespace
+{
+XrdPosixXrootd posix(-1024);
+
+const int nFiles = 8;
+
+int NewFile()
+{
+  bool aOK;
+  XrdPosixFile *fP = new XrdPosixFile(aOK, "root://localhost//bench");
+  EXPECT_TRUE(aOK);
+  EXPECT_TRUE(fP->AssignFD());
+  return fP->FDNum();
+}
+
+void FreeFile(int fd)
+{
+  XrdPosixFile *fP = XrdPosixObject::ReleaseFile(fd);
+  ASSERT_NE(fP, nullptr);
+  delete fP;
+}
+
+// Releases a file and then destroys and poisons the object, keeping its
+// memory so that a lookup still using it crashes instead of reading memory
+// that has been handed out again
+void *PoisonFile(int fd)
+{
+  XrdPosixFile *fP = XrdPosixObject::ReleaseFile(fd);
+  EXPECT_NE(fP, nullptr);
+  fP->~XrdPosixFile();
+  memset((void *)fP, 0, sizeof(XrdPosixFile));
+  return fP;
+}
+}
+
+TEST(XrdPosixObjectTests, LookupsRaceWithClose)
+{
+  std::atomic<bool> done(false);
+  std::atomic<long long> found(0), gone(0);
+  std::vector<int> fds;
+  std::vector<std::thread> readers;
+
+  for (int i = 0; i < nFiles; i++) fds.push_back(NewFile());
+  int lowFD = fds.front(), highFD = fds.back();
+
+  // Readers look up descriptors that are being closed and reused
+  for (int i = 0; i < 4; i++)
+    readers.emplace_back([&] {
+      while (!done)
+        for (int fd = lowFD; fd <= highFD; fd++)
+        {
+          XrdPosixFile *fP = XrdPosixObject::File(fd);
+          if (!fP) {gone++; continue;}
+          EXPECT_EQ(fP->FDNum(), fd);
+          fP->UnLock();
+          found++;
+        }
+    });
+
+  for (int k = 0; k < 200 || !found || !gone; k++)
+  {
+    int i = k % nFiles;
+    FreeFile(fds[i]);
+    fds[i] = NewFile();
+    if (!(k % 100)) std::this_thread::yield();
+  }
+  done = true;
+  for (auto &t : readers) t.join();
+  for (int fd : fds) FreeFile(fd);
+
+}
+
+TEST(XrdPosixObjectTests, LookupsRaceWithRelease)
+{
+  std::atomic<bool> done(false);
+  std::atomic<long long> found(0);
+  std::vector<int> fds;
+  std::vector<void *> released;
+  std::vector<std::thread> readers;
+
+  for (int i = 0; i < nFiles; i++) fds.push_back(NewFile());
+  int lowFD = fds.front(), highFD = fds.back();
+
+  // Once Release() returns no lookup may use the object anymore, so the
+  // readers never get to see one that has been poisoned
+  for (int i = 0; i < 4; i++)
+    readers.emplace_back([&] {
+      while (!done)
+        for (int fd = lowFD; fd <= highFD; fd++)
+        {
+          XrdPosixFile *fP = XrdPosixObject::File(fd);
+          if (!fP) continue;
+          ASSERT_EQ(fP->FDNum(), fd);
+          fP->UnLock();
+          found++;
+        }
+    });
+
+  for (int k = 0; k < 5000 || !found; k++)
+  {
+    int i = k % nFiles;
+    released.push_back(PoisonFile(fds[i]));
+    fds[i] = NewFile();
+    ASSERT_GE(fds[i], lowFD);
+    ASSERT_LE(fds[i], highFD);
+  }
+  done = true;
+  for (auto &t : readers) t.join();
+  for (int fd : fds) FreeFile(fd);
+  for (void *p : released) ::operator delete(p);
+}
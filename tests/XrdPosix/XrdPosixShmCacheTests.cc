@@ -0,0 +1,237 @@
+#undef NDEBUG
+
+#include "XrdPosix/XrdPosixShmCache.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/statvfs.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const int pageSize = 64 * 1024;
+
+// Counters shared with child processes
+struct Shared
+{
+  std::atomic<int> originReads;
+  std::atomic<int> badData;
+};
+
+Shared *MakeShared()
+{
+  void *p = mmap(0, sizeof(Shared), PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  EXPECT_NE(p, MAP_FAILED);
+  return new (p) Shared{{0}, {0}};
+}
+
+inline char Byte(long long off, int gen) { return (char)(off * 31 + gen); }
+
+// A slow origin whose content depends on the offset and a generation
+class SlowIO : public XrdOucCacheIO
+{
+public:
+  SlowIO(Shared *sP, const char *path, long long size, int gen = 0)
+      : shared(sP), fPath(path), fSize(size), fGen(gen) {}
+
+  bool Detach(XrdOucCacheIOCD &) override { return true; }
+  long long FSize() override { return fSize; }
+  int Fstat(struct stat &sbuff) override
+  {
+    memset(&sbuff, 0, sizeof(sbuff));
+    sbuff.st_size  = fSize;
+    sbuff.st_mtime = 1000 + fGen;
+    return 0;
+  }
+  const char *Path() override { return fPath.c_str(); }
+  int Read(char *buff, long long offs, int rlen) override
+  {
+    shared->originReads++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    if (offs >= fSize) return 0;
+    if (rlen > fSize - offs) rlen = fSize - offs;
+    for (int i = 0; i < rlen; i++) buff[i] = Byte(offs + i, fGen);
+    return rlen;
+  }
+  int Sync() override { return 0; }
+  int Trunc(long long) override { return -EROFS; }
+  int Write(char *, long long, int) override { return -EROFS; }
+
+private:
+  Shared *shared;
+  std::string fPath;
+  long long fSize;
+  int fGen;
+};
+
+class XrdPosixShmCacheTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    name = "gtest" + std::to_string(getpid());
+    parms.CacheSize = 64LL * pageSize;
+    parms.PageSize  = pageSize;
+    shared = MakeShared();
+  }
+
+  void TearDown() override
+  {
+    shm_unlink(("/xrdposix." + name + "." + std::to_string(getuid())).c_str());
+    munmap(shared, sizeof(Shared));
+  }
+
+  // Read the whole file in odd sized pieces and verify what we got
+  void ReadAll(XrdOucCacheIO *ioP, long long size, int gen)
+  {
+    std::vector<char> buff(10000);
+    long long offs = 0;
+    int n;
+    while ((n = ioP->Read(buff.data(), offs, buff.size())) > 0)
+    {
+      for (int i = 0; i < n; i++)
+        if (buff[i] != Byte(offs + i, gen)) {shared->badData++; break;}
+      offs += n;
+    }
+    if (n < 0 || offs != size) shared->badData++;
+  }
+
+  std::string name;
+  XrdPosixShmCache::Parms parms;
+  Shared *shared;
+};
+}
+
+TEST_F(XrdPosixShmCacheTests, ProcessesShareAndDeduplicateReads)
+{
+  const int nProcs = 8;
+  const long long fSize = 10LL * pageSize + 123;
+
+  std::vector<pid_t> kids;
+  for (int i = 0; i < nProcs; i++)
+  {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (!pid)
+    {
+      XrdPosixShmCache *cP = XrdPosixShmCache::Create(name.c_str(), parms);
+      if (!cP) _exit(1);
+      SlowIO io(shared, "root://host//file?user=x", fSize);
+      XrdOucCacheIO *ioP = cP->Attach(&io);
+      ReadAll(ioP, fSize, 0);
+      _exit(0);
+    }
+    kids.push_back(pid);
+  }
+
+  for (pid_t pid : kids)
+  {
+    int status;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status) && !WEXITSTATUS(status));
+  }
+
+  // Every page was read from the origin exactly once by all of them together
+  EXPECT_EQ(shared->badData.load(), 0);
+  EXPECT_EQ(shared->originReads.load(), 11);
+}
+
+TEST_F(XrdPosixShmCacheTests, ChangedFilesAreNotServedStale)
+{
+  const long long fSize = 3LL * pageSize;
+  XrdPosixShmCache *cP = XrdPosixShmCache::Create(name.c_str(), parms);
+  ASSERT_NE(cP, nullptr);
+
+  // Different cgi refers to the same file
+  SlowIO io1(shared, "root://host//f?a=1", fSize);
+  SlowIO io2(shared, "root://host//f?a=2", fSize);
+  ReadAll(cP->Attach(&io1), fSize, 0);
+  ReadAll(cP->Attach(&io2), fSize, 0);
+  EXPECT_EQ(shared->originReads.load(), 3);
+
+  // A new modification time means new content
+  SlowIO io3(shared, "root://host//f", fSize, 1);
+  ReadAll(cP->Attach(&io3), fSize, 1);
+  EXPECT_EQ(shared->originReads.load(), 6);
+  EXPECT_EQ(shared->badData.load(), 0);
+}
+
+TEST_F(XrdPosixShmCacheTests, EvictedPagesAreReread)
+{
+  const long long fSize = 200LL * pageSize;
+  XrdPosixShmCache *cP = XrdPosixShmCache::Create(name.c_str(), parms);
+  ASSERT_NE(cP, nullptr);
+  EXPECT_EQ(cP->PageSize(), pageSize);
+
+  // The file is much larger than the cache yet always read correctly
+  SlowIO io(shared, "root://host//big", fSize);
+  XrdOucCacheIO *ioP = cP->Attach(&io);
+  ReadAll(ioP, fSize, 0);
+  ReadAll(ioP, fSize, 0);
+  EXPECT_EQ(shared->badData.load(), 0);
+  EXPECT_GT(shared->originReads.load(), 200);
+}
+
+TEST_F(XrdPosixShmCacheTests, ReadWriteFilesAreNotCached)
+{
+  XrdPosixShmCache *cP = XrdPosixShmCache::Create(name.c_str(), parms);
+  ASSERT_NE(cP, nullptr);
+  SlowIO io(shared, "root://host//rw", pageSize);
+  EXPECT_EQ(cP->Attach(&io, XrdOucCache::optRW), &io);
+  EXPECT_EQ(XrdPosixShmCache::Create("bad/name", parms), nullptr);
+}
+
+TEST_F(XrdPosixShmCacheTests, IncompatibleSegmentIsReplaced)
+{
+  // A segment left behind by some other version, still mapped by its user
+  const size_t oSize = 1024 * 1024;
+  std::string shmName = "/xrdposix." + name + "." + std::to_string(getuid());
+  int fd = shm_open(shmName.c_str(), O_RDWR|O_CREAT|O_EXCL, 0600);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(ftruncate(fd, oSize), 0);
+  char *old = (char *)mmap(0, oSize, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  ASSERT_NE(old, MAP_FAILED);
+  memset(old, 0x5a, oSize);
+
+  // It is replaced rather than resized under its user
+  const long long fSize = 8LL * pageSize;
+  XrdPosixShmCache *cP = XrdPosixShmCache::Create(name.c_str(), parms);
+  ASSERT_NE(cP, nullptr);
+  SlowIO io(shared, "root://host//f", fSize);
+  ReadAll(cP->Attach(&io), fSize, 0);
+  EXPECT_EQ(shared->badData.load(), 0);
+  EXPECT_EQ(old[0], 0x5a);
+  EXPECT_EQ(old[oSize - 1], 0x5a);
+  munmap(old, oSize);
+}
+
+TEST_F(XrdPosixShmCacheTests, NoRoomIsReportedNotFatal)
+{
+  // Filling up a large /dev/shm would take that much memory, so this only
+  // runs where it is small, like the default 64MB of a container
+  struct statvfs vfs;
+  ASSERT_EQ(statvfs("/dev/shm", &vfs), 0);
+  long long avail = (long long)vfs.f_bavail * vfs.f_frsize;
+  if (avail > 256LL * 1024 * 1024)
+    GTEST_SKIP() << "/dev/shm has " << (avail >> 20) << "MB available";
+
+  parms.CacheSize = avail + 16LL * 1024 * 1024;
+  errno = 0;
+  EXPECT_EQ(XrdPosixShmCache::Create(name.c_str(), parms), nullptr);
+  EXPECT_EQ(errno, ENOSPC);
+}
@@ -0,0 +1,84 @@
+#undef NDEBUG
+
+#include "XrdPosix/XrdPosixFile.hh"
+#include "XrdPosix/XrdPosixObject.hh"
+#include "XrdPosix/XrdPosixXrootd.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Measures the client side of pread(): descriptor lookup, object locking and
+// the read itself. The files are never opened, so the read fails right away
+// and what is measured is the overhead that threads reading different files
+// (or the same one) have in common.
+//
+// Usage: xrdposix-bench-pread [max threads]
+
+namespace
+{
+XrdPosixXrootd posix(-1024);
+
+int NewFile()
+{
+  bool aOK;
+  XrdPosixFile *fP = new XrdPosixFile(aOK, "root://localhost//bench");
+  if (!aOK || !fP->AssignFD()) {
+    fprintf(stderr, "unable to create a file object\n");
+    exit(EXIT_FAILURE);
+  }
+  return fP->FDNum();
+}
+
+void FreeFile(int fd)
+{
+  delete XrdPosixObject::ReleaseFile(fd);
+}
+
+// Returns preads per second over all threads
+double Bench(int nThreads, bool sameFile)
+{
+  const auto runFor = std::chrono::milliseconds(300);
+  std::vector<int> fds;
+  std::vector<std::thread> threads;
+  std::atomic<long long> total(0);
+  std::atomic<bool> go(false);
+
+  for (int i = 0; i < (sameFile ? 1 : nThreads); i++) fds.push_back(NewFile());
+
+  for (int i = 0; i < nThreads; i++)
+    threads.emplace_back([&, i] {
+      int fd = fds[sameFile ? 0 : i];
+      char buff[16];
+      long long n = 0;
+      while (!go) std::this_thread::yield();
+      auto end = std::chrono::steady_clock::now() + runFor;
+      do {
+        for (int k = 0; k < 256; k++, n++)
+          XrdPosixXrootd::Pread(fd, buff, sizeof(buff), n);
+      } while (std::chrono::steady_clock::now() < end);
+      total += n;
+    });
+
+  go = true;
+  for (auto &t : threads) t.join();
+  for (int fd : fds) FreeFile(fd);
+  return total / (runFor.count() / 1000.0);
+}
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int maxThreads = std::thread::hardware_concurrency();
+  if (argc > 1) maxThreads = atoi(argv[1]);
+  if (maxThreads < 1) maxThreads = 1;
+
+  for (unsigned int n = 1; n <= maxThreads; n *= 2)
+    printf("%2u threads: %8.2f M pread/s distinct files, "
+           "%8.2f M pread/s same file\n",
+           n, Bench(n, false) / 1e6, Bench(n, true) / 1e6);
+  return 0;
+}
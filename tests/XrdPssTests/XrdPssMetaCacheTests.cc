@@ -0,0 +1,266 @@
+#undef NDEBUG
+
+#include "XrdPss/XrdPssMetaCache.hh"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+XrdPssMetaCache::Parms MakeParms(int ttl = 60)
+{
+  XrdPssMetaCache::Parms parms;
+  parms.statTTL = parms.negTTL = parms.dirTTL = ttl;
+  parms.rptIntv = 0;
+  return parms;
+}
+
+struct stat MakeStat(off_t size)
+{
+  struct stat st;
+  memset(&st, 0, sizeof(st));
+  st.st_size = size;
+  st.st_mode = S_IFREG | 0644;
+  return st;
+}
+
+// Fetch a stat result as XrdPssSys::Stat() does, "asking the origin" on a miss
+bool CachedStat(XrdPssMetaCache &mc, const char *path, int &rc,
+                struct stat &st, int originRC = 0, off_t size = 0,
+                const char *ident = "")
+{
+  if (mc.StatFind(path, st, rc, ident)) return true;
+  struct stat ost = MakeStat(size);
+  mc.StatDone(path, originRC, (originRC ? 0 : &ost), ident);
+  return false;
+}
+
+XrdPssMetaCache::DirList *MakeList(const char *name)
+{
+  XrdPssMetaCache::DirList *list = new XrdPssMetaCache::DirList;
+  list->names.push_back(name);
+  return list;
+}
+}
+
+TEST(XrdPssMetaCacheTests, PositiveAndNegativeResults)
+{
+  XrdPssMetaCache mc(MakeParms());
+  struct stat st;
+  int rc;
+
+  EXPECT_FALSE(CachedStat(mc, "/d/f", rc, st, 0, 1234));
+  ASSERT_TRUE(CachedStat(mc, "/d/f", rc, st));
+  EXPECT_EQ(rc, 0);
+  EXPECT_EQ(st.st_size, 1234);
+
+  EXPECT_FALSE(CachedStat(mc, "/d/missing", rc, st, -ENOENT));
+  ASSERT_TRUE(CachedStat(mc, "/d/missing", rc, st));
+  EXPECT_EQ(rc, -ENOENT);
+
+  // Other failures are not cached
+  EXPECT_FALSE(CachedStat(mc, "/d/denied", rc, st, -EACCES));
+  EXPECT_FALSE(CachedStat(mc, "/d/denied", rc, st, -EACCES));
+
+  XrdPssMetaCache::Stats stats;
+  mc.GetStats(stats);
+  EXPECT_EQ(stats.statHits, 1);
+  EXPECT_EQ(stats.negHits, 1);
+  EXPECT_EQ(stats.statMiss, 4);
+}
+
+TEST(XrdPssMetaCacheTests, EntriesExpire)
+{
+  XrdPssMetaCache mc(MakeParms(1));
+  struct stat st;
+  uint64_t gen;
+  int rc;
+
+  EXPECT_FALSE(CachedStat(mc, "/f", rc, st));
+  mc.DirFind("/", gen);
+  mc.DirAdd("/", MakeList("f"), gen);
+  EXPECT_TRUE(CachedStat(mc, "/f", rc, st));
+  EXPECT_TRUE(mc.DirFind("/", gen));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+  EXPECT_FALSE(CachedStat(mc, "/f", rc, st));
+  EXPECT_FALSE(mc.DirFind("/", gen));
+}
+
+TEST(XrdPssMetaCacheTests, ConcurrentMissesAreCoalesced)
+{
+  const int nWaiters = 8;
+  XrdPssMetaCache mc(MakeParms());
+  struct stat st;
+  int rc;
+
+  // The first requester goes to the origin
+  ASSERT_FALSE(mc.StatFind("/busy", st, rc));
+
+  std::vector<std::thread> waiters;
+  std::vector<int> results(nWaiters, 1);
+  std::vector<off_t> sizes(nWaiters, 0);
+  for (int i = 0; i < nWaiters; i++)
+    waiters.emplace_back([&, i] {
+      struct stat wst;
+      int wrc;
+      EXPECT_TRUE(mc.StatFind("/busy", wst, wrc));
+      results[i] = wrc;
+      sizes[i] = wst.st_size;
+    });
+
+  // Wait until everyone is waiting for the one origin request
+  XrdPssMetaCache::Stats stats;
+  do {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    mc.GetStats(stats);
+  } while (stats.coalesced < nWaiters);
+
+  struct stat ost = MakeStat(42);
+  mc.StatDone("/busy", 0, &ost);
+  for (auto &t : waiters) t.join();
+
+  for (int i = 0; i < nWaiters; i++) {
+    EXPECT_EQ(results[i], 0);
+    EXPECT_EQ(sizes[i], 42);
+  }
+  mc.GetStats(stats);
+  EXPECT_EQ(stats.statMiss, 1);
+  EXPECT_EQ(stats.coalesced, nWaiters);
+}
+
+TEST(XrdPssMetaCacheTests, InvalidationDiscardsPathAndParent)
+{
+  XrdPssMetaCache mc(MakeParms());
+  struct stat st;
+  uint64_t gen;
+  int rc;
+
+  EXPECT_FALSE(CachedStat(mc, "/d", rc, st));
+  EXPECT_FALSE(CachedStat(mc, "/d/f", rc, st, -ENOENT));
+  EXPECT_FALSE(CachedStat(mc, "/d/g", rc, st));
+  mc.DirFind("/d", gen);
+  mc.DirAdd("/d/", MakeList("g"), gen);
+
+  // Creating /d/f makes its negative entry and the listing of /d stale
+  mc.Invalidate("/d/f");
+  EXPECT_FALSE(CachedStat(mc, "/d/f", rc, st));
+  EXPECT_FALSE(CachedStat(mc, "/d", rc, st));
+  EXPECT_FALSE(mc.DirFind("/d", gen));
+  EXPECT_TRUE(CachedStat(mc, "/d/g", rc, st));
+}
+
+TEST(XrdPssMetaCacheTests, TreeInvalidation)
+{
+  XrdPssMetaCache mc(MakeParms());
+  struct stat st;
+  uint64_t gen;
+  int rc;
+
+  EXPECT_FALSE(CachedStat(mc, "/a/b", rc, st));
+  EXPECT_FALSE(CachedStat(mc, "/a/b/c", rc, st));
+  EXPECT_FALSE(CachedStat(mc, "/a/bc", rc, st));
+  mc.DirFind("/a/b/d", gen);
+  mc.DirAdd("/a/b/d", MakeList("e"), gen);
+
+  // Renaming directory /a/b affects everything below it but not /a/bc
+  mc.Invalidate("/a/b", true);
+  EXPECT_FALSE(mc.DirFind("/a/b/d", gen));
+  EXPECT_FALSE(CachedStat(mc, "/a/b/c", rc, st));
+  EXPECT_TRUE(CachedStat(mc, "/a/bc", rc, st));
+}
+
+TEST(XrdPssMetaCacheTests, ResultsRacingInvalidationAreNotKept)
+{
+  XrdPssMetaCache mc(MakeParms());
+  struct stat st = MakeStat(1);
+  uint64_t gen;
+  int rc;
+
+  // A stat and a listing are outstanding when the file is removed
+  ASSERT_FALSE(mc.StatFind("/d/f", st, rc));
+  mc.DirFind("/d", gen);
+  mc.Invalidate("/d/f");
+  mc.StatDone("/d/f", 0, &st);
+  mc.DirAdd("/d", MakeList("f"), gen);
+
+  EXPECT_FALSE(CachedStat(mc, "/d/f", rc, st, -ENOENT));
+  EXPECT_FALSE(mc.DirFind("/d", gen));
+}
+
+TEST(XrdPssMetaCacheTests, InvalidationOnlyAffectsRequestsForItsPaths)
+{
+  XrdPssMetaCache mc(MakeParms());
+  struct stat st = MakeStat(1);
+  uint64_t dGen, eGen;
+  int rc;
+
+  // Unrelated requests are outstanding when /d/f is removed
+  ASSERT_FALSE(mc.StatFind("/e/f", st, rc));
+  mc.DirFind("/d/sub", dGen);
+  mc.DirFind("/e", eGen);
+  mc.Invalidate("/d/f");
+  mc.StatDone("/e/f", 0, &st);
+  mc.DirAdd("/d/sub", MakeList("x"), dGen);
+  mc.DirAdd("/e", MakeList("f"), eGen);
+
+  EXPECT_TRUE(CachedStat(mc, "/e/f", rc, st));
+  EXPECT_TRUE(mc.DirFind("/d/sub", dGen));
+  EXPECT_TRUE(mc.DirFind("/e", eGen));
+}
+
+TEST(XrdPssMetaCacheTests, TreeInvalidationAffectsRequestsBelowIt)
+{
+  XrdPssMetaCache mc(MakeParms());
+  struct stat st = MakeStat(1);
+  uint64_t gen, bcGen;
+  int rc;
+
+  // Renaming /a/b while listings below it and beside it are being read
+  ASSERT_FALSE(mc.StatFind("/a/b/c/f", st, rc));
+  mc.DirFind("/a/b/c", gen);
+  mc.DirFind("/a/bc", bcGen);
+  mc.Invalidate("/a/b", true);
+  mc.StatDone("/a/b/c/f", 0, &st);
+  mc.DirAdd("/a/b/c", MakeList("f"), gen);
+  mc.DirAdd("/a/bc", MakeList("f"), bcGen);
+
+  EXPECT_FALSE(CachedStat(mc, "/a/b/c/f", rc, st));
+  EXPECT_FALSE(mc.DirFind("/a/b/c", gen));
+  EXPECT_TRUE(mc.DirFind("/a/bc", bcGen));
+}
+
+TEST(XrdPssMetaCacheTests, IdentitiesAreKeptApart)
+{
+  XrdPssMetaCache mc(MakeParms());
+  struct stat st;
+  uint64_t gen;
+  int rc;
+
+  // What the origin told one identity is not given to another
+  EXPECT_FALSE(CachedStat(mc, "/d/f", rc, st, 0, 10, "U1@"));
+  EXPECT_FALSE(CachedStat(mc, "/d/f", rc, st, -ENOENT, 0, "U2@"));
+  EXPECT_FALSE(CachedStat(mc, "/d/f", rc, st, -EACCES));
+  ASSERT_TRUE(CachedStat(mc, "/d/f", rc, st, 0, 0, "U1@"));
+  EXPECT_EQ(rc, 0);
+  EXPECT_EQ(st.st_size, 10);
+  ASSERT_TRUE(CachedStat(mc, "/d/f", rc, st, 0, 0, "U2@"));
+  EXPECT_EQ(rc, -ENOENT);
+
+  mc.DirFind("/d", gen, "U1@");
+  mc.DirAdd("/d", MakeList("f"), gen, "U1@");
+  EXPECT_TRUE(mc.DirFind("/d", gen, "U1@"));
+  EXPECT_FALSE(mc.DirFind("/d", gen, "U2@"));
+  EXPECT_FALSE(mc.DirFind("/d", gen));
+
+  // A change is seen by every identity
+  mc.Invalidate("/d/f");
+  EXPECT_FALSE(CachedStat(mc, "/d/f", rc, st, 0, 0, "U1@"));
+  EXPECT_FALSE(CachedStat(mc, "/d/f", rc, st, 0, 0, "U2@"));
+  EXPECT_FALSE(mc.DirFind("/d", gen, "U1@"));
+}
@@ -0,0 +1,85 @@
+#undef NDEBUG
+
+#include "XrdSciTokens/XrdSciTokensPathIndex.hh"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// What XrdAccRules::apply() did before the index: test every rule in turn
+bool LinearScan(const std::vector<std::string> &rules, const std::string &path,
+                bool parents)
+{
+  for (const std::string &rule : rules) {
+    if (rule == "/") return true;
+    if (is_subdirectory(rule, path)) return true;
+    if (parents && is_subdirectory(path, rule)) return true;
+  }
+  return false;
+}
+
+// Paths built from a handful of components that are prefixes of one another,
+// with the odd trailing slash, doubled slash or missing leading slash
+std::string MakePath(std::mt19937 &rng)
+{
+  static const char *comps[] = {"a", "ab", "abc", "b", "store", "store1"};
+  std::string p;
+  int depth = rng() % 4;
+  for (int d = 0; d < depth; d++) {
+    p += (rng() % 16 ? "/" : "//");
+    p += comps[rng() % 6];
+  }
+  switch (rng() % 8) {
+    case 0: p += "/"; break;
+    case 1: if (!p.empty()) p.erase(0, 1); break;
+    case 2: if (p.empty()) p = "/"; break;
+  }
+  return p;
+}
+
+void ExpectSame(const std::vector<std::string> &rules,
+                const std::vector<std::string> &paths)
+{
+  PathRuleIndex index;
+  for (const std::string &rule : rules) index.insert(rule);
+
+  for (const std::string &path : paths)
+    for (bool parents : {false, true}) {
+      ASSERT_EQ(index.allows(path, parents), LinearScan(rules, path, parents))
+        << "path '" << path << "' parents " << parents;
+    }
+}
+}
+
+TEST(XrdSciTokensPathIndexTests, PrefixBoundaries)
+{
+  ExpectSame({"/a"}, {"/a", "/ab", "/a/b", "/a/", "/", "", "a", "/abc/d"});
+  ExpectSame({"/ab"}, {"/a", "/ab", "/ab/", "/a/b", "/abc"});
+  ExpectSame({"/a/b"}, {"/", "/a", "/a/", "/ab", "/a/b", "/a/bc", "/a/b/c"});
+  ExpectSame({"/a/"}, {"/a", "/a/", "/ab", "/a/b", "/"});
+  ExpectSame({"/"}, {"/", "/a", "", "a"});
+  ExpectSame({}, {"/", "/a", ""});
+}
+
+TEST(XrdSciTokensPathIndexTests, MatchesLinearScan)
+{
+  std::mt19937 rng(1234);
+
+  for (size_t nrules : {1, 2, 5, 20, 100}) {
+    for (int round = 0; round < 50; round++) {
+      std::vector<std::string> rules, paths;
+      for (size_t i = 0; i < nrules; i++) {
+        std::string rule = MakePath(rng);
+        // "/" grants everything and would hide the rest of the set
+        if (rule == "/" && rng() % 4) continue;
+        rules.push_back(rule);
+      }
+      for (int i = 0; i < 200; i++) paths.push_back(MakePath(rng));
+      ExpectSame(rules, paths);
+    }
+  }
+}
@@ -0,0 +1,355 @@
+#undef NDEBUG
+
+#include "Xrd/XrdScheduler.hh"
+#include "XrdOuc/XrdOucBuffer.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdOuc/XrdOucErrInfo.hh"
+#include "XrdOuc/XrdOucSFVec.hh"
+#include "XrdSfs/XrdSfsDio.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdSsi/XrdSsiErrInfo.hh"
+#include "XrdSsi/XrdSsiFileSess.hh"
+#include "XrdSsi/XrdSsiRRInfo.hh"
+#include "XrdSsi/XrdSsiRequest.hh"
+#include "XrdSsi/XrdSsiResponder.hh"
+#include "XrdSsi/XrdSsiService.hh"
+#include "XrdSsi/XrdSsiStream.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace XrdSsi
+{
+extern XrdOucBuffPool *BuffPool;
+extern XrdScheduler   *Sched;
+extern XrdSsiService  *Service;
+extern XrdSysError     Log;
+}
+
+// Drives SSI responses through XrdSsiFileSess::SendData() the way do_Read()
+// does, with a link that records what XrdSsiFileReq::Send() hands to it.
+namespace
+{
+struct TestDio : public XrdSfsDio
+{
+  std::string       sent;
+  std::vector<int>  sends;           // data length of each send
+  int               rc = 0;          // what SendFile() returns
+
+  int SendFile(int) override { return -ENOTSUP; }
+
+  int SendFile(XrdOucSFVec *sfvec, int sfvnum) override
+  {
+    if (rc) return rc;
+    EXPECT_EQ(sfvnum, 2);
+    XrdOucSFVec &v = sfvec[1];
+    std::string data(v.sendsz, '\0');
+    if (v.fdnum < 0) data.assign(v.buffer, v.sendsz);
+    else EXPECT_EQ(pread(v.fdnum, &data[0], v.sendsz, v.offset), v.sendsz);
+    sent += data;
+    sends.push_back(v.sendsz);
+    return 0;
+  }
+
+  void SetFD(int) override {}
+};
+
+// An active stream handing out its data in buffers of a fixed size, which
+// may fail instead of ending.
+class TestStream : public XrdSsiStream
+{
+public:
+  TestStream(const std::string &data, int chunk, bool fail)
+    : XrdSsiStream(isActive), m_data(data), m_chunk(chunk), m_fail(fail) {}
+
+  Buffer *GetBuff(XrdSsiErrInfo &eRef, int &dlen, bool &last) override
+  {
+    if (m_off >= m_data.size())
+    {
+      last = ! m_fail;
+      if (m_fail) eRef.Set("stream broke", EIO);
+      return 0;
+    }
+    dlen = std::min<size_t>(m_chunk, m_data.size() - m_off);
+    Buffer *bP = new TestBuff(&m_data[m_off]);
+    m_off += dlen;
+    last = (m_off >= m_data.size() && ! m_fail);
+    return bP;
+  }
+
+private:
+  struct TestBuff : public Buffer
+  {
+    TestBuff(char *dp) : Buffer(dp) {}
+    void Recycle() override { delete this; }
+  };
+
+  std::string m_data;
+  size_t      m_off = 0;
+  int         m_chunk;
+  bool        m_fail;
+};
+
+// What the provider answers to the next request
+struct Answer
+{
+  enum Kind { Data, File, Stream } kind = Data;
+  std::string data;
+  int         fd        = -1;
+  int         strmChunk = 0;
+  bool        strmFail  = false;
+};
+
+class TestResponder : public XrdSsiResponder
+{
+public:
+  XrdSysSemaphore finished{0};
+  bool            cancelled = false;
+
+  ~TestResponder() override { delete m_stream; }
+
+  void Respond(const Answer &a)
+  {
+    switch (a.kind)
+    {
+      case Answer::Data:
+        m_data = a.data;
+        SetResponse(m_data.data(), m_data.size());
+        break;
+      case Answer::File:
+        SetResponse((long long)a.data.size(), a.fd);
+        break;
+      case Answer::Stream:
+        m_stream = new TestStream(a.data, a.strmChunk, a.strmFail);
+        SetResponse(m_stream);
+        break;
+    }
+  }
+
+protected:
+  void Finished(XrdSsiRequest &, const XrdSsiRespInfo &, bool cancel) override
+  {
+    cancelled = cancel;
+    UnBindRequest();
+    finished.Post();
+  }
+
+private:
+  std::string  m_data;
+  TestStream  *m_stream = 0;
+};
+
+class TestService : public XrdSsiService
+{
+public:
+  Answer           answer;
+  TestResponder   *responder = 0;
+  XrdSysSemaphore  responded{0};
+
+  bool Prepare(XrdSsiErrInfo &, const XrdSsiResource &) override { return true; }
+
+  void ProcessRequest(XrdSsiRequest &rqst, XrdSsiResource &) override
+  {
+    responder->BindRequest(rqst);
+    responder->Respond(answer);
+    responded.Post();
+  }
+};
+
+class SendDataTest : public ::testing::Test
+{
+protected:
+  static TestService *s_service;
+
+  XrdOucErrInfo   m_eInfo{"tester"};
+  XrdSsiFileSess *m_sess = 0;
+  TestResponder   m_responder;
+  TestDio         m_dio;
+  unsigned int    m_reqID = 0;
+
+  static void SetUpTestSuite()
+  {
+    // Errors are logged as well as returned
+    static XrdSysLogger logger;
+    XrdSsi::Log.logger(&logger);
+
+    // As in the server, the scheduler is never deleted
+    XrdSsi::Sched    = new XrdScheduler(1, 4, 4);
+    XrdSsi::Sched->Start();
+    XrdSsi::BuffPool = new XrdOucBuffPool(1024, 2097152);
+    s_service        = new TestService();
+    XrdSsi::Service  = s_service;
+  }
+
+  void SetUp() override
+  {
+    m_sess = XrdSsiFileSess::Alloc(m_eInfo, "tester");
+    XrdOucEnv env;
+    ASSERT_EQ(m_sess->open("/ssi", env, SFS_O_RDWR), SFS_OK);
+  }
+
+  void TearDown() override
+  {
+    m_sess->close();
+    m_sess->Recycle();
+  }
+
+  // Post a request and wait for the provider to respond to it
+  void Post(const Answer &answer)
+  {
+    s_service->answer    = answer;
+    s_service->responder = &m_responder;
+    XrdSsiRRInfo rInfo;
+    const char rqst[] = "request";
+    rInfo.Id(++m_reqID);
+    rInfo.Size(sizeof(rqst));
+    ASSERT_EQ(m_sess->write(rInfo.Info(), rqst, sizeof(rqst)), (int)sizeof(rqst));
+    s_service->responded.Wait();
+  }
+
+  int SendData(int blen)
+  {
+    XrdSsiRRInfo rInfo;
+    rInfo.Id(m_reqID);
+    return m_sess->SendData(&m_dio, rInfo.Info(), blen);
+  }
+
+  int Read(char *buff, int blen)
+  {
+    XrdSsiRRInfo rInfo;
+    rInfo.Id(m_reqID);
+    return m_sess->read(rInfo.Info(), buff, blen);
+  }
+};
+
+TestService *SendDataTest::s_service = 0;
+
+std::string Pattern(int len)
+{
+  std::string s(len, '\0');
+  for (int i = 0; i < len; ++i) s[i] = 'a' + i % 26;
+  return s;
+}
+}
+
+TEST_F(SendDataTest, DataResponseEndsOnTheLastFullSend)
+{
+  Answer a;
+  a.data = Pattern(3 * 1000);
+  Post(a);
+
+  for (int i = 0; i < 3; ++i) ASSERT_EQ(SendData(1000), SFS_OK) << i;
+
+  // The third send completed the response, no empty one is needed
+  m_responder.finished.Wait();
+  EXPECT_FALSE(m_responder.cancelled);
+  EXPECT_EQ(m_dio.sends, (std::vector<int>{1000, 1000, 1000}));
+  EXPECT_EQ(m_dio.sent, a.data);
+}
+
+TEST_F(SendDataTest, FileResponseEndsOnTheLastFullSend)
+{
+  char path[] = "/tmp/xrdssi-respXXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  unlink(path);
+
+  Answer a;
+  a.kind = Answer::File;
+  a.data = Pattern(2 * 4096);
+  a.fd   = fd;
+  ASSERT_EQ(write(fd, a.data.data(), a.data.size()), (ssize_t)a.data.size());
+  Post(a);
+
+  ASSERT_EQ(SendData(4096), SFS_OK);
+  ASSERT_EQ(SendData(4096), SFS_OK);
+  m_responder.finished.Wait();
+  EXPECT_FALSE(m_responder.cancelled);
+  EXPECT_EQ(m_dio.sends, (std::vector<int>{4096, 4096}));
+  EXPECT_EQ(m_dio.sent, a.data);
+  close(fd);
+}
+
+TEST_F(SendDataTest, ShortLastSendAndEofAfterCompletion)
+{
+  Answer a;
+  a.data = Pattern(2500);
+  Post(a);
+
+  ASSERT_EQ(SendData(1000), SFS_OK);
+  ASSERT_EQ(SendData(1000), SFS_OK);
+  ASSERT_EQ(SendData(1000), SFS_OK);
+  m_responder.finished.Wait();
+  EXPECT_EQ(m_dio.sends, (std::vector<int>{1000, 1000, 500}));
+
+  // Reading past the end sends nothing, so the caller's read() gets the eof
+  ASSERT_EQ(SendData(1000), SFS_OK);
+  EXPECT_EQ(m_dio.sends.size(), 3u);
+  char buff[1000];
+  EXPECT_EQ(Read(buff, sizeof(buff)), 0);
+
+  // After that the request is unknown
+  EXPECT_EQ(SendData(1000), SFS_ERROR);
+  EXPECT_EQ(m_eInfo.getErrInfo(), ESRCH);
+}
+
+TEST_F(SendDataTest, StreamResponseIsSentByBuffer)
+{
+  Answer a;
+  a.kind      = Answer::Stream;
+  a.data      = Pattern(2500);
+  a.strmChunk = 1000;
+  Post(a);
+
+  // Each send is bounded by the stream buffer as well as by the read size
+  for (int i = 0; i < 4; ++i) ASSERT_EQ(SendData(600), SFS_OK) << i;
+  EXPECT_EQ(m_dio.sends, (std::vector<int>{600, 400, 600, 400}));
+
+  // The rest of the stream and its end
+  ASSERT_EQ(SendData(600), SFS_OK);
+  ASSERT_EQ(SendData(600), SFS_OK);
+  EXPECT_EQ(m_dio.sent, a.data);
+  char buff[600];
+  EXPECT_EQ(Read(buff, sizeof(buff)), 0);
+  m_responder.finished.Wait();
+  EXPECT_FALSE(m_responder.cancelled);
+}
+
+TEST_F(SendDataTest, StreamErrorIsReported)
+{
+  Answer a;
+  a.kind      = Answer::Stream;
+  a.data      = Pattern(1000);
+  a.strmChunk = 1000;
+  a.strmFail  = true;
+  Post(a);
+
+  ASSERT_EQ(SendData(1000), SFS_OK);
+  EXPECT_EQ(SendData(1000), SFS_ERROR);
+  EXPECT_EQ(m_eInfo.getErrInfo(), EIO);
+  m_responder.finished.Wait();
+  EXPECT_TRUE(m_responder.cancelled);
+  EXPECT_EQ(m_dio.sent, a.data);
+}
+
+TEST_F(SendDataTest, LinkErrorIsReported)
+{
+  Answer a;
+  a.data = Pattern(1000);
+  Post(a);
+
+  m_dio.rc = -1;
+  EXPECT_EQ(SendData(1000), SFS_ERROR);
+  EXPECT_EQ(m_eInfo.getErrInfo(), EIO);
+  m_responder.finished.Wait();
+  EXPECT_TRUE(m_responder.cancelled);
+}
@@ -0,0 +1,196 @@
+#undef NDEBUG
+
+#include "XrdOuc/XrdOucSFVec.hh"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Compares the two ways an SSI response reaches the client link. With read(),
+// each client read has the response copied into a server buffer which is then
+// written out. With SendData(), the response region (memory or file) is passed
+// to the link as a sendfile vector: memory is written straight from the
+// provider's buffer and file data goes out via sendfile(). The link is a
+// loopback TCP connection drained by a reader thread; the figure of merit is
+// the CPU time spent by the sending thread per GB.
+//
+// Usage: xrdssi-bench-resp-xfer [response size in MB]
+
+namespace
+{
+const int hdrLen   = 8;
+const int readSize = 1024 * 1024;        // client read request size
+
+struct Link
+{
+  int sFD = -1, cFD = -1;
+  std::thread reader;
+  long long received = 0;
+
+  Link()
+  {
+    int lFD = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family      = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(bind(lFD, (sockaddr *)&sa, sizeof(sa)) == 0);
+    socklen_t slen = sizeof(sa);
+    getsockname(lFD, (sockaddr *)&sa, &slen);
+    listen(lFD, 1);
+    cFD = socket(AF_INET, SOCK_STREAM, 0);
+    assert(connect(cFD, (sockaddr *)&sa, sizeof(sa)) == 0);
+    sFD = accept(lFD, 0, 0);
+    close(lFD);
+
+    reader = std::thread([this] {
+      std::vector<char> buff(4 * 1024 * 1024);
+      ssize_t n;
+      while ((n = read(cFD, buff.data(), buff.size())) > 0) received += n;
+    });
+  }
+
+  long long Close()
+  {
+    shutdown(sFD, SHUT_WR);
+    reader.join();
+    close(sFD);
+    close(cFD);
+    return received;
+  }
+
+  // Does what XrdLink::Send(const sfVec *, int) does for a header and one
+  // element
+  void Send(XrdOucSFVec *sfv)
+  {
+    if (sfv[1].fdnum < 0)
+    {
+      struct iovec iov[2] = {{sfv[0].buffer, (size_t)sfv[0].sendsz},
+                             {sfv[1].buffer, (size_t)sfv[1].sendsz}};
+      size_t left = sfv[0].sendsz + sfv[1].sendsz;
+      while (left)
+      {
+        ssize_t n = writev(sFD, iov, 2);
+        assert(n > 0);
+        left -= n;
+        for (auto &v : iov)
+        {
+          size_t k = ((size_t)n < v.iov_len ? n : v.iov_len);
+          v.iov_base = (char *)v.iov_base + k; v.iov_len -= k; n -= k;
+        }
+      }
+      return;
+    }
+    assert(write(sFD, sfv[0].buffer, sfv[0].sendsz) == sfv[0].sendsz);
+    off_t off = sfv[1].offset;
+    int left = sfv[1].sendsz;
+    while (left)
+    {
+      ssize_t n = sendfile(sFD, sfv[1].fdnum, &off, left);
+      assert(n > 0);
+      left -= n;
+    }
+  }
+};
+
+double ThreadCPU()
+{
+  struct rusage ru;
+  getrusage(RUSAGE_THREAD, &ru);
+  return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec
+       + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+// Send the response in client-sized pieces, either copying each piece into
+// the server buffer first (as read() does) or handing over the region itself.
+void Transfer(const char *resp, int fd, long long respSize, bool zeroCopy,
+              double &cpuPerGB, double &mbPerSec)
+{
+  Link link;
+  std::vector<char> srvBuff(readSize);
+  char hdr[hdrLen] = {0};
+  XrdOucSFVec sfv[2];
+
+  auto t0 = std::chrono::steady_clock::now();
+  double c0 = ThreadCPU();
+  for (long long off = 0; off < respSize; off += readSize)
+  {
+    int blen = (respSize - off < readSize ? respSize - off : readSize);
+    sfv[0].buffer = hdr; sfv[0].sendsz = hdrLen; sfv[0].fdnum = -1;
+    sfv[1].sendsz = blen;
+    if (zeroCopy)
+    {
+      if (resp) {sfv[1].buffer = (char *)resp + off; sfv[1].fdnum = -1;}
+      else      {sfv[1].offset = off;                sfv[1].fdnum = fd;}
+    }
+    else
+    {
+      if (resp) memcpy(srvBuff.data(), resp + off, blen);
+      else assert(pread(fd, srvBuff.data(), blen, off) == blen);
+      sfv[1].buffer = srvBuff.data(); sfv[1].fdnum = -1;
+    }
+    link.Send(sfv);
+  }
+  double cpu = ThreadCPU() - c0;
+  long long got = link.Close();
+  double secs = std::chrono::duration<double>(
+                  std::chrono::steady_clock::now() - t0).count();
+
+  assert(got == respSize + ((respSize + readSize - 1) / readSize) * hdrLen);
+  cpuPerGB = cpu / (respSize / 1e9);
+  mbPerSec = respSize / 1e6 / secs;
+}
+}
+
+int main(int argc, char *argv[])
+{
+  long long respSize = 128LL * 1024 * 1024;
+  if (argc > 1) respSize = atoll(argv[1]) * 1024 * 1024;
+  if (respSize < readSize) respSize = readSize;
+
+  double cpuCopy, cpuZero, rateCopy, rateZero;
+
+  char *resp = (char *)mmap(0, respSize, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (resp == MAP_FAILED) {
+    perror("mmap");
+    return EXIT_FAILURE;
+  }
+  memset(resp, 'r', respSize);
+  Transfer(resp, -1, respSize, false, cpuCopy, rateCopy);
+  Transfer(resp, -1, respSize, true,  cpuZero, rateZero);
+  printf("memory response: copy %.2f s/GB %.0f MB/s, zero-copy %.2f s/GB "
+         "%.0f MB/s\n", cpuCopy, rateCopy, cpuZero, rateZero);
+  munmap(resp, respSize);
+
+  char path[] = "/tmp/xrdssi-respXXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0) {
+    perror("mkstemp");
+    return EXIT_FAILURE;
+  }
+  unlink(path);
+  std::vector<char> chunk(readSize, 'f');
+  for (long long off = 0; off < respSize; off += readSize)
+    assert(write(fd, chunk.data(), readSize) == readSize);
+
+  Transfer(0, fd, respSize, false, cpuCopy, rateCopy);
+  Transfer(0, fd, respSize, true,  cpuZero, rateZero);
+  printf("file response:   copy %.2f s/GB %.0f MB/s, zero-copy %.2f s/GB "
+         "%.0f MB/s\n", cpuCopy, rateCopy, cpuZero, rateZero);
+  close(fd);
+  return 0;
+}
@@ -0,0 +1,49 @@
+#undef NDEBUG
+
+#include "XrdTlsTestPair.hh"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+class TlsSessionTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    std::string eMsg;
+    ASSERT_TRUE(pair.Init(eMsg)) << eMsg;
+  }
+
+  bool Connect(bool resume) { return pair.Connect(resume); }
+
+  XrdTlsTestPair pair;
+};
+}
+
+TEST_F(TlsSessionTest, ResumesWithSavedSession)
+{
+  unsigned long long full, resumed;
+
+  ASSERT_TRUE(Connect(true));
+  pair.cliCtx->HandshakeStats(full, resumed);
+  EXPECT_EQ(full, 1u);
+  EXPECT_EQ(resumed, 0u);
+
+  // The first connection left a session behind which is offered now
+  for (int i = 0; i < 3; i++) ASSERT_TRUE(Connect(true));
+  pair.cliCtx->HandshakeStats(full, resumed);
+  EXPECT_EQ(full, 1u);
+  EXPECT_EQ(resumed, 3u);
+
+  pair.srvCtx->HandshakeStats(full, resumed);
+  EXPECT_EQ(full, 1u);
+  EXPECT_EQ(resumed, 3u);
+
+  // Not offering the session means a full handshake
+  ASSERT_TRUE(Connect(false));
+  pair.cliCtx->HandshakeStats(full, resumed);
+  EXPECT_EQ(full, 2u);
+}
@@ -0,0 +1,146 @@
+#ifndef __XRDTLS_TESTPAIR_HH__
+#define __XRDTLS_TESTPAIR_HH__
+
+#include "XrdTls/XrdTlsContext.hh"
+#include "XrdTls/XrdTlsSocket.hh"
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A server and a client context for "localhost" with a self-signed
+// certificate, both caching sessions, and connections between them over a
+// socket pair.
+class XrdTlsTestPair
+{
+public:
+  std::unique_ptr<XrdTlsContext> srvCtx, cliCtx;
+
+  bool Init(std::string &eMsg)
+  {
+    char dTemplate[] = "/tmp/xrdtls-test-XXXXXX";
+    if (!mkdtemp(dTemplate)) {
+      eMsg = "unable to create a temporary directory";
+      return false;
+    }
+    dir = dTemplate;
+    certFN = dir + "/cert.pem";
+    keyFN  = dir + "/key.pem";
+    if (!MakeCert()) {
+      eMsg = "unable to create a certificate";
+      return false;
+    }
+
+    srvCtx.reset(new XrdTlsContext(certFN.c_str(), keyFN.c_str(), nullptr,
+                                   nullptr, XrdTlsContext::servr, &eMsg));
+    if (!srvCtx->isOK()) return false;
+    srvCtx->SessionCache(XrdTlsContext::scSrvr, "test", 4);
+
+    cliCtx.reset(new XrdTlsContext(nullptr, nullptr, nullptr, certFN.c_str(),
+                                   0, &eMsg));
+    if (!cliCtx->isOK()) return false;
+    cliCtx->SessionCache(XrdTlsContext::scClnt);
+    return true;
+  }
+
+  ~XrdTlsTestPair()
+  {
+    cliCtx.reset();
+    srvCtx.reset();
+    if (!dir.empty()) {
+      unlink(certFN.c_str());
+      unlink(keyFN.c_str());
+      rmdir(dir.c_str());
+    }
+  }
+
+  // Do one connection over a socket pair. The server sends a byte so that
+  // the client also reads any session ticket sent after the handshake.
+  bool Connect(bool resume)
+  {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) return false;
+
+    bool srvOK = false;
+    std::thread srv([&]() {
+      XrdTlsSocket sock(*srvCtx, fds[1], XrdTlsSocket::TLS_RBL_WBL,
+                        XrdTlsSocket::TLS_HS_BLOCK, false);
+      int n;
+      srvOK = sock.Accept() == XrdTls::TLS_AOK
+           && sock.Write("x", 1, n) == XrdTls::TLS_AOK && n == 1;
+      sock.Shutdown();
+    });
+
+    bool cliOK;
+    {
+      XrdTlsSocket sock(*cliCtx, fds[0], XrdTlsSocket::TLS_RBL_WBL,
+                        XrdTlsSocket::TLS_HS_BLOCK, true);
+      if (resume) sock.ResumeSession("localhost:1094");
+      char c;
+      int n;
+      cliOK = sock.Connect("localhost") == XrdTls::TLS_AOK
+           && sock.Read(&c, 1, n) == XrdTls::TLS_AOK && n == 1;
+      sock.Shutdown();
+    }
+    srv.join();
+    close(fds[0]);
+    close(fds[1]);
+    return cliOK && srvOK;
+  }
+
+private:
+  std::string dir, certFN, keyFN;
+
+  // Write a self-signed certificate and its key for "localhost".
+  bool MakeCert()
+  {
+    EVP_PKEY *pkey = nullptr;
+    EVP_PKEY_CTX *kctx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, nullptr);
+    if (!kctx || EVP_PKEY_keygen_init(kctx) <= 0
+    ||  EVP_PKEY_CTX_set_rsa_keygen_bits(kctx, 2048) <= 0
+    ||  EVP_PKEY_keygen(kctx, &pkey) <= 0) {
+      EVP_PKEY_CTX_free(kctx);
+      return false;
+    }
+    EVP_PKEY_CTX_free(kctx);
+
+    X509 *x509 = X509_new();
+    ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+    X509_gmtime_adj(X509_getm_notBefore(x509), 0);
+    X509_gmtime_adj(X509_getm_notAfter(x509), 24*60*60);
+    X509_set_pubkey(x509, pkey);
+    X509_NAME *name = X509_get_subject_name(x509);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               (const unsigned char *)"localhost", -1, -1, 0);
+    X509_set_issuer_name(x509, name);
+    bool aOK = X509_sign(x509, pkey, EVP_sha256()) > 0;
+
+    FILE *fp;
+    if (aOK && (aOK = (fp = fopen(certFN.c_str(), "w")))) {
+      aOK = PEM_write_X509(fp, x509) == 1;
+      fclose(fp);
+    }
+    if (aOK && (aOK = (fp = fopen(keyFN.c_str(), "w")))) {
+      aOK = PEM_write_PrivateKey(fp, pkey, nullptr, nullptr, 0, nullptr, nullptr) == 1;
+      fclose(fp);
+    }
+    chmod(certFN.c_str(), 0644);
+    chmod(keyFN.c_str(), 0600);
+
+    X509_free(x509);
+    EVP_PKEY_free(pkey);
+    return aOK;
+  }
+};
+
+#endif
@@ -0,0 +1,50 @@
+#undef NDEBUG
+
+#include "XrdTlsTestPair.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Measures TLS connection setup over a socket pair, with a full handshake
+// each time and with the session saved by the previous connection resumed.
+//
+// Usage: xrdtls-bench-session [connections per pass]
+
+int main(int argc, char *argv[])
+{
+  int count = 200;
+  if (argc > 1) count = atoi(argv[1]);
+  if (count < 1) count = 1;
+
+  XrdTlsTestPair pair;
+  std::string eMsg;
+  if (!pair.Init(eMsg)) {
+    fprintf(stderr, "unable to set up TLS contexts; %s\n", eMsg.c_str());
+    return EXIT_FAILURE;
+  }
+
+  // The first connection of each pass is a warm up, in the resume pass it
+  // also leaves the first session behind
+  for (bool resume : {false, true}) {
+    if (!pair.Connect(resume)) {
+      fprintf(stderr, "connection failed\n");
+      return EXIT_FAILURE;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+      if (!pair.Connect(resume)) {
+        fprintf(stderr, "connection failed\n");
+        return EXIT_FAILURE;
+      }
+    std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+    printf("%s handshakes: %8.1f connections/s\n",
+           resume ? "resumed" : "full   ", count / secs.count());
+  }
+
+  unsigned long long full, resumed;
+  pair.cliCtx->HandshakeStats(full, resumed);
+  printf("client handshakes: %llu full, %llu resumed\n", full, resumed);
+  return 0;
+}